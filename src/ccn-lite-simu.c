@@ -342,12 +342,6 @@ ccnl_simu_defaultFaceScheduler(struct ccnl_relay_s *ccnl,
 }
 #endif
 
-void ccnl_ageing(void *relay, void *aux)
-{
-    ccnl_do_ageing(relay, aux);
-    ccnl_set_timer(1000000, ccnl_ageing, relay, 0);
-}
-
 void
 ccnl_simu_init_node(char node, const char *addr,
                     int max_cache_entries, int mtu)
@@ -389,8 +383,6 @@ ccnl_simu_init_node(char node, const char *addr,
             "/ccnl/simu/movie1" : "/ccnl/simu/movie2";
         relay->aux = (void *) client;
     }
-
-    ccnl_set_timer(1000000, ccnl_ageing, relay, 0);
 }
 
 
@@ -418,8 +410,7 @@ ccnl_simu_add_fwd(char node, const char *name, char dstnode, int mtu)
         fwd->face->frag = ccnl_frag_new(CCNL_FRAG_BEGINEND2015, mtu);
 #endif
     fwd->face->flags |= CCNL_FACE_FLAGS_STATIC;
-    fwd->next = relay->fib;
-    relay->fib = fwd;
+    ccnl_forward_add(relay, fwd);
 }
 
 
@@ -499,36 +490,14 @@ ccnl_simu_phase_two(void *ptr, void *dummy)
 void
 simu_eventloop()
 {
-    static struct timeval now;
-    long usec;
+    int usec;
 
-    while (eventqueue) {
-        struct ccnl_timer_s *t = eventqueue;
+    while ((usec = ccnl_run_events()) >= 0) {
         // printf("  looping now %g\n", CCNL_NOW());
-        gettimeofday(&now, 0);
-        usec = timevaldelta(&(t->timeout), &now);
-        if (usec >= 0) {
-            // usleep(usec);
-            struct timespec ts;
-            ts.tv_sec = usec / 1000000;
-            ts.tv_nsec = 1000 * (usec % 1000000);
-            nanosleep(&ts, NULL);
-        }
-        t = eventqueue;
-        eventqueue = t->next;
-        if (t->fct) {
-            void (*fct)(char,int) = t->fct;
-            char c = t->node;
-            int i = t->intarg;
-            ccnl_free(t);
-            (fct)(c, i);
-        } else if (t->fct2) {
-            void (*fct2)(void*,void*) = t->fct2;
-            void *aux1 = t->aux1;
-            void *aux2 = t->aux2;
-            ccnl_free(t);
-            (fct2)(aux1, aux2);
-        }
+        struct timespec ts;
+        ts.tv_sec = usec / 1000000;
+        ts.tv_nsec = 1000 * (usec % 1000000);
+        nanosleep(&ts, NULL);
     }
     DEBUGMSG(ERROR, "simu event loop: no more events to handle\n");
 }
@@ -550,8 +519,7 @@ ccnl_simu_cleanup(void *dummy, void *dummy2)
         ccnl_core_cleanup(relay);
     }
 
-    while(eventqueue)
-        ccnl_rem_timer(eventqueue);
+    ccnl_timer_cleanup();
 
     while(etherqueue) {
         struct ccnl_ethernet_s *e = etherqueue->next;
@@ -56,8 +56,6 @@ ccnl_ll_TX(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
 int
 ccnl_close_socket(int s);
 
-void ccnl_ageing(void *relay, void *aux);
-
 void
 add_udpPort(struct ccnl_relay_s *relay, int port);
 
@@ -214,14 +214,6 @@ ccnl_relay_defaultInterfaceScheduler(struct ccnl_relay_s *ccnl,
 */
 #endif // USE_SCHEDULER
 
-
-void ccnl_ageing(void *relay, void *aux)
-{
-    ccnl_do_ageing(relay, aux);
-
-    ccnl_set_timer(1000000, ccnl_ageing, relay, 0);
-}
-
 // ----------------------------------------------------------------------
 
 char *echopath = "/local/echo";
@@ -294,8 +286,6 @@ ccnl_relay_config(struct ccnl_relay_s *relay, int httpport, char *uxpath,
         relay->http = ccnl_http_new(relay, httpport);
     }
 #endif // USE_HTTP_STATUS
-
-    ccnl_set_timer(1000000, ccnl_ageing, relay, 0);
 }
 
 // ----------------------------------------------------------------------
@@ -22,24 +22,58 @@
 #ifndef CCNL_LINUXKERNEL
 #include <unistd.h> //FIXME: SWITCH HERE
 #include <string.h>
+#include <stdint.h>
+#else
+#include <linux/types.h>
 #endif
 #include <stddef.h>
 
 
 struct ccnl_relay_s;
 
+/**
+ * @brief A packet in memory
+ *
+ * Once a buffer is shared with ccnl_buf_ref() its data must not change: the
+ * content store, the PIT and the queues of the faces hold the same buffer.
+ */
 struct ccnl_buf_s {
     struct ccnl_buf_s *next;
     size_t datalen;
+    uint32_t refcnt;            /**< number of owners, see ccnl_buf_free() */
+    uint32_t hash;              /**< hash over data, 0: not computed yet */
     unsigned char data[1];
 };
 
 /**
- * 
+ * @brief Allocates a buffer with a reference count of one
+ *
+ * @param[in] data      Bytes to copy into the buffer, may be NULL
+ * @param[in] len       Size of the buffer
  */
 struct ccnl_buf_s*
 ccnl_buf_new(void *data, size_t len);
 
+/**
+ * @brief Adds an owner to @p buf
+ *
+ * @return @p buf, which may be NULL
+ */
+struct ccnl_buf_s*
+ccnl_buf_ref(struct ccnl_buf_s *buf);
+
+/**
+ * @brief Drops an owner of @p buf, the last one releases the buffer
+ */
+void
+ccnl_buf_free(struct ccnl_buf_s *buf);
+
+/**
+ * @brief Returns the hash over the data of @p buf, computed on first use
+ */
+uint32_t
+ccnl_buf_hash(struct ccnl_buf_s *buf);
+
 #define buf_dup(B)      (B) ? ccnl_buf_new(B->data, B->datalen) : NULL
 #define buf_equal(X,Y)  ((X) && (Y) && (X->datalen==Y->datalen) &&\
                          !memcmp(X->data,Y->data,X->datalen))
@@ -0,0 +1,194 @@
+/**
+ * @addtogroup CCNL-core
+ * @{
+ *
+ * @file ccnl-cache.h
+ * @brief CCN lite (CCNL), replacement policies of the content store
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef CCNL_CACHE_H
+#define CCNL_CACHE_H
+
+#ifndef CCNL_LINUXKERNEL
+#include <stdint.h>
+#else
+#include <linux/types.h>
+#endif
+
+#include "ccnl-content.h"
+#include "ccnl-htable.h"
+
+struct ccnl_relay_s;
+
+/**
+ * @brief Replacement policies of the content store
+ */
+enum ccnl_cache_policy_e {
+    CCNL_CACHE_LRU = 0,     /**< least recently used (default) */
+    CCNL_CACHE_LFU,         /**< least frequently used, ties broken by recency */
+    CCNL_CACHE_ARC,         /**< adaptive replacement cache */
+    CCNL_CACHE_S3FIFO,      /**< small and main FIFO queues with a ghost queue */
+    CCNL_CACHE_LAST
+};
+
+/**
+ * @brief Number of content queues a policy can use
+ *
+ * LFU keeps one queue per access count, counts above this value share the
+ * last queue.
+ */
+#define CCNL_CACHE_QUEUES 16
+
+/**
+ * @brief Upper bound of the S3-FIFO access counter
+ */
+#define CCNL_CACHE_S3FIFO_MAXFREQ 3
+
+/**
+ * @brief Queue of cached contents, linked through their qnext/qprev fields
+ */
+struct ccnl_cache_queue_s {
+    struct ccnl_content_s *head;    /**< most recently queued entry */
+    struct ccnl_content_s *tail;    /**< least recently queued entry */
+    uint32_t count;                 /**< number of queued entries */
+};
+
+/**
+ * @brief Remembers the name hash of an evicted content (ARC, S3-FIFO)
+ */
+struct ccnl_cache_ghost_s {
+    struct ccnl_cache_ghost_s *next;
+    struct ccnl_cache_ghost_s *prev;
+    struct ccnl_hnode_s hnode;      /**< link in the ghost index */
+    uint8_t queue;                  /**< index of the ghost queue holding this entry */
+};
+
+/**
+ * @brief Queue of ghost entries
+ */
+struct ccnl_cache_gqueue_s {
+    struct ccnl_cache_ghost_s *head;
+    struct ccnl_cache_ghost_s *tail;
+    uint32_t count;
+};
+
+/**
+ * @brief Per relay state of the content store's replacement policy
+ *
+ * A zero-initialized struct is an empty LRU cache.
+ */
+struct ccnl_cache_s {
+    int policy;                     /**< one of @ref ccnl_cache_policy_e */
+    struct ccnl_cache_queue_s queues[CCNL_CACHE_QUEUES]; /**< policy specific content queues */
+    struct ccnl_cache_gqueue_s ghosts[2]; /**< policy specific ghost queues */
+    struct ccnl_htable_s ghost_index; /**< ghost entries, hashed by name */
+    int ghost_hit;                  /**< 1 + ghost queue the admitted content was found in, 0: none */
+    uint32_t arc_p;                 /**< ARC's target size of its recency queue */
+    unsigned long hits;             /**< number of content store hits */
+    unsigned long misses;           /**< number of content store misses */
+    unsigned long evictions;        /**< number of entries evicted by the policy */
+};
+
+/**
+ * @brief Returns the policy with name @p str (lru, lfu, arc, s3fifo)
+ *
+ * @param[in] str   Name of the policy
+ *
+ * @return the policy, -1 if @p str is not a known policy name
+ */
+int
+ccnl_cache_str2policy(const char *str);
+
+/**
+ * @brief Returns the name of policy @p policy
+ */
+const char*
+ccnl_cache_policy2str(int policy);
+
+/**
+ * @brief Selects the replacement policy of relay @p relay
+ *
+ * Entries which are already cached are handed over to the new policy.
+ *
+ * @param[in] relay     The relay
+ * @param[in] policy    One of @ref ccnl_cache_policy_e
+ *
+ * @return 0 on success
+ * @return -1 if @p policy is not a valid policy
+ */
+int
+ccnl_cache_set_policy(struct ccnl_relay_s *relay, int policy);
+
+/**
+ * @brief Prepares the admission of @p c, must precede evictions on its behalf
+ *
+ * @param[in] relay     The relay
+ * @param[in] c         Content which is about to be added to the cache
+ */
+void
+ccnl_cache_admit(struct ccnl_relay_s *relay, struct ccnl_content_s *c);
+
+/**
+ * @brief Hands a content which was added to the content store to the policy
+ *
+ * Static contents are not queued, they are never evicted.
+ *
+ * @param[in] relay     The relay
+ * @param[in] c         The new content
+ */
+void
+ccnl_cache_insert(struct ccnl_relay_s *relay, struct ccnl_content_s *c);
+
+/**
+ * @brief Records a content store hit on @p c
+ *
+ * @param[in] relay     The relay
+ * @param[in] c         The content which was found
+ */
+void
+ccnl_cache_hit(struct ccnl_relay_s *relay, struct ccnl_content_s *c);
+
+/**
+ * @brief Takes @p c out of the policy's queues, called on any removal
+ *
+ * @param[in] relay     The relay
+ * @param[in] c         The content which leaves the content store
+ */
+void
+ccnl_cache_remove(struct ccnl_relay_s *relay, struct ccnl_content_s *c);
+
+/**
+ * @brief Removes the content the policy chooses as victim from the cache
+ *
+ * @param[in] relay     The relay
+ *
+ * @return 0 if an entry was removed
+ * @return -1 if there was no entry which could be evicted
+ */
+int
+ccnl_cache_evict(struct ccnl_relay_s *relay);
+
+/**
+ * @brief Releases the ghost entries of the policy
+ *
+ * @param[in] relay     The relay
+ */
+void
+ccnl_cache_cleanup(struct ccnl_relay_s *relay);
+
+#endif // CCNL_CACHE_H
+/** @} */
@@ -56,17 +56,19 @@ void ccnl_set_cb_tx_on_data(ccnl_cb_on_data func);
  *
  * @param[in] relay The active ccn-lite relay
  * @param[in] from  The face the packet was received over
- * @param[in] pkt   The actual received packet 
+ * @param[in,out] pkt   The actual received packet 
  *
  * @note if the callback function returns any other value than 0,
- *       then the data packet is discarded.
+ *       then the data packet is discarded and @p pkt set to NULL.
+ *       A packet parsed in place is copied before it is passed to the
+ *       callback, see ccnl_pkt_own().
  *
  * @return return value of the callback function
  * @return 0, if no function has been set
  */
 int ccnl_callback_rx_on_data(struct ccnl_relay_s *relay,
                              struct ccnl_face_s *from,
-                             struct ccnl_pkt_s *pkt);
+                             struct ccnl_pkt_s **pkt);
 
 /**
  * @brief Callback for outbound on-data events
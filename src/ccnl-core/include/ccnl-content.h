@@ -25,12 +25,16 @@
 
 #include <stdbool.h>
 #ifndef CCNL_LINUXKERNEL
+#include <stddef.h>
 #include <stdint.h>
 #else
 #include <linux/types.h>
 
 #endif
 
+#include "ccnl-htable.h"
+#include "ccnl-os-time.h"
+
 #ifdef CCNL_RIOT
 #include "evtimer_msg.h"
 #endif
@@ -60,6 +64,12 @@ typedef struct ccnl_content_s {
     struct ccnl_content_s *next;          /**< pointer to the next element in the content store */
     struct ccnl_content_s *prev;          /**< pointer to the previous element in the content store */
     struct ccnl_pkt_s *pkt;               /**< a byte representation of received content (the actual packet) */
+    struct ccnl_hnode_s hnode;            /**< link in the content store's name index */
+    struct ccnl_content_s *qnext;         /**< next entry in the replacement policy's queue */
+    struct ccnl_content_s *qprev;         /**< previous entry in the replacement policy's queue */
+    uint8_t queue;                        /**< 1 + the policy queue holding the content, 0: none */
+    uint8_t freq;                         /**< access count as kept by the replacement policy */
+    size_t size;                          /**< bytes charged to the content store's byte budget */
 
     ccnl_content_flags flags;             /**< indicates if content is marked static or stale */
 
@@ -67,6 +77,11 @@ typedef struct ccnl_content_s {
     // >> CCNL: currently no stale bit, old content is fully removed <<
 
     uint32_t last_used;                   /**< indicates when the stored content was last used */
+#ifdef CCNL_ENTRY_TIMERS
+    void *timer;                          /**< timer for the next of stale and expires */
+    uint64_t stale;                       /**< when the content becomes stale, 0: never */
+    uint64_t expires;                     /**< when the content is removed, see ccnl_time_usec() */
+#endif
 #ifdef CCNL_RIOT
     evtimer_msg_event_t evtmsg_cstimeout; /**< event timer message which is triggered when a timeout in the content store occurs */
 #endif
@@ -94,5 +109,18 @@ ccnl_content_new(struct ccnl_pkt_s **packet);
 int
 ccnl_content_free(struct ccnl_content_s *content);
 
+/**
+ * @brief Returns the memory held by \p content
+ *
+ * Counts the entry itself, the parsed packet, the packet's buffer and the
+ * name, i.e. what is released when the entry leaves the content store.
+ *
+ * @param[in] content The content object
+ *
+ * @return The size of \p content in bytes
+ */
+size_t
+ccnl_content_size(struct ccnl_content_s *content);
+
 #endif // EOF
 /** @} */
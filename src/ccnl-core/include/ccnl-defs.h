@@ -68,6 +68,22 @@
 # define CCNL_DEFAULT_MAX_PIT_ENTRIES    (-1)
 #endif
 
+// packets read or sent with one system call, see ccnl_relay_s.rx_batch
+#ifndef CCNL_DEFAULT_IO_BATCH
+# define CCNL_DEFAULT_IO_BATCH           32
+#endif
+#ifndef CCNL_MAX_IO_BATCH
+# define CCNL_MAX_IO_BATCH               CCNL_MAX_IF_QLEN
+#endif
+
+// the core's caches and static buffers, one set per thread when the relay
+// runs several shards (see ccnl-shard.h), each relay stays in its thread
+#ifdef USE_THREADS
+# define CCNL_THREAD_LOCAL               __thread
+#else
+# define CCNL_THREAD_LOCAL
+#endif
+
 #ifndef CCNL_CONTENT_TIMEOUT
 # define CCNL_CONTENT_TIMEOUT            300 // sec
 #endif
@@ -77,6 +93,9 @@
 #ifndef CCNL_MAX_INTEREST_RETRANSMIT
 # define CCNL_MAX_INTEREST_RETRANSMIT    7
 #endif
+#ifndef CCNL_INTEREST_RETRANS_TIMEOUT
+# define CCNL_INTEREST_RETRANS_TIMEOUT   1000 // msec
+#endif
 
 #ifndef CCNL_FACE_TIMEOUT
 // # define CCNL_FACE_TIMEOUT    60 // sec
@@ -87,8 +106,11 @@
 #ifdef CCNL_RIOT
 #define CCNL_MAX_NONCES                 -1 // -1 --> detect dups by PIT
 #else //!CCNL_RIOT
-#define CCNL_MAX_NONCES                 256 // for detected dups
+#define CCNL_MAX_NONCES                 262144 // for detected dups
 #endif //CCNL_RIOT
+#ifndef CCNL_NONCE_LIFETIME
+# define CCNL_NONCE_LIFETIME             6 // sec
+#endif
 
 enum {
 #ifdef USE_SUITE_CCNB
@@ -174,6 +196,8 @@ typedef enum ccnl_enc_e {
 #define CCNL_DTAG_SERVEDCTN     99224
 #define CCNL_DTAG_VERIFIED      99225
 #define CCNL_DTAG_CALLBACK      99226
+#define CCNL_DTAG_CSBYTES       99227 // bytes held by the content store
+#define CCNL_DTAG_CSMAXBYTES    99228 // byte budget of the content store
 #define CCNL_DTAG_SUITE         99300
 #define CCNL_DTAG_COMPLENGTH    99301
 #define CCNL_DTAG_CHUNKNUM      99302
@@ -235,8 +259,8 @@ typedef enum ccnl_enc_e {
 
 #define CCNL_FACE_FLAGS_STATIC  1
 #define CCNL_FACE_FLAGS_REFLECT 2
-#define CCNL_FACE_FLAGS_SERVED  4
 #define CCNL_FACE_FLAGS_FWDALLI 8 // forward all interests, also known ones
+#define CCNL_FACE_FLAGS_PUSH    16 // cache Data no interest asked for
 
 #define CCNL_FRAG_NONE          0
 #define CCNL_FRAG_SEQUENCED2012 1
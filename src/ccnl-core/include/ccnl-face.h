@@ -24,21 +24,38 @@
 #define CCNL_FACE_H
 
 #include "ccnl-sockunion.h"
+#include "ccnl-htable.h"
+#include "ccnl-os-time.h"
 
 #ifdef CCNL_RIOT
 #include "evtimer_msg.h"
 #endif
 
+// entry of a face's send queue, the buffer may be queued on other faces too
+struct ccnl_outq_s {
+    struct ccnl_outq_s *next;
+    struct ccnl_buf_s *buf;
+};
+
 struct ccnl_face_s {
     struct ccnl_face_s *next, *prev;
+    struct ccnl_hnode_s hnode; // link in the relay's face index
     int faceid;
     int ifndx;
     sockunion peer;
     int flags;
     uint32_t last_used; // updated when we receive a packet
-    struct ccnl_buf_s *outq, *outqend; // queue of packets to send
+    uint32_t served_seq; // relay's serve_seq when this face was last served
+    struct ccnl_outq_s *outq, *outqend; // queue of packets to send
     struct ccnl_frag_s *frag;  // which special datagram armoring
     struct ccnl_sched_s *sched;
+    // back references, so that removing the face does not walk PIT and FIB
+    struct ccnl_interest_s *pit;       // PIT entries received from this face
+    struct ccnl_pendint_s *pendints;   // pending interest records of this face
+    struct ccnl_forward_s *fib;        // FIB entries via this face
+#ifdef CCNL_ENTRY_TIMERS
+    void *timer; // fires CCNL_FACE_TIMEOUT after last_used
+#endif
 #ifdef CCNL_RIOT
     evtimer_msg_event_t evtmsg_timeout;
 #endif
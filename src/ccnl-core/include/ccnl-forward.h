@@ -27,15 +27,20 @@
 #include "ccnl-face.h"
 #include "ccnl-relay.h"
 #include "ccnl-buf.h"
+#include "ccnl-htable.h"
  
 typedef void (*tapCallback)(struct ccnl_relay_s *, struct ccnl_face_s *,
                             struct ccnl_prefix_s *, struct ccnl_buf_s *);
 
 struct ccnl_forward_s {
     struct ccnl_forward_s *next;
+    struct ccnl_forward_s *prev;
+    struct ccnl_hnode_s hnode;    /**< link in the FIB's prefix index */
     struct ccnl_prefix_s *prefix;
     tapCallback tap;
     struct ccnl_face_s *face;
+    struct ccnl_forward_s *fnext;   /**< next entry via the same face */
+    struct ccnl_forward_s **fpprev; /**< link pointing to this entry in the face's list */
     char suite;
 };
 
@@ -0,0 +1,136 @@
+/**
+ * @addtogroup CCNL-core
+ * @{
+ *
+ * @file ccnl-htable.h
+ * @brief CCN lite (CCNL), intrusive hash table used to index the relay tables
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef CCNL_HTABLE_H
+#define CCNL_HTABLE_H
+
+#ifndef CCNL_LINUXKERNEL
+#include <stddef.h>
+#include <stdint.h>
+#else
+#include <linux/stddef.h>
+#include <linux/types.h>
+#endif
+
+/**
+ * @brief Initial number of buckets, the table doubles once it is full
+ */
+#define CCNL_HTABLE_MIN_SIZE 64
+
+/**
+ * @brief Start value for @ref ccnl_hash_bytes
+ */
+#define CCNL_HASH_INIT 2166136261u
+
+/**
+ * @brief Hash chain link, embedded into the indexed data structure
+ */
+struct ccnl_hnode_s {
+    struct ccnl_hnode_s *next;  /**< next node in the same bucket */
+    uint32_t hash;              /**< full hash value of the node's key */
+};
+
+/**
+ * @brief Chained hash table over embedded @ref ccnl_hnode_s links
+ *
+ * The table does not own its nodes and never compares keys, it only narrows
+ * a lookup down to the nodes with the same hash value. A zero-initialized
+ * table is empty and valid, the buckets are allocated on the first insert.
+ */
+struct ccnl_htable_s {
+    struct ccnl_hnode_s **buckets; /**< bucket array, NULL while empty */
+    uint32_t size;                 /**< number of buckets (a power of two) */
+    uint32_t count;                /**< number of linked nodes */
+};
+
+/**
+ * @brief Returns the structure of type @p type which embeds node @p n as @p member
+ */
+#define CCNL_HTABLE_ENTRY(n, type, member) \
+    ((type*) ((char*) (n) - offsetof(type, member)))
+
+/**
+ * @brief Link node @p n with hash value @p hash into table @p t
+ *
+ * @param[in] t     The hash table
+ * @param[in] n     The node to be linked, must not be linked already
+ * @param[in] hash  Hash value of the node's key
+ *
+ * @return 0 on success
+ * @return -1 if no buckets could be allocated
+ */
+int
+ccnl_htable_insert(struct ccnl_htable_s *t, struct ccnl_hnode_s *n,
+                   uint32_t hash);
+
+/**
+ * @brief Unlink node @p n from table @p t, unknown nodes are ignored
+ *
+ * @param[in] t     The hash table
+ * @param[in] n     The node to be unlinked
+ */
+void
+ccnl_htable_remove(struct ccnl_htable_s *t, struct ccnl_hnode_s *n);
+
+/**
+ * @brief Returns the first node with hash value @p hash
+ *
+ * @param[in] t     The hash table
+ * @param[in] hash  Hash value to look for
+ *
+ * @return the first node with this hash value, NULL if there is none
+ */
+struct ccnl_hnode_s*
+ccnl_htable_lookup(struct ccnl_htable_s *t, uint32_t hash);
+
+/**
+ * @brief Returns the node following @p n which has the same hash value
+ *
+ * @param[in] n     A node returned by @ref ccnl_htable_lookup
+ *
+ * @return the next node with the same hash value, NULL if there is none
+ */
+struct ccnl_hnode_s*
+ccnl_htable_next(struct ccnl_hnode_s *n);
+
+/**
+ * @brief Releases the bucket array of table @p t, the nodes are not touched
+ *
+ * @param[in] t     The hash table
+ */
+void
+ccnl_htable_free(struct ccnl_htable_s *t);
+
+/**
+ * @brief Continues the (FNV-1a) hash value @p h over @p len bytes of @p data
+ *
+ * @param[in] h     Hash value so far, @ref CCNL_HASH_INIT to start a new one
+ * @param[in] data  The bytes to be hashed
+ * @param[in] len   Number of bytes in @p data
+ *
+ * @return the new hash value
+ */
+uint32_t
+ccnl_hash_bytes(uint32_t h, const uint8_t *data, size_t len);
+
+#endif // CCNL_HTABLE_H
+/** @} */
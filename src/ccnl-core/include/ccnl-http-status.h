@@ -40,6 +40,31 @@ int ccnl_http_status(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http);
 struct ccnl_http_s*
 ccnl_http_cleanup(struct ccnl_http_s *http);
 
+/**
+ * @brief Tells which descriptor the status server waits on
+ *
+ * @param[in] http  the status server
+ * @param[out] fd   the listening socket, or the client's while one is connected
+ * @param[out] rd   whether to wait for @p fd to become readable
+ * @param[out] wr   whether to wait for @p fd to become writable
+ *
+ * @return 0 on success, -1 if there is no server
+ */
+int
+ccnl_http_interest(struct ccnl_http_s *http, int *fd, int *rd, int *wr);
+
+/**
+ * @brief Serves the descriptor returned by ccnl_http_interest()
+ *
+ * @param[in] rd    whether the descriptor is readable
+ * @param[in] wr    whether the descriptor is writable
+ *
+ * @return 0 on success, -1 if there is no server
+ */
+int
+ccnl_http_io(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
+             int rd, int wr);
+
 int
 ccnl_http_anteselect(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
                      fd_set *readfs, fd_set *writefs, int *maxfd);
@@ -56,9 +56,19 @@ struct ccnl_if_s { // interface for packet IO
     uint16_t addr_len;
 #else
     int sock;
+    int gso; // socket takes UDP_SEGMENT sends (USE_GSO)
+    int gro; // socket delivers coalesced UDP_GRO datagrams (USE_GSO)
+    int piped; // threads of the pipeline move the packets (USE_THREADS)
+    void *ring; // memory mapped packet rings of the socket (USE_TPACKET, USE_XDP)
+    void (*ring_release)(struct ccnl_if_s *i); // unmaps them
+    void *stream; // connections of a listening stream socket (USE_STREAM)
+    void (*stream_release)(struct ccnl_if_s *i); // closes them
+    void *shm; // shared memory faces set up through a UNIX socket (USE_SHM)
+    void (*shm_release)(struct ccnl_if_s *i); // unmaps them
 #endif
     int reflect; // whether to reflect I packets on this interface
     int fwdalli; // whether to forward all I packets rcvd on this interface
+    int push; // whether D packets rcvd on this interface are cached unasked
     uint32_t mtu;
 
     size_t qlen;  // number of pending sends
@@ -68,6 +78,7 @@ struct ccnl_if_s { // interface for packet IO
 
 #ifdef USE_STATS
     uint32_t rx_cnt, tx_cnt;
+    uint32_t rx_batches, tx_batches; // system calls which moved packets
 #endif
 };
 
@@ -27,6 +27,8 @@
 
 #include "ccnl-pkt.h"
 #include "ccnl-face.h"
+#include "ccnl-htable.h"
+#include "ccnl-os-time.h"
 
 #ifdef CCNL_RIOT
 #include "evtimer_msg.h"
@@ -38,6 +40,9 @@
 struct ccnl_pendint_s { 
     struct ccnl_pendint_s *next; /**< pointer to the next list element */
     struct ccnl_face_s *face;    /**< pointer to incoming face  */
+    struct ccnl_interest_s *interest; /**< the PIT entry holding this element */
+    struct ccnl_pendint_s *fnext;     /**< next element of the same face */
+    struct ccnl_pendint_s **fpprev;   /**< link pointing to this element in the face's list */
     uint32_t last_used;          /** */
 };
 
@@ -47,12 +52,19 @@ struct ccnl_pendint_s {
 struct ccnl_interest_s {
     struct ccnl_interest_s *next;       /**< pointer to the next list element */
     struct ccnl_interest_s *prev;       /**< pointer to the previous list element */
+    struct ccnl_hnode_s hnode;          /**< link in the PIT's name index */
     struct ccnl_pkt_s *pkt;             /**< the packet the interests originates from (?) */
     struct ccnl_face_s *from;           /**< the face the interest was received from */
+    struct ccnl_interest_s *fnext;      /**< next entry received from the same face */
+    struct ccnl_interest_s **fpprev;    /**< link pointing to this entry in the face's list */
     struct ccnl_pendint_s *pending;     /**< linked list of faces wanting that content */
-    uint32_t lifetime;                  /**< interest lifetime */
+    uint32_t lifetime;                  /**< interest lifetime in milliseconds */
     uint32_t last_used;                 /**< last time the entry was used */
     int retries;                        /**< current number of executed retransmits. */
+#ifdef CCNL_ENTRY_TIMERS
+    void *timer;                        /**< next retransmission or timeout */
+    uint64_t expires;                   /**< end of the lifetime, see ccnl_time_usec() */
+#endif
 #ifdef CCNL_RIOT
     evtimer_msg_event_t evtmsg_retrans; /**< retransmission timer */
     evtimer_msg_event_t evtmsg_timeout; /**< timeout timer for (?) */
@@ -73,6 +85,17 @@ struct ccnl_interest_s*
 ccnl_interest_new(struct ccnl_relay_s *ccnl, struct ccnl_face_s *from,
                   struct ccnl_pkt_s **pkt);
 
+/**
+ * Looks up the PIT entry which is the same interest as \ref pkt
+ *
+ * @param[in] ccnl
+ * @param[in] pkt
+ *
+ * @return the PIT entry for which \ref ccnl_interest_isSame holds, NULL if none
+ */
+struct ccnl_interest_s*
+ccnl_interest_find(struct ccnl_relay_s *ccnl, struct ccnl_pkt_s *pkt);
+
 /**
  * Checks if two interests are the same
  * 
@@ -29,6 +29,21 @@
 #endif //CCNL_LINUXKERNEL
 
 
+/**
+ * @brief Types of objects the allocator keeps counters for
+ */
+enum ccnl_mem_type {
+    CCNL_MEM_OTHER = 0,         /**< anything not listed below */
+    CCNL_MEM_PKT,               /**< struct ccnl_pkt_s */
+    CCNL_MEM_PREFIX,            /**< struct ccnl_prefix_s */
+    CCNL_MEM_INTEREST,          /**< struct ccnl_interest_s */
+    CCNL_MEM_PENDINT,           /**< struct ccnl_pendint_s */
+    CCNL_MEM_CONTENT,           /**< struct ccnl_content_s */
+    CCNL_MEM_FACE,              /**< struct ccnl_face_s */
+    CCNL_MEM_TIMER,             /**< struct ccnl_timer_s */
+    CCNL_MEM_TYPES
+};
+
 #ifdef USE_DEBUG_MALLOC
 struct mhdr {
     struct mhdr *next;
@@ -79,7 +94,85 @@ debug_strdup(const char *s, const char *fn, int lno, char *tstamp);
 
 #endif // CCNL_ARDUINO
 
-#else // !USE_DEBUG_MALLOC
+#elif defined(USE_SLAB_MALLOC)
+
+/**
+ * @brief Size of a slab, the unit in which the allocator requests memory
+ */
+#define CCNL_SLAB_SIZE          (64 * 1024)
+
+/**
+ * @brief Size of the arenas the slabs are cut from with USE_SLAB_HUGEPAGES
+ */
+#define CCNL_SLAB_ARENA_SIZE    (2 * 1024 * 1024)
+
+/**
+ * @brief Largest block, including its header, which is served from a slab
+ *
+ * Larger blocks are taken from malloc().
+ */
+#define CCNL_SLAB_MAX           2048
+
+/**
+ * @brief Counters of the allocator for one type of objects
+ */
+struct ccnl_mem_stats_s {
+    size_t objects;             /**< number of live objects */
+    size_t bytes;               /**< bytes requested for the live objects */
+};
+
+void*
+ccnl_slab_malloc(int type, size_t s);
+
+void*
+ccnl_slab_calloc(int type, size_t n, size_t s);
+
+void*
+ccnl_slab_realloc(void *p, size_t s);
+
+char*
+ccnl_slab_strdup(const char *s);
+
+void
+ccnl_slab_free(void *p);
+
+/**
+ * @brief Reads the counters for objects of @p type
+ *
+ * @param[in] type      One of @ref ccnl_mem_type
+ * @param[out] stats    The counters
+ */
+void
+ccnl_mem_stats(int type, struct ccnl_mem_stats_s *stats);
+
+/**
+ * @brief Returns the bytes the allocator holds in slabs and large blocks
+ */
+size_t
+ccnl_mem_reserved(void);
+
+/**
+ * @brief Releases the empty slabs kept by the calling thread's caches,
+ *        e.g. before the thread exits
+ */
+void
+ccnl_mem_trim(void);
+
+/**
+ * @brief Returns the name of a @ref ccnl_mem_type
+ */
+const char*
+ccnl_mem_type2str(int type);
+
+#  define ccnl_malloc(s)        ccnl_slab_malloc(CCNL_MEM_OTHER, s)
+#  define ccnl_calloc(n,s)      ccnl_slab_calloc(CCNL_MEM_OTHER, n, s)
+#  define ccnl_realloc(p,s)     ccnl_slab_realloc(p, s)
+#  define ccnl_strdup(s)        ccnl_slab_strdup(s)
+#  define ccnl_free(p)          ccnl_slab_free(p)
+#  define ccnl_obj_malloc(t,s)  ccnl_slab_malloc(t, s)
+#  define ccnl_obj_calloc(t,s)  ccnl_slab_calloc(t, 1, s)
+
+#else // !USE_DEBUG_MALLOC && !USE_SLAB_MALLOC
 
 
 # ifndef CCNL_LINUXKERNEL
@@ -97,6 +190,13 @@ debug_strdup(const char *s, const char *fn, int lno, char *tstamp);
 
 #endif// USE_DEBUG_MALLOC
 
+/* Allocations of the object types listed in ccnl_mem_type, they are freed
+ * with ccnl_free() like any other block. */
+#ifndef ccnl_obj_malloc
+#  define ccnl_obj_malloc(t,s)  ccnl_malloc(s)
+#  define ccnl_obj_calloc(t,s)  ccnl_calloc(1,s)
+#endif
+
 #ifdef CCNL_LINUXKERNEL
 
 
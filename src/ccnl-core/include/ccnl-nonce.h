@@ -0,0 +1,98 @@
+/**
+ * @addtogroup CCNL-core
+ * @{
+ *
+ * @file ccnl-nonce.h
+ * @brief CCN lite (CCNL), table of recently seen Interest nonces
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef CCNL_NONCE_H
+#define CCNL_NONCE_H
+
+#ifndef CCNL_LINUXKERNEL
+#include <stdint.h>
+#else
+#include <linux/types.h>
+#endif
+
+struct ccnl_relay_s;
+struct ccnl_prefix_s;
+struct ccnl_buf_s;
+
+/**
+ * @brief Number of entries per bucket of the nonce table
+ */
+#define CCNL_NONCE_WAYS 4
+
+/**
+ * @brief Initial number of entries of the nonce table
+ */
+#define CCNL_NONCE_MIN_SIZE 1024
+
+/**
+ * @brief Entry of the nonce table
+ *
+ * Only a hash over name and nonce is kept, like in NFD's dead nonce list.
+ */
+struct ccnl_nonce_s {
+    uint32_t hash;                  /**< hash over the Interest's name and nonce */
+    uint32_t expires;               /**< time (CCNL_NOW) the entry expires, 0: unused */
+};
+
+/**
+ * @brief Set associative table of recently seen name and nonce pairs
+ *
+ * Entries expire after CCNL_NONCE_LIFETIME seconds. When all entries of a
+ * bucket are live the table doubles, up to CCNL_MAX_NONCES entries, after
+ * that the entry which expires first is replaced. A zero-initialized table
+ * is empty and valid.
+ */
+struct ccnl_nonce_table_s {
+    struct ccnl_nonce_s *slots;     /**< size entries, NULL while empty */
+    uint32_t size;                  /**< number of entries (a power of two) */
+};
+
+/**
+ * @brief Looks up the pair of @p pfx and @p nonce and records it if it is new
+ *
+ * @param[in] relay     The relay
+ * @param[in] pfx       Name of the Interest
+ * @param[in] nonce     Nonce of the Interest
+ *
+ * @return -1 if the pair was seen within the last CCNL_NONCE_LIFETIME seconds
+ * @return 0 otherwise
+ */
+int
+ccnl_nonce_find_or_append(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
+                          struct ccnl_buf_s *nonce);
+
+/**
+ * @brief Returns the number of live entries of the nonce table
+ */
+uint32_t
+ccnl_nonce_count(struct ccnl_relay_s *relay);
+
+/**
+ * @brief Releases the nonce table
+ *
+ * @param[in] relay     The relay
+ */
+void
+ccnl_nonce_cleanup(struct ccnl_relay_s *relay);
+
+#endif // CCNL_NONCE_H
+/** @} */
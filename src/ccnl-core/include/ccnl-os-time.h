@@ -76,18 +76,49 @@ timestamp(void);
 
 // ----------------------------------------------------------------------
 
+/**
+ * @brief Number of timers which are allocated at once for the timer pool,
+ * unused with USE_SLAB_MALLOC where the allocator pools the timers
+ */
+#define CCNL_TIMER_POOL_CHUNK 64
+
+/**
+ * @brief A pending timer
+ *
+ * Timers are kept in a binary min-heap ordered by their timeout, a timer
+ * knows its position in the heap so that it can be removed in O(log n).
+ * Unused timers are kept on the free list of the timer pool.
+ */
 struct ccnl_timer_s {
-    struct ccnl_timer_s *next;
-    struct timeval timeout;
+    struct ccnl_timer_s *next;  /**< next free timer in the pool */
+    uint64_t timeout;           /**< expiry time, see ccnl_time_usec() */
+    int idx;                    /**< position in the timer heap, -1: not queued */
     void (*fct)(char,int);
     void (*fct2)(void*,void*);
     char node;
     int intarg;
     void *aux1;
     void *aux2;
-  //    int handler;
 };
 
+/**
+ * @brief Reads the clock, to be called once per iteration of the event loop
+ *
+ * The time is taken from CLOCK_MONOTONIC where available. Until this is
+ * called for the first time, the time functions read the clock on each
+ * call.
+ */
+void
+ccnl_time_update(void);
+
+/**
+ * @brief Returns the time of the last ccnl_time_update() in microseconds
+ *
+ * The origin of the time is unspecified.
+ */
+uint64_t
+ccnl_time_usec(void);
+
 void
 ccnl_get_timeval(struct timeval *tv);
 
@@ -101,6 +132,29 @@ ccnl_set_timer(uint64_t usec, void (*fct)(void *aux1, void *aux2),
 void
 ccnl_rem_timer(void *h);
 
+/**
+ * @brief Returns the number of pending timers
+ */
+int
+ccnl_timer_count(void);
+
+/**
+ * @brief Removes all pending timers and releases the timer pool
+ */
+void
+ccnl_timer_cleanup(void);
+
+#endif
+
+#if !defined(CCNL_LINUXKERNEL) && !defined(CCNL_RIOT)
+/**
+ * @brief PIT entries, content and faces expire by timers of their own
+ *
+ * Where the relay is driven by the timer heap above, each entry keeps a
+ * timer for its next deadline. RIOT uses its event timers instead, the
+ * Linux kernel module walks all entries once per second in ccnl_do_ageing().
+ */
+#define CCNL_ENTRY_TIMERS
 #endif
 
 #ifdef CCNL_LINUXKERNEL
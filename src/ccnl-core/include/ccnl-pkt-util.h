@@ -46,6 +46,23 @@ ccnl_str2suite(char *cp);
 int
 ccnl_pkt2suite(uint8_t *data, size_t len, size_t *skip);
 
+/**
+ * @brief Finds the end of the packet at the start of a byte stream
+ *
+ * Packets of the TLV suites carry their length in the outermost header
+ * behind the optional switch headers, the NDN TLV or the CCNx fixed
+ * header. Stream faces cut their bytes into packets with it.
+ *
+ * @param[in] data      Start of the packet
+ * @param[in] len       Number of bytes at @p data
+ * @param[out] framelen Length of the packet including its switch headers
+ *                      (may exceed @p len), 0 if @p len bytes do not tell
+ *
+ * @return 0 on success, -1 if the bytes do not start a packet of a TLV suite
+ */
+int
+ccnl_pkt_framelen(uint8_t *data, size_t len, size_t *framelen);
+
 /**
  * Returns the integer representation of a string
  *
@@ -59,11 +76,11 @@ int
 ccnl_cmp2int(unsigned char *cmp, size_t cmplen);
 
 /**
- * Returns the Interest lifetime in seconds
+ * Returns the Interest lifetime in milliseconds
  *
  * @param[in] pkt Pointer to the Interest packet
  *
- * @return        The interest lifetime in seconds
+ * @return        The interest lifetime in milliseconds
  */
 uint64_t
 ccnl_pkt_interest_lifetime(const struct ccnl_pkt_s *pkt);
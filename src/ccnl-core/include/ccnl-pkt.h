@@ -31,6 +31,7 @@
 #include <linux/types.h>
 #endif
 
+#include "ccnl-defs.h"
 #include "ccnl-buf.h"
 #include "ccnl-prefix.h"
 
@@ -48,6 +49,7 @@
 #define CCNL_PKT_FRAGMENT   0x03 // "Fragment"
 #define CCNL_PKT_FRAG_BEGIN 0x04 // see also CCNL_DATA_FRAG_FLAG_FIRST etc
 #define CCNL_PKT_FRAG_END   0x08
+#define CCNL_PKT_BORROWED   0x10 // parsed in place, see ccnl_pkt_own()
 
 /**
  * @brief Options for Interest messages of all TLV formats
@@ -117,9 +119,110 @@ struct ccnl_pkt_s {
     char suite;
 };
 
+/**
+ * @brief Largest nonce, key id or digest a packet parsed in place can hold
+ */
+#define CCNL_PKT_RX_FIELD_SIZE  64
+
+/**
+ * @brief A name parsed and hashed before the packet reached the forwarder
+ *
+ * The pipeline's receive threads parse the name to steer a packet and
+ * pass the result along with it. The forwarding thread's parser then takes
+ * the components and their hashes from here, see ccnl_pkt_rx_name().
+ */
+struct ccnl_pkt_name_s {
+    uint8_t *nameptr;                   /**< where the name starts in the bytes parsed */
+    uint32_t namelen;
+    uint32_t compcnt;
+    uint32_t chunknum;
+    uint32_t haschunknum;               /**< 1 if the name carries a chunk number */
+    struct {
+        uint32_t off;                   /**< offset from nameptr */
+        uint32_t len;
+        uint32_t hash;                  /**< see ccnl_prefix_hash() */
+    } comp[CCNL_MAX_NAME_COMP];         /**< the first compcnt are valid */
+};
+
+/**
+ * @brief Storage for a packet parsed in place
+ *
+ * The packet's name, content and signature point into the receive buffer,
+ * the name's component table and small fields like the nonce live in this
+ * structure. Parsing allocates nothing, hence packets which are answered
+ * from the content store or dropped as duplicates never touch the heap.
+ * ccnl_pkt_own() copies the packet once the relay keeps it.
+ */
+struct ccnl_pkt_rx_s {
+    struct ccnl_pkt_s pkt;              /**< the packet, flagged CCNL_PKT_BORROWED */
+    struct ccnl_prefix_s pfx;           /**< its name */
+    uint8_t *comp[CCNL_MAX_NAME_COMP];
+    size_t complen[CCNL_MAX_NAME_COMP];
+    uint32_t comphash[CCNL_MAX_NAME_COMP];
+    uint32_t chunknum;
+    uint8_t *start;                     /**< the packet's bytes in the receive buffer */
+    size_t len;
+    int fieldcnt;                       /**< fields in use */
+    const struct ccnl_pkt_name_s *name; /**< set by the caller, NULL if no name was parsed before */
+    union {
+        struct ccnl_buf_s buf;
+        uint8_t bytes[sizeof(struct ccnl_buf_s) + CCNL_PKT_RX_FIELD_SIZE];
+    } fields[2];
+};
+
+/**
+ * @brief Prepares @p rx for parsing a packet
+ *
+ * @return the packet of @p rx
+ */
+struct ccnl_pkt_s*
+ccnl_pkt_rx_init(struct ccnl_pkt_rx_s *rx);
+
+/**
+ * @brief Returns the empty name of @p rx
+ */
+struct ccnl_prefix_s*
+ccnl_pkt_rx_prefix(struct ccnl_pkt_rx_s *rx, char suite);
+
+/**
+ * @brief Takes the name @p p starts at from the name parsed before
+ *
+ * Fills the components, their hashes and the chunk number of @p p if
+ * @p rx carries a name parsed before which starts where @p p does.
+ *
+ * @return 1 if the name was taken, 0 if it has to be parsed
+ */
+int
+ccnl_pkt_rx_name(struct ccnl_pkt_rx_s *rx, struct ccnl_prefix_s *p);
+
+/**
+ * @brief Copies a nonce, key id or digest to a buffer of @p rx
+ *
+ * @return the buffer, NULL if @p len exceeds CCNL_PKT_RX_FIELD_SIZE or all
+ *         buffers are in use
+ */
+struct ccnl_buf_s*
+ccnl_pkt_rx_field(struct ccnl_pkt_rx_s *rx, uint8_t *data, size_t len);
+
+/**
+ * @brief Replaces a packet parsed in place by a copy on the heap
+ *
+ * The copy owns a buffer with the packet's bytes, its pointers are rebased
+ * into that buffer. Packets not flagged CCNL_PKT_BORROWED stay as they are.
+ *
+ * @param[in,out] pkt   The packet
+ *
+ * @return 0 on success, -1 if out of memory (@p pkt is left unchanged)
+ */
+int
+ccnl_pkt_own(struct ccnl_pkt_s **pkt);
+
 /**
  * @brief Free a pkt data structure
  *
+ * A packet parsed in place is released with its storage, freeing it is
+ * a no-op.
+ *
  * @param[in] pkt       pkt datastructure to be freed
 */
 void
@@ -45,6 +45,10 @@ struct ccnl_prefix_s {
     ssize_t namelen; /**<  valid length of name memory */
     uint8_t *bytes;   /**< memory for name component copies */
     uint32_t *chunknum;   /**< if defined, number of the chunk else -1 */
+    uint32_t chunkval;    /**< chunk number storage of a compact prefix */
+    uint32_t inlinelen;   /**< bytes allocated behind the structure */
+    uint32_t *comphash;   /**< hashes of the first 1..n components, see ccnl_prefix_hash() */
+    uint32_t hashcnt;     /**< number of valid entries in comphash */
 };
 
 /**
@@ -58,6 +62,35 @@ struct ccnl_prefix_s {
 struct ccnl_prefix_s*
 ccnl_prefix_new(char suite, uint32_t cnt);
 
+/**
+ * @brief Create a CCNL_Prefix datastructure in a single allocation
+ *
+ * The component tables (comp, complen and comphash) are sized to @p cnt
+ * and stored behind the structure,
+ * followed by @p byteslen bytes for component copies (@p bytes, NULL if
+ * @p byteslen is 0). A chunk number is kept in the structure itself.
+ * Prefixes held by PIT and CS entries use this layout.
+ *
+ * @param[in] suite       Packet format for which the Prefix should be created
+ * @param[in] cnt         Number of components which the Prefix should contain
+ * @param[in] byteslen    Number of bytes to reserve for component copies
+ * @param[in] chunknum    Chunk number of the Prefix or NULL
+ *
+ * @return The created Prefix
+*/
+struct ccnl_prefix_s*
+ccnl_prefix_new_compact(char suite, uint32_t cnt, size_t byteslen,
+                        uint32_t *chunknum);
+
+/**
+ * @brief Takes over the component hashes computed for another Prefix
+ *
+ * @param[in,out] dst   Prefix with the same components as @p src
+ * @param[in] src       Prefix whose hashes are copied
+*/
+void
+ccnl_prefix_copy_hashes(struct ccnl_prefix_s *dst, struct ccnl_prefix_s *src);
+
 /**
  * @brief Frees CCNL_Prefix datastructure
  *
@@ -115,6 +148,25 @@ int32_t
 ccnl_prefix_cmp(struct ccnl_prefix_s *pfx, unsigned char *md,
                 struct ccnl_prefix_s *nam, int mode);
 
+/**
+ * @brief Hash value over the suite and the first @p compcnt components of a Prefix
+ *
+ * Two prefixes which are equal under CMP_EXACT have the same hash value,
+ * which makes it usable as key for the hashed relay tables.
+ *
+ * The hash is built component by component. Prefixes with a comphash
+ * table remember each step, so the components are hashed once and later
+ * calls for the full name or any shorter prefix of it (FIB longest
+ * prefix match) are table lookups.
+ *
+ * @param[in] pfx       Prefix to be hashed
+ * @param[in] compcnt   Number of leading components to include, at most pfx->compcnt
+ *
+ * @return      the hash value
+*/
+uint32_t
+ccnl_prefix_hash(struct ccnl_prefix_s *pfx, uint32_t compcnt);
+
 /**
  * @brief checks if a prefixname is a prefix of a content name
  *
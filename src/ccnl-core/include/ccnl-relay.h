@@ -23,9 +23,12 @@
 #ifndef CCNL_RELAY_H
 #define CCNL_RELAY_H
 
+#include "ccnl-cache.h"
 #include "ccnl-defs.h"
 #include "ccnl-face.h"
+#include "ccnl-htable.h"
 #include "ccnl-if.h"
+#include "ccnl-nonce.h"
 #include "ccnl-pkt.h"
 #include "ccnl-sched.h"
 
@@ -33,20 +36,36 @@
 struct ccnl_relay_s {
     void (*ccnl_ll_TX_ptr)(struct ccnl_relay_s*, struct ccnl_if_s*,
         sockunion*, struct ccnl_buf_s*);
+    void (*ccnl_ll_TX_batch_ptr)(struct ccnl_relay_s*, struct ccnl_if_s*); /**< sends an interface's queue, see ccnl_interface_flush() */
+    int rx_batch;               /**< max packets read per system call */
+    int tx_batch;               /**< packets an interface queues before it is flushed, <= 1: send at once */
+    int (*ccnl_RX_steer_ptr)(struct ccnl_relay_s*, int, uint8_t*, size_t,
+        sockunion*);            /**< hands a received packet to another relay (shard), returns 1 if it took it */
+    int (*ccnl_fib_face_ptr)(struct ccnl_relay_s*, struct ccnl_face_s*); /**< checks the face of a FIB entry registered by a management request, returns 0 to refuse it */
+    const struct ccnl_pkt_name_s *rx_name; /**< name of the packet being received, parsed before, see ccnl_pkt_rx_name() */
 #ifndef CCNL_ARDUINO
     time_t startup_time;
 #endif
     int id;
     struct ccnl_face_s *faces;  /**< The existing forwarding faces */
+    struct ccnl_htable_s face_index; /**< The faces, hashed by interface and peer address */
     struct ccnl_forward_s *fib; /**< The Forwarding Information Base (FIB) */
+    struct ccnl_htable_s fib_index; /**< The FIB entries, hashed by their prefix */
+    uint32_t fib_version;       /**< bumped whenever a FIB entry is added, changed or removed */
 
     struct ccnl_interest_s *pit; /**< The Pending Interest Table (PIT) */
+    struct ccnl_htable_s pit_index; /**< The PIT entries, hashed by their name */
     struct ccnl_content_s *contents; /**< contentsend; */
-    struct ccnl_buf_s *nonces;  /**< The nonces that are currently in use */
+    struct ccnl_htable_s cs_index; /**< The contents, hashed by their full name */
+    struct ccnl_nonce_table_s nonces; /**< The recently seen name and nonce pairs */
     int contentcnt;             /**< number of cached items */
     int max_cache_entries;      /**< max number of cached items -1: unlimited */
+    size_t cs_bytes;            /**< bytes held by the cached items, see ccnl_content_size() */
+    size_t max_cache_bytes;     /**< max bytes held by the cached items, 0: unlimited */
     int pitcnt;                 /**< Number of entries in the PIT */
     int max_pit_entries;        /**< max number of pit entries; -1: unlimited */ 
+    uint32_t serve_seq;         /**< number of the current ccnl_content_serve_pending run */
+    struct ccnl_cache_s cache;  /**< state of the content store's replacement policy */
     struct ccnl_if_s ifs[CCNL_MAX_INTERFACES];
     int ifcount;               /**< number of active interfaces */
     char halt_flag;            /**< Flag to interrupt the IO_Loop and to exit the relay */
@@ -82,6 +101,18 @@ void ccnl_interest_broadcast(struct ccnl_relay_s *ccnl,
 
 void ccnl_face_CTS(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f);
 
+/**
+ * @brief Finds the face of a peer on an interface, through the face index
+ *
+ * @param[in] ccnl      The relay
+ * @param[in] ifndx     Index of the interface
+ * @param[in] peer      Address of the peer
+ *
+ * @return the face, NULL if there is none
+ */
+struct ccnl_face_s*
+ccnl_face_lookup(struct ccnl_relay_s *ccnl, int ifndx, sockunion *peer);
+
 struct ccnl_face_s*
 ccnl_get_face_or_create(struct ccnl_relay_s *ccnl, int ifndx,
                         struct sockaddr *sa, size_t addrlen);
@@ -145,6 +176,17 @@ ccnl_interest_propagate(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i);
 struct ccnl_content_s*
 ccnl_content_remove(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c);
 
+/**
+ * @brief Find the content with exactly the name @p pfx in the content store
+ *
+ * @param[in] ccnl  pointer to current ccnl relay
+ * @param[in] pfx   name of the content
+ *
+ * @return   the cached content, NULL if there is none
+*/
+struct ccnl_content_s*
+ccnl_content_find(struct ccnl_relay_s *ccnl, struct ccnl_prefix_s *pfx);
+
 /**
  * @brief add content @p c to the content store
  *
@@ -170,11 +212,20 @@ ccnl_content_add2cache(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c);
 int
 ccnl_content_serve_pending(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c);
 
+#ifdef CCNL_ENTRY_TIMERS
+/**
+ * @brief Arms the timer of a PIT entry for its next retransmission, or for
+ * the end of its lifetime if that comes first
+ *
+ * @param[in] ccnl  The relay
+ * @param[in] i     The PIT entry, i->expires must be set
+ */
+void
+ccnl_interest_set_timer(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i);
+#else
 void
 ccnl_do_ageing(void *ptr, void *dummy);
-
-int
-ccnl_nonce_find_or_append(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *nonce);
+#endif
 
 int
 ccnl_nonce_isDup(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt);
@@ -182,6 +233,43 @@ ccnl_nonce_isDup(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt);
 void
 ccnl_core_cleanup(struct ccnl_relay_s *ccnl);
 
+/**
+ * @brief Link a new entry into the FIB
+ *
+ * The entry's prefix and suite must be set, they are the key of the entry
+ * in the FIB's prefix index and must not change while it is linked.
+ *
+ * @par[in] relay   Local relay struct
+ * @par[in] fwd     The FIB entry
+ *
+ * @return 0    on success
+ * @return -1   on error, the entry is not linked
+ */
+int
+ccnl_forward_add(struct ccnl_relay_s *relay, struct ccnl_forward_s *fwd);
+
+/**
+ * @brief Unlink an entry from the FIB and free it, including its prefix
+ *
+ * @par[in] relay   Local relay struct
+ * @par[in] fwd     The FIB entry
+ *
+ * @return the entry which followed @p fwd in the FIB list
+ */
+struct ccnl_forward_s*
+ccnl_forward_remove(struct ccnl_relay_s *relay, struct ccnl_forward_s *fwd);
+
+/**
+ * @brief Find the FIB entry for exactly the prefix @p pfx
+ *
+ * @par[in] relay   Local relay struct
+ * @par[in] pfx     Prefix of the FIB entry
+ *
+ * @return the FIB entry, NULL if there is none
+ */
+struct ccnl_forward_s*
+ccnl_forward_find(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx);
+
 #ifdef NEEDS_PREFIX_MATCHING
 /**
  * @brief Add entry to the FIB
@@ -231,6 +319,19 @@ ccnl_cs_dump(struct ccnl_relay_s *ccnl);
 void
 ccnl_interface_CTS(void *aux1, void *aux2);
 
+/**
+ * @brief Sends all packets queued at an interface
+ *
+ * With a tx_batch above 1 and a ccnl_ll_TX_batch_ptr, interfaces collect
+ * packets and the platform's event loop flushes them once per round, or
+ * ccnl_interface_enqueue() when tx_batch packets are queued.
+ *
+ * @param[in] ccnl  the relay
+ * @param[in] ifc   the interface to flush
+ */
+void
+ccnl_interface_flush(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc);
+
 #define DBL_LINKED_LIST_ADD(l,e) \
   do { if ((l)) (l)->prev = (e); \
        (e)->next = (l); \
@@ -243,6 +344,23 @@ ccnl_interface_CTS(void *aux1, void *aux2);
        if ((e)->next) (e)->next->prev = (e)->prev; \
   } while(0)
 
+// lists of the entries referring to one face, linked through the members
+// fnext and fpprev so that an entry can be unlinked without the face
+#define FACE_LIST_ADD(l,e) \
+  do { (e)->fnext = (l); \
+       if ((l)) (l)->fpprev = &(e)->fnext; \
+       (e)->fpprev = &(l); \
+       (l) = (e); \
+  } while(0)
+
+#define FACE_LIST_REMOVE(e) \
+  do { if ((e)->fpprev) { \
+           *(e)->fpprev = (e)->fnext; \
+           if ((e)->fnext) (e)->fnext->fpprev = (e)->fpprev; \
+           (e)->fpprev = NULL; \
+       } \
+  } while(0)
+
 #ifdef CCNL_APP_RX
 int ccnl_app_RX(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c);
 #endif
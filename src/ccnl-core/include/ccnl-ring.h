@@ -0,0 +1,128 @@
+/**
+ * @addtogroup CCNL-core
+ * @{
+ *
+ * @file ccnl-ring.h
+ * @brief CCN lite (CCNL), single producer single consumer ring of records
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef CCNL_RING_H
+#define CCNL_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Assumed size of a cache line, the two ends of a ring never share one
+ */
+#define CCNL_CACHE_LINE 64
+
+/**
+ * @brief Lock free ring of variable sized records between two threads
+ *
+ * One thread appends records with @ref ccnl_ring_reserve and
+ * @ref ccnl_ring_commit, the other one takes them in the same order with
+ * @ref ccnl_ring_peek and @ref ccnl_ring_release. A record is copied in
+ * once and read in place, it stays contiguous in the buffer. The consumer
+ * may peek at several records, e.g. to send them with one system call,
+ * before it releases them together.
+ */
+struct ccnl_ring_s {
+    uint8_t *buf;                       /**< the records, @ref size bytes */
+    uint32_t size;                      /**< buffer size, a power of two */
+    uint8_t pad0[CCNL_CACHE_LINE - sizeof(uint8_t*) - sizeof(uint32_t)];
+    // producer side
+    uint32_t head;                      /**< bytes appended so far */
+    uint32_t pushed;                    /**< records appended so far */
+    uint32_t tail_seen;                 /**< the producer's copy of @ref tail */
+    uint32_t skip;                      /**< bytes left unused by the reservation */
+    uint8_t pad1[CCNL_CACHE_LINE - 4 * sizeof(uint32_t)];
+    // consumer side
+    uint32_t tail;                      /**< bytes taken so far */
+    uint32_t popped;                    /**< records taken so far */
+    uint32_t next;                      /**< bytes of the records returned by @ref ccnl_ring_peek */
+    uint32_t peeked;                    /**< records returned by @ref ccnl_ring_peek */
+    uint8_t pad2[CCNL_CACHE_LINE - 4 * sizeof(uint32_t)];
+};
+
+/**
+ * @brief Allocates the buffer of ring @p r
+ *
+ * @param[in] r     The ring
+ * @param[in] size  Buffer size in bytes, rounded up to a power of two
+ *
+ * @return 0 on success
+ * @return -1 if out of memory
+ */
+int
+ccnl_ring_init(struct ccnl_ring_s *r, size_t size);
+
+/**
+ * @brief Releases the buffer of ring @p r, records left are dropped
+ */
+void
+ccnl_ring_free(struct ccnl_ring_s *r);
+
+/**
+ * @brief Reserves space for a record of @p len bytes (producer)
+ *
+ * @return where the record is to be written, NULL if the ring is full or
+ *         @p len exceeds half of it
+ */
+void*
+ccnl_ring_reserve(struct ccnl_ring_s *r, size_t len);
+
+/**
+ * @brief Appends the record written to the last reservation (producer)
+ *
+ * @param[in] r     The ring
+ * @param[in] tag   Type of the record, given back by @ref ccnl_ring_peek,
+ *                  UINT32_MAX is reserved
+ * @param[in] len   Length of the record, at most the reserved length
+ *
+ * @return 1 if the ring was empty before, i.e. the consumer may sleep
+ * @return 0 otherwise
+ */
+int
+ccnl_ring_commit(struct ccnl_ring_s *r, uint32_t tag, size_t len);
+
+/**
+ * @brief Returns the oldest record not peeked at yet (consumer)
+ *
+ * @param[in] r     The ring
+ * @param[out] tag  Type of the record
+ * @param[out] len  Length of the record
+ *
+ * @return the record, NULL if the ring is empty
+ */
+void*
+ccnl_ring_peek(struct ccnl_ring_s *r, uint32_t *tag, size_t *len);
+
+/**
+ * @brief Removes the records returned by @ref ccnl_ring_peek (consumer)
+ */
+void
+ccnl_ring_release(struct ccnl_ring_s *r);
+
+/**
+ * @brief Returns the number of records in the ring, from either side
+ */
+uint32_t
+ccnl_ring_depth(struct ccnl_ring_s *r);
+
+#endif // CCNL_RING_H
+/** @} */
@@ -130,6 +130,19 @@ char* ccnl_addr2ascii(sockunion *su);
 int
 ccnl_addr_cmp(sockunion *s1, sockunion *s2);
 
+/**
+ * @brief Hashes the fields of \ref su which \ref ccnl_addr_cmp compares
+ *
+ * Addresses which compare equal have the same hash value, whatever the
+ * bytes of the socket structure which are not part of the address.
+ *
+ * @param[in] su The socket address
+ *
+ * @return The hash value of \ref su
+ */
+uint32_t
+ccnl_addr_hash(sockunion *su);
+
 char*
 ll2ascii(unsigned char *addr, size_t len);
 
@@ -28,6 +28,7 @@
 #include "ccnl-relay.h"
 #include "ccnl-forward.h"
 #include "ccnl-prefix.h"
+#include "ccnl-htable.h"
 #include "ccnl-malloc.h"
 #else
 #include "../include/ccnl-os-time.h"
@@ -36,6 +37,7 @@
 #include "../include/ccnl-relay.h"
 #include "../include/ccnl-forward.h"
 #include "../include/ccnl-prefix.h"
+#include "../include/ccnl-htable.h"
 #include "../include/ccnl-malloc.h"
 #endif
 
@@ -49,12 +51,43 @@ ccnl_buf_new(void *data, size_t len)
     }
     b->next = NULL;
     b->datalen = len;
+    b->refcnt = 1;
+    b->hash = 0;
     if (data) {
         memcpy(b->data, data, len);
     }
     return b;
 }
 
+struct ccnl_buf_s*
+ccnl_buf_ref(struct ccnl_buf_s *buf)
+{
+    if (buf) {
+        buf->refcnt++;
+    }
+    return buf;
+}
+
+void
+ccnl_buf_free(struct ccnl_buf_s *buf)
+{
+    if (buf && !--buf->refcnt) {
+        ccnl_free(buf);
+    }
+}
+
+uint32_t
+ccnl_buf_hash(struct ccnl_buf_s *buf)
+{
+    if (!buf->hash) {
+        buf->hash = ccnl_hash_bytes(CCNL_HASH_INIT, buf->data, buf->datalen);
+        if (!buf->hash) {
+            buf->hash = 1;
+        }
+    }
+    return buf->hash;
+}
+
 void
 ccnl_core_cleanup(struct ccnl_relay_s *ccnl)
 {
@@ -64,21 +97,19 @@ ccnl_core_cleanup(struct ccnl_relay_s *ccnl)
 
     while (ccnl->pit)
         ccnl_interest_remove(ccnl, ccnl->pit);
+    ccnl_htable_free(&ccnl->pit_index);
     while (ccnl->faces)
         ccnl_face_remove(ccnl, ccnl->faces); // removes allmost all FWD entries
+    ccnl_htable_free(&ccnl->face_index);
     while (ccnl->fib) {
-        struct ccnl_forward_s *fwd = ccnl->fib->next;
-        ccnl_prefix_free(ccnl->fib->prefix);
-        ccnl_free(ccnl->fib);
-        ccnl->fib = fwd;
+        ccnl_forward_remove(ccnl, ccnl->fib);
     }
+    ccnl_htable_free(&ccnl->fib_index);
     while (ccnl->contents)
         ccnl_content_remove(ccnl, ccnl->contents);
-    while (ccnl->nonces) {
-        struct ccnl_buf_s *tmp = ccnl->nonces->next;
-        ccnl_free(ccnl->nonces);
-        ccnl->nonces = tmp;
-    }
+    ccnl_htable_free(&ccnl->cs_index);
+    ccnl_cache_cleanup(ccnl);
+    ccnl_nonce_cleanup(ccnl);
     for (k = 0; k < ccnl->ifcount; k++)
         ccnl_interface_cleanup(ccnl->ifs + k);
 }
@@ -0,0 +1,501 @@
+/*
+ * @f ccnl-cache.c
+ * @b CCN lite (CCNL), replacement policies of the content store
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-17 created
+ */
+
+#ifndef CCNL_LINUXKERNEL
+#include "ccnl-cache.h"
+#include "ccnl-relay.h"
+#include "ccnl-pkt.h"
+#include "ccnl-prefix.h"
+#include "ccnl-malloc.h"
+#include "ccnl-logging.h"
+#include <string.h>
+#else
+#include "../include/ccnl-cache.h"
+#include "../include/ccnl-relay.h"
+#include "../include/ccnl-pkt.h"
+#include "../include/ccnl-prefix.h"
+#include "../include/ccnl-malloc.h"
+#include "../include/ccnl-logging.h"
+#endif
+
+/* Each policy keeps the evictable contents in some of the cache's queues:
+ *
+ *   LRU      queues[0] in order of last access
+ *   LFU      queues[n-1] holds the entries accessed n times, each in LRU order
+ *   ARC      queues[0] (T1) seen once, queues[1] (T2) seen at least twice,
+ *            ghosts[0] (B1) and ghosts[1] (B2) remember their evictions
+ *   S3-FIFO  queues[0] small FIFO, queues[1] main FIFO, ghosts[0] remembers
+ *            the evictions from the small FIFO
+ *
+ * Ghost entries only keep the hash of the content's name, a collision makes
+ * a new content look like a returning one, which is harmless. */
+
+struct ccnl_cache_ops_s {
+    const char *name;
+    void (*insert)(struct ccnl_cache_s *cache, struct ccnl_content_s *c);
+    void (*hit)(struct ccnl_cache_s *cache, struct ccnl_content_s *c);
+    struct ccnl_content_s* (*victim)(struct ccnl_relay_s *relay);
+};
+
+// ----------------------------------------------------------------------
+// queues
+
+static void
+ccnl_cache_push(struct ccnl_cache_s *cache, int q, struct ccnl_content_s *c)
+{
+    struct ccnl_cache_queue_s *queue = &cache->queues[q];
+
+    c->qprev = NULL;
+    c->qnext = queue->head;
+    if (queue->head) {
+        queue->head->qprev = c;
+    } else {
+        queue->tail = c;
+    }
+    queue->head = c;
+    queue->count++;
+    c->queue = q + 1;
+}
+
+static void
+ccnl_cache_unlink(struct ccnl_cache_s *cache, struct ccnl_content_s *c)
+{
+    struct ccnl_cache_queue_s *queue = &cache->queues[c->queue - 1];
+
+    if (c->qprev) {
+        c->qprev->qnext = c->qnext;
+    } else {
+        queue->head = c->qnext;
+    }
+    if (c->qnext) {
+        c->qnext->qprev = c->qprev;
+    } else {
+        queue->tail = c->qprev;
+    }
+    queue->count--;
+    c->qnext = c->qprev = NULL;
+    c->queue = 0;
+}
+
+// dequeue the oldest entry of queue q, static entries are dropped on the way
+static struct ccnl_content_s*
+ccnl_cache_pop(struct ccnl_cache_s *cache, int q)
+{
+    struct ccnl_content_s *c;
+
+    while ((c = cache->queues[q].tail)) {
+        ccnl_cache_unlink(cache, c);
+        if (!(c->flags & CCNL_CONTENT_FLAGS_STATIC)) {
+            return c;
+        }
+    }
+    return NULL;
+}
+
+// number of entries the policy may assume the cache can hold
+static uint32_t
+ccnl_cache_capacity(struct ccnl_relay_s *relay)
+{
+    if (relay->max_cache_entries > 0) {
+        return (uint32_t) relay->max_cache_entries;
+    }
+    return relay->contentcnt > 0 ? (uint32_t) relay->contentcnt : 1;
+}
+
+// ----------------------------------------------------------------------
+// ghosts
+
+static uint32_t
+ccnl_cache_hash(struct ccnl_content_s *c)
+{
+    return ccnl_prefix_hash(c->pkt->pfx, c->pkt->pfx->compcnt);
+}
+
+static void
+ccnl_cache_ghost_remove(struct ccnl_cache_s *cache, struct ccnl_cache_ghost_s *g)
+{
+    struct ccnl_cache_gqueue_s *queue = &cache->ghosts[g->queue];
+
+    if (g->prev) {
+        g->prev->next = g->next;
+    } else {
+        queue->head = g->next;
+    }
+    if (g->next) {
+        g->next->prev = g->prev;
+    } else {
+        queue->tail = g->prev;
+    }
+    queue->count--;
+    ccnl_htable_remove(&cache->ghost_index, &g->hnode);
+    ccnl_free(g);
+}
+
+static void
+ccnl_cache_ghost_add(struct ccnl_cache_s *cache, int q, struct ccnl_content_s *c)
+{
+    struct ccnl_cache_gqueue_s *queue = &cache->ghosts[q];
+    struct ccnl_cache_ghost_s *g;
+
+    g = (struct ccnl_cache_ghost_s*) ccnl_calloc(1, sizeof(*g));
+    if (!g) {
+        return;
+    }
+    if (ccnl_htable_insert(&cache->ghost_index, &g->hnode, ccnl_cache_hash(c))) {
+        ccnl_free(g);
+        return;
+    }
+    g->queue = q;
+    g->next = queue->head;
+    if (queue->head) {
+        queue->head->prev = g;
+    } else {
+        queue->tail = g;
+    }
+    queue->head = g;
+    queue->count++;
+}
+
+static void
+ccnl_cache_ghost_trim(struct ccnl_cache_s *cache, int q, uint32_t max)
+{
+    while (cache->ghosts[q].count > max) {
+        ccnl_cache_ghost_remove(cache, cache->ghosts[q].tail);
+    }
+}
+
+static struct ccnl_cache_ghost_s*
+ccnl_cache_ghost_find(struct ccnl_cache_s *cache, uint32_t hash)
+{
+    struct ccnl_hnode_s *n = ccnl_htable_lookup(&cache->ghost_index, hash);
+
+    return n ? CCNL_HTABLE_ENTRY(n, struct ccnl_cache_ghost_s, hnode) : NULL;
+}
+
+// ----------------------------------------------------------------------
+// LRU
+
+static void
+ccnl_cache_lru_insert(struct ccnl_cache_s *cache, struct ccnl_content_s *c)
+{
+    ccnl_cache_push(cache, 0, c);
+}
+
+static void
+ccnl_cache_lru_hit(struct ccnl_cache_s *cache, struct ccnl_content_s *c)
+{
+    ccnl_cache_unlink(cache, c);
+    ccnl_cache_push(cache, 0, c);
+}
+
+static struct ccnl_content_s*
+ccnl_cache_lru_victim(struct ccnl_relay_s *relay)
+{
+    return ccnl_cache_pop(&relay->cache, 0);
+}
+
+// ----------------------------------------------------------------------
+// LFU
+
+static void
+ccnl_cache_lfu_insert(struct ccnl_cache_s *cache, struct ccnl_content_s *c)
+{
+    c->freq = 1;
+    ccnl_cache_push(cache, 0, c);
+}
+
+static void
+ccnl_cache_lfu_hit(struct ccnl_cache_s *cache, struct ccnl_content_s *c)
+{
+    ccnl_cache_unlink(cache, c);
+    if (c->freq < CCNL_CACHE_QUEUES) {
+        c->freq++;
+    }
+    ccnl_cache_push(cache, c->freq - 1, c);
+}
+
+static struct ccnl_content_s*
+ccnl_cache_lfu_victim(struct ccnl_relay_s *relay)
+{
+    struct ccnl_content_s *c;
+    int q;
+
+    for (q = 0; q < CCNL_CACHE_QUEUES; q++) {
+        if ((c = ccnl_cache_pop(&relay->cache, q))) {
+            return c;
+        }
+    }
+    return NULL;
+}
+
+// ----------------------------------------------------------------------
+// ARC, see Megiddo and Modha, "ARC: A Self-Tuning, Low Overhead
+// Replacement Cache", FAST 2003
+
+static void
+ccnl_cache_arc_insert(struct ccnl_cache_s *cache, struct ccnl_content_s *c)
+{
+    // a returning name goes to the frequency side right away
+    ccnl_cache_push(cache, cache->ghost_hit ? 1 : 0, c);
+}
+
+static void
+ccnl_cache_arc_hit(struct ccnl_cache_s *cache, struct ccnl_content_s *c)
+{
+    ccnl_cache_unlink(cache, c);
+    ccnl_cache_push(cache, 1, c);
+}
+
+static struct ccnl_content_s*
+ccnl_cache_arc_victim(struct ccnl_relay_s *relay)
+{
+    struct ccnl_cache_s *cache = &relay->cache;
+    struct ccnl_content_s *c = NULL;
+    uint32_t t1 = cache->queues[0].count, cap = ccnl_cache_capacity(relay);
+    int q = 1;
+
+    // REPLACE
+    if (t1 > 0 && (t1 > cache->arc_p ||
+                   (cache->ghost_hit == 2 && t1 == cache->arc_p))) {
+        q = 0;
+    }
+    if (!(c = ccnl_cache_pop(cache, q))) {
+        q = !q;
+        if (!(c = ccnl_cache_pop(cache, q))) {
+            return NULL;
+        }
+    }
+
+    // T1 evictions are remembered in B1, T2 evictions in B2,
+    // keeping |T1| + |B1| <= c and |B1| + |B2| <= c
+    ccnl_cache_ghost_add(cache, q, c);
+    t1 = cache->queues[0].count;
+    ccnl_cache_ghost_trim(cache, 0, cap > t1 ? cap - t1 : 0);
+    ccnl_cache_ghost_trim(cache, 1, cap > cache->ghosts[0].count ?
+                                    cap - cache->ghosts[0].count : 0);
+    return c;
+}
+
+// ----------------------------------------------------------------------
+// S3-FIFO, see Yang et al., "FIFO queues are all you need for cache
+// eviction", SOSP 2023
+
+static void
+ccnl_cache_s3fifo_insert(struct ccnl_cache_s *cache, struct ccnl_content_s *c)
+{
+    c->freq = 0;
+    ccnl_cache_push(cache, cache->ghost_hit ? 1 : 0, c);
+}
+
+static void
+ccnl_cache_s3fifo_hit(struct ccnl_cache_s *cache, struct ccnl_content_s *c)
+{
+    (void) cache;
+    if (c->freq < CCNL_CACHE_S3FIFO_MAXFREQ) {
+        c->freq++;
+    }
+}
+
+static struct ccnl_content_s*
+ccnl_cache_s3fifo_victim(struct ccnl_relay_s *relay)
+{
+    struct ccnl_cache_s *cache = &relay->cache;
+    struct ccnl_content_s *c;
+    uint32_t cap = ccnl_cache_capacity(relay);
+    uint32_t small = cap / 10 > 0 ? cap / 10 : 1;
+
+    // evict from the small queue while it exceeds its 10% share, entries
+    // which were accessed in there are promoted to the main queue
+    while (cache->queues[0].count >= small || !cache->queues[1].count) {
+        if (!(c = ccnl_cache_pop(cache, 0))) {
+            break;
+        }
+        if (c->freq > 0) {
+            c->freq = 0;
+            ccnl_cache_push(cache, 1, c);
+            continue;
+        }
+        ccnl_cache_ghost_add(cache, 0, c);
+        ccnl_cache_ghost_trim(cache, 0, cap - small);
+        return c;
+    }
+
+    // the main queue is a FIFO with reinsertion (CLOCK)
+    while ((c = ccnl_cache_pop(cache, 1))) {
+        if (c->freq > 0) {
+            c->freq--;
+            ccnl_cache_push(cache, 1, c);
+            continue;
+        }
+        return c;
+    }
+    return NULL;
+}
+
+// ----------------------------------------------------------------------
+
+static const struct ccnl_cache_ops_s ccnl_cache_ops[CCNL_CACHE_LAST] = {
+    [CCNL_CACHE_LRU] = {"lru", ccnl_cache_lru_insert,
+                        ccnl_cache_lru_hit, ccnl_cache_lru_victim},
+    [CCNL_CACHE_LFU] = {"lfu", ccnl_cache_lfu_insert,
+                        ccnl_cache_lfu_hit, ccnl_cache_lfu_victim},
+    [CCNL_CACHE_ARC] = {"arc", ccnl_cache_arc_insert,
+                        ccnl_cache_arc_hit, ccnl_cache_arc_victim},
+    [CCNL_CACHE_S3FIFO] = {"s3fifo", ccnl_cache_s3fifo_insert,
+                           ccnl_cache_s3fifo_hit, ccnl_cache_s3fifo_victim},
+};
+
+int
+ccnl_cache_str2policy(const char *str)
+{
+    int policy;
+
+    for (policy = 0; policy < CCNL_CACHE_LAST; policy++) {
+        if (!strcmp(str, ccnl_cache_ops[policy].name)) {
+            return policy;
+        }
+    }
+    return -1;
+}
+
+const char*
+ccnl_cache_policy2str(int policy)
+{
+    if (policy < 0 || policy >= CCNL_CACHE_LAST) {
+        return "?";
+    }
+    return ccnl_cache_ops[policy].name;
+}
+
+int
+ccnl_cache_set_policy(struct ccnl_relay_s *relay, int policy)
+{
+    struct ccnl_content_s *c;
+
+    if (policy < 0 || policy >= CCNL_CACHE_LAST) {
+        return -1;
+    }
+    for (c = relay->contents; c; c = c->next) {
+        ccnl_cache_remove(relay, c);
+    }
+    ccnl_cache_cleanup(relay);
+    relay->cache.policy = policy;
+    relay->cache.arc_p = 0;
+    // oldest first, so that the queues keep the order of the content store
+    for (c = relay->contents; c && c->next; c = c->next);
+    for (; c; c = c->prev) {
+        ccnl_cache_insert(relay, c);
+    }
+    return 0;
+}
+
+void
+ccnl_cache_admit(struct ccnl_relay_s *relay, struct ccnl_content_s *c)
+{
+    struct ccnl_cache_s *cache = &relay->cache;
+    struct ccnl_cache_ghost_s *g;
+    uint32_t b1, b2, delta;
+
+    cache->ghost_hit = 0;
+    if (!cache->ghost_index.count) {
+        return;
+    }
+    g = ccnl_cache_ghost_find(cache, ccnl_cache_hash(c));
+    if (!g) {
+        return;
+    }
+    cache->ghost_hit = g->queue + 1;
+
+    if (cache->policy == CCNL_CACHE_ARC) {
+        // adapt the target size of T1 towards the queue which had the hit
+        b1 = cache->ghosts[0].count;
+        b2 = cache->ghosts[1].count;
+        if (g->queue == 0) {
+            delta = b2 > b1 ? b2 / b1 : 1;
+            cache->arc_p += delta;
+            if (cache->arc_p > ccnl_cache_capacity(relay)) {
+                cache->arc_p = ccnl_cache_capacity(relay);
+            }
+        } else {
+            delta = b1 > b2 ? b1 / b2 : 1;
+            cache->arc_p = cache->arc_p > delta ? cache->arc_p - delta : 0;
+        }
+    }
+    ccnl_cache_ghost_remove(cache, g);
+}
+
+void
+ccnl_cache_insert(struct ccnl_relay_s *relay, struct ccnl_content_s *c)
+{
+    if (!(c->flags & CCNL_CONTENT_FLAGS_STATIC)) {
+        c->freq = 0;
+        ccnl_cache_ops[relay->cache.policy].insert(&relay->cache, c);
+    }
+    relay->cache.ghost_hit = 0;
+}
+
+void
+ccnl_cache_hit(struct ccnl_relay_s *relay, struct ccnl_content_s *c)
+{
+    relay->cache.hits++;
+    if (c->queue) {
+        ccnl_cache_ops[relay->cache.policy].hit(&relay->cache, c);
+    }
+}
+
+void
+ccnl_cache_remove(struct ccnl_relay_s *relay, struct ccnl_content_s *c)
+{
+    if (c->queue) {
+        ccnl_cache_unlink(&relay->cache, c);
+    }
+}
+
+int
+ccnl_cache_evict(struct ccnl_relay_s *relay)
+{
+    struct ccnl_content_s *c;
+
+    c = ccnl_cache_ops[relay->cache.policy].victim(relay);
+    if (!c) {
+        return -1;
+    }
+    DEBUGMSG_CORE(DEBUG, " %s: remove old entry from cache\n",
+                  ccnl_cache_ops[relay->cache.policy].name);
+    relay->cache.evictions++;
+    ccnl_content_remove(relay, c);
+    return 0;
+}
+
+void
+ccnl_cache_cleanup(struct ccnl_relay_s *relay)
+{
+    struct ccnl_cache_s *cache = &relay->cache;
+    int q;
+
+    for (q = 0; q < 2; q++) {
+        while (cache->ghosts[q].head) {
+            ccnl_cache_ghost_remove(cache, cache->ghosts[q].head);
+        }
+    }
+    ccnl_htable_free(&cache->ghost_index);
+}
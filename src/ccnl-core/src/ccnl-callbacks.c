@@ -47,10 +47,19 @@ ccnl_set_cb_tx_on_data(ccnl_cb_on_data func)
 int
 ccnl_callback_rx_on_data(struct ccnl_relay_s *relay,
                          struct ccnl_face_s *from,
-                         struct ccnl_pkt_s *pkt)
+                         struct ccnl_pkt_s **pkt)
 {
+    int rc;
+
     if (_cb_rx_on_data) {
-        return _cb_rx_on_data(relay, from, pkt);
+        if (ccnl_pkt_own(pkt)) {
+            return 0;
+        }
+        rc = _cb_rx_on_data(relay, from, *pkt);
+        if (rc) {
+            *pkt = NULL;
+        }
+        return rc;
     }
 
     return 0;
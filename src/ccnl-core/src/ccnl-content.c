@@ -41,7 +41,7 @@
 struct ccnl_content_s*
 ccnl_content_new(struct ccnl_pkt_s **pkt)
 {
-    if (!pkt) {
+    if (!pkt || ccnl_pkt_own(pkt)) {
         return NULL;
     }
 
@@ -54,7 +54,7 @@ ccnl_content_new(struct ccnl_pkt_s **pkt)
              (void*) *pkt, ccnl_prefix_to_str((*pkt)->pfx, s, CCNL_MAX_PREFIX_SIZE),
              ((*pkt)->pfx->chunknum) ? (long unsigned) *((*pkt)->pfx->chunknum) : (long unsigned) 0);
 
-    c = (struct ccnl_content_s *) ccnl_calloc(1, sizeof(struct ccnl_content_s));
+    c = (struct ccnl_content_s *) ccnl_obj_calloc(CCNL_MEM_CONTENT, sizeof(struct ccnl_content_s));
     if (!c)
         return NULL;
     c->pkt = *pkt;
@@ -80,3 +80,35 @@ ccnl_content_free(struct ccnl_content_s *content)
 
     return -1;
 }
+
+size_t
+ccnl_content_size(struct ccnl_content_s *content)
+{
+    struct ccnl_prefix_s *pfx;
+    size_t size = sizeof(struct ccnl_content_s);
+    uint32_t i;
+
+    if (!content || !content->pkt) {
+        return size;
+    }
+    size += sizeof(struct ccnl_pkt_s);
+    if (content->pkt->buf) {
+        size += sizeof(struct ccnl_buf_s) + content->pkt->buf->datalen;
+    }
+    pfx = content->pkt->pfx;
+    if (pfx) {
+        size += sizeof(struct ccnl_prefix_s);
+        size += pfx->compcnt * (sizeof(*pfx->comp) + sizeof(*pfx->complen) +
+                                sizeof(*pfx->comphash));
+        if (pfx->bytes) {
+            // components which were copied out of the packet
+            for (i = 0; i < pfx->compcnt; i++) {
+                size += pfx->complen[i];
+            }
+        }
+        if (pfx->chunknum && pfx->chunknum != &pfx->chunkval) {
+            size += sizeof(*pfx->chunknum);
+        }
+    }
+    return size;
+}
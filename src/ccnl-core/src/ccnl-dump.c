@@ -125,7 +125,8 @@ ccnl_dump(int lev, int typ, void *p)
             }
             if (top->contents) {
                 INDENT(lev);
-                CONSOLE("contents:\n");
+                CONSOLE("contents: %d entries, %zu bytes\n",
+                        top->contentcnt, top->cs_bytes);
                 ccnl_dump(lev + 1, CCNL_CONTENT, top->contents);
             }
             break;
@@ -165,9 +166,12 @@ ccnl_dump(int lev, int typ, void *p)
                     ccnl_dump(lev + 2, CCNL_FRAG, fac->frag);
                 CONSOLE("\n");
                 if (fac->outq) {
+                    struct ccnl_outq_s *q;
                     INDENT(lev + 1);
                     CONSOLE("outq:\n");
-                    ccnl_dump(lev + 2, CCNL_BUF, fac->outq);
+                    for (q = fac->outq; q; q = q->next) {
+                        ccnl_dump(lev + 2, CCNL_BUF, q->buf);
+                    }
                 }
                 fac = fac->next;
             }
@@ -0,0 +1,146 @@
+/*
+ * @f ccnl-htable.c
+ * @b CCN lite (CCNL), intrusive hash table used to index the relay tables
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-17 created
+ */
+
+#ifndef CCNL_LINUXKERNEL
+#include "ccnl-htable.h"
+#include "ccnl-malloc.h"
+#include "ccnl-logging.h"
+#else
+#include "../include/ccnl-htable.h"
+#include "../include/ccnl-malloc.h"
+#include "../include/ccnl-logging.h"
+#endif
+
+// move all nodes into a bucket array of the given size (a power of two)
+static int
+ccnl_htable_resize(struct ccnl_htable_s *t, uint32_t size)
+{
+    struct ccnl_hnode_s **buckets, *n, *next;
+    uint32_t i;
+
+    buckets = (struct ccnl_hnode_s**) ccnl_calloc(size, sizeof(*buckets));
+    if (!buckets) {
+        DEBUGMSG(WARNING, "htable: could not grow to %lu buckets\n",
+                 (unsigned long) size);
+        return -1;
+    }
+    for (i = 0; i < t->size; i++) {
+        for (n = t->buckets[i]; n; n = next) {
+            next = n->next;
+            n->next = buckets[n->hash & (size - 1)];
+            buckets[n->hash & (size - 1)] = n;
+        }
+    }
+    ccnl_free(t->buckets);
+    t->buckets = buckets;
+    t->size = size;
+    return 0;
+}
+
+int
+ccnl_htable_insert(struct ccnl_htable_s *t, struct ccnl_hnode_s *n,
+                   uint32_t hash)
+{
+    struct ccnl_hnode_s **b;
+
+    if (!t->size) {
+        if (ccnl_htable_resize(t, CCNL_HTABLE_MIN_SIZE)) {
+            return -1;
+        }
+    } else if (t->count >= t->size && t->size < (1UL << 31)) {
+        // a failed resize only leads to longer chains
+        ccnl_htable_resize(t, t->size << 1);
+    }
+
+    b = &t->buckets[hash & (t->size - 1)];
+    n->hash = hash;
+    n->next = *b;
+    *b = n;
+    t->count++;
+    return 0;
+}
+
+void
+ccnl_htable_remove(struct ccnl_htable_s *t, struct ccnl_hnode_s *n)
+{
+    struct ccnl_hnode_s **pp;
+
+    if (!t->size) {
+        return;
+    }
+    for (pp = &t->buckets[n->hash & (t->size - 1)]; *pp; pp = &(*pp)->next) {
+        if (*pp == n) {
+            *pp = n->next;
+            n->next = NULL;
+            t->count--;
+            return;
+        }
+    }
+}
+
+struct ccnl_hnode_s*
+ccnl_htable_lookup(struct ccnl_htable_s *t, uint32_t hash)
+{
+    struct ccnl_hnode_s *n;
+
+    if (!t->size) {
+        return NULL;
+    }
+    for (n = t->buckets[hash & (t->size - 1)]; n; n = n->next) {
+        if (n->hash == hash) {
+            return n;
+        }
+    }
+    return NULL;
+}
+
+struct ccnl_hnode_s*
+ccnl_htable_next(struct ccnl_hnode_s *n)
+{
+    uint32_t hash = n->hash;
+
+    for (n = n->next; n; n = n->next) {
+        if (n->hash == hash) {
+            return n;
+        }
+    }
+    return NULL;
+}
+
+void
+ccnl_htable_free(struct ccnl_htable_s *t)
+{
+    ccnl_free(t->buckets);
+    t->buckets = NULL;
+    t->size = 0;
+    t->count = 0;
+}
+
+uint32_t
+ccnl_hash_bytes(uint32_t h, const uint8_t *data, size_t len)
+{
+    while (len--) {
+        h ^= *data++;
+        h *= 16777619u;
+    }
+    return h;
+}
@@ -83,48 +83,45 @@ ccnl_http_cleanup(struct ccnl_http_s *http)
 
 
 int
-ccnl_http_anteselect(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
-                     fd_set *readfs, fd_set *writefs, int *maxfd)
+ccnl_http_interest(struct ccnl_http_s *http, int *fd, int *rd, int *wr)
 {
-    (void) ccnl;
     if (!http)
         return -1;
     if (!http->client) {
-        FD_SET(http->server, readfs);
-        if (*maxfd <= http->server)
-            *maxfd = http->server + 1;
+        *fd = http->server;
+        *rd = 1;
+        *wr = 0;
     } else {
-        if ((unsigned long)http->inlen < sizeof(http->in))
-            FD_SET(http->client, readfs);
-        if (http->outlen > 0)
-            FD_SET(http->client, writefs);
-        if (*maxfd <= http->client)
-            *maxfd = http->client + 1;
+        *fd = http->client;
+        *rd = (unsigned long)http->inlen < sizeof(http->in);
+        *wr = http->outlen > 0;
     }
     return 0;
 }
 
-
 int
-ccnl_http_postselect(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
-                     fd_set *readfs, fd_set *writefs)
+ccnl_http_io(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
+             int rd, int wr)
 {
     if (!http)
         return -1;
     // accept only one client at the time:
-    if (!http->client && FD_ISSET(http->server, readfs)) {
-        struct sockaddr_in peer;
-        socklen_t len = sizeof(peer);
-        http->client = accept(http->server, (struct sockaddr*) &peer, &len);
-        if (http->client < 0)
-            http->client = 0;
-        else {
-            DEBUGMSG(INFO, "accepted web server client %s\n",
-                     ccnl_addr2ascii((sockunion*)&peer));
-            http->inlen = http->outlen = http->inoffs = http->outoffs = 0;
+    if (!http->client) {
+        if (rd) {
+            struct sockaddr_in peer;
+            socklen_t len = sizeof(peer);
+            http->client = accept(http->server, (struct sockaddr*) &peer, &len);
+            if (http->client < 0)
+                http->client = 0;
+            else {
+                DEBUGMSG(INFO, "accepted web server client %s\n",
+                         ccnl_addr2ascii((sockunion*)&peer));
+                http->inlen = http->outlen = http->inoffs = http->outoffs = 0;
+            }
         }
+        return 0;
     }
-    if (http->client && FD_ISSET(http->client, readfs)) {
+    if (rd) {
         int len = sizeof(http->in) - http->inlen - 1;
         len = recv(http->client, http->in + http->inlen, len, 0);
         if (len == 0) {
@@ -136,7 +133,7 @@ ccnl_http_postselect(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
             ccnl_http_status(ccnl, http);
         }
     }
-    if (http->client && FD_ISSET(http->client, writefs) && http->out) {
+    if (http->client && wr && http->out) {
         int len = send(http->client, http->out + http->outoffs,
                        http->outlen, 0);
         if (len > 0) {
@@ -151,6 +148,36 @@ ccnl_http_postselect(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
     return 0;
 }
 
+int
+ccnl_http_anteselect(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
+                     fd_set *readfs, fd_set *writefs, int *maxfd)
+{
+    int fd, rd, wr;
+    (void) ccnl;
+
+    if (ccnl_http_interest(http, &fd, &rd, &wr))
+        return -1;
+    if (rd)
+        FD_SET(fd, readfs);
+    if (wr)
+        FD_SET(fd, writefs);
+    if (*maxfd <= fd)
+        *maxfd = fd + 1;
+    return 0;
+}
+
+int
+ccnl_http_postselect(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
+                     fd_set *readfs, fd_set *writefs)
+{
+    int fd, rd, wr;
+
+    if (ccnl_http_interest(http, &fd, &rd, &wr))
+        return -1;
+    return ccnl_http_io(ccnl, http, rd && FD_ISSET(fd, readfs),
+                        wr && FD_ISSET(fd, writefs));
+}
+
 int
 ccnl_cmpfaceid(const void *a, const void *b)
 {
@@ -207,7 +234,7 @@ ccnl_http_status(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http)
     struct ccnl_face_s *f;
     struct ccnl_forward_s *fwd;
     struct ccnl_interest_s *ipt;
-    struct ccnl_buf_s *bpt;
+    struct ccnl_outq_s *bpt;
     char s[CCNL_MAX_PREFIX_SIZE];
 
     strcpy(txt, hdr);
@@ -293,11 +320,12 @@ ccnl_http_status(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http)
         len += snprintf(txt+len, sizeof(txt) - len, "<li><strong>i%d</strong>&nbsp;&nbsp;"
                        "addr=<font face=courier>%s</font>&nbsp;&nbsp;"
                        "qlen=%zu/%d"
-                       "&nbsp;&nbsp;rx=%u&nbsp;&nbsp;tx=%u"
+                       "&nbsp;&nbsp;rx=%u/%u&nbsp;&nbsp;tx=%u/%u"
                        "\n",
                        i, ccnl_addr2ascii(&ccnl->ifs[i].addr),
                        ccnl->ifs[i].qlen, CCNL_MAX_IF_QLEN,
-                       ccnl->ifs[i].rx_cnt, ccnl->ifs[i].tx_cnt);
+                       ccnl->ifs[i].rx_cnt, ccnl->ifs[i].rx_batches,
+                       ccnl->ifs[i].tx_cnt, ccnl->ifs[i].tx_batches);
 #else
         len += snprintf(txt+len, sizeof(txt) - len, "<li><strong>i%d</strong>&nbsp;&nbsp;"
                        "addr=<font face=courier>%s</font>&nbsp;&nbsp;"
@@ -311,12 +339,29 @@ ccnl_http_status(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http)
 
     len += snprintf(txt+len, sizeof(txt) - len, "\n<p><table borders=0 width=100%% bgcolor=#e0e0ff>"
                    "<tr><td><em>Misc stats</em></table><ul>\n");
-    for (cnt = 0, bpt = ccnl->nonces; bpt; bpt = bpt->next, cnt++);
-    len += snprintf(txt+len, sizeof(txt) - len, "<li>Nonces: %d\n", cnt);
+    len += snprintf(txt+len, sizeof(txt) - len, "<li>Nonces: %lu\n",
+                   (unsigned long) ccnl_nonce_count(ccnl));
     for (cnt = 0, ipt = ccnl->pit; ipt; ipt = ipt->next, cnt++);
     len += snprintf(txt+len, sizeof(txt) - len, "<li>Pending interests: %d\n", cnt);
     len += snprintf(txt+len, sizeof(txt) - len, "<li>Content chunks: %d (max=%d)\n",
                    ccnl->contentcnt, ccnl->max_cache_entries);
+    len += snprintf(txt+len, sizeof(txt) - len, "<li>Content bytes: %zu (max=%zu)\n",
+                   ccnl->cs_bytes, ccnl->max_cache_bytes);
+    len += snprintf(txt+len, sizeof(txt) - len, "<li>Cache policy: %s, "
+                   "%lu hits, %lu misses, %lu evictions\n",
+                   ccnl_cache_policy2str(ccnl->cache.policy), ccnl->cache.hits,
+                   ccnl->cache.misses, ccnl->cache.evictions);
+#ifdef USE_SLAB_MALLOC
+    for (i = 0; i < CCNL_MEM_TYPES; i++) {
+        struct ccnl_mem_stats_s ms;
+
+        ccnl_mem_stats(i, &ms);
+        len += snprintf(txt+len, sizeof(txt) - len, "<li>Memory %s: %zu objects, "
+                       "%zu bytes\n", ccnl_mem_type2str(i), ms.objects, ms.bytes);
+    }
+    len += snprintf(txt+len, sizeof(txt) - len, "<li>Memory reserved: %zu bytes\n",
+                   ccnl_mem_reserved());
+#endif
     len += snprintf(txt+len, sizeof(txt) - len, "</ul>\n");
 
     len += snprintf(txt+len, sizeof(txt) - len, "\n<p><table borders=0 width=100%% bgcolor=#e0e0ff>"
@@ -43,6 +43,20 @@
 #include "ccn-lite-riot.h"
 #endif
 
+/* Key of an interest in the PIT's name index. A trailing component with the
+ * size of a SHA256 digest is left out, so that interests for an implicit
+ * digest are found when enumerating the prefixes of the Data name. */
+static uint32_t
+ccnl_interest_hash(struct ccnl_prefix_s *pfx)
+{
+    uint32_t cnt = pfx->compcnt;
+
+    if (cnt > 0 && pfx->complen[cnt - 1] == 32) { // SHA256_DIGEST_LEN
+        cnt--;
+    }
+    return ccnl_prefix_hash(pfx, cnt);
+}
+
 struct ccnl_interest_s*
 ccnl_interest_new(struct ccnl_relay_s *ccnl, struct ccnl_face_s *from,
                   struct ccnl_pkt_s **pkt)
@@ -50,7 +64,11 @@ ccnl_interest_new(struct ccnl_relay_s *ccnl, struct ccnl_face_s *from,
     char s[CCNL_MAX_PREFIX_SIZE];
     (void) s;
 
-    struct ccnl_interest_s *i = (struct ccnl_interest_s *) ccnl_calloc(1,
+    if (ccnl_pkt_own(pkt)) {
+        return NULL;
+    }
+
+    struct ccnl_interest_s *i = (struct ccnl_interest_s *) ccnl_obj_calloc(CCNL_MEM_INTEREST,
                                             sizeof(struct ccnl_interest_s));
     DEBUGMSG_CORE(TRACE,
                   "ccnl_new_interest(prefix=%s, suite=%s)\n",
@@ -60,23 +78,35 @@ ccnl_interest_new(struct ccnl_relay_s *ccnl, struct ccnl_face_s *from,
     if (!i)
         return NULL;
     i->pkt = *pkt;
-    /* currently, the aging function relies on seconds rather than on milli seconds */
     i->lifetime = ccnl_pkt_interest_lifetime(*pkt);
 
     *pkt = NULL;
     i->from = from;
     i->last_used = CCNL_NOW();
 
-    if (ccnl->pitcnt >= ccnl->max_pit_entries) {
+    if (ccnl->max_pit_entries >= 0 && ccnl->pitcnt >= ccnl->max_pit_entries) {
         ccnl_pkt_free(i->pkt);
         ccnl_free(i);
         return NULL;
     }
 
+    if (ccnl_htable_insert(&ccnl->pit_index, &i->hnode,
+                           ccnl_interest_hash(i->pkt->pfx))) {
+        ccnl_pkt_free(i->pkt);
+        ccnl_free(i);
+        return NULL;
+    }
     DBL_LINKED_LIST_ADD(ccnl->pit, i);
+    if (from) {
+        FACE_LIST_ADD(from->pit, i);
+    }
 
     ccnl->pitcnt++;
 
+#ifdef CCNL_ENTRY_TIMERS
+    i->expires = ccnl_time_usec() + (uint64_t) i->lifetime * 1000;
+    ccnl_interest_set_timer(ccnl, i);
+#endif
 #ifdef CCNL_RIOT
     ccnl_evtimer_reset_interest_retrans(i);
     ccnl_evtimer_reset_interest_timeout(i);
@@ -85,6 +115,22 @@ ccnl_interest_new(struct ccnl_relay_s *ccnl, struct ccnl_face_s *from,
     return i;
 }
 
+struct ccnl_interest_s*
+ccnl_interest_find(struct ccnl_relay_s *ccnl, struct ccnl_pkt_s *pkt)
+{
+    struct ccnl_hnode_s *n;
+    struct ccnl_interest_s *i;
+
+    for (n = ccnl_htable_lookup(&ccnl->pit_index, ccnl_interest_hash(pkt->pfx));
+         n; n = ccnl_htable_next(n)) {
+        i = CCNL_HTABLE_ENTRY(n, struct ccnl_interest_s, hnode);
+        if (ccnl_interest_isSame(i, pkt) == 1) {
+            return i;
+        }
+    }
+    return NULL;
+}
+
 int
 ccnl_interest_isSame(struct ccnl_interest_s *i, struct ccnl_pkt_s *pkt)
 {
@@ -141,7 +187,7 @@ ccnl_interest_append_pending(struct ccnl_interest_s *i,  struct ccnl_face_s *fro
                     }
                     last = pi;
             }
-            pi = (struct ccnl_pendint_s *) ccnl_calloc(1,sizeof(struct ccnl_pendint_s));
+            pi = (struct ccnl_pendint_s *) ccnl_obj_calloc(CCNL_MEM_PENDINT, sizeof(struct ccnl_pendint_s));
             if (!pi) {
                     DEBUGMSG_CORE(DEBUG, "  no mem\n");
                     return -1;
@@ -151,6 +197,8 @@ ccnl_interest_append_pending(struct ccnl_interest_s *i,  struct ccnl_face_s *fro
                             (void *) pi, ccnl_prefix_to_str(i->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE),
                             (void *) i->pkt->pfx);
             pi->face = from;
+            pi->interest = i;
+            FACE_LIST_ADD(from->pendints, pi);
             pi->last_used = CCNL_NOW();
             if (last)
                     last->next = pi;
@@ -190,6 +238,7 @@ ccnl_interest_remove_pending(struct ccnl_interest_s *interest, struct ccnl_face_
                         ccnl_prefix_to_str(interest->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE)); 
                     
                     result++; 
+                    FACE_LIST_REMOVE(pend);
                     if (prev) { 
                         prev->next = pend->next;
                         ccnl_free(pend);
@@ -19,6 +19,10 @@
  * File history:
  * 2017-06-16 created
  */
+#if defined(USE_SLAB_HUGEPAGES) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE // MAP_ANONYMOUS, MAP_HUGETLB
+#endif
+#include "ccnl-defs.h"
 #include "ccnl-malloc.h"
 #include "ccnl-logging.h"
 #include "ccnl-overflow.h"
@@ -168,6 +172,12 @@ debug_realloc(void *p, size_t s, const char *fn, int lno)
         if (!h) {
             return NULL;
         }
+        // debug_free() releases a set timestamp
+#ifdef CCNL_ARDUINO
+        h->tstamp = 0;
+#else
+        h->tstamp = NULL;
+#endif
     }
 
     h->fname = (char *) fn;
@@ -235,3 +245,358 @@ debug_free(void *p, const char *fn, int lno)
 }
 
 #endif // USE_DEBUG_MALLOC
+
+#ifdef USE_SLAB_MALLOC
+
+#if defined(USE_SLAB_HUGEPAGES) && defined(__linux__)
+#include <sys/mman.h>
+#define CCNL_SLAB_ARENAS
+#endif
+
+struct ccnl_slab_cache_s;
+
+// header in front of every block
+union ccnl_slab_hdr_u {
+    struct {
+        struct ccnl_slab_s *slab;       // NULL: the block is from malloc()
+        uint32_t size;                  // requested size
+        uint32_t type;                  // enum ccnl_mem_type
+    } h;
+    union ccnl_slab_hdr_u *next;        // next free block of the slab
+    double align;
+};
+
+// a slab of CCNL_SLAB_SIZE bytes, the header is followed by the blocks
+struct ccnl_slab_s {
+    struct ccnl_slab_s *next, *prev;    // list of the cache's partial slabs
+    struct ccnl_slab_cache_s *cache;
+    union ccnl_slab_hdr_u *free;        // freed blocks
+    uint32_t inuse;                     // allocated blocks
+    uint32_t used;                      // blocks handed out at least once
+};
+
+// blocks of one size, each cache has slabs of its own
+struct ccnl_slab_cache_s {
+    struct ccnl_slab_s *partial;        // slabs with free blocks
+    uint32_t size;                      // block size with header, 0: unset
+    uint32_t perslab;
+};
+
+#define CCNL_SLAB_HDR           sizeof(union ccnl_slab_hdr_u)
+#define CCNL_SLAB_FIRST         ((sizeof(struct ccnl_slab_s) + 15) & ~(size_t) 15)
+#define CCNL_SLAB_MIN           32
+#define CCNL_SLAB_CLASSES       7       // CCNL_SLAB_MIN .. CCNL_SLAB_MAX
+
+// each type of object has a cache, the first allocation fixes its size,
+// anything else goes to the cache of the next power of two; with
+// USE_THREADS each thread has caches of its own and frees only its blocks
+static CCNL_THREAD_LOCAL struct ccnl_slab_cache_s ccnl_slab_types[CCNL_MEM_TYPES];
+static CCNL_THREAD_LOCAL struct ccnl_slab_cache_s ccnl_slab_classes[CCNL_SLAB_CLASSES];
+static CCNL_THREAD_LOCAL struct ccnl_mem_stats_s ccnl_mem_counters[CCNL_MEM_TYPES];
+static CCNL_THREAD_LOCAL size_t ccnl_mem_held;
+#ifdef CCNL_SLAB_ARENAS
+static CCNL_THREAD_LOCAL struct ccnl_slab_s *ccnl_slab_spare;
+#endif
+
+static const char *ccnl_mem_names[CCNL_MEM_TYPES] = {
+    "other", "pkt", "prefix", "interest", "pendint", "content", "face", "timer"
+};
+
+static struct ccnl_slab_s*
+ccnl_slab_get(void)
+{
+#ifdef CCNL_SLAB_ARENAS
+    struct ccnl_slab_s *s;
+    uint8_t *arena;
+    int i;
+
+    if (!ccnl_slab_spare) {
+        arena = mmap(NULL, CCNL_SLAB_ARENA_SIZE, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (arena == MAP_FAILED) {
+            // no huge pages reserved, ask for transparent ones
+            arena = mmap(NULL, CCNL_SLAB_ARENA_SIZE, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (arena == MAP_FAILED) {
+                return NULL;
+            }
+#ifdef MADV_HUGEPAGE
+            madvise(arena, CCNL_SLAB_ARENA_SIZE, MADV_HUGEPAGE);
+#endif
+        }
+        ccnl_mem_held += CCNL_SLAB_ARENA_SIZE;
+        // arenas are kept, their slabs go back to the spare list
+        for (i = CCNL_SLAB_ARENA_SIZE / CCNL_SLAB_SIZE - 1; i >= 0; i--) {
+            s = (struct ccnl_slab_s *) (arena + i * CCNL_SLAB_SIZE);
+            s->next = ccnl_slab_spare;
+            ccnl_slab_spare = s;
+        }
+    }
+    s = ccnl_slab_spare;
+    ccnl_slab_spare = s->next;
+    return s;
+#else
+    struct ccnl_slab_s *s = (struct ccnl_slab_s *) malloc(CCNL_SLAB_SIZE);
+
+    if (s) {
+        ccnl_mem_held += CCNL_SLAB_SIZE;
+    }
+    return s;
+#endif
+}
+
+static void
+ccnl_slab_put(struct ccnl_slab_s *s)
+{
+#ifdef CCNL_SLAB_ARENAS
+    s->next = ccnl_slab_spare;
+    ccnl_slab_spare = s;
+#else
+    ccnl_mem_held -= CCNL_SLAB_SIZE;
+    free(s);
+#endif
+}
+
+static void
+ccnl_slab_link(struct ccnl_slab_cache_s *c, struct ccnl_slab_s *s)
+{
+    s->prev = NULL;
+    s->next = c->partial;
+    if (c->partial) {
+        c->partial->prev = s;
+    }
+    c->partial = s;
+}
+
+static void
+ccnl_slab_unlink(struct ccnl_slab_cache_s *c, struct ccnl_slab_s *s)
+{
+    if (s->prev) {
+        s->prev->next = s->next;
+    } else {
+        c->partial = s->next;
+    }
+    if (s->next) {
+        s->next->prev = s->prev;
+    }
+}
+
+static struct ccnl_slab_cache_s*
+ccnl_slab_cache(int type, size_t total)
+{
+    struct ccnl_slab_cache_s *c = ccnl_slab_types + type;
+    uint32_t size;
+    int i;
+
+    if (type == CCNL_MEM_OTHER || (c->size && total > c->size)) {
+        for (i = 0, size = CCNL_SLAB_MIN; size < total; i++, size <<= 1);
+        c = ccnl_slab_classes + i;
+    } else {
+        size = (uint32_t) ((total + 15) & ~(size_t) 15);
+    }
+    if (!c->size) {
+        c->size = size;
+        c->perslab = (uint32_t) ((CCNL_SLAB_SIZE - CCNL_SLAB_FIRST) / size);
+    }
+    return c;
+}
+
+void*
+ccnl_slab_malloc(int type, size_t s)
+{
+    union ccnl_slab_hdr_u *h;
+    struct ccnl_slab_cache_s *c;
+    struct ccnl_slab_s *slab;
+
+    if (type < 0 || type >= CCNL_MEM_TYPES) {
+        type = CCNL_MEM_OTHER;
+    }
+    if (s > UINT32_MAX - CCNL_SLAB_HDR) {
+        return NULL;
+    }
+    if (s + CCNL_SLAB_HDR > CCNL_SLAB_MAX) {
+        h = (union ccnl_slab_hdr_u *) malloc(s + CCNL_SLAB_HDR);
+        if (!h) {
+            return NULL;
+        }
+        h->h.slab = NULL;
+        ccnl_mem_held += s + CCNL_SLAB_HDR;
+    } else {
+        c = ccnl_slab_cache(type, s + CCNL_SLAB_HDR);
+        slab = c->partial;
+        if (!slab) {
+            slab = ccnl_slab_get();
+            if (!slab) {
+                return NULL;
+            }
+            memset(slab, 0, sizeof(*slab));
+            slab->cache = c;
+            ccnl_slab_link(c, slab);
+        }
+        if (slab->free) {
+            h = slab->free;
+            slab->free = h->next;
+        } else {
+            h = (union ccnl_slab_hdr_u *) ((uint8_t *) slab + CCNL_SLAB_FIRST +
+                                           slab->used * c->size);
+            slab->used++;
+        }
+        if (++slab->inuse == c->perslab) {
+            ccnl_slab_unlink(c, slab);
+        }
+        h->h.slab = slab;
+    }
+    h->h.size = (uint32_t) s;
+    h->h.type = (uint32_t) type;
+    ccnl_mem_counters[type].objects++;
+    ccnl_mem_counters[type].bytes += s;
+    return h + 1;
+}
+
+void*
+ccnl_slab_calloc(int type, size_t n, size_t s)
+{
+    size_t size;
+    void *p = NULL;
+#ifndef BUILTIN_INT_MULT_OVERFLOW_DETECTION_UNAVAILABLE
+    if (INT_MULT_OVERFLOW(n, s, &size)) {
+        return NULL;
+    }
+#else
+    size = n * s;
+#endif // BUILTIN_INT_MULT_OVERFLOW_DETECTION_UNAVAILABLE
+    p = ccnl_slab_malloc(type, size);
+    if (p) {
+        memset(p, 0, size);
+    }
+    return p;
+}
+
+void*
+ccnl_slab_realloc(void *p, size_t s)
+{
+    union ccnl_slab_hdr_u *h;
+    void *q;
+    size_t avail;
+
+    if (!p) {
+        return ccnl_slab_malloc(CCNL_MEM_OTHER, s);
+    }
+    h = (union ccnl_slab_hdr_u *) p - 1;
+    if (s > UINT32_MAX - CCNL_SLAB_HDR) {
+        return NULL;
+    }
+    avail = h->h.slab ? h->h.slab->cache->size - CCNL_SLAB_HDR : h->h.size;
+    if (!h->h.slab && s + CCNL_SLAB_HDR > CCNL_SLAB_MAX && s > avail) {
+        // a large block stays a large block
+        h = (union ccnl_slab_hdr_u *) realloc(h, s + CCNL_SLAB_HDR);
+        if (!h) {
+            return NULL;
+        }
+        ccnl_mem_held += s - h->h.size;
+        avail = s;
+    }
+    if (s <= avail) {
+        ccnl_mem_counters[h->h.type].bytes += s;
+        ccnl_mem_counters[h->h.type].bytes -= h->h.size;
+        h->h.size = (uint32_t) s;
+        return h + 1;
+    }
+    q = ccnl_slab_malloc((int) h->h.type, s);
+    if (q) {
+        memcpy(q, p, h->h.size);
+        ccnl_slab_free(p);
+    }
+    return q;
+}
+
+char*
+ccnl_slab_strdup(const char *s)
+{
+    size_t len = strlen(s) + 1;
+    char *cp = (char *) ccnl_slab_malloc(CCNL_MEM_OTHER, len);
+
+    if (cp) {
+        memcpy(cp, s, len);
+    }
+    return cp;
+}
+
+void
+ccnl_slab_free(void *p)
+{
+    union ccnl_slab_hdr_u *h;
+    struct ccnl_slab_cache_s *c;
+    struct ccnl_slab_s *slab;
+
+    if (!p) {
+        return;
+    }
+    h = (union ccnl_slab_hdr_u *) p - 1;
+    ccnl_mem_counters[h->h.type].objects--;
+    ccnl_mem_counters[h->h.type].bytes -= h->h.size;
+    slab = h->h.slab;
+    if (!slab) {
+        ccnl_mem_held -= h->h.size + CCNL_SLAB_HDR;
+        free(h);
+        return;
+    }
+    c = slab->cache;
+    h->next = slab->free;
+    slab->free = h;
+    if (slab->inuse-- == c->perslab) {
+        ccnl_slab_link(c, slab);
+    }
+    // an empty slab is released unless it is the last one with free blocks
+    if (!slab->inuse && (c->partial != slab || slab->next)) {
+        ccnl_slab_unlink(c, slab);
+        ccnl_slab_put(slab);
+    }
+}
+
+void
+ccnl_mem_stats(int type, struct ccnl_mem_stats_s *stats)
+{
+    if (type < 0 || type >= CCNL_MEM_TYPES) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+    *stats = ccnl_mem_counters[type];
+}
+
+size_t
+ccnl_mem_reserved(void)
+{
+    return ccnl_mem_held;
+}
+
+void
+ccnl_mem_trim(void)
+{
+    struct ccnl_slab_cache_s *c;
+    struct ccnl_slab_s *slab, *next;
+    int i;
+
+    for (i = 0; i < CCNL_MEM_TYPES + CCNL_SLAB_CLASSES; i++) {
+        c = i < CCNL_MEM_TYPES ? ccnl_slab_types + i
+                               : ccnl_slab_classes + i - CCNL_MEM_TYPES;
+        for (slab = c->partial; slab; slab = next) {
+            next = slab->next;
+            if (!slab->inuse) {
+                ccnl_slab_unlink(c, slab);
+                ccnl_slab_put(slab);
+            }
+        }
+    }
+}
+
+const char*
+ccnl_mem_type2str(int type)
+{
+    if (type < 0 || type >= CCNL_MEM_TYPES) {
+        return "?";
+    }
+    return ccnl_mem_names[type];
+}
+
+#endif // USE_SLAB_MALLOC
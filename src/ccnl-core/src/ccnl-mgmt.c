@@ -241,7 +241,7 @@ ccnl_mgmt_send_return_split(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
 
                 DEBUGMSG(INFO, "  .. adding to cache %zu %zu bytes\n", len4, len5);
                 snprintf(uri, sizeof(uri), "/mgmt/seqnum-%zu", it);
-                pkt = ccnl_calloc(1, sizeof(*pkt));
+                pkt = ccnl_obj_calloc(CCNL_MEM_PKT, sizeof(*pkt));
                 if (!pkt) {
                     goto Bail;
                 }
@@ -326,7 +326,7 @@ ccnl_prefix_clone(struct ccnl_prefix_s *p)
     int i, len;
     struct ccnl_prefix_s *p2;
 
-    p2 = (struct ccnl_prefix_s*) ccnl_calloc(1, sizeof(struct ccnl_prefix_s));
+    p2 = (struct ccnl_prefix_s*) ccnl_obj_calloc(CCNL_MEM_PREFIX, sizeof(struct ccnl_prefix_s));
     if (!p2) return NULL;
     for (i = 0, len = 0; i < p->compcnt; len += p->complen[i++]);
     p2->bytes = (unsigned char*) ccnl_malloc(len);
@@ -725,6 +725,23 @@ ccnl_mgmt_create_content_stmt(size_t num_contents, long *content, long *contentn
     return 0;
 }
 
+static int8_t
+ccnl_mgmt_create_csbytes_stmt(struct ccnl_relay_s *ccnl, uint8_t *stmt,
+                              const uint8_t *stmtend, size_t *len3)
+{
+    char str[32];
+
+    snprintf(str, sizeof(str), "%zu", ccnl->cs_bytes);
+    if (ccnl_ccnb_mkStrBlob(stmt+*len3, stmtend, CCNL_DTAG_CSBYTES, CCN_TT_DTAG, str, len3)) {
+        return -1;
+    }
+    snprintf(str, sizeof(str), "%zu", ccnl->max_cache_bytes);
+    if (ccnl_ccnb_mkStrBlob(stmt+*len3, stmtend, CCNL_DTAG_CSMAXBYTES, CCN_TT_DTAG, str, len3)) {
+        return -1;
+    }
+    return 0;
+}
+
 int8_t
 ccnl_mgmt_debug(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
                 struct ccnl_prefix_s *prefix, struct ccnl_face_s *from)
@@ -1066,7 +1083,7 @@ SoftBail:
         debugaction = (unsigned char *) "Error for debug cmd";
     }
     stmt_length = 200 * num_faces + 200 * num_interfaces + 200 * num_fwds //alloc stroage for answer dynamically.
-            + 200 * num_interests + 200 * num_contents;
+            + 200 * num_interests + 200 * num_contents + 100;
     contentobject_length = stmt_length + 1000;
     object_length = contentobject_length + 1000;
 
@@ -1147,6 +1164,10 @@ SoftBail:
                 contentlast_use, contentserved_cnt, ccontents, cprefix, stmt, stmt+stmt_length, &len3)) {
             goto Bail;
         }
+
+        if (ccnl_mgmt_create_csbytes_stmt(ccnl, stmt, stmt+stmt_length, &len3)) {
+            goto Bail;
+        }
     }
 
     if (len3 + 1 >= stmt_length) {
@@ -2326,7 +2347,7 @@ ccnl_mgmt_echo(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
         goto SoftBail;
     }
 
-    p = (struct ccnl_prefix_s *) ccnl_calloc(1, sizeof(struct ccnl_prefix_s));
+    p = (struct ccnl_prefix_s *) ccnl_obj_calloc(CCNL_MEM_PREFIX, sizeof(struct ccnl_prefix_s));
     if (!p) {
         goto SoftBail;
     }
@@ -2508,7 +2529,7 @@ ccnl_mgmt_prefixreg(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
         goto SoftBail;
     }
 
-    p = (struct ccnl_prefix_s *) ccnl_calloc(1, sizeof(struct ccnl_prefix_s));
+    p = (struct ccnl_prefix_s *) ccnl_obj_calloc(CCNL_MEM_PREFIX, sizeof(struct ccnl_prefix_s));
     if (!p) {
         goto Bail;
     }
@@ -2560,7 +2581,6 @@ ccnl_mgmt_prefixreg(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
     // should (re)verify that action=="prefixreg"
     if (faceid && p->compcnt > 0) {
         struct ccnl_face_s *f = NULL;
-        struct ccnl_forward_s **fwd2 = NULL;
         long faceid_l;
 
         errno = 0;
@@ -2580,6 +2600,11 @@ ccnl_mgmt_prefixreg(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
         if (!f) {
             goto SoftBail;
         }
+        if (ccnl->ccnl_fib_face_ptr && !ccnl->ccnl_fib_face_ptr(ccnl, f)) {
+            DEBUGMSG(WARNING, "mgmt: prefixreg refused for faceid=%d\n", fi);
+            cp = "prefixreg cmd failed, face not usable for this relay";
+            goto SoftBail;
+        }
 
 //      printf("Face %s found\n", faceid);
         fwd = (struct ccnl_forward_s *) ccnl_calloc(1, sizeof(*fwd));
@@ -2592,11 +2617,13 @@ ccnl_mgmt_prefixreg(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
             fwd->suite = suite[0];
         }
 
-        fwd2 = &ccnl->fib;
-        while (*fwd2) {
-            fwd2 = &((*fwd2)->next);
+        if (!fwd->prefix || ccnl_forward_add(ccnl, fwd)) {
+            ccnl_prefix_free(fwd->prefix);
+            ccnl_free(fwd);
+            fwd = NULL;
+            goto SoftBail;
         }
-        *fwd2 = fwd;
+        fwd = NULL; // owned by the FIB now
         cp = "prefixreg cmd worked";
     } else {
         DEBUGMSG(TRACE, "mgmt: ignored prefixreg faceid=%s\n", faceid);
@@ -2805,7 +2832,7 @@ ccnl_mgmt_addcacheobject(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
         struct ccnl_interest_s *interest = NULL;
         struct ccnl_buf_s *buffer = NULL;
 
-        pkt = ccnl_calloc(1, sizeof(*pkt));
+        pkt = ccnl_obj_calloc(CCNL_MEM_PKT, sizeof(*pkt));
         if (!pkt) {
             goto Bail;
         }
@@ -2827,7 +2854,7 @@ ccnl_mgmt_addcacheobject(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
             goto Bail;
         }
         pkt->val.final_block_id = -1;
-        buffer = buf_dup(pkt->buf);
+        buffer = ccnl_buf_ref(pkt->buf);
         if (!buffer) {
             goto Bail;
         }
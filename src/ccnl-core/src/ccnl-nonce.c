@@ -0,0 +1,141 @@
+/*
+ * @f ccnl-nonce.c
+ * @b CCN lite (CCNL), table of recently seen Interest nonces
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-17 created
+ */
+
+#ifndef CCNL_LINUXKERNEL
+#include "ccnl-nonce.h"
+#include "ccnl-relay.h"
+#include "ccnl-buf.h"
+#include "ccnl-prefix.h"
+#include "ccnl-htable.h"
+#include "ccnl-malloc.h"
+#include "ccnl-os-time.h"
+#include "ccnl-logging.h"
+#else
+#include "../include/ccnl-nonce.h"
+#include "../include/ccnl-relay.h"
+#include "../include/ccnl-buf.h"
+#include "../include/ccnl-prefix.h"
+#include "../include/ccnl-htable.h"
+#include "../include/ccnl-malloc.h"
+#include "../include/ccnl-os-time.h"
+#include "../include/ccnl-logging.h"
+#endif
+
+static int
+ccnl_nonce_live(struct ccnl_nonce_s *e, uint32_t now)
+{
+    return e->expires && (int32_t) (e->expires - now) > 0;
+}
+
+// doubles the table, the entries of a bucket are split over two buckets
+// of the new table, hence they always fit
+static int
+ccnl_nonce_grow(struct ccnl_nonce_table_s *t, uint32_t now)
+{
+    struct ccnl_nonce_s *slots, *e, *d;
+    uint32_t size = t->size ? 2 * t->size : CCNL_NONCE_MIN_SIZE;
+    uint32_t i, k;
+
+    slots = (struct ccnl_nonce_s *) ccnl_calloc(size, sizeof(*slots));
+    if (!slots) {
+        return -1;
+    }
+    for (i = 0; i < t->size; i++) {
+        e = t->slots + i;
+        if (!ccnl_nonce_live(e, now)) {
+            continue;
+        }
+        d = slots + (e->hash & (size / CCNL_NONCE_WAYS - 1)) * CCNL_NONCE_WAYS;
+        for (k = 0; d[k].expires; k++);
+        d[k] = *e;
+    }
+    ccnl_free(t->slots);
+    t->slots = slots;
+    t->size = size;
+    return 0;
+}
+
+int
+ccnl_nonce_find_or_append(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
+                          struct ccnl_buf_s *nonce)
+{
+    struct ccnl_nonce_table_s *t = &relay->nonces;
+    struct ccnl_nonce_s *bucket, *victim;
+    uint32_t now = (uint32_t) CCNL_NOW();
+    uint32_t hash, k;
+    DEBUGMSG_CORE(TRACE, "ccnl_nonce_find_or_append\n");
+
+    hash = ccnl_hash_bytes(ccnl_prefix_hash(pfx, pfx->compcnt),
+                           nonce->data, nonce->datalen);
+    if (!t->slots && ccnl_nonce_grow(t, now)) {
+        return 0;
+    }
+
+    for (;;) {
+        bucket = t->slots + (hash & (t->size / CCNL_NONCE_WAYS - 1)) * CCNL_NONCE_WAYS;
+        // the victim is a free entry, else the one which expires first
+        victim = NULL;
+        for (k = 0; k < CCNL_NONCE_WAYS; k++) {
+            if (!ccnl_nonce_live(bucket + k, now)) {
+                if (!victim || ccnl_nonce_live(victim, now)) {
+                    victim = bucket + k;
+                }
+            } else if (bucket[k].hash == hash) {
+                return -1;
+            } else if (!victim || (ccnl_nonce_live(victim, now) &&
+                       (int32_t) (bucket[k].expires - victim->expires) < 0)) {
+                victim = bucket + k;
+            }
+        }
+        if (!ccnl_nonce_live(victim, now) || t->size >= (uint32_t) CCNL_MAX_NONCES ||
+            ccnl_nonce_grow(t, now)) {
+            break;
+        }
+    }
+
+    victim->hash = hash;
+    victim->expires = now + CCNL_NONCE_LIFETIME;
+    if (!victim->expires) {
+        victim->expires = 1;
+    }
+    return 0;
+}
+
+uint32_t
+ccnl_nonce_count(struct ccnl_relay_s *relay)
+{
+    uint32_t now = (uint32_t) CCNL_NOW();
+    uint32_t i, cnt = 0;
+
+    for (i = 0; i < relay->nonces.size; i++) {
+        cnt += ccnl_nonce_live(relay->nonces.slots + i, now) ? 1 : 0;
+    }
+    return cnt;
+}
+
+void
+ccnl_nonce_cleanup(struct ccnl_relay_s *relay)
+{
+    ccnl_free(relay->nonces.slots);
+    relay->nonces.slots = NULL;
+    relay->nonces.size = 0;
+}
@@ -21,22 +21,24 @@
  */
 
 #ifndef CCNL_LINUXKERNEL
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE // clock_gettime
+#endif
+#include "ccnl-defs.h"
 #include "ccnl-os-time.h"
 #include "ccnl-malloc.h"
+#include <limits.h>
 #include <stdio.h>
 #include <string.h>
 #include <time.h>
 #else
+#include "../include/ccnl-defs.h"
 #include "../include/ccnl-os-time.h"
 #include "../include/ccnl-malloc.h"
 #endif
 
 
 
-
-struct ccnl_timer_s *eventqueue;
-
-
 #if defined(CCNL_RIOT) && !(defined(__FreeBSD__) || defined(__APPLE__) || defined(__linux__))
 #include <xtimer.h>
 
@@ -51,6 +53,42 @@ int gettimeofday(struct timeval *__restrict __p, void *__restrict __tz)
 }
 #endif
 
+#if defined(CCNL_UNIX) || defined (CCNL_RIOT) || defined (CCNL_ARDUINO)
+
+static CCNL_THREAD_LOCAL uint64_t ccnl_clock;     // time of the last ccnl_time_update()
+static CCNL_THREAD_LOCAL int ccnl_clock_cached;   // whether ccnl_clock is maintained
+
+static uint64_t
+ccnl_clock_read(void)
+{
+#if defined(CCNL_UNIX) && defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + (uint64_t) ts.tv_nsec / 1000;
+#else
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return (uint64_t) tv.tv_sec * 1000000 + (uint64_t) tv.tv_usec;
+#endif
+}
+
+void
+ccnl_time_update(void)
+{
+    ccnl_clock = ccnl_clock_read();
+    ccnl_clock_cached = 1;
+}
+
+uint64_t
+ccnl_time_usec(void)
+{
+    return ccnl_clock_cached ? ccnl_clock : ccnl_clock_read();
+}
+
+#endif
+
 #ifdef CCNL_ARDUINO
 
 double CCNL_NOW(void) { return (double) millis() / Hz; }
@@ -77,28 +115,26 @@ timestamp(void)
 #else // !CCNL_ARDUINO
 
 #ifndef CCNL_LINUXKERNEL
+// the first call sets the start, before any threads are started (see
+// ccnl_shard_run() and ccnl_pipeline_run()) as they all share it
 double
 current_time(void)
 {
-    struct timeval tv;
-    static time_t start;
-    static time_t start_usec;
-
-    gettimeofday(&tv, NULL);
+    static uint64_t start;
+    uint64_t now = ccnl_time_usec();
 
     if (!start) {
-        start = tv.tv_sec;
-        start_usec = tv.tv_usec;
+        start = now;
     }
 
-    return (double)(tv.tv_sec) - start +
-                ((double)(tv.tv_usec) - start_usec) / 1000000;
+    return (double)(now - start) / 1000000;
 }
 
 char*
 timestamp(void)
 {
-    static char ts[16], *cp;
+    static CCNL_THREAD_LOCAL char ts[16];
+    char *cp;
 
     snprintf(ts, sizeof(ts), "%.4g", CCNL_NOW());
     cp = strchr(ts, '.');
@@ -126,53 +162,216 @@ timevaldelta(struct timeval *a, struct timeval *b) {
 void
 ccnl_get_timeval(struct timeval *tv)
 {
-    gettimeofday(tv, NULL);
+    uint64_t now = ccnl_time_usec();
+
+    tv->tv_sec = now / 1000000;
+    tv->tv_usec = now % 1000000;
 }
 
-void*
-ccnl_set_timer(uint64_t usec, void (*fct)(void *aux1, void *aux2),
-                 void *aux1, void *aux2)
+// pending timers, a binary min-heap ordered by timeout
+static CCNL_THREAD_LOCAL struct ccnl_timer_s **ccnl_timer_heap;
+static CCNL_THREAD_LOCAL int ccnl_timer_heapsize;
+static CCNL_THREAD_LOCAL int ccnl_timer_heapcnt;
+
+#ifdef USE_SLAB_MALLOC
+// the allocator keeps the timers in slabs of their own
+static struct ccnl_timer_s*
+ccnl_timer_alloc(void)
+{
+    struct ccnl_timer_s *t;
+
+    t = (struct ccnl_timer_s *) ccnl_obj_calloc(CCNL_MEM_TIMER, sizeof(*t));
+    if (t) {
+        t->idx = -1;
+    }
+    return t;
+}
+
+static void
+ccnl_timer_release(struct ccnl_timer_s *t)
+{
+    ccnl_free(t);
+}
+#else
+// the timer pool, timers are allocated in chunks and never freed before
+// ccnl_timer_cleanup()
+struct ccnl_timer_chunk_s {
+    struct ccnl_timer_chunk_s *next;
+    struct ccnl_timer_s timers[CCNL_TIMER_POOL_CHUNK];
+};
+static CCNL_THREAD_LOCAL struct ccnl_timer_chunk_s *ccnl_timer_chunks;
+static CCNL_THREAD_LOCAL struct ccnl_timer_s *ccnl_timer_free;
+
+static struct ccnl_timer_s*
+ccnl_timer_alloc(void)
+{
+    struct ccnl_timer_chunk_s *c;
+    struct ccnl_timer_s *t;
+    int i;
+
+    if (!ccnl_timer_free) {
+        c = (struct ccnl_timer_chunk_s *) ccnl_malloc(sizeof(*c));
+        if (!c) {
+            return NULL;
+        }
+        c->next = ccnl_timer_chunks;
+        ccnl_timer_chunks = c;
+        for (i = CCNL_TIMER_POOL_CHUNK - 1; i >= 0; i--) {
+            c->timers[i].next = ccnl_timer_free;
+            ccnl_timer_free = c->timers + i;
+        }
+    }
+    t = ccnl_timer_free;
+    ccnl_timer_free = t->next;
+    memset(t, 0, sizeof(*t));
+    t->idx = -1;
+    return t;
+}
+
+static void
+ccnl_timer_release(struct ccnl_timer_s *t)
+{
+    t->idx = -1;
+    t->next = ccnl_timer_free;
+    ccnl_timer_free = t;
+}
+#endif // USE_SLAB_MALLOC
+
+static void
+ccnl_timer_place(struct ccnl_timer_s *t, int idx)
+{
+    ccnl_timer_heap[idx] = t;
+    t->idx = idx;
+}
+
+static void
+ccnl_timer_siftup(struct ccnl_timer_s *t, int idx)
 {
-    struct ccnl_timer_s *t, **pp;
-    //    static int handlercnt;
+    int parent;
+
+    while (idx > 0) {
+        parent = (idx - 1) / 2;
+        if (ccnl_timer_heap[parent]->timeout <= t->timeout) {
+            break;
+        }
+        ccnl_timer_place(ccnl_timer_heap[parent], idx);
+        idx = parent;
+    }
+    ccnl_timer_place(t, idx);
+}
+
+static void
+ccnl_timer_siftdown(struct ccnl_timer_s *t, int idx)
+{
+    int child;
+
+    while ((child = 2 * idx + 1) < ccnl_timer_heapcnt) {
+        if (child + 1 < ccnl_timer_heapcnt &&
+            ccnl_timer_heap[child + 1]->timeout < ccnl_timer_heap[child]->timeout) {
+            child++;
+        }
+        if (t->timeout <= ccnl_timer_heap[child]->timeout) {
+            break;
+        }
+        ccnl_timer_place(ccnl_timer_heap[child], idx);
+        idx = child;
+    }
+    ccnl_timer_place(t, idx);
+}
 
-    t = (struct ccnl_timer_s *) ccnl_calloc(1, sizeof(*t));
-    if (!t)
-        return 0;
+static void*
+ccnl_timer_add(uint64_t timeout, void (*fct)(void *aux1, void *aux2),
+               void *aux1, void *aux2)
+{
+    struct ccnl_timer_s *t, **heap;
+    int size;
+
+    if (ccnl_timer_heapcnt == ccnl_timer_heapsize) {
+        size = ccnl_timer_heapsize ? 2 * ccnl_timer_heapsize : CCNL_TIMER_POOL_CHUNK;
+        heap = (struct ccnl_timer_s **) ccnl_realloc(ccnl_timer_heap,
+                                                     size * sizeof(*heap));
+        if (!heap) {
+            return NULL;
+        }
+        ccnl_timer_heap = heap;
+        ccnl_timer_heapsize = size;
+    }
+    t = ccnl_timer_alloc();
+    if (!t) {
+        return NULL;
+    }
     t->fct2 = fct;
-    gettimeofday(&t->timeout, NULL);
-    usec += t->timeout.tv_usec;
-    t->timeout.tv_sec += usec / 1000000;
-    t->timeout.tv_usec = usec % 1000000;
+    t->timeout = timeout;
     t->aux1 = aux1;
     t->aux2 = aux2;
+    ccnl_timer_siftup(t, ccnl_timer_heapcnt++);
+    return t;
+}
 
-    for (pp = &eventqueue; ; pp = &((*pp)->next)) {
-    if (!*pp || (*pp)->timeout.tv_sec > t->timeout.tv_sec ||
-        ((*pp)->timeout.tv_sec == t->timeout.tv_sec &&
-         (*pp)->timeout.tv_usec > t->timeout.tv_usec)) {
-        t->next = *pp;
-        //        t->handler = handlercnt++;
-        *pp = t;
-        return t;
+static void
+ccnl_timer_unqueue(struct ccnl_timer_s *t)
+{
+    struct ccnl_timer_s *last = ccnl_timer_heap[--ccnl_timer_heapcnt];
+    int idx = t->idx;
+
+    t->idx = -1;
+    if (last == t) {
+        return;
     }
+    // the last timer takes the free position and moves up or down
+    if (idx > 0 && ccnl_timer_heap[(idx - 1) / 2]->timeout > last->timeout) {
+        ccnl_timer_siftup(last, idx);
+    } else {
+        ccnl_timer_siftdown(last, idx);
     }
-    return NULL; // ?
+}
+
+void*
+ccnl_set_timer(uint64_t usec, void (*fct)(void *aux1, void *aux2),
+                 void *aux1, void *aux2)
+{
+    return ccnl_timer_add(ccnl_time_usec() + usec, fct, aux1, aux2);
 }
 
 void
 ccnl_rem_timer(void *h)
 {
-    struct ccnl_timer_s **pp;
+    struct ccnl_timer_s *t = (struct ccnl_timer_s *) h;
 
-    for (pp = &eventqueue; *pp; pp = &((*pp)->next)) {
-        if ((void*)*pp == h) {
-            struct ccnl_timer_s *e = *pp;
-            *pp = e->next;
-            ccnl_free(e);
-            break;
-        }
+    // a timer which already fired is not queued anymore
+    if (!t || t->idx < 0) {
+        return;
+    }
+    ccnl_timer_unqueue(t);
+    ccnl_timer_release(t);
+}
+
+int
+ccnl_timer_count(void)
+{
+    return ccnl_timer_heapcnt;
+}
+
+void
+ccnl_timer_cleanup(void)
+{
+#ifdef USE_SLAB_MALLOC
+    while (ccnl_timer_heapcnt > 0) {
+        ccnl_free(ccnl_timer_heap[--ccnl_timer_heapcnt]);
+    }
+#else
+    struct ccnl_timer_chunk_s *c;
+
+    while (ccnl_timer_chunks) {
+        c = ccnl_timer_chunks->next;
+        ccnl_free(ccnl_timer_chunks);
+        ccnl_timer_chunks = c;
     }
+    ccnl_timer_free = NULL;
+#endif
+    ccnl_free(ccnl_timer_heap);
+    ccnl_timer_heap = NULL;
+    ccnl_timer_heapsize = ccnl_timer_heapcnt = 0;
 }
 
 #endif
@@ -269,23 +468,36 @@ ccnl_rem_timer(void *p)
 int
 ccnl_run_events(void)
 {
-    static struct timeval now;
-    long usec;
-
-    gettimeofday(&now, 0);
-    while (eventqueue) {
-        struct ccnl_timer_s *t = eventqueue;
-
-        usec = timevaldelta(&(t->timeout), &now);
-        if (usec >= 0)
-            return usec;
-
-        if (t->fct)
-            (t->fct)(t->node, t->intarg);
-        else if (t->fct2)
-            (t->fct2)(t->aux1, t->aux2);
-        eventqueue = t->next;
-        ccnl_free(t);
+    struct ccnl_timer_s *t;
+    void (*fct)(char,int);
+    void (*fct2)(void*,void*);
+    char node;
+    int intarg;
+    void *aux1, *aux2;
+    uint64_t now;
+
+    ccnl_time_update();
+    now = ccnl_time_usec();
+    while (ccnl_timer_heapcnt) {
+        t = ccnl_timer_heap[0];
+        if (t->timeout > now) {
+            return t->timeout - now > INT_MAX ? INT_MAX : (int) (t->timeout - now);
+        }
+
+        // the timer goes back to the pool before its handler runs, the
+        // handler may set new timers
+        fct = t->fct;
+        fct2 = t->fct2;
+        node = t->node;
+        intarg = t->intarg;
+        aux1 = t->aux1;
+        aux2 = t->aux2;
+        ccnl_timer_unqueue(t);
+        ccnl_timer_release(t);
+        if (fct)
+            (fct)(node, intarg);
+        else if (fct2)
+            (fct2)(aux1, aux2);
     }
 
     return -1;
@@ -301,28 +513,8 @@ void*
 ccnl_set_absolute_timer(struct timeval abstime, void (*fct)(void *aux1, void *aux2),
          void *aux1, void *aux2)
 {
-    struct ccnl_timer_s *t, **pp;
-    //    static int handlercnt;
-
-    t = (struct ccnl_timer_s *) ccnl_calloc(1, sizeof(*t));
-    if (!t)
-    return 0;
-    t->fct2 = fct;
-    t->timeout = abstime;
-    t->aux1 = aux1;
-    t->aux2 = aux2;
-
-    for (pp = &eventqueue; ; pp = &((*pp)->next)) {
-    if (!*pp || (*pp)->timeout.tv_sec > t->timeout.tv_sec ||
-        ((*pp)->timeout.tv_sec == t->timeout.tv_sec &&
-         (*pp)->timeout.tv_usec > t->timeout.tv_usec)) {
-        t->next = *pp;
-        //        t->handler = handlercnt++;
-        *pp = t;
-        return t;
-    }
-    }
-    return NULL; // ?
+    return ccnl_timer_add((uint64_t) abstime.tv_sec * 1000000 + abstime.tv_usec,
+                          fct, aux1, aux2);
 }
 
 #endif
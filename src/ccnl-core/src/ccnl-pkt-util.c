@@ -193,6 +193,79 @@ ccnl_pkt2suite(uint8_t *data, size_t len, size_t *skip)
     return -1;
 }
 
+int
+ccnl_pkt_framelen(uint8_t *data, size_t len, size_t *framelen)
+{
+    size_t skip = 0, hdrlen;
+    uint64_t vallen;
+
+    *framelen = 0;
+    while (len - skip >= 2 && data[skip] == 0x80) { // switch headers
+        if (data[skip + 1] >= 253) {
+            return -1;
+        }
+        skip += 2;
+    }
+    if (len - skip < 2) {
+        return 0;
+    }
+    (void) hdrlen;
+    (void) vallen;
+
+#ifdef USE_SUITE_CCNTLV
+    if (data[skip] == CCNX_TLV_V1 &&
+        (data[skip + 1] == CCNX_PT_Interest || data[skip + 1] == CCNX_PT_Data ||
+         data[skip + 1] == CCNX_PT_NACK || data[skip + 1] == CCNX_PT_Fragment)) {
+        // the fixed header's packet length covers the whole packet
+        if (len - skip < 4) {
+            return 0;
+        }
+        vallen = ((uint64_t) data[skip + 2] << 8) | data[skip + 3];
+        if (vallen < sizeof(struct ccnx_tlvhdr_ccnx2015_s)) {
+            return -1;
+        }
+        *framelen = skip + (size_t) vallen;
+        return 0;
+    }
+#endif
+
+#ifdef USE_SUITE_NDNTLV
+    if (data[skip] == NDN_TLV_Interest || data[skip] == NDN_TLV_Data ||
+        data[skip] == NDN_TLV_Fragment) {
+        // one byte type, the length is a var-number of 1, 3 or 5 bytes
+        switch (data[skip + 1]) {
+        case 253:
+            hdrlen = 4;
+            break;
+        case 254:
+            hdrlen = 6;
+            break;
+        case 255:
+            return -1;
+        default:
+            hdrlen = 2;
+            break;
+        }
+        if (len - skip < hdrlen) {
+            return 0;
+        }
+        if (hdrlen == 2) {
+            vallen = data[skip + 1];
+        } else {
+            size_t k;
+
+            for (vallen = 0, k = skip + 2; k < skip + hdrlen; k++) {
+                vallen = (vallen << 8) | data[k];
+            }
+        }
+        *framelen = skip + hdrlen + (size_t) vallen;
+        return 0;
+    }
+#endif
+
+    return -1;
+}
+
 int
 ccnl_cmp2int(unsigned char *cmp, size_t cmplen)
 {
@@ -226,15 +299,15 @@ ccnl_pkt_interest_lifetime(const struct ccnl_pkt_s *pkt)
 #ifdef USE_SUITE_CCNTLV
     case CCNL_SUITE_CCNTLV:
         /* CCN-TLV parser does not support lifetime parsing, yet. */
-        return CCNL_INTEREST_TIMEOUT;
+        return CCNL_INTEREST_TIMEOUT * 1000;
 #endif
 #ifdef USE_SUITE_NDNTLV
     case CCNL_SUITE_NDNTLV:
-        return (pkt->s.ndntlv.interestlifetime / 1000);
+        return pkt->s.ndntlv.interestlifetime;
 #endif
     default:
         break;
     }
 
-    return CCNL_INTEREST_TIMEOUT;
+    return CCNL_INTEREST_TIMEOUT * 1000;
 }
@@ -43,10 +43,161 @@
 #include "../include/ccnl-logging.h"
 #endif
 
+struct ccnl_pkt_s*
+ccnl_pkt_rx_init(struct ccnl_pkt_rx_s *rx)
+{
+    memset(&rx->pkt, 0, sizeof(rx->pkt));
+    rx->pkt.flags = CCNL_PKT_BORROWED;
+    rx->start = NULL;
+    rx->len = 0;
+    rx->fieldcnt = 0;
+    return &rx->pkt;
+}
+
+struct ccnl_prefix_s*
+ccnl_pkt_rx_prefix(struct ccnl_pkt_rx_s *rx, char suite)
+{
+    memset(&rx->pfx, 0, sizeof(rx->pfx));
+    rx->pfx.comp = rx->comp;
+    rx->pfx.complen = rx->complen;
+    rx->pfx.comphash = rx->comphash;
+    rx->pfx.suite = suite;
+    return &rx->pfx;
+}
+
+int
+ccnl_pkt_rx_name(struct ccnl_pkt_rx_s *rx, struct ccnl_prefix_s *p)
+{
+    const struct ccnl_pkt_name_s *n = rx->name;
+    uint32_t i;
+
+    if (!n || n->nameptr != p->nameptr || n->compcnt > CCNL_MAX_NAME_COMP) {
+        return 0;
+    }
+    for (i = 0; i < n->compcnt; i++) {
+        p->comp[i] = n->nameptr + n->comp[i].off;
+        p->complen[i] = n->comp[i].len;
+        p->comphash[i] = n->comp[i].hash;
+    }
+    p->compcnt = p->hashcnt = n->compcnt;
+    if (n->haschunknum) {
+        rx->chunknum = n->chunknum;
+        p->chunknum = &rx->chunknum;
+    }
+    return 1;
+}
+
+struct ccnl_buf_s*
+ccnl_pkt_rx_field(struct ccnl_pkt_rx_s *rx, uint8_t *data, size_t len)
+{
+    struct ccnl_buf_s *b;
+
+    if (len > CCNL_PKT_RX_FIELD_SIZE ||
+        rx->fieldcnt >= (int) (sizeof(rx->fields) / sizeof(rx->fields[0]))) {
+        return NULL;
+    }
+    b = &rx->fields[rx->fieldcnt++].buf;
+    b->next = NULL;
+    b->datalen = len;
+    b->refcnt = 1;
+    b->hash = 0;
+    memcpy(b->data, data, len);
+    return b;
+}
+
+// pointer into the packet's bytes, moved to the same offset of the copy
+#define CCNL_PKT_REBASE(p, rx, ptr) \
+    ((ptr) ? (p)->buf->data + ((ptr) - (rx)->start) : NULL)
+
+int
+ccnl_pkt_own(struct ccnl_pkt_s **pkt)
+{
+    struct ccnl_pkt_rx_s *rx = (struct ccnl_pkt_rx_s *) *pkt;
+    struct ccnl_pkt_s *p;
+    struct ccnl_prefix_s *pfx;
+    uint32_t i;
+
+    if (!*pkt || !((*pkt)->flags & CCNL_PKT_BORROWED)) {
+        return 0;
+    }
+    p = (struct ccnl_pkt_s *) ccnl_obj_malloc(CCNL_MEM_PKT, sizeof(*p));
+    if (!p) {
+        return -1;
+    }
+    *p = rx->pkt;
+    p->flags &= ~CCNL_PKT_BORROWED;
+    p->pfx = NULL;
+    p->buf = ccnl_buf_new(rx->start, rx->len);
+    if (!p->buf) {
+        goto Bail;
+    }
+    p->content = CCNL_PKT_REBASE(p, rx, rx->pkt.content);
+#ifdef USE_HMAC256
+    p->hmacStart = CCNL_PKT_REBASE(p, rx, rx->pkt.hmacStart);
+    p->hmacSignature = CCNL_PKT_REBASE(p, rx, rx->pkt.hmacSignature);
+#endif
+
+    if (rx->pkt.pfx) {
+        // the components stay in the packet's bytes
+        pfx = ccnl_prefix_new_compact(rx->pfx.suite, rx->pfx.compcnt, 0,
+                                      rx->pfx.chunknum);
+        if (!pfx) {
+            goto Bail;
+        }
+        p->pfx = pfx;
+        for (i = 0; i < pfx->compcnt; i++) {
+            pfx->comp[i] = CCNL_PKT_REBASE(p, rx, rx->pfx.comp[i]);
+            pfx->complen[i] = rx->pfx.complen[i];
+        }
+        pfx->nameptr = CCNL_PKT_REBASE(p, rx, rx->pfx.nameptr);
+        pfx->namelen = rx->pfx.namelen;
+        ccnl_prefix_copy_hashes(pfx, &rx->pfx);
+    }
+
+    // ccnl_pkt_free() releases the fields along with the name, a packet
+    // without a name keeps none
+    switch (p->suite) {
+#ifdef USE_SUITE_CCNB
+    case CCNL_SUITE_CCNB:
+        p->s.ccnb.nonce = p->s.ccnb.ppkd = NULL;
+        if (p->pfx) {
+            p->s.ccnb.nonce = buf_dup(rx->pkt.s.ccnb.nonce);
+            p->s.ccnb.ppkd = buf_dup(rx->pkt.s.ccnb.ppkd);
+        }
+        break;
+#endif
+#ifdef USE_SUITE_CCNTLV
+    case CCNL_SUITE_CCNTLV:
+        p->s.ccntlv.keyid = NULL;
+        if (p->pfx) {
+            p->s.ccntlv.keyid = buf_dup(rx->pkt.s.ccntlv.keyid);
+        }
+        break;
+#endif
+#ifdef USE_SUITE_NDNTLV
+    case CCNL_SUITE_NDNTLV:
+        p->s.ndntlv.nonce = p->s.ndntlv.ppkl = NULL;
+        if (p->pfx) {
+            p->s.ndntlv.nonce = buf_dup(rx->pkt.s.ndntlv.nonce);
+            p->s.ndntlv.ppkl = buf_dup(rx->pkt.s.ndntlv.ppkl);
+        }
+        break;
+#endif
+    default:
+        break;
+    }
+
+    *pkt = p;
+    return 0;
+Bail:
+    ccnl_pkt_free(p);
+    return -1;
+}
+
 void
 ccnl_pkt_free(struct ccnl_pkt_s *pkt)
 {
-    if (pkt) {
+    if (pkt && !(pkt->flags & CCNL_PKT_BORROWED)) {
         if (pkt->pfx) {
             switch (pkt->pfx->suite) {
 #ifdef USE_SUITE_CCNB
@@ -75,7 +226,7 @@ ccnl_pkt_free(struct ccnl_pkt_s *pkt)
             ccnl_prefix_free(pkt->pfx);
         }
         if(pkt->buf){
-            ccnl_free(pkt->buf);
+            ccnl_buf_free(pkt->buf);
         }
         ccnl_free(pkt);
     }
@@ -84,7 +235,7 @@ ccnl_pkt_free(struct ccnl_pkt_s *pkt)
 
 struct ccnl_pkt_s *
 ccnl_pkt_dup(struct ccnl_pkt_s *pkt){
-    struct ccnl_pkt_s * ret = ccnl_malloc(sizeof(struct ccnl_pkt_s));
+    struct ccnl_pkt_s * ret = ccnl_obj_malloc(CCNL_MEM_PKT, sizeof(struct ccnl_pkt_s));
     if(!pkt){
         if (ret) {
             ccnl_free(ret);
@@ -128,7 +279,7 @@ ccnl_pkt_dup(struct ccnl_pkt_s *pkt){
         }
         ret->pfx->suite = pkt->pfx->suite;
         ret->suite = pkt->suite;
-        ret->buf = buf_dup(pkt->buf);
+        ret->buf = ccnl_buf_ref(pkt->buf);
         ret->content = ret->buf->data + (pkt->content - pkt->buf->data);
         ret->contlen = pkt->contlen;
     }
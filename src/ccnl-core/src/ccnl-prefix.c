@@ -23,6 +23,7 @@
 
 #ifndef CCNL_LINUXKERNEL
 #include "ccnl-prefix.h"
+#include "ccnl-htable.h"
 #include "ccnl-pkt-ndntlv.h"
 #include "ccnl-pkt-ccntlv.h"
 #include <string.h>
@@ -33,6 +34,7 @@
 #endif // !defined(CCNL_RIOT) && !defined(CCNL_ANDROID)
 #else //CCNL_LINUXKERNEL
 #include "../include/ccnl-prefix.h"
+#include "../include/ccnl-htable.h"
 #include "../../ccnl-pkt/include/ccnl-pkt-ndntlv.h"
 #include "../../ccnl-pkt/include/ccnl-pkt-ccntlv.h"
 
@@ -44,13 +46,14 @@ ccnl_prefix_new(char suite, uint32_t cnt)
 {
     struct ccnl_prefix_s *p;
 
-    p = (struct ccnl_prefix_s *) ccnl_calloc(1, sizeof(struct ccnl_prefix_s));
+    p = (struct ccnl_prefix_s *) ccnl_obj_calloc(CCNL_MEM_PREFIX, sizeof(struct ccnl_prefix_s));
     if (!p){
         return NULL;
     }
     p->comp = (uint8_t **) ccnl_malloc(cnt * sizeof(uint8_t*));
     p->complen = (size_t *) ccnl_malloc(cnt * sizeof(size_t));
-    if (!p->comp || !p->complen) {
+    p->comphash = (uint32_t *) ccnl_malloc(cnt * sizeof(uint32_t));
+    if (!p->comp || !p->complen || !p->comphash) {
         ccnl_prefix_free(p);
         return NULL;
     }
@@ -61,16 +64,77 @@ ccnl_prefix_new(char suite, uint32_t cnt)
     return p;
 }
 
+struct ccnl_prefix_s*
+ccnl_prefix_new_compact(char suite, uint32_t cnt, size_t byteslen,
+                        uint32_t *chunknum)
+{
+    struct ccnl_prefix_s *p;
+    size_t tablen = cnt * (sizeof(uint8_t*) + sizeof(size_t) + sizeof(uint32_t));
+
+    p = (struct ccnl_prefix_s *) ccnl_obj_calloc(CCNL_MEM_PREFIX,
+                                           sizeof(*p) + tablen + byteslen);
+    if (!p){
+        return NULL;
+    }
+    // pointers first, the struct's size keeps them aligned
+    p->comp = (uint8_t **) (p + 1);
+    p->complen = (size_t *) (p->comp + cnt);
+    p->comphash = (uint32_t *) (p->complen + cnt);
+    if (byteslen) {
+        p->bytes = (uint8_t *) (p->comphash + cnt);
+    }
+    p->inlinelen = (uint32_t) (tablen + byteslen);
+    p->compcnt = cnt;
+    p->suite = suite;
+    if (chunknum) {
+        p->chunkval = *chunknum;
+        p->chunknum = &p->chunkval;
+    }
+
+    return p;
+}
+
+// frees memory of a prefix unless it is part of the prefix's own block
+static void
+ccnl_prefix_release(struct ccnl_prefix_s *p, void *ptr)
+{
+    uint8_t *start = (uint8_t *) p;
+
+    if ((uint8_t *) ptr < start ||
+            (uint8_t *) ptr >= start + sizeof(*p) + p->inlinelen) {
+        ccnl_free(ptr);
+    }
+}
+
 void
 ccnl_prefix_free(struct ccnl_prefix_s *p)
 {
-    ccnl_free(p->bytes);
-    ccnl_free(p->comp);
-    ccnl_free(p->complen);
-    ccnl_free(p->chunknum);
+    ccnl_prefix_release(p, p->bytes);
+    ccnl_prefix_release(p, p->comp);
+    ccnl_prefix_release(p, p->complen);
+    ccnl_prefix_release(p, p->comphash);
+    ccnl_prefix_release(p, p->chunknum);
     ccnl_free(p);
 }
 
+void
+ccnl_prefix_copy_hashes(struct ccnl_prefix_s *dst, struct ccnl_prefix_s *src)
+{
+    uint32_t cnt = src->hashcnt;
+
+    if (!dst->comphash || !src->comphash) {
+        return;
+    }
+    if (cnt > src->compcnt) {
+        cnt = src->compcnt;
+    }
+    if (cnt > dst->compcnt) {
+        cnt = dst->compcnt;
+    }
+    memcpy(dst->comphash, src->comphash, cnt * sizeof(uint32_t));
+    dst->hashcnt = cnt;
+}
+
 struct ccnl_prefix_s*
 ccnl_prefix_dup(struct ccnl_prefix_s *prefix)
 {
@@ -78,20 +142,12 @@ ccnl_prefix_dup(struct ccnl_prefix_s *prefix)
     size_t len;
     struct ccnl_prefix_s *p;
 
-    p = ccnl_prefix_new(prefix->suite, prefix->compcnt);
-    if (!p){
-        return NULL;
-    }
-
-    p->compcnt = prefix->compcnt;
-    p->chunknum = prefix->chunknum;
-
     for (i = 0, len = 0; i < prefix->compcnt; i++) {
         len += prefix->complen[i];
     }
-    p->bytes = (unsigned char*) ccnl_malloc(len);
-    if (!p->bytes) {
-        ccnl_prefix_free(p);
+    p = ccnl_prefix_new_compact(prefix->suite, prefix->compcnt, len,
+                                prefix->chunknum);
+    if (!p){
         return NULL;
     }
 
@@ -101,11 +157,7 @@ ccnl_prefix_dup(struct ccnl_prefix_s *prefix)
         memcpy(p->bytes + len, prefix->comp[i], p->complen[i]);
         len += p->complen[i];
     }
-
-    if (prefix->chunknum) {
-        p->chunknum = (uint32_t *) ccnl_malloc(sizeof(uint32_t));
-        *p->chunknum = *prefix->chunknum;
-    }
+    ccnl_prefix_copy_hashes(p, prefix);
 
     return p;
 }
@@ -118,6 +170,7 @@ ccnl_prefix_appendCmp(struct ccnl_prefix_s *prefix, uint8_t *cmp,
     size_t *oldcomplen = prefix->complen;
     uint8_t **oldcomp = prefix->comp;
     uint8_t *oldbytes = prefix->bytes;
+    uint32_t *oldcomphash = prefix->comphash;
 
     size_t prefixlen = 0;
 
@@ -141,31 +194,46 @@ ccnl_prefix_appendCmp(struct ccnl_prefix_s *prefix, uint8_t *cmp,
         prefix->complen = oldcomplen;
         return -1;
     }
+    prefix->comphash = (uint32_t *) ccnl_malloc(prefix->compcnt * sizeof(uint32_t));
     prefix->bytes = (uint8_t *) ccnl_malloc(prefixlen + cmplen);
-    if (!prefix->bytes) {
+    if (!prefix->bytes || !prefix->comphash) {
         ccnl_free(prefix->comp);
         ccnl_free(prefix->complen);
+        ccnl_free(prefix->comphash);
+        ccnl_free(prefix->bytes);
         prefix->comp = oldcomp;
         prefix->complen = oldcomplen;
+        prefix->comphash = oldcomphash;
         prefix->bytes = oldbytes;
         return -1;
     }
 
-    memcpy(prefix->bytes, oldbytes, prefixlen);
-    memcpy(prefix->bytes + prefixlen, cmp, cmplen);
-
+    // the components need not be in oldbytes, e.g. if they point into a packet
     prefixlen = 0;
     for (i = 0; i < lastcmp; i++) {
         prefix->comp[i] = &prefix->bytes[prefixlen];
         prefix->complen[i] = oldcomplen[i];
+        memcpy(prefix->comp[i], oldcomp[i], oldcomplen[i]);
         prefixlen += oldcomplen[i];
     }
+    memcpy(prefix->bytes + prefixlen, cmp, cmplen);
     prefix->comp[lastcmp] = &prefix->bytes[prefixlen];
     prefix->complen[lastcmp] = cmplen;
 
-    ccnl_free(oldcomp);
-    ccnl_free(oldcomplen);
-    ccnl_free(oldbytes);
+    // the hashes of the components before the new one stay valid
+    if (prefix->hashcnt > lastcmp) {
+        prefix->hashcnt = lastcmp;
+    }
+    if (oldcomphash) {
+        memcpy(prefix->comphash, oldcomphash, prefix->hashcnt * sizeof(uint32_t));
+    } else {
+        prefix->hashcnt = 0;
+    }
+
+    ccnl_prefix_release(prefix, oldcomphash);
+    ccnl_prefix_release(prefix, oldcomp);
+    ccnl_prefix_release(prefix, oldcomplen);
+    ccnl_prefix_release(prefix, oldbytes);
 
     return 0;
 }
@@ -199,7 +267,7 @@ ccnl_prefix_addChunkNum(struct ccnl_prefix_s *prefix, uint32_t chunknum)
             }
             *prefix->chunknum = chunknum;
             if (oldchunknum) {
-                ccnl_free(oldchunknum);
+                ccnl_prefix_release(prefix, oldchunknum);
             }
         }
         break;
@@ -225,7 +293,7 @@ ccnl_prefix_addChunkNum(struct ccnl_prefix_s *prefix, uint32_t chunknum)
             }
             *prefix->chunknum = chunknum;
             if (oldchunknum) {
-                ccnl_free(oldchunknum);
+                ccnl_prefix_release(prefix, oldchunknum);
             }
         }
         break;
@@ -321,11 +389,6 @@ ccnl_URItoPrefix(char* uri, int suite, uint32_t *chunknum)
         cnt = 0U;
     }
 
-    p = ccnl_prefix_new(suite, cnt);
-    if (!p) {
-        return NULL;
-    }
-
     for (i = 0, len = 0; i < cnt; i++) {
         len += complens[i];
     }
@@ -335,9 +398,8 @@ ccnl_URItoPrefix(char* uri, int suite, uint32_t *chunknum)
     }
 #endif
 
-    p->bytes = (unsigned char*) ccnl_malloc(len);
-    if (!p->bytes) {
-        ccnl_prefix_free(p);
+    p = ccnl_prefix_new_compact((char) suite, cnt, len, chunknum);
+    if (!p) {
         return NULL;
     }
 
@@ -351,18 +413,40 @@ ccnl_URItoPrefix(char* uri, int suite, uint32_t *chunknum)
         len += tlen;
     }
 
-    p->compcnt = cnt;
+    return p;
+}
 
-    if (chunknum) {
-        p->chunknum = (uint32_t*) ccnl_malloc(sizeof(uint32_t));
-        if (!p->chunknum) {
-            ccnl_prefix_free(p);
-            return NULL;
+uint32_t
+ccnl_prefix_hash(struct ccnl_prefix_s *pfx, uint32_t compcnt)
+{
+    uint32_t h = CCNL_HASH_INIT, i = 0;
+    uint8_t suite = (uint8_t) pfx->suite;
+
+    if (compcnt > pfx->compcnt) {
+        compcnt = pfx->compcnt;
+    }
+    // continue after the longest prefix hashed before
+    if (pfx->comphash) {
+        if (pfx->hashcnt > pfx->compcnt) {
+            pfx->hashcnt = pfx->compcnt;
+        }
+        i = pfx->hashcnt < compcnt ? pfx->hashcnt : compcnt;
+        if (i > 0) {
+            h = pfx->comphash[i - 1];
         }
-        *p->chunknum = *chunknum;
     }
+    for (; i < compcnt; i++) {
+        uint32_t len = (uint32_t) pfx->complen[i];
 
-    return p;
+        // mix in the length so that component boundaries are significant
+        h = ccnl_hash_bytes(h, (uint8_t*) &len, sizeof(len));
+        h = ccnl_hash_bytes(h, pfx->comp[i], pfx->complen[i]);
+        if (pfx->comphash) {
+            pfx->comphash[i] = h;
+            pfx->hashcnt = i + 1;
+        }
+    }
+    return ccnl_hash_bytes(h, &suite, 1);
 }
 
 #ifdef NEEDS_PREFIX_MATCHING
@@ -416,6 +500,21 @@ ccnl_prefix_cmp(struct ccnl_prefix_s *pfx, unsigned char *md,
                 goto done;
             }
         }
+        // names whose components were hashed before differ if the hashes
+        // do, and are equal if their encodings are
+        if (!md && plen > 0 && pfx->comphash && nam->comphash &&
+            pfx->hashcnt >= plen && nam->hashcnt >= plen) {
+            if (pfx->comphash[plen - 1] != nam->comphash[plen - 1]) {
+                DEBUGMSG(VERBOSE, "hash mismatch\n");
+                goto done;
+            }
+            if (pfx->suite == nam->suite && pfx->nameptr && nam->nameptr &&
+                pfx->namelen == nam->namelen &&
+                !memcmp(pfx->nameptr, nam->nameptr, pfx->namelen)) {
+                rc = 0;
+                goto done;
+            }
+        }
     }
 
     for (i = 0; i < plen && i < nam->compcnt; ++i) {
@@ -598,7 +697,7 @@ ccnl_prefix_to_str_detailed(struct ccnl_prefix_s *pr, int ccntlv_skip, int escap
 char*
 ccnl_prefix_to_path(struct ccnl_prefix_s *pr)
 {
-    static char prefix_buf[4096];
+    static CCNL_THREAD_LOCAL char prefix_buf[4096];
     int len= 0, i;
     int result;
 
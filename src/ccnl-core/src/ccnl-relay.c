@@ -45,6 +45,146 @@ static ccnl_cache_strategy_func _cs_remove_func = NULL;
  */
 static ccnl_cache_strategy_func _cs_decision_func = NULL;
 
+// faces are indexed by their interface and the address fields of their peer
+static uint32_t
+ccnl_face_hash(int ifndx, sockunion *peer)
+{
+    return ccnl_hash_bytes(ccnl_addr_hash(peer), (uint8_t*) &ifndx, sizeof(ifndx));
+}
+
+#ifdef CCNL_ENTRY_TIMERS
+static void
+ccnl_face_set_timer(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f);
+
+// last_used is refreshed by every packet, the timer is only moved when
+// it fires before the face has been idle for CCNL_FACE_TIMEOUT
+static void
+ccnl_face_timeout(void *relay, void *ptr)
+{
+    struct ccnl_face_s *f = (struct ccnl_face_s*) ptr;
+
+    f->timer = NULL;
+    if (!(f->flags & CCNL_FACE_FLAGS_STATIC) &&
+        (f->last_used + CCNL_FACE_TIMEOUT) <= (uint32_t) CCNL_NOW()) {
+        DEBUGMSG_CORE(TRACE, "AGING: FACE REMOVE %p\n", (void*) f);
+        ccnl_face_remove((struct ccnl_relay_s*) relay, f);
+        return;
+    }
+    ccnl_face_set_timer((struct ccnl_relay_s*) relay, f);
+}
+
+static void
+ccnl_face_set_timer(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f)
+{
+    double idle = CCNL_NOW() - f->last_used;
+    uint64_t usec = 0;
+
+    if (f->flags & CCNL_FACE_FLAGS_STATIC) {
+        idle = 0;
+    }
+    if (idle < CCNL_FACE_TIMEOUT) {
+        usec = (uint64_t) ((CCNL_FACE_TIMEOUT - idle) * 1000000);
+    }
+    f->timer = ccnl_set_timer(usec, ccnl_face_timeout, ccnl, f);
+}
+
+static void
+ccnl_content_set_timer(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c,
+                       uint64_t now);
+
+static void
+ccnl_content_timeout(void *relay, void *ptr)
+{
+    struct ccnl_content_s *c = (struct ccnl_content_s*) ptr;
+    uint64_t now = ccnl_time_usec();
+
+    c->timer = NULL;
+    if (c->flags & CCNL_CONTENT_FLAGS_STATIC) {
+        return;
+    }
+    if (c->expires <= now) {
+        DEBUGMSG_CORE(TRACE, "AGING: CONTENT REMOVE %p\n", (void*) c);
+        ccnl_content_remove((struct ccnl_relay_s*) relay, c);
+        return;
+    }
+    ccnl_content_set_timer((struct ccnl_relay_s*) relay, c, now);
+}
+
+// marks the content stale if its freshness period is over and arms the
+// timer for whatever comes next, staleness or removal
+static void
+ccnl_content_set_timer(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c,
+                       uint64_t now)
+{
+    uint64_t due = c->expires;
+
+    if (c->stale && c->stale <= now) {
+        c->flags |= CCNL_CONTENT_FLAGS_STALE;
+        c->stale = 0;
+    }
+    if (c->stale && c->stale < due) {
+        due = c->stale;
+    }
+    c->timer = ccnl_set_timer(due > now ? due - now : 0,
+                              ccnl_content_timeout, ccnl, c);
+}
+
+static void
+ccnl_interest_timeout(void *relay, void *ptr)
+{
+    struct ccnl_interest_s *i = (struct ccnl_interest_s*) ptr;
+    char s[CCNL_MAX_PREFIX_SIZE];
+    (void) s;
+
+    i->timer = NULL;
+    // CONFORM: "Entries in the PIT MUST timeout rather than being held
+    // indefinitely."
+    if (i->expires <= ccnl_time_usec() ||
+        i->retries >= CCNL_MAX_INTEREST_RETRANSMIT) {
+        DEBUGMSG_CORE(TRACE, "AGING: REMOVE INTEREST %p\n", (void*) i);
+        DEBUGMSG_CORE(DEBUG, " timeout: remove interest 0x%p <%s>\n", (void*) i,
+                      ccnl_prefix_to_str(i->pkt->pfx, s, CCNL_MAX_PREFIX_SIZE));
+        ccnl_interest_remove((struct ccnl_relay_s*) relay, i);
+        return;
+    }
+    // CONFORM: "A node MUST retransmit Interest Messages periodically for
+    // pending PIT entries."
+    DEBUGMSG_CORE(DEBUG, " retransmit %d <%s>\n", i->retries,
+                  ccnl_prefix_to_str(i->pkt->pfx, s, CCNL_MAX_PREFIX_SIZE));
+    ccnl_interest_propagate((struct ccnl_relay_s*) relay, i);
+    i->retries++;
+    ccnl_interest_set_timer((struct ccnl_relay_s*) relay, i);
+}
+
+void
+ccnl_interest_set_timer(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
+{
+    uint64_t now = ccnl_time_usec();
+    uint64_t usec = (uint64_t) CCNL_INTEREST_RETRANS_TIMEOUT * 1000;
+
+    if (i->expires < now + usec) {
+        usec = i->expires > now ? i->expires - now : 0;
+    }
+    i->timer = ccnl_set_timer(usec, ccnl_interest_timeout, ccnl, i);
+}
+#endif // CCNL_ENTRY_TIMERS
+
+struct ccnl_face_s*
+ccnl_face_lookup(struct ccnl_relay_s *ccnl, int ifndx, sockunion *peer)
+{
+    struct ccnl_hnode_s *n;
+    struct ccnl_face_s *f;
+
+    for (n = ccnl_htable_lookup(&ccnl->face_index, ccnl_face_hash(ifndx, peer));
+         n; n = ccnl_htable_next(n)) {
+        f = CCNL_HTABLE_ENTRY(n, struct ccnl_face_s, hnode);
+        if (f->ifndx == ifndx && !ccnl_addr_cmp(&f->peer, peer)) {
+            return f;
+        }
+    }
+    return NULL;
+}
+
 struct ccnl_face_s*
 ccnl_get_face_or_create(struct ccnl_relay_s *ccnl, int ifndx,
                         struct sockaddr *sa, size_t addrlen)
@@ -52,21 +192,21 @@ ccnl_get_face_or_create(struct ccnl_relay_s *ccnl, int ifndx,
 // sa!=NULL && ifndx==-1: search suitable interface for given sa_family
 // sa!=NULL && ifndx!=-1: use this (incoming) interface for outgoing
 {
-    static int seqno;
+    static CCNL_THREAD_LOCAL int seqno;
     int i;
     struct ccnl_face_s *f;
 
     DEBUGMSG_CORE(TRACE, "ccnl_get_face_or_create src=%s\n",
              ccnl_addr2ascii((sockunion*)sa));
 
-    for (f = ccnl->faces; f; f = f->next) {
-        if (!sa) {
+    if (!sa) {
+        for (f = ccnl->faces; f; f = f->next) {
             if (f->ifndx == -1)
                 return f;
-            continue;
         }
-        if (ifndx != -1 && (f->ifndx == ifndx) &&
-            !ccnl_addr_cmp(&f->peer, (sockunion*)sa)) {
+    } else if (ifndx != -1) {
+        f = ccnl_face_lookup(ccnl, ifndx, (sockunion*)sa);
+        if (f) {
             f->last_used = CCNL_NOW();
 #ifdef CCNL_RIOT
             ccnl_evtimer_reset_face_timeout(f);
@@ -90,7 +230,7 @@ ccnl_get_face_or_create(struct ccnl_relay_s *ccnl, int ifndx,
     DEBUGMSG_CORE(VERBOSE, "  found suitable interface %d for %s\n", ifndx,
                 ccnl_addr2ascii((sockunion*)sa));
 
-    f = (struct ccnl_face_s *) ccnl_calloc(1, sizeof(struct ccnl_face_s));
+    f = (struct ccnl_face_s *) ccnl_obj_calloc(CCNL_MEM_FACE, sizeof(struct ccnl_face_s));
     if (!f) {
         DEBUGMSG_CORE(VERBOSE, "  no memory for face\n");
         return NULL;
@@ -109,6 +249,9 @@ ccnl_get_face_or_create(struct ccnl_relay_s *ccnl, int ifndx,
         if (ccnl->ifs[ifndx].fwdalli) {
             f->flags |= CCNL_FACE_FLAGS_FWDALLI;
         }
+        if (ccnl->ifs[ifndx].push) {
+            f->flags |= CCNL_FACE_FLAGS_PUSH;
+        }
     }
 
     if (sa) {
@@ -116,11 +259,21 @@ ccnl_get_face_or_create(struct ccnl_relay_s *ccnl, int ifndx,
     } else {  // local client
         f->ifndx = -1;
     }
+    if (ccnl_htable_insert(&ccnl->face_index, &f->hnode,
+                           ccnl_face_hash(f->ifndx, &f->peer))) {
+        DEBUGMSG_CORE(VERBOSE, "  no memory for face index\n");
+        ccnl_sched_destroy(f->sched);
+        ccnl_free(f);
+        return NULL;
+    }
     f->last_used = CCNL_NOW();
     DBL_LINKED_LIST_ADD(ccnl->faces, f);
 
     TRACEOUT();
 
+#ifdef CCNL_ENTRY_TIMERS
+    ccnl_face_set_timer(ccnl, f);
+#endif
 #ifdef CCNL_RIOT
     ccnl_evtimer_reset_face_timeout(f);
 #endif
@@ -133,52 +286,45 @@ ccnl_face_remove(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f)
 {
     struct ccnl_face_s *f2;
     struct ccnl_interest_s *pit;
-    struct ccnl_forward_s **ppfwd;
 
     DEBUGMSG_CORE(DEBUG, "face_remove relay=%p face=%p\n",
              (void*)ccnl, (void*)f);
 
+#ifdef CCNL_ENTRY_TIMERS
+    ccnl_rem_timer(f->timer);
+#endif
     ccnl_sched_destroy(f->sched);
 #ifdef USE_FRAG
     ccnl_frag_destroy(f->frag);
 #endif
     DEBUGMSG_CORE(TRACE, "face_remove: cleaning PIT\n");
-    for (pit = ccnl->pit; pit; ) {
-        struct ccnl_pendint_s **ppend, *pend;
-        if (pit->from == f) {
-            pit->from = NULL;
-        }
-        for (ppend = &pit->pending; *ppend;) {
-            if ((*ppend)->face == f) {
-                pend = *ppend;
-                *ppend = pend->next;
-                ccnl_free(pend);
-            } else {
-                ppend = &(*ppend)->next;
-            }
-        }
-        if (pit->pending) {
-            pit = pit->next;
-        } else {
+    while (f->pit) {
+        pit = f->pit;
+        FACE_LIST_REMOVE(pit);
+        pit->from = NULL;
+    }
+    while (f->pendints) {
+        struct ccnl_pendint_s **ppend, *pend = f->pendints;
+
+        pit = pend->interest;
+        FACE_LIST_REMOVE(pend);
+        for (ppend = &pit->pending; *ppend != pend; ppend = &(*ppend)->next);
+        *ppend = pend->next;
+        ccnl_free(pend);
+        if (!pit->pending) {
             DEBUGMSG_CORE(TRACE, "before interest_remove 0x%p\n",
                           (void*)pit);
-            pit = ccnl_interest_remove(ccnl, pit);
+            ccnl_interest_remove(ccnl, pit);
         }
     }
     DEBUGMSG_CORE(TRACE, "face_remove: cleaning fwd table\n");
-    for (ppfwd = &ccnl->fib; *ppfwd;) {
-        if ((*ppfwd)->face == f) {
-            struct ccnl_forward_s *pfwd = *ppfwd;
-            ccnl_prefix_free(pfwd->prefix);
-            *ppfwd = pfwd->next;
-            ccnl_free(pfwd);
-        } else {
-            ppfwd = &(*ppfwd)->next;
-        }
+    while (f->fib) {
+        ccnl_forward_remove(ccnl, f->fib);
     }
     DEBUGMSG_CORE(TRACE, "face_remove: cleaning pkt queue\n");
     while (f->outq) {
-        struct ccnl_buf_s *tmp = f->outq->next;
+        struct ccnl_outq_s *tmp = f->outq->next;
+        ccnl_buf_free(f->outq->buf);
         ccnl_free(f->outq);
         f->outq = tmp;
     }
@@ -187,6 +333,7 @@ ccnl_face_remove(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f)
     f2 = f->next;
     DEBUGMSG_CORE(TRACE, "face_remove: unlinking2\n");
     DBL_LINKED_LIST_REMOVE(ccnl->faces, f);
+    ccnl_htable_remove(&ccnl->face_index, &f->hnode);
     DEBUGMSG_CORE(TRACE, "face_remove: unlinking3\n");
     ccnl_free(f);
 
@@ -211,7 +358,7 @@ ccnl_interface_enqueue(void (tx_done)(void*, int, int), struct ccnl_face_s *f,
         if (ifc->qlen >= CCNL_MAX_IF_QLEN) {
             if (buf) {
                 DEBUGMSG_CORE(WARNING, "  DROPPING buf=%p\n", (void*)buf); 
-                ccnl_free(buf); 
+                ccnl_buf_free(buf); 
                 return;
             }
         }
@@ -226,7 +373,14 @@ ccnl_interface_enqueue(void (tx_done)(void*, int, int), struct ccnl_face_s *f,
 #ifdef USE_SCHEDULER
         ccnl_sched_RTS(ifc->sched, 1, buf->datalen, ccnl, ifc);
 #else 
-        ccnl_interface_CTS(ccnl, ifc);
+        if (ccnl->tx_batch > 1 && ccnl->ccnl_ll_TX_batch_ptr) {
+            // the event loop flushes the rest at the end of its round
+            if (ifc->qlen >= (size_t) ccnl->tx_batch) {
+                ccnl_interface_flush(ccnl, ifc);
+            }
+        } else {
+            ccnl_interface_CTS(ccnl, ifc);
+        }
 #endif
     }
 }
@@ -234,6 +388,7 @@ ccnl_interface_enqueue(void (tx_done)(void*, int, int), struct ccnl_face_s *f,
 struct ccnl_buf_s*
 ccnl_face_dequeue(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f)
 {
+    struct ccnl_outq_s *q;
     struct ccnl_buf_s *pkt;
     DEBUGMSG_CORE(TRACE, "dequeue face=%p (id=%d.%d)\n",
              (void *) f, ccnl->id, f->faceid);
@@ -241,12 +396,13 @@ ccnl_face_dequeue(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f)
     if (!f->outq) {
         return NULL;
     }
-    pkt = f->outq;
-    f->outq = pkt->next;
-    if (!pkt->next) {
+    q = f->outq;
+    f->outq = q->next;
+    if (!q->next) {
         f->outqend = NULL;
     }
-    pkt->next = NULL;
+    pkt = q->buf;
+    ccnl_free(q);
     return pkt;
 }
 
@@ -299,14 +455,16 @@ int
 ccnl_send_pkt(struct ccnl_relay_s *ccnl, struct ccnl_face_s *to,
                 struct ccnl_pkt_s *pkt)
 {
-    return ccnl_face_enqueue(ccnl, to, buf_dup(pkt->buf));
+    // the queue shares the packet's buffer instead of copying it
+    return ccnl_face_enqueue(ccnl, to, ccnl_buf_ref(pkt->buf));
 }
 
 int
 ccnl_face_enqueue(struct ccnl_relay_s *ccnl, struct ccnl_face_s *to,
                  struct ccnl_buf_s *buf)
 {
-    struct ccnl_buf_s *msg;
+    struct ccnl_outq_s *msg;
+    uint32_t hash;
     if (buf == NULL) {
         DEBUGMSG_CORE(ERROR, "enqueue face: buf most not be NULL\n");
         return -1;
@@ -314,20 +472,40 @@ ccnl_face_enqueue(struct ccnl_relay_s *ccnl, struct ccnl_face_s *to,
     DEBUGMSG_CORE(TRACE, "enqueue face=%p (id=%d.%d) buf=%p len=%zd\n",
              (void*) to, ccnl->id, to->faceid, (void*) buf, buf ? buf->datalen : 0);
 
-    for (msg = to->outq; msg; msg = msg->next) { // already in the queue?
-        if (buf_equal(msg, buf)) {
+#ifndef USE_SCHEDULER
+    // nothing queued and nothing to fragment: hand the buffer straight to
+    // the interface instead of going through a queue entry
+    if (!to->outq && (!to->frag || to->frag->protocol == CCNL_FRAG_NONE)) {
+        ccnl_interface_enqueue(ccnl_face_CTS_done, to,
+                               ccnl, ccnl->ifs + to->ifndx, buf, &to->peer);
+        return 0;
+    }
+#endif
+
+    // already in the queue? Shared buffers compare by identity, the bytes
+    // are only compared when the hashes match
+    hash = to->outq ? ccnl_buf_hash(buf) : 0;
+    for (msg = to->outq; msg; msg = msg->next) {
+        if (msg->buf == buf || (ccnl_buf_hash(msg->buf) == hash &&
+                                buf_equal(msg->buf, buf))) {
             DEBUGMSG_CORE(VERBOSE, "    not enqueued because already there\n");
-            ccnl_free(buf);
+            ccnl_buf_free(buf);
             return -1;
         }
     }
-    buf->next = NULL;
+    msg = (struct ccnl_outq_s *) ccnl_malloc(sizeof(*msg));
+    if (!msg) {
+        ccnl_buf_free(buf);
+        return -1;
+    }
+    msg->next = NULL;
+    msg->buf = buf;
     if (to->outqend) {
-        to->outqend->next = buf;
+        to->outqend->next = msg;
     } else {
-        to->outq = buf;
+        to->outq = msg;
     }
-    to->outqend = buf;
+    to->outqend = msg;
 #ifdef USE_SCHEDULER
     if (to->sched) {
 #ifdef USE_FRAG
@@ -357,20 +535,26 @@ ccnl_interest_remove(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
 */
     DEBUGMSG_CORE(TRACE, "ccnl_interest_remove %p\n", (void *) i);
 
+#ifdef CCNL_ENTRY_TIMERS
+    ccnl_rem_timer(i->timer);
+#endif
 #ifdef CCNL_RIOT
     ccnl_riot_interest_remove((evtimer_t *)(&ccnl_evtimer), i);
 #endif
 
     while (i->pending) {
         struct ccnl_pendint_s *tmp = i->pending->next;          \
+        FACE_LIST_REMOVE(i->pending);
         ccnl_free(i->pending);
         i->pending = tmp;
     }
+    FACE_LIST_REMOVE(i);
     i2 = i->next;
 
     ccnl->pitcnt--;
 
     DBL_LINKED_LIST_REMOVE(ccnl->pit, i);
+    ccnl_htable_remove(&ccnl->pit_index, &i->hnode);
 
     if (i->pkt) {
         ccnl_pkt_free(i->pkt);
@@ -385,6 +569,8 @@ void
 ccnl_interest_propagate(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
 {
     struct ccnl_forward_s *fwd;
+    struct ccnl_hnode_s *n;
+    uint32_t len, cnt;
     int rc = 0;
     char s[CCNL_MAX_PREFIX_SIZE];
     (void) s;
@@ -402,54 +588,65 @@ ccnl_interest_propagate(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
     // transmit an Interest Message on all listed dest faces in sequence."
     // CCNL strategy: we forward on all FWD entries with a prefix match
 
-    for (fwd = ccnl->fib; fwd; fwd = fwd->next) {
-        if (!fwd->prefix) {
-            continue;
-        }
+    if (!i->pkt->pfx) {
+        return;
+    }
 
-        //Only for matching suite
-        if (!i->pkt->pfx || fwd->suite != i->pkt->pfx->suite) {
-            DEBUGMSG_CORE(VERBOSE, "  not same suite (%d/%d)\n",
-                     fwd->suite, i->pkt->pfx ? i->pkt->pfx->suite : -1);
-            continue;
-        }
+    // probe the prefix index once per prefix length, longest first
+    for (len = 0; len <= i->pkt->pfx->compcnt; len++) {
+        cnt = i->pkt->pfx->compcnt - len;
+        for (n = ccnl_htable_lookup(&ccnl->fib_index,
+                                    ccnl_prefix_hash(i->pkt->pfx, cnt));
+             n; n = ccnl_htable_next(n)) {
+            fwd = CCNL_HTABLE_ENTRY(n, struct ccnl_forward_s, hnode);
+            if (!fwd->prefix || fwd->prefix->compcnt != cnt) {
+                continue;
+            }
 
-        rc = ccnl_prefix_cmp(fwd->prefix, NULL, i->pkt->pfx, CMP_LONGEST);
+            //Only for matching suite
+            if (fwd->suite != i->pkt->pfx->suite) {
+                DEBUGMSG_CORE(VERBOSE, "  not same suite (%d/%d)\n",
+                         fwd->suite, i->pkt->pfx->suite);
+                continue;
+            }
 
-        DEBUGMSG_CORE(DEBUG, "  ccnl_interest_propagate, rc=%ld/%ld\n",
-                 (long) rc, (long) fwd->prefix->compcnt);
-        if (rc < (signed) fwd->prefix->compcnt) {
-            continue;
-        }
+            rc = ccnl_prefix_cmp(fwd->prefix, NULL, i->pkt->pfx, CMP_LONGEST);
 
-        DEBUGMSG_CORE(DEBUG, "  ccnl_interest_propagate, fwd==%p\n", (void*)fwd);
-        // suppress forwarding to origin of interest, except wireless
-        if (!i->from || fwd->face != i->from ||
-                                (i->from->flags & CCNL_FACE_FLAGS_REFLECT)) {
-            int nonce = 0;
-            if (i->pkt != NULL && i->pkt->s.ndntlv.nonce != NULL) {
-                if (i->pkt->s.ndntlv.nonce->datalen == 4) {
-                    memcpy(&nonce, i->pkt->s.ndntlv.nonce->data, 4);
-                }
+            DEBUGMSG_CORE(DEBUG, "  ccnl_interest_propagate, rc=%ld/%ld\n",
+                     (long) rc, (long) fwd->prefix->compcnt);
+            if (rc < (signed) fwd->prefix->compcnt) {
+                continue;
             }
 
-            DEBUGMSG_CFWD(INFO, "  outgoing interest=<%s> nonce=%i to=%s\n",
-                          ccnl_prefix_to_str(i->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE), nonce,
-                          fwd->face ? ccnl_addr2ascii(&fwd->face->peer)
-                                    : "<tap>");
+            DEBUGMSG_CORE(DEBUG, "  ccnl_interest_propagate, fwd==%p\n", (void*)fwd);
+            // suppress forwarding to origin of interest, except wireless
+            if (!i->from || fwd->face != i->from ||
+                                    (i->from->flags & CCNL_FACE_FLAGS_REFLECT)) {
+                int nonce = 0;
+                if (i->pkt != NULL && i->pkt->s.ndntlv.nonce != NULL) {
+                    if (i->pkt->s.ndntlv.nonce->datalen == 4) {
+                        memcpy(&nonce, i->pkt->s.ndntlv.nonce->data, 4);
+                    }
+                }
 
-            // DEBUGMSG(DEBUG, "%p %p %p\n", (void*)i, (void*)i->pkt, (void*)i->pkt->buf);
-            if (fwd->tap) {
-                (fwd->tap)(ccnl, i->from, i->pkt->pfx, i->pkt->buf);
-            }
-            if (fwd->face) {
-                ccnl_send_pkt(ccnl, fwd->face, i->pkt);
-            }
+                DEBUGMSG_CFWD(INFO, "  outgoing interest=<%s> nonce=%i to=%s\n",
+                              ccnl_prefix_to_str(i->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE), nonce,
+                              fwd->face ? ccnl_addr2ascii(&fwd->face->peer)
+                                        : "<tap>");
+
+                // DEBUGMSG(DEBUG, "%p %p %p\n", (void*)i, (void*)i->pkt, (void*)i->pkt->buf);
+                if (fwd->tap) {
+                    (fwd->tap)(ccnl, i->from, i->pkt->pfx, i->pkt->buf);
+                }
+                if (fwd->face) {
+                    ccnl_send_pkt(ccnl, fwd->face, i->pkt);
+                }
 #if defined(USE_RONR)
-            matching_face = 1;
+                matching_face = 1;
 #endif
-        } else {
-            DEBUGMSG_CORE(DEBUG, "  no matching fib entry found\n");
+            } else {
+                DEBUGMSG_CORE(DEBUG, "  no matching fib entry found\n");
+            }
         }
     }
 
@@ -530,13 +727,19 @@ ccnl_content_remove(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
     struct ccnl_content_s *c2;
     DEBUGMSG_CORE(TRACE, "ccnl_content_remove\n");
 
+#ifdef CCNL_ENTRY_TIMERS
+    ccnl_rem_timer(c->timer);
+#endif
     c2 = c->next;
     DBL_LINKED_LIST_REMOVE(ccnl->contents, c);
+    ccnl_htable_remove(&ccnl->cs_index, &c->hnode);
+    ccnl_cache_remove(ccnl, c);
+    ccnl->cs_bytes -= c->size;
 
 //    free_content(c);
     if (c->pkt) {
         ccnl_prefix_free(c->pkt->pfx);
-        ccnl_free(c->pkt->buf);
+        ccnl_buf_free(c->pkt->buf);
         ccnl_free(c->pkt);
     }
     //    ccnl_prefix_free(c->name);
@@ -549,10 +752,26 @@ ccnl_content_remove(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
     return c2;
 }
 
+struct ccnl_content_s*
+ccnl_content_find(struct ccnl_relay_s *ccnl, struct ccnl_prefix_s *pfx)
+{
+    struct ccnl_hnode_s *n;
+    struct ccnl_content_s *c;
+
+    for (n = ccnl_htable_lookup(&ccnl->cs_index,
+                                ccnl_prefix_hash(pfx, pfx->compcnt));
+                                n; n = ccnl_htable_next(n)) {
+        c = CCNL_HTABLE_ENTRY(n, struct ccnl_content_s, hnode);
+        if (ccnl_prefix_cmp(c->pkt->pfx, NULL, pfx, CMP_EXACT) == 0) {
+            return c;
+        }
+    }
+    return NULL;
+}
+
 struct ccnl_content_s*
 ccnl_content_add2cache(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
 {
-    struct ccnl_content_s *cit;
     char s[CCNL_MAX_PREFIX_SIZE];
     (void) s;
 
@@ -560,41 +779,68 @@ ccnl_content_add2cache(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
                   ccnl->contentcnt, ccnl->max_cache_entries,
                   (void*)c, ccnl_prefix_to_str(c->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE), (c->pkt->pfx->chunknum)? (signed) *(c->pkt->pfx->chunknum) : -1);
 
-    for (cit = ccnl->contents; cit; cit = cit->next) {
-        if (ccnl_prefix_cmp(c->pkt->pfx, NULL, cit->pkt->pfx, CMP_EXACT) == 0) {
-            DEBUGMSG_CORE(DEBUG, "--- Already in cache ---\n");
-            return NULL;
-        }
+    if (ccnl_content_find(ccnl, c->pkt->pfx)) {
+        DEBUGMSG_CORE(DEBUG, "--- Already in cache ---\n");
+        return NULL;
+    }
+
+    c->size = ccnl_content_size(c);
+    if (ccnl->max_cache_bytes && c->size > ccnl->max_cache_bytes) {
+        DEBUGMSG_CORE(DEBUG, "  content exceeds the cache's byte budget, not cached\n");
+        return NULL;
     }
 
+    ccnl_cache_admit(ccnl, c);
     if (ccnl->max_cache_entries > 0 &&
         ccnl->contentcnt >= ccnl->max_cache_entries && !cache_strategy_remove(ccnl, c)) {
-        // remove oldest content
-        struct ccnl_content_s *c2, *oldest = NULL;
-        uint32_t age = 0;
-        for (c2 = ccnl->contents; c2; c2 = c2->next) {
-             if (!(c2->flags & CCNL_CONTENT_FLAGS_STATIC)) {
-                 if ((age == 0) || c2->last_used < age) {
-                     age = c2->last_used;
-                     oldest = c2;
-                 }
-             }
-         }
-         if (oldest) {
-             DEBUGMSG_CORE(DEBUG, " remove old entry from cache\n");
-             ccnl_content_remove(ccnl, oldest);
-         }
-    }
-    if ((ccnl->max_cache_entries <= 0) ||
-         (ccnl->contentcnt <= ccnl->max_cache_entries)) {
+        // let the replacement policy make room
+        ccnl_cache_evict(ccnl);
+    }
+    // the byte budget may need several victims for one large content
+    while (ccnl->max_cache_bytes &&
+           ccnl->cs_bytes + c->size > ccnl->max_cache_bytes) {
+        if (ccnl_cache_evict(ccnl)) {
+            break;
+        }
+    }
+    if (((ccnl->max_cache_entries <= 0) ||
+         (ccnl->contentcnt < ccnl->max_cache_entries)) &&
+        (!ccnl->max_cache_bytes ||
+         (ccnl->cs_bytes + c->size <= ccnl->max_cache_bytes))) {
+            if (ccnl_htable_insert(&ccnl->cs_index, &c->hnode,
+                         ccnl_prefix_hash(c->pkt->pfx, c->pkt->pfx->compcnt))) {
+                DEBUGMSG_CORE(WARNING, "  could not index content, not cached\n");
+                return NULL;
+            }
             DBL_LINKED_LIST_ADD(ccnl->contents, c);
             ccnl->contentcnt++;
+            ccnl->cs_bytes += c->size;
+            ccnl_cache_insert(ccnl, c);
+#ifdef CCNL_ENTRY_TIMERS
+            {
+                uint64_t now = ccnl_time_usec();
+
+                c->expires = now + (uint64_t) CCNL_CONTENT_TIMEOUT * 1000000;
+#ifdef USE_SUITE_NDNTLV
+                // NDN content is fresh for its FreshnessPeriod, in msec
+                if (c->pkt->suite == CCNL_SUITE_NDNTLV) {
+                    c->stale = now + (uint64_t) c->pkt->s.ndntlv.freshnessperiod * 1000;
+                }
+#endif
+                if (!(c->flags & CCNL_CONTENT_FLAGS_STATIC)) {
+                    ccnl_content_set_timer(ccnl, c, now);
+                }
+            }
+#endif
 #ifdef CCNL_RIOT
             /* set cache timeout timer if content is not static */
             if (!(c->flags & CCNL_CONTENT_FLAGS_STATIC)) {
                 ccnl_evtimer_set_cs_timeout(c);
             }
 #endif
+    } else {
+        DEBUGMSG_CORE(DEBUG, "  cache is full, content not cached\n");
+        return NULL;
     }
 
     return c;
@@ -604,114 +850,122 @@ int
 ccnl_content_serve_pending(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
 {
     struct ccnl_interest_s *i;
-    struct ccnl_face_s *f;
+    struct ccnl_hnode_s *n, *next;
+    uint32_t len;
     int cnt = 0;
     DEBUGMSG_CORE(TRACE, "ccnl_content_serve_pending\n");
     char s[CCNL_MAX_PREFIX_SIZE];
 
-    for (f = ccnl->faces; f; f = f->next){
-                f->flags &= ~CCNL_FACE_FLAGS_SERVED; // reply on a face only once
+    // a face is served in this run if its served_seq matches, so that
+    // we reply on a face only once without resetting all faces
+    if (++ccnl->serve_seq == 0) {
+        ++ccnl->serve_seq;
     }
-    for (i = ccnl->pit; i;) {
-        struct ccnl_pendint_s *pi;
-        if (!i->pkt->pfx) {
-            continue;
-        }
 
-        switch (i->pkt->pfx->suite) {
+    // the candidates are the PIT entries indexed under a prefix of the
+    // Data name, probe the index once per prefix length
+    for (len = 0; len <= c->pkt->pfx->compcnt; len++) {
+        n = ccnl_htable_lookup(&ccnl->pit_index,
+                               ccnl_prefix_hash(c->pkt->pfx,
+                                                c->pkt->pfx->compcnt - len));
+        for (; n; n = next) {
+            struct ccnl_pendint_s *pi;
+
+            next = ccnl_htable_next(n);
+            i = CCNL_HTABLE_ENTRY(n, struct ccnl_interest_s, hnode);
+
+            switch (i->pkt->pfx->suite) {
 #ifdef USE_SUITE_CCNB
-        case CCNL_SUITE_CCNB:
-            if (ccnl_i_prefixof_c(i->pkt->pfx, i->pkt->s.ccnb.minsuffix,
-                       i->pkt->s.ccnb.maxsuffix, c) < 0) {
-                // XX must also check i->ppkd
-                i = i->next;
-                continue;
-            }
-            break;
+            case CCNL_SUITE_CCNB:
+                if (ccnl_i_prefixof_c(i->pkt->pfx, i->pkt->s.ccnb.minsuffix,
+                           i->pkt->s.ccnb.maxsuffix, c) < 0) {
+                    // XX must also check i->ppkd
+                    continue;
+                }
+                break;
 #endif
 #ifdef USE_SUITE_CCNTLV
-        case CCNL_SUITE_CCNTLV:
-            if (ccnl_prefix_cmp(c->pkt->pfx, NULL, i->pkt->pfx, CMP_EXACT)) {
-                // XX must also check keyid
-                i = i->next;
-                continue;
-            }
-            break;
+            case CCNL_SUITE_CCNTLV:
+                if (ccnl_prefix_cmp(c->pkt->pfx, NULL, i->pkt->pfx, CMP_EXACT)) {
+                    // XX must also check keyid
+                    continue;
+                }
+                break;
 #endif
 #ifdef USE_SUITE_NDNTLV
-        case CCNL_SUITE_NDNTLV:
-            if (ccnl_i_prefixof_c(i->pkt->pfx, i->pkt->s.ndntlv.minsuffix,
-                    i->pkt->s.ndntlv.maxsuffix, c) < 0) {
-                // XX must also check i->ppkl,
-                i = i->next;
+            case CCNL_SUITE_NDNTLV:
+                if (ccnl_i_prefixof_c(i->pkt->pfx, i->pkt->s.ndntlv.minsuffix,
+                        i->pkt->s.ndntlv.maxsuffix, c) < 0) {
+                    // XX must also check i->ppkl,
+                    continue;
+                }
+                break;
+#endif
+            default:
                 continue;
             }
-            break;
-#endif
-        default:
-            i = i->next;
-            continue;
-        }
-
-        //Hook for add content to cache by callback:
-        if(i && ! i->pending){
-            DEBUGMSG_CORE(WARNING, "releasing interest 0x%p OK?\n", (void*)i);
-            c->flags |= CCNL_CONTENT_FLAGS_STATIC;
-            i = ccnl_interest_remove(ccnl, i);
 
-            c->served_cnt++;
-            cnt++;
-            continue;
-            //return 1;
+            //Hook for add content to cache by callback:
+            if(i && ! i->pending){
+                DEBUGMSG_CORE(WARNING, "releasing interest 0x%p OK?\n", (void*)i);
+                c->flags |= CCNL_CONTENT_FLAGS_STATIC;
+                ccnl_interest_remove(ccnl, i);
 
-        }
-
-        // CONFORM: "Data MUST only be transmitted in response to
-        // an Interest that matches the Data."
-        for (pi = i->pending; pi; pi = pi->next) {
-            if (pi->face->flags & CCNL_FACE_FLAGS_SERVED) {
+                c->served_cnt++;
+                cnt++;
                 continue;
+                //return 1;
+
             }
-            pi->face->flags |= CCNL_FACE_FLAGS_SERVED;
-            if (pi->face->ifndx >= 0) {
-                int32_t nonce = 0;
-                if (i->pkt != NULL && i->pkt->s.ndntlv.nonce != NULL) {
-                    if (i->pkt->s.ndntlv.nonce->datalen == 4) {
-                        memcpy(&nonce, i->pkt->s.ndntlv.nonce->data, 4);
-                    }
+
+            // CONFORM: "Data MUST only be transmitted in response to
+            // an Interest that matches the Data."
+            for (pi = i->pending; pi; pi = pi->next) {
+                if (pi->face->served_seq == ccnl->serve_seq) {
+                    continue;
                 }
+                pi->face->served_seq = ccnl->serve_seq;
+                if (pi->face->ifndx >= 0) {
+                    int32_t nonce = 0;
+                    if (i->pkt != NULL && i->pkt->s.ndntlv.nonce != NULL) {
+                        if (i->pkt->s.ndntlv.nonce->datalen == 4) {
+                            memcpy(&nonce, i->pkt->s.ndntlv.nonce->data, 4);
+                        }
+                    }
 
 #ifndef CCNL_LINUXKERNEL
-                DEBUGMSG_CFWD(INFO, "  outgoing data=<%s>%s nonce=%"PRIi32" to=%s\n",
-                          ccnl_prefix_to_str(i->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE),
-                          ccnl_suite2str(i->pkt->pfx->suite), nonce,
-                          ccnl_addr2ascii(&pi->face->peer));
+                    DEBUGMSG_CFWD(INFO, "  outgoing data=<%s>%s nonce=%"PRIi32" to=%s\n",
+                              ccnl_prefix_to_str(i->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE),
+                              ccnl_suite2str(i->pkt->pfx->suite), nonce,
+                              ccnl_addr2ascii(&pi->face->peer));
 #else
-                DEBUGMSG_CFWD(INFO, "  outgoing data=<%s>%s nonce=%d to=%s\n",
-                          ccnl_prefix_to_str(i->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE),
-                          ccnl_suite2str(i->pkt->pfx->suite), nonce,
-                          ccnl_addr2ascii(&pi->face->peer));
+                    DEBUGMSG_CFWD(INFO, "  outgoing data=<%s>%s nonce=%d to=%s\n",
+                              ccnl_prefix_to_str(i->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE),
+                              ccnl_suite2str(i->pkt->pfx->suite), nonce,
+                              ccnl_addr2ascii(&pi->face->peer));
 #endif
-                DEBUGMSG_CORE(VERBOSE, "    Serve to face: %d (pkt=%p)\n",
-                         pi->face->faceid, (void*) c->pkt);
+                    DEBUGMSG_CORE(VERBOSE, "    Serve to face: %d (pkt=%p)\n",
+                             pi->face->faceid, (void*) c->pkt);
 
-                ccnl_send_pkt(ccnl, pi->face, c->pkt);
+                    ccnl_send_pkt(ccnl, pi->face, c->pkt);
 
 
-            } else {// upcall to deliver content to local client
+                } else {// upcall to deliver content to local client
 #ifdef CCNL_APP_RX
-                ccnl_app_RX(ccnl, c);
+                    ccnl_app_RX(ccnl, c);
 #endif
+                }
+                c->served_cnt++;
+                cnt++;
             }
-            c->served_cnt++;
-            cnt++;
+            ccnl_interest_remove(ccnl, i);
         }
-        i = ccnl_interest_remove(ccnl, i);
     }
 
     return cnt;
 }
 
+#ifndef CCNL_ENTRY_TIMERS
 #define DEBUGMSG_AGEING(trace, debug, buf, buf_len)    \
 DEBUGMSG_CORE(TRACE, "%s %p\n", (trace), (void*) i);   \
 DEBUGMSG_CORE(DEBUG, " %s 0x%p <%s>\n", (debug),       \
@@ -753,7 +1007,7 @@ ccnl_do_ageing(void *ptr, void *dummy)
     }
     while (i) { // CONFORM: "Entries in the PIT MUST timeout rather
                 // than being held indefinitely."
-        if ((i->last_used + i->lifetime) <= (uint32_t) t ||
+        if ((i->last_used + i->lifetime / 1000) <= (uint32_t) t ||
                                 i->retries >= CCNL_MAX_INTEREST_RETRANSMIT) {
                 DEBUGMSG_AGEING("AGING: REMOVE INTEREST", "timeout: remove interest", s, CCNL_MAX_PREFIX_SIZE);
                 i = ccnl_interest_remove(relay, i);
@@ -779,33 +1033,7 @@ ccnl_do_ageing(void *ptr, void *dummy)
         }
     }
 }
-
-int
-ccnl_nonce_find_or_append(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *nonce)
-{
-    struct ccnl_buf_s *n, *n2 = 0;
-    int i;
-    DEBUGMSG_CORE(TRACE, "ccnl_nonce_find_or_append\n");
-
-    for (n = ccnl->nonces, i = 0; n; n = n->next, i++) {
-        if (buf_equal(n, nonce)) {
-            return -1;
-        }
-        if (n->next) {
-            n2 = n;
-        }
-    }
-    n = ccnl_buf_new(nonce->data, nonce->datalen);
-    if (n) {
-        n->next = ccnl->nonces;
-        ccnl->nonces = n;
-        if (i >= CCNL_MAX_NONCES && n2) {
-            ccnl_free(n2->next);
-            n2->next = 0;
-        }
-    }
-    return 0;
-}
+#endif // !CCNL_ENTRY_TIMERS
 
 int
 ccnl_nonce_isDup(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt)
@@ -823,12 +1051,12 @@ ccnl_nonce_isDup(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt)
 #ifdef USE_SUITE_CCNB
     case CCNL_SUITE_CCNB:
         return pkt->s.ccnb.nonce &&
-            ccnl_nonce_find_or_append(relay, pkt->s.ccnb.nonce);
+            ccnl_nonce_find_or_append(relay, pkt->pfx, pkt->s.ccnb.nonce);
 #endif
 #ifdef USE_SUITE_NDNTLV
     case CCNL_SUITE_NDNTLV:
         return pkt->s.ndntlv.nonce &&
-            ccnl_nonce_find_or_append(relay, pkt->s.ndntlv.nonce);
+            ccnl_nonce_find_or_append(relay, pkt->pfx, pkt->s.ndntlv.nonce);
 #endif
     default:
         break;
@@ -836,6 +1064,54 @@ ccnl_nonce_isDup(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt)
     return 0;
 }
 
+int
+ccnl_forward_add(struct ccnl_relay_s *relay, struct ccnl_forward_s *fwd)
+{
+    if (ccnl_htable_insert(&relay->fib_index, &fwd->hnode,
+                           ccnl_prefix_hash(fwd->prefix, fwd->prefix->compcnt))) {
+        return -1;
+    }
+    DBL_LINKED_LIST_ADD(relay->fib, fwd);
+    if (fwd->face) {
+        FACE_LIST_ADD(fwd->face->fib, fwd);
+    }
+    relay->fib_version++;
+    return 0;
+}
+
+struct ccnl_forward_s*
+ccnl_forward_remove(struct ccnl_relay_s *relay, struct ccnl_forward_s *fwd)
+{
+    struct ccnl_forward_s *fwd2 = fwd->next;
+
+    DBL_LINKED_LIST_REMOVE(relay->fib, fwd);
+    ccnl_htable_remove(&relay->fib_index, &fwd->hnode);
+    FACE_LIST_REMOVE(fwd);
+    ccnl_prefix_free(fwd->prefix);
+    ccnl_free(fwd);
+    relay->fib_version++;
+
+    return fwd2;
+}
+
+struct ccnl_forward_s*
+ccnl_forward_find(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx)
+{
+    struct ccnl_hnode_s *n;
+    struct ccnl_forward_s *fwd;
+
+    for (n = ccnl_htable_lookup(&relay->fib_index,
+                                ccnl_prefix_hash(pfx, pfx->compcnt));
+         n; n = ccnl_htable_next(n)) {
+        fwd = CCNL_HTABLE_ENTRY(n, struct ccnl_forward_s, hnode);
+        if (fwd->suite == pfx->suite &&
+                        !ccnl_prefix_cmp(fwd->prefix, NULL, pfx, CMP_EXACT)) {
+            return fwd;
+        }
+    }
+    return NULL;
+}
+
 #ifdef NEEDS_PREFIX_MATCHING
 
 /* add a new entry to the FIB */
@@ -843,35 +1119,37 @@ int
 ccnl_fib_add_entry(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
                    struct ccnl_face_s *face)
 {
-    struct ccnl_forward_s *fwd, **fwd2;
+    struct ccnl_forward_s *fwd;
     char s[CCNL_MAX_PREFIX_SIZE];
     (void) s;
 
     DEBUGMSG_CUTL(INFO, "adding FIB for <%s>, suite %s\n",
              ccnl_prefix_to_str(pfx,s,CCNL_MAX_PREFIX_SIZE), ccnl_suite2str(pfx->suite));
 
-    for (fwd = relay->fib; fwd; fwd = fwd->next) {
-        if (fwd->suite == pfx->suite &&
-                        !ccnl_prefix_cmp(fwd->prefix, NULL, pfx, CMP_EXACT)) {
-            ccnl_prefix_free(fwd->prefix);
-            fwd->prefix = NULL;
-            break;
+    fwd = ccnl_forward_find(relay, pfx);
+    if (fwd) {
+        // same key, the entry stays where it is in the index
+        ccnl_prefix_free(fwd->prefix);
+        fwd->prefix = pfx;
+        FACE_LIST_REMOVE(fwd);
+        fwd->face = face;
+        if (face) {
+            FACE_LIST_ADD(face->fib, fwd);
         }
-    }
-    if (!fwd) {
+        relay->fib_version++;
+    } else {
         fwd = (struct ccnl_forward_s *) ccnl_calloc(1, sizeof(*fwd));
         if (!fwd) {
             return -1;
         }
-        fwd2 = &relay->fib;
-        while (*fwd2) {
-            fwd2 = &((*fwd2)->next);
-        }
-        *fwd2 = fwd;
+        fwd->prefix = pfx;
         fwd->suite = pfx->suite;
+        fwd->face = face;
+        if (ccnl_forward_add(relay, fwd)) {
+            ccnl_free(fwd);
+            return -1;
+        }
     }
-    fwd->prefix = pfx;
-    fwd->face = face;
     DEBUGMSG_CUTL(DEBUG, "added FIB via %s\n", ccnl_addr2ascii(&fwd->face->peer));
 
     return 0;
@@ -883,8 +1161,7 @@ ccnl_fib_rem_entry(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
                    struct ccnl_face_s *face)
 {
     struct ccnl_forward_s *fwd;
-    int res = -1;
-    struct ccnl_forward_s *last = NULL;
+    struct ccnl_hnode_s *n;
     char s[CCNL_MAX_PREFIX_SIZE];
     (void) s;
 
@@ -892,32 +1169,35 @@ ccnl_fib_rem_entry(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
         char *s = NULL;
         DEBUGMSG_CUTL(INFO, "removing FIB for <%s>, suite %s\n",
                       ccnl_prefix_to_str(pfx,s,CCNL_MAX_PREFIX_SIZE), ccnl_suite2str(pfx->suite));
-    }
 
-    for (fwd = relay->fib; fwd; last = fwd, fwd = fwd->next) {
-        if (((pfx == NULL) || (fwd->suite == pfx->suite)) &&
-            ((pfx == NULL) || !ccnl_prefix_cmp(fwd->prefix, NULL, pfx, CMP_EXACT)) &&
-            ((face == NULL) || (fwd->face == face))) {
-            res = 0;
-            if (!last) {
-                relay->fib = fwd->next;
+        n = ccnl_htable_lookup(&relay->fib_index,
+                               ccnl_prefix_hash(pfx, pfx->compcnt));
+        for (; n; n = ccnl_htable_next(n)) {
+            fwd = CCNL_HTABLE_ENTRY(n, struct ccnl_forward_s, hnode);
+            if (fwd->suite == pfx->suite &&
+                !ccnl_prefix_cmp(fwd->prefix, NULL, pfx, CMP_EXACT) &&
+                ((face == NULL) || (fwd->face == face))) {
+                break;
             }
-            else {
-                last->next = fwd->next;
+        }
+        fwd = n ? CCNL_HTABLE_ENTRY(n, struct ccnl_forward_s, hnode) : NULL;
+    } else {
+        for (fwd = relay->fib; fwd; fwd = fwd->next) {
+            if ((face == NULL) || (fwd->face == face)) {
+                break;
             }
-            ccnl_prefix_free(fwd->prefix);
-            ccnl_free(fwd);
-            break;
         }
     }
 
-    if (fwd) {
-        if (fwd->face) {
-            DEBUGMSG_CUTL(DEBUG, "added FIB via %s\n", ccnl_addr2ascii(&fwd->face->peer));
-        }
+    if (!fwd) {
+        return -1;
+    }
+    if (fwd->face) {
+        DEBUGMSG_CUTL(DEBUG, "removed FIB via %s\n", ccnl_addr2ascii(&fwd->face->peer));
     }
+    ccnl_forward_remove(relay, fwd);
 
-    return res;
+    return 0;
 }
 #endif
 
@@ -972,6 +1252,21 @@ ccnl_cs_dump(struct ccnl_relay_s *ccnl)
 #endif
 }
 
+void
+ccnl_interface_flush(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc)
+{
+    if (!ifc->qlen) {
+        return;
+    }
+    if (ccnl->ccnl_ll_TX_batch_ptr) {
+        ccnl->ccnl_ll_TX_batch_ptr(ccnl, ifc);
+        return;
+    }
+    while (ifc->qlen > 0) {
+        ccnl_interface_CTS(ccnl, ifc);
+    }
+}
+
 void
 ccnl_interface_CTS(void *aux1, void *aux2)
 {
@@ -1003,7 +1298,7 @@ ccnl_interface_CTS(void *aux1, void *aux2)
     if (req.txdone)
         req.txdone(req.txdone_face, 1, req.buf->datalen);
 #endif
-    ccnl_free(req.buf);
+    ccnl_buf_free(req.buf);
 }
 
 int
@@ -0,0 +1,171 @@
+/*
+ * @f ccnl-ring.c
+ * @b CCN lite (CCNL), single producer single consumer ring of records
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-17 created
+ */
+
+#ifndef CCNL_LINUXKERNEL
+#include "ccnl-ring.h"
+#include "ccnl-malloc.h"
+#include "ccnl-logging.h"
+#else
+#include "../include/ccnl-ring.h"
+#include "../include/ccnl-malloc.h"
+#include "../include/ccnl-logging.h"
+#endif
+
+// every record starts with this header, records are 8 byte aligned
+struct ccnl_ring_rec_s {
+    uint32_t len;
+    uint32_t tag;
+};
+
+#define CCNL_RING_HDR           ((uint32_t) sizeof(struct ccnl_ring_rec_s))
+#define CCNL_RING_ALIGN(len)    (((uint32_t) (len) + 7) & ~(uint32_t) 7)
+#define CCNL_RING_WRAP          UINT32_MAX  // rest of the buffer is unused
+#define CCNL_RING_MIN_SIZE      64
+
+// the indices are free running, only their low bits address the buffer;
+// the end which publishes an index stores it sequentially consistent so
+// that a producer checking for an empty ring and a consumer checking for
+// new records cannot both miss each other (see ccnl_ring_commit())
+
+int
+ccnl_ring_init(struct ccnl_ring_s *r, size_t size)
+{
+    uint32_t sz = CCNL_RING_MIN_SIZE;
+
+    memset(r, 0, sizeof(*r));
+    if (size > (UINT32_MAX >> 1) + 1) {
+        return -1;
+    }
+    while (sz < size) {
+        sz <<= 1;
+    }
+    r->buf = (uint8_t *) ccnl_malloc(sz);
+    if (!r->buf) {
+        DEBUGMSG(WARNING, "ring: could not allocate %lu bytes\n",
+                 (unsigned long) sz);
+        return -1;
+    }
+    r->size = sz;
+    return 0;
+}
+
+void
+ccnl_ring_free(struct ccnl_ring_s *r)
+{
+    ccnl_free(r->buf);
+    r->buf = NULL;
+    r->size = 0;
+}
+
+void*
+ccnl_ring_reserve(struct ccnl_ring_s *r, size_t len)
+{
+    uint32_t need, off, skip = 0;
+
+    // at most half the buffer, a record then always fits once it is empty
+    if (len > r->size / 2 - CCNL_RING_HDR) {
+        return NULL;
+    }
+    need = CCNL_RING_HDR + CCNL_RING_ALIGN(len);
+    off = r->head & (r->size - 1);
+    if (off + need > r->size) {
+        // records do not wrap around, the end of the buffer stays unused
+        skip = r->size - off;
+    }
+    if (r->head - r->tail_seen + skip + need > r->size) {
+        r->tail_seen = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+        if (r->head - r->tail_seen + skip + need > r->size) {
+            return NULL;
+        }
+    }
+    r->skip = skip;
+    return r->buf + ((r->head + skip) & (r->size - 1)) + CCNL_RING_HDR;
+}
+
+int
+ccnl_ring_commit(struct ccnl_ring_s *r, uint32_t tag, size_t len)
+{
+    struct ccnl_ring_rec_s *rec;
+    uint32_t old = r->head, head = r->head;
+
+    if (r->skip) {
+        rec = (struct ccnl_ring_rec_s *) (r->buf + (head & (r->size - 1)));
+        rec->len = 0;
+        rec->tag = CCNL_RING_WRAP;
+        head += r->skip;
+        r->skip = 0;
+    }
+    rec = (struct ccnl_ring_rec_s *) (r->buf + (head & (r->size - 1)));
+    rec->len = (uint32_t) len;
+    rec->tag = tag;
+    head += CCNL_RING_HDR + CCNL_RING_ALIGN(len);
+
+    __atomic_store_n(&r->pushed, r->pushed + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&r->head, head, __ATOMIC_SEQ_CST);
+    // the consumer took everything before this record: it may wait for us
+    return __atomic_load_n(&r->tail, __ATOMIC_SEQ_CST) == old;
+}
+
+void*
+ccnl_ring_peek(struct ccnl_ring_s *r, uint32_t *tag, size_t *len)
+{
+    struct ccnl_ring_rec_s *rec;
+    uint32_t head = __atomic_load_n(&r->head, __ATOMIC_SEQ_CST);
+    uint32_t pos = r->tail + r->next;
+
+    for (;;) {
+        if (pos == head) {
+            return NULL;
+        }
+        rec = (struct ccnl_ring_rec_s *) (r->buf + (pos & (r->size - 1)));
+        if (rec->tag != CCNL_RING_WRAP) {
+            break;
+        }
+        // released with the record behind it, which always follows
+        r->next += r->size - (pos & (r->size - 1));
+        pos = r->tail + r->next;
+    }
+    *tag = rec->tag;
+    *len = rec->len;
+    r->next += CCNL_RING_HDR + CCNL_RING_ALIGN(rec->len);
+    r->peeked++;
+    return rec + 1;
+}
+
+void
+ccnl_ring_release(struct ccnl_ring_s *r)
+{
+    if (!r->next) {
+        return;
+    }
+    __atomic_store_n(&r->popped, r->popped + r->peeked, __ATOMIC_RELAXED);
+    __atomic_store_n(&r->tail, r->tail + r->next, __ATOMIC_SEQ_CST);
+    r->next = 0;
+    r->peeked = 0;
+}
+
+uint32_t
+ccnl_ring_depth(struct ccnl_ring_s *r)
+{
+    return __atomic_load_n(&r->pushed, __ATOMIC_RELAXED) -
+           __atomic_load_n(&r->popped, __ATOMIC_RELAXED);
+}
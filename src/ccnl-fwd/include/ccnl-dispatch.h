@@ -48,5 +48,22 @@ void
 ccnl_core_RX(struct ccnl_relay_s *relay, int ifndx, uint8_t *data,
              size_t datalen, struct sockaddr *sa, size_t addrlen);
 
+/**
+ * @brief       Parses the name of the first packet in a received frame
+ *
+ * Recognizes the suite like @ref ccnl_core_RX but does not forward the
+ * packet, e.g. to pick the thread which owns the name.
+ *
+ * @param[out] rx       the parsed packet, the name points into @p data,
+ *                      flagged CCNL_PKT_REQUEST for an Interest
+ * @param[in] data      data which were received
+ * @param[in] datalen   length of the received data
+ *
+ * @return the name of the packet, NULL if it has none or is malformed
+ */
+struct ccnl_prefix_s*
+ccnl_core_peek_prefix(struct ccnl_pkt_rx_s *rx, uint8_t *data,
+                      size_t datalen);
+
 #endif
 /** @} */
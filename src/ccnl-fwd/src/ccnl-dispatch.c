@@ -122,6 +122,80 @@ ccnl_core_RX(struct ccnl_relay_s *relay, int ifndx, uint8_t *data,
     }
 }
 
+struct ccnl_prefix_s*
+ccnl_core_peek_prefix(struct ccnl_pkt_rx_s *rx, uint8_t *data, size_t datalen)
+{
+    struct ccnl_pkt_s *pkt = NULL;
+    int32_t enc;
+    int suite = -1;
+    size_t skip;
+    (void) skip;
+
+    rx->name = NULL;
+    while (!ccnl_switch_dehead(&data, &datalen, &enc))
+        suite = ccnl_enc2suite(enc);
+    if (suite == -1)
+        suite = ccnl_pkt2suite(data, datalen, &skip);
+
+    // the same parsers as the forwarders, but the bytes stay untouched
+    switch (suite) {
+#ifdef USE_SUITE_CCNB
+    case CCNL_SUITE_CCNB: {
+        uint64_t num;
+        uint8_t typ;
+
+        if (ccnl_ccnb_dehead(&data, &datalen, &num, &typ) ||
+            typ != CCN_TT_DTAG ||
+            (num != CCN_DTAG_INTEREST && num != CCN_DTAG_CONTENTOBJ)) {
+            return NULL;
+        }
+        pkt = ccnl_ccnb_bytes2pkt_rx(rx, data - 2, &data, &datalen);
+        if (pkt) {
+            pkt->flags |= num == CCN_DTAG_INTEREST ? CCNL_PKT_REQUEST
+                                                   : CCNL_PKT_REPLY;
+        }
+        break;
+    }
+#endif
+#ifdef USE_SUITE_CCNTLV
+    case CCNL_SUITE_CCNTLV: {
+        uint8_t *start = data;
+        size_t hdrlen;
+
+        if (datalen < sizeof(struct ccnx_tlvhdr_ccnx2015_s) ||
+            ccnl_ccntlv_getHdrLen(data, datalen, &hdrlen)) {
+            return NULL;
+        }
+        data += hdrlen;
+        datalen -= hdrlen;
+        pkt = ccnl_ccntlv_bytes2pkt_rx(rx, start, &data, &datalen);
+        if (pkt) {
+            pkt->flags |= pkt->type == CCNX_TLV_TL_Interest ? CCNL_PKT_REQUEST
+                                                            : CCNL_PKT_REPLY;
+        }
+        break;
+    }
+#endif
+#ifdef USE_SUITE_NDNTLV
+    case CCNL_SUITE_NDNTLV: {
+        uint8_t *start = data;
+        uint64_t typ;
+        size_t len;
+
+        if (ccnl_ndntlv_dehead(&data, &datalen, &typ, &len) ||
+            len > datalen) {
+            return NULL;
+        }
+        pkt = ccnl_ndntlv_bytes2pkt_rx(rx, typ, start, &data, &datalen);
+        break;
+    }
+#endif
+    default:
+        break;
+    }
+    return pkt ? pkt->pfx : NULL;
+}
+
 // ----------------------------------------------------------------------
 
 void
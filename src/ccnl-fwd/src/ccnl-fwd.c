@@ -85,18 +85,15 @@ ccnl_fwd_handleContent(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
         }
 #endif /* USE_SUITE_CCNB && USE_SIGNATURES*/
 #ifndef CCNL_LINUXKERNEL
-    if (ccnl_callback_rx_on_data(relay, from, *pkt)) {
-        *pkt = NULL;
+    if (ccnl_callback_rx_on_data(relay, from, pkt)) {
         return 0;
     }
 #endif
 
     // CONFORM: Step 1:
-    for (c = relay->contents; c; c = c->next) {
-        if (ccnl_prefix_cmp(c->pkt->pfx, NULL, (*pkt)->pfx, CMP_EXACT) == 0) {
-            DEBUGMSG_CFWD(TRACE, "  content is duplicate, ignoring\n");
-            return 0; // content is dup, do nothing
-        }
+    if (ccnl_content_find(relay, (*pkt)->pfx)) {
+        DEBUGMSG_CFWD(TRACE, "  content is duplicate, ignoring\n");
+        return 0; // content is dup, do nothing
     }
 
     c = ccnl_content_new(pkt);
@@ -105,33 +102,44 @@ ccnl_fwd_handleContent(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
     }
 
     if (!ccnl_content_serve_pending(relay, c)) { // unsolicited content
+        if (from && (from->flags & CCNL_FACE_FLAGS_PUSH) &&
+            relay->max_cache_entries != 0) {
+            // a local producer fills the content store ahead of interests
+            DEBUGMSG_CFWD(DEBUG, "  pushed content, adding to cache\n");
+            if (ccnl_cs_add(relay, c)) {
+                ccnl_content_free(c);
+            }
+            return 0;
+        }
         // CONFORM: "A node MUST NOT forward unsolicited data [...]"
         DEBUGMSG_CFWD(DEBUG, "  removed because no matching interest\n");
         ccnl_content_free(c);
         return 0;
     }
 
-    if (relay->max_cache_entries != 0 && cache_strategy_cache(relay,c)) {
-        DEBUGMSG_CFWD(DEBUG, "  adding content to cache\n");
-        ccnl_content_add2cache(relay, c);
-        int contlen = (int) (c->pkt->contlen > INT_MAX ? INT_MAX : c->pkt->contlen);
-        DEBUGMSG_CFWD(INFO, "data after creating packet %.*s\n", contlen, c->pkt->content);
-    } else {
-        DEBUGMSG_CFWD(DEBUG, "  content not added to cache\n");
-        ccnl_content_free(c);
-    }
-
 #ifdef USE_RONR
     /* if we receive a chunk, we assume more chunks of this content may be
      * retrieved along the same path */
     if (c->pkt->pfx->chunknum) {
         struct ccnl_prefix_s *pfx_wo_chunk = ccnl_prefix_dup(c->pkt->pfx);
         pfx_wo_chunk->compcnt--;
-        ccnl_free(pfx_wo_chunk->chunknum);
-        pfx_wo_chunk->chunknum = NULL;
+        pfx_wo_chunk->chunknum = NULL; // stored inline, see ccnl_prefix_dup()
         ccnl_fib_add_entry(relay, pfx_wo_chunk, from);
     }
 #endif
+
+    if (relay->max_cache_entries != 0 && cache_strategy_cache(relay,c)) {
+        DEBUGMSG_CFWD(DEBUG, "  adding content to cache\n");
+        int contlen = (int) (c->pkt->contlen > INT_MAX ? INT_MAX : c->pkt->contlen);
+        DEBUGMSG_CFWD(INFO, "data after creating packet %.*s\n", contlen, c->pkt->content);
+        if (!ccnl_content_add2cache(relay, c)) {
+            ccnl_content_free(c);
+        }
+    } else {
+        DEBUGMSG_CFWD(DEBUG, "  content not added to cache\n");
+        ccnl_content_free(c);
+    }
+
     return 0;
 }
 
@@ -148,7 +156,7 @@ ccnl_fwd_handleFragment(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
         char *from_as_str = ccnl_addr2ascii(&(from->peer));
 
         DEBUGMSG_CFWD(INFO, "  incoming fragment (%zd bytes) from=%s\n", 
-            (*pkt)->buf->datalen, from_as_str ? from_as_str : "");
+            (*pkt)->contlen, from_as_str ? from_as_str : "");
     }
 
     ccnl_frag_RX_BeginEnd2015(callback, relay, from,
@@ -179,6 +187,63 @@ ccnl_pkt_fwdOK(struct ccnl_pkt_s *pkt)
     return -1;
 }
 
+// returns 1 if the interest carries selectors which may let it match
+// content with a name longer than its own
+static int
+ccnl_fwd_hasSelectors(struct ccnl_pkt_s *pkt)
+{
+    switch (pkt->suite) {
+#ifdef USE_SUITE_CCNB
+    case CCNL_SUITE_CCNB:
+        return pkt->s.ccnb.minsuffix != 0 ||
+               pkt->s.ccnb.maxsuffix != CCNL_MAX_NAME_COMP;
+#endif
+#ifdef USE_SUITE_NDNTLV
+    case CCNL_SUITE_NDNTLV:
+        return pkt->s.ndntlv.minsuffix != 0 ||
+               pkt->s.ndntlv.maxsuffix != CCNL_MAX_NAME_COMP;
+#endif
+    default:
+        break;
+    }
+
+    return 0;
+}
+
+// search the content store: the name index holds all candidates with the
+// interest's exact name, or with one component less in case the interest
+// ends with an implicit digest; only interests with selectors need a scan
+static struct ccnl_content_s*
+ccnl_fwd_lookupContent(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt,
+                       cMatchFct cMatch)
+{
+    struct ccnl_prefix_s *pfx = pkt->pfx;
+    struct ccnl_hnode_s *n;
+    struct ccnl_content_s *c;
+    uint32_t i, cnt;
+
+    for (i = 0; i < 2 && i <= pfx->compcnt; i++) {
+        cnt = pfx->compcnt - i;
+        for (n = ccnl_htable_lookup(&relay->cs_index, ccnl_prefix_hash(pfx, cnt));
+                                    n; n = ccnl_htable_next(n)) {
+            c = CCNL_HTABLE_ENTRY(n, struct ccnl_content_s, hnode);
+            if (c->pkt->pfx->compcnt == cnt && !cMatch(pkt, c)) {
+                return c;
+            }
+        }
+    }
+
+    if (ccnl_fwd_hasSelectors(pkt)) {
+        for (c = relay->contents; c; c = c->next) {
+            if (c->pkt->pfx->suite == pfx->suite && !cMatch(pkt, c)) {
+                return c;
+            }
+        }
+    }
+
+    return NULL;
+}
+
 int
 ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
                         struct ccnl_pkt_s **pkt, cMatchFct cMatch)
@@ -230,6 +295,9 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
     if ((*pkt)->suite == CCNL_SUITE_CCNB && (*pkt)->pfx->compcnt == 4 &&
                                   !memcmp((*pkt)->pfx->comp[0], "ccnx", 4)) {
         DEBUGMSG_CFWD(INFO, "  found a mgmt message\n");
+        if (ccnl_pkt_own(pkt)) {
+            return 0;
+        }
         ccnl_mgmt(relay, (*pkt)->buf, (*pkt)->pfx, from); // use return value? // TODO uncomment
         return 0;
     }
@@ -240,6 +308,9 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
         !memcmp((*pkt)->pfx->comp[0], "ccnx", 4)) {
         DEBUGMSG_CFWD(INFO, "  found a mgmt message\n");
 #ifdef USE_MGMT
+        if (ccnl_pkt_own(pkt)) {
+            return 0;
+        }
         ccnl_mgmt(relay, (*pkt)->buf, (*pkt)->pfx, from); // use return value?
 #endif
         return 0;
@@ -249,13 +320,10 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
             // Step 1: search in content store
     DEBUGMSG_CFWD(DEBUG, "  searching in CS\n");
 
-    for (c = relay->contents; c; c = c->next) {
-        if (c->pkt->pfx->suite != (*pkt)->pfx->suite)
-            continue;
-        if (cMatch(*pkt, c))
-            continue;
-
+    c = ccnl_fwd_lookupContent(relay, *pkt, cMatch);
+    if (c) {
         DEBUGMSG_CFWD(DEBUG, "  found matching content %p\n", (void *) c);
+        ccnl_cache_hit(relay, c);
 
         if (from) {
             if (from->ifndx >= 0) {
@@ -269,11 +337,10 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
 
         return 0; // we are done
     }
+    relay->cache.misses++;
 
     // CONFORM: Step 2: check whether interest is already known
-    for (i = relay->pit; i; i = i->next)
-        if (ccnl_interest_isSame(i, *pkt))
-            break;
+    i = ccnl_interest_find(relay, *pkt);
 
     if (!i) { // this is a new/unknown I request: create and propagate
         propagate = 1;
@@ -283,9 +350,11 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
     if (!i) {
         i = ccnl_interest_new(relay, from, pkt);
 
-        DEBUGMSG_CFWD(DEBUG,
-                      "  created new interest entry %p (prefix=%s)\n",
-                      (void *) i, ccnl_prefix_to_str(i->pkt->pfx,s,CCNL_MAX_PACKET_SIZE));
+        if (i) {
+            DEBUGMSG_CFWD(DEBUG,
+                          "  created new interest entry %p (prefix=%s)\n",
+                          (void *) i, ccnl_prefix_to_str(i->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE));
+        }
     }
     if (i) { // store the I request, for the incoming face (Step 3)
         DEBUGMSG_CFWD(DEBUG, "  appending interest entry %p\n", (void *) i);
@@ -307,11 +376,13 @@ ccnl_ccnb_fwd(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
               uint8_t **data, size_t *datalen, uint64_t typ)
 {
     int8_t rc= -1;
+    struct ccnl_pkt_rx_s rx;
     struct ccnl_pkt_s *pkt;
 
     DEBUGMSG_CFWD(DEBUG, "ccnb fwd (%zu bytes left)\n", *datalen);
 
-    pkt = ccnl_ccnb_bytes2pkt(*data - 2, data, datalen);
+    rx.name = relay->rx_name;
+    pkt = ccnl_ccnb_bytes2pkt_rx(&rx, *data - 2, data, datalen);
     if (!pkt) {
         DEBUGMSG_CFWD(WARNING, "  parsing error or no prefix\n");
         goto Done;
@@ -411,6 +482,7 @@ ccnl_ccntlv_forwarder(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
     size_t hdrlen;
     struct ccnx_tlvhdr_ccnx2015_s *hp;
     uint8_t *start = *data;
+    struct ccnl_pkt_rx_s rx;
     struct ccnl_pkt_s *pkt;
 
     DEBUGMSG_CFWD(DEBUG, "ccnl_ccntlv_forwarder: %zuB from face=%p (id=%d.%d)\n",
@@ -494,7 +566,8 @@ ccnl_ccntlv_forwarder(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
         DEBUGMSG_CFWD(TRACE, "  local data, datalen=%zu\n", *datalen);
     }
 
-    pkt = ccnl_ccntlv_bytes2pkt(start, data, datalen);
+    rx.name = relay->rx_name;
+    pkt = ccnl_ccntlv_bytes2pkt_rx(&rx, start, data, datalen);
     if (!pkt) {
         DEBUGMSG_CFWD(WARNING, "  parsing error or no prefix\n");
         goto Done;
@@ -547,6 +620,7 @@ ccnl_ndntlv_forwarder(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
     size_t len;
     uint64_t typ;
     unsigned char *start = *data;
+    struct ccnl_pkt_rx_s rx;
     struct ccnl_pkt_s *pkt;
 
     DEBUGMSG_CFWD(DEBUG, "ccnl_ndntlv_forwarder (%zu bytes left)\n", *datalen);
@@ -555,7 +629,9 @@ ccnl_ndntlv_forwarder(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
         DEBUGMSG_CFWD(TRACE, "  invalid packet format\n");
         return -1;
     }
-    pkt = ccnl_ndntlv_bytes2pkt(typ, start, data, datalen);
+    // the packet points into the receive buffer until the relay keeps it
+    rx.name = relay->rx_name;
+    pkt = ccnl_ndntlv_bytes2pkt_rx(&rx, typ, start, data, datalen);
     if (!pkt) {
         DEBUGMSG_CFWD(INFO, "  ndntlv packet coding problem\n");
         goto Done;
@@ -598,7 +674,7 @@ int
 ccnl_set_tap(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
              tapCallback callback)
 {
-    struct ccnl_forward_s *fwd, **fwd2;
+    struct ccnl_forward_s *fwd;
     char s[CCNL_MAX_PREFIX_SIZE];
     (void) s;
 
@@ -606,25 +682,21 @@ ccnl_set_tap(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
              ccnl_prefix_to_str(pfx,s,CCNL_MAX_PREFIX_SIZE),
              ccnl_suite2str(pfx->suite));
 
-    for (fwd = relay->fib; fwd; fwd = fwd->next) {
-        if (fwd->suite == pfx->suite &&
-                        !ccnl_prefix_cmp(fwd->prefix, NULL, pfx, CMP_EXACT)) {
-            ccnl_prefix_free(fwd->prefix);
-            fwd->prefix = NULL;
-            break;
-        }
-    }
-    if (!fwd) {
+    fwd = ccnl_forward_find(relay, pfx);
+    if (fwd) {
+        ccnl_prefix_free(fwd->prefix);
+        fwd->prefix = pfx;
+    } else {
         fwd = (struct ccnl_forward_s *) ccnl_calloc(1, sizeof(*fwd));
         if (!fwd)
             return -1;
-        fwd2 = &relay->fib;
-        while (*fwd2)
-            fwd2 = &((*fwd2)->next);
-        *fwd2 = fwd;
+        fwd->prefix = pfx;
         fwd->suite = pfx->suite;
+        if (ccnl_forward_add(relay, fwd)) {
+            ccnl_free(fwd);
+            return -1;
+        }
     }
-    fwd->prefix = pfx;
     fwd->tap = callback;
     return 0;
 }
@@ -59,6 +59,9 @@ static const char *compile_string = ""
 #ifdef USE_ECHO
         "ECHO, "
 #endif
+#ifdef USE_EPOLL
+        "EPOLL, "
+#endif
 #ifdef USE_LINKLAYER
         "ETHERNET, "
 #endif
@@ -83,12 +86,18 @@ static const char *compile_string = ""
 #ifdef USE_MGMT
         "MGMT, "
 #endif
+#ifdef USE_MMSG
+        "MMSG, "
+#endif
 #ifdef USE_SCHEDULER
         "SCHEDULER, "
 #endif
 #ifdef USE_SIGNATURES
         "SIGNATURES, "
 #endif
+#ifdef USE_SLAB_MALLOC
+        "SLAB_MALLOC, "
+#endif
 #ifdef USE_SUITE_CCNB
         "SUITE_CCNB, "
 #endif
@@ -101,8 +110,20 @@ static const char *compile_string = ""
 #ifdef USE_SUITE_NDNTLV
         "SUITE_NDNTLV, "
 #endif
+#ifdef USE_THREADS
+        "THREADS, "
+#endif
+#ifdef USE_TPACKET
+        "TPACKET, "
+#endif
 #ifdef USE_UNIXSOCKET
         "UNIXSOCKET, "
+#endif
+#ifdef USE_URING
+        "URING, "
+#endif
+#ifdef USE_XDP
+        "XDP, "
 #endif
         ;
 
@@ -120,6 +120,9 @@ kfree(ptr);
 #include "../../ccnl-core/src/ccnl-pkt.c"
 #include "../../ccnl-core/src/ccnl-logging.c"
 #include "../../ccnl-core/src/ccnl-os-time.c"
+#include "../../ccnl-core/src/ccnl-htable.c"
+#include "../../ccnl-core/src/ccnl-cache.c"
+#include "../../ccnl-core/src/ccnl-nonce.c"
 #include "../../ccnl-core/src/ccnl-prefix.c"
 #include "../../ccnl-core/src/ccnl-relay.c"
 #include "../../ccnl-core/src/ccnl-sched.c"
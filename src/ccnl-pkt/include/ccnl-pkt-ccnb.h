@@ -94,6 +94,12 @@ ccnl_ccnb_dehead(uint8_t **buf, size_t *len, uint64_t *num, uint8_t *typ);
 struct ccnl_pkt_s*
 ccnl_ccnb_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen);
 
+// parses a packet in place into rx, without copying or allocating,
+// see ccnl_pkt_own()
+struct ccnl_pkt_s*
+ccnl_ccnb_bytes2pkt_rx(struct ccnl_pkt_rx_s *rx, uint8_t *start,
+                       uint8_t **data, size_t *datalen);
+
 int8_t
 ccnl_ccnb_cMatch(struct ccnl_pkt_s *p, struct ccnl_content_s *c);
 
@@ -185,6 +185,16 @@ ccnl_ccntlv_dehead(uint8_t **buf, size_t *len,
 struct ccnl_pkt_s*
 ccnl_ccntlv_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen);
 
+/**
+ * Parses a packet in place, like ccnl_ccntlv_bytes2pkt() but without
+ * copying the packet's bytes or allocating memory
+ * @param rx storage for the packet, see ccnl_pkt_own()
+ * @return the packet, which points into @p rx and the bytes at @p start
+ */
+struct ccnl_pkt_s*
+ccnl_ccntlv_bytes2pkt_rx(struct ccnl_pkt_rx_s *rx, uint8_t *start,
+                         uint8_t **data, size_t *datalen);
+
 int8_t
 ccnl_ccntlv_cMatch(struct ccnl_pkt_s *p, struct ccnl_content_s *c);
 
@@ -36,6 +36,8 @@
 #include "../../ccnl-core/include/ccnl-content.h"
 #endif
 
+struct ccnl_pkt_rx_s;
+
 
 /**
  * Default interest lifetime in milliseconds. If the element is omitted by a user, a default
@@ -174,6 +176,16 @@ struct ccnl_pkt_s*
 ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
                       uint8_t **data, size_t *datalen);
 
+/**
+ * Parses a packet in place, like ccnl_ndntlv_bytes2pkt() but without
+ * copying the packet's bytes or allocating memory
+ * @param rx storage for the packet, see ccnl_pkt_own()
+ * @return the packet, which points into @p rx and the bytes at @p start
+ */
+struct ccnl_pkt_s*
+ccnl_ndntlv_bytes2pkt_rx(struct ccnl_pkt_rx_s *rx, uint64_t pkttype,
+                         uint8_t *start, uint8_t **data, size_t *datalen);
+
 int8_t
 ccnl_ndntlv_cMatch(struct ccnl_pkt_s *p, struct ccnl_content_s *c);
 
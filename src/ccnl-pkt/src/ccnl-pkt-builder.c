@@ -148,12 +148,12 @@ ccnl_isFragment(uint8_t *buf, size_t len, int suite)
 struct ccnl_interest_s *
 ccnl_mkInterestObject(struct ccnl_prefix_s *name, ccnl_interest_opts_u *opts)
 {
-    struct ccnl_interest_s *i = (struct ccnl_interest_s *) ccnl_calloc(1,
+    struct ccnl_interest_s *i = (struct ccnl_interest_s *) ccnl_obj_calloc(CCNL_MEM_INTEREST,
                                                                        sizeof(struct ccnl_interest_s));
     if (!i) {
         return NULL;
     }
-    i->pkt = (struct ccnl_pkt_s *) ccnl_calloc(1, sizeof(struct ccnl_pkt_s));
+    i->pkt = (struct ccnl_pkt_s *) ccnl_obj_calloc(CCNL_MEM_PKT, sizeof(struct ccnl_pkt_s));
     if (!i->pkt) {
         ccnl_free(i);
         return NULL;
@@ -253,7 +253,7 @@ ccnl_mkContentObject(struct ccnl_prefix_s *name,
                      ccnl_data_opts_u *opts)
 {
     size_t dataoffset = 0;
-    struct ccnl_pkt_s *c_p = ccnl_calloc(1, sizeof(struct ccnl_pkt_s));
+    struct ccnl_pkt_s *c_p = ccnl_obj_calloc(CCNL_MEM_PKT, sizeof(struct ccnl_pkt_s));
     if (!c_p) {
         return NULL;
     }
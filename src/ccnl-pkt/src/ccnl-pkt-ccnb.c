@@ -135,7 +135,8 @@ ccnl_ccnb_data2uint(uint8_t *cp, size_t len, uint64_t *retval)
 }
 
 struct ccnl_pkt_s*
-ccnl_ccnb_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
+ccnl_ccnb_bytes2pkt_rx(struct ccnl_pkt_rx_s *rx, uint8_t *start,
+                       uint8_t **data, size_t *datalen)
 {
     struct ccnl_pkt_s *pkt;
     uint8_t *cp;
@@ -146,23 +147,14 @@ ccnl_ccnb_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
 
     DEBUGMSG(TRACE, "ccnl_ccnb_extract\n");
 
-    //pkt = (struct ccnl_pkt_s *) ccnl_calloc(1, sizeof(*pkt));
-    pkt = (struct ccnl_pkt_s *) ccnl_calloc(1, sizeof(*pkt));
-    if (!pkt) {
-        return NULL;
-    }
+    pkt = ccnl_pkt_rx_init(rx);
     pkt->suite = CCNL_SUITE_CCNB;
     pkt->val.final_block_id = -1;
     pkt->s.ccnb.scope = 3;
     pkt->s.ccnb.aok = 3;
     pkt->s.ccnb.maxsuffix = CCNL_MAX_NAME_COMP;
 
-    pkt->pfx = p = ccnl_prefix_new(CCNL_SUITE_CCNB, CCNL_MAX_NAME_COMP);
-    if (!p) {
-        ccnl_free(pkt);
-        return NULL;
-    }
-    p->compcnt = 0;
+    pkt->pfx = p = ccnl_pkt_rx_prefix(rx, CCNL_SUITE_CCNB);
 
     oldpos = *data - start;
     while (!ccnl_ccnb_dehead(data, datalen, &num, &typ)) {
@@ -173,6 +165,16 @@ ccnl_ccnb_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
             switch (num) {
             case CCN_DTAG_NAME:
                 p->nameptr = start + oldpos;
+                if (ccnl_pkt_rx_name(rx, p)) {
+                    len = p->nameptr + rx->name->namelen - *data;
+                    if (len > *datalen) {
+                        goto Bail;
+                    }
+                    *data += len;
+                    *datalen -= len;
+                    p->namelen = rx->name->namelen;
+                    break;
+                }
                 for (;;) {
                     if (ccnl_ccnb_dehead(data, datalen, &num, &typ)) {
                         goto Bail;
@@ -254,7 +256,7 @@ ccnl_ccnb_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
                 }
                 case CCN_DTAG_NONCE:
                     if (!pkt->s.ccnb.nonce) {
-                        pkt->s.ccnb.nonce = ccnl_buf_new(cp, len);
+                        pkt->s.ccnb.nonce = ccnl_pkt_rx_field(rx, cp, len);
                         if (!pkt->s.ccnb.nonce) {
                             goto Bail;
                         }
@@ -262,7 +264,7 @@ ccnl_ccnb_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
                     break;
                 case CCN_DTAG_PUBPUBKDIGEST:
                     if (!pkt->s.ccnb.ppkd) {
-                        pkt->s.ccnb.ppkd = ccnl_buf_new(cp, len);
+                        pkt->s.ccnb.ppkd = ccnl_pkt_rx_field(rx, cp, len);
                         if (!pkt->s.ccnb.ppkd) {
                             goto Bail;
                         }
@@ -290,24 +292,28 @@ ccnl_ccnb_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
         oldpos = *data - start;
     }
     pkt->pfx = p;
-    pkt->buf = ccnl_buf_new(start, *data - start);
-    // carefully rebase ptrs to new buf because of 64bit pointers:
-    if (pkt->content) {
-        pkt->content = pkt->buf->data + (pkt->content - start);
-    }
-    for (num = 0; num < p->compcnt; num++) {
-        p->comp[num] = pkt->buf->data + (p->comp[num] - start);
-    }
-    if (p->nameptr) {
-        p->nameptr = pkt->buf->data + (p->nameptr - start);
-    }
+    rx->start = start;
+    rx->len = *data - start;
 
     return pkt;
 Bail:
-    ccnl_pkt_free(pkt);
     return NULL;
 }
 
+struct ccnl_pkt_s*
+ccnl_ccnb_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
+{
+    struct ccnl_pkt_rx_s rx;
+    struct ccnl_pkt_s *pkt;
+
+    rx.name = NULL;
+    pkt = ccnl_ccnb_bytes2pkt_rx(&rx, start, data, datalen);
+    if (!pkt || ccnl_pkt_own(&pkt)) {
+        return NULL;
+    }
+    return pkt;
+}
+
 int8_t
 ccnl_ccnb_unmkBinaryInt(uint8_t **data, size_t *datalen,
                         unsigned int *result, uint8_t *width)
@@ -112,11 +112,11 @@ ccnl_ccntlv_dehead(uint8_t **buf, size_t *len,
 // We use one extraction procedure for both interest and data pkts.
 // This proc assumes that the packet header was already processed and consumed
 struct ccnl_pkt_s*
-ccnl_ccntlv_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
+ccnl_ccntlv_bytes2pkt_rx(struct ccnl_pkt_rx_s *rx, uint8_t *start,
+                         uint8_t **data, size_t *datalen)
 {
     struct ccnl_pkt_s *pkt;
     struct ccnl_prefix_s *p;
-    uint32_t i;
     size_t len;
     size_t oldpos;
     uint16_t typ;
@@ -126,17 +126,8 @@ ccnl_ccntlv_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
 
     DEBUGMSG_PCNX(TRACE, "ccnl_ccntlv_bytes2pkt len=%zu\n", *datalen);
 
-    pkt = (struct ccnl_pkt_s*) ccnl_calloc(1, sizeof(*pkt));
-    if (!pkt) {
-        return NULL;
-    }
-
-    pkt->pfx = p = ccnl_prefix_new(CCNL_SUITE_CCNTLV, CCNL_MAX_NAME_COMP);
-    if (!p) {
-        ccnl_free(pkt);
-        return NULL;
-    }
-    p->compcnt = 0;
+    pkt = ccnl_pkt_rx_init(rx);
+    pkt->pfx = p = ccnl_pkt_rx_prefix(rx, CCNL_SUITE_CCNTLV);
 
 #ifdef USE_HMAC256
     pkt->hmacStart = *data;
@@ -166,6 +157,9 @@ ccnl_ccntlv_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
         switch (typ) {
         case CCNX_TLV_M_Name:
             p->nameptr = start + oldpos;
+            if (ccnl_pkt_rx_name(rx, p)) {
+                len2 = 0;
+            }
             while (len2 > 0) {
                 cp2 = cp;
                 if (ccnl_ccntlv_dehead(&cp, &len2, &typ, &len3) || len>*datalen) {
@@ -179,7 +173,7 @@ ccnl_ccntlv_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
                     // possibly want to remove the chunk segment from the
                     // name components and rely on the chunknum field in
                     // the prefix.
-                  p->chunknum = (uint32_t *) ccnl_malloc(sizeof(uint32_t));
+                    p->chunknum = &rx->chunknum;
 
                     if (ccnl_ccnltv_extractNetworkVarInt(cp, len3, p->chunknum) < 0) {
                         DEBUGMSG_PCNX(WARNING, "Error in NetworkVarInt for chunk\n");
@@ -256,31 +250,28 @@ ccnl_ccntlv_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
     }
 
     pkt->pfx = p;
-    pkt->buf = ccnl_buf_new(start, *data - start);
-    if (!pkt->buf) {
-        goto Bail;
-    }
-    // carefully rebase ptrs to new buf because of 64bit pointers:
-    if (pkt->content) {
-        pkt->content = pkt->buf->data + (pkt->content - start);
-    }
-    for (i = 0; i < p->compcnt; i++) {
-        p->comp[i] = pkt->buf->data + (p->comp[i] - start);
-    }
-    if (p->nameptr) {
-        p->nameptr = pkt->buf->data + (p->nameptr - start);
-    }
-#ifdef USE_HMAC256
-    pkt->hmacStart = pkt->buf->data + (pkt->hmacStart - start);
-    pkt->hmacSignature = pkt->buf->data + (pkt->hmacSignature - start);
-#endif
+    rx->start = start;
+    rx->len = *data - start;
 
     return pkt;
 Bail:
-    ccnl_pkt_free(pkt);
     return NULL;
 }
 
+struct ccnl_pkt_s*
+ccnl_ccntlv_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
+{
+    struct ccnl_pkt_rx_s rx;
+    struct ccnl_pkt_s *pkt;
+
+    rx.name = NULL;
+    pkt = ccnl_ccntlv_bytes2pkt_rx(&rx, start, data, datalen);
+    if (!pkt || ccnl_pkt_own(&pkt)) {
+        return NULL;
+    }
+    return pkt;
+}
+
 // ----------------------------------------------------------------------
 
 #ifdef NEEDS_PREFIX_MATCHING
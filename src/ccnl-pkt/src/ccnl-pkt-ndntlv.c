@@ -106,8 +106,8 @@ ccnl_ndntlv_dehead(uint8_t **buf, size_t *len,
 
 // we use one extraction routine for each of interest, data and fragment pkts
 struct ccnl_pkt_s*
-ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
-                      uint8_t **data, size_t *datalen)
+ccnl_ndntlv_bytes2pkt_rx(struct ccnl_pkt_rx_s *rx, uint64_t pkttype,
+                         uint8_t *start, uint8_t **data, size_t *datalen)
 {
     struct ccnl_pkt_s *pkt;
     size_t oldpos, len, i;
@@ -120,10 +120,7 @@ ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
 
     DEBUGMSG(DEBUG, "ccnl_ndntlv_bytes2pkt len=%zu\n", *datalen);
 
-    pkt = (struct ccnl_pkt_s*) ccnl_calloc(1, sizeof(struct ccnl_pkt_s));
-    if (!pkt) {
-        return NULL;
-    }
+    pkt = ccnl_pkt_rx_init(rx);
     pkt->type = pkttype;
 
 #ifdef USE_HMAC256
@@ -151,7 +148,7 @@ ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
     pkt->s.ndntlv.maxsuffix = CCNL_MAX_NAME_COMP;
 
     /* set default lifetime, in case InterestLifetime guider is absent */
-    pkt->s.ndntlv.interestlifetime = CCNL_INTEREST_TIMEOUT;
+    pkt->s.ndntlv.interestlifetime = NDN_DEFAULT_INTEREST_LIFETIME;
 
     oldpos = *data - start;
     while (ccnl_ndntlv_dehead(data, datalen, &typ, &len) == 0) {
@@ -164,15 +161,14 @@ ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
                 DEBUGMSG(WARNING, " ndntlv: name already defined\n");
                 goto Bail;
             }
-            prefix = ccnl_prefix_new(CCNL_SUITE_NDNTLV, CCNL_MAX_NAME_COMP);
-            if (!prefix) {
-                goto Bail;
-            }
-            prefix->compcnt = 0;
+            prefix = ccnl_pkt_rx_prefix(rx, CCNL_SUITE_NDNTLV);
             pkt->pfx = prefix;
             pkt->val.final_block_id = -1;
 
             prefix->nameptr = start + oldpos;
+            if (ccnl_pkt_rx_name(rx, prefix)) {
+                len2 = 0;
+            }
             while (len2 > 0) {
                 if (ccnl_ndntlv_dehead(&cp, &len2, &typ, &i)) {
                     goto Bail;
@@ -181,7 +177,7 @@ ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
                             prefix->compcnt < CCNL_MAX_NAME_COMP) {
                     if(cp[0] == NDN_Marker_SegmentNumber) {
                         uint64_t chunknum;
-                        prefix->chunknum = (uint32_t *) ccnl_malloc(sizeof(uint32_t));
+                        prefix->chunknum = &rx->chunknum;
                         // TODO: requires ccnl_ndntlv_includedNonNegInt which includes the length of the marker
                         // it is implemented for encode, the decode is not yet implemented
                         chunknum = ccnl_ndntlv_nonNegInt(cp + 1, i - 1);
@@ -227,7 +223,10 @@ ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
             }
             break;
         case NDN_TLV_Nonce:
-            pkt->s.ndntlv.nonce = ccnl_buf_new(*data, len);
+            pkt->s.ndntlv.nonce = ccnl_pkt_rx_field(rx, *data, len);
+            if (!pkt->s.ndntlv.nonce) {
+                goto Bail;
+            }
             break;
         case NDN_TLV_Scope:
             pkt->s.ndntlv.scope = ccnl_ndntlv_nonNegInt(*data, len);
@@ -314,29 +313,29 @@ ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
     }
 
     pkt->pfx = prefix;
-    pkt->buf = ccnl_buf_new(start, *data - start);
-    if (!pkt->buf) {
-        goto Bail;
-    }
-    // carefully rebase ptrs to new buf because of 64bit pointers:
-    if (pkt->content) {
-        pkt->content = pkt->buf->data + (pkt->content - start);
-    }
-    if (prefix) {
-        for (i = 0; i < prefix->compcnt; i++) {
-            prefix->comp[i] = pkt->buf->data + (prefix->comp[i] - start);
-        }
-        if (prefix->nameptr) {
-            prefix->nameptr = pkt->buf->data + (prefix->nameptr - start);
-        }
-    }
+    rx->start = start;
+    rx->len = *data - start;
 
     return pkt;
 Bail:
-    ccnl_pkt_free(pkt);
     return NULL;
 }
 
+struct ccnl_pkt_s*
+ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
+                      uint8_t **data, size_t *datalen)
+{
+    struct ccnl_pkt_rx_s rx;
+    struct ccnl_pkt_s *pkt;
+
+    rx.name = NULL;
+    pkt = ccnl_ndntlv_bytes2pkt_rx(&rx, pkttype, start, data, datalen);
+    if (!pkt || ccnl_pkt_own(&pkt)) {
+        return NULL;
+    }
+    return pkt;
+}
+
 // ----------------------------------------------------------------------
 
 #ifdef NEEDS_PREFIX_MATCHING
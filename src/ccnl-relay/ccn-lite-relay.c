@@ -68,6 +68,11 @@
 
 #include "ccn-lite-relay.h"
 #include "ccnl-unix.h"
+#include "ccnl-shard.h"
+#include "ccnl-pipeline.h"
+#include "ccnl-xdp.h"
+#include "ccnl-stream.h"
+#include "ccnl-shm.h"
 
 static int lasthour = -1;
 static int inter_ccn_interval = 0; // in usec
@@ -91,6 +96,9 @@ const char *compile_string = ""
 #ifdef USE_ECHO
         "ECHO, "
 #endif
+#ifdef USE_EPOLL
+        "EPOLL, "
+#endif
 #ifdef USE_LINKLAYER
         "ETHERNET, "
 #endif
@@ -115,12 +123,24 @@ const char *compile_string = ""
 #ifdef USE_MGMT
         "MGMT, "
 #endif
+#ifdef USE_MMSG
+        "MMSG, "
+#endif
 #ifdef USE_SCHEDULER
         "SCHEDULER, "
 #endif
+#ifdef USE_SHM
+        "SHM, "
+#endif
 #ifdef USE_SIGNATURES
         "SIGNATURES, "
 #endif
+#ifdef USE_SLAB_MALLOC
+        "SLAB_MALLOC, "
+#endif
+#ifdef USE_STREAM
+        "STREAM, "
+#endif
 #ifdef USE_SUITE_CCNB
         "SUITE_CCNB, "
 #endif
@@ -133,21 +153,92 @@ const char *compile_string = ""
 #ifdef USE_SUITE_NDNTLV
         "SUITE_NDNTLV, "
 #endif
+#ifdef USE_THREADS
+        "THREADS, "
+#endif
+#ifdef USE_TPACKET
+        "TPACKET, "
+#endif
 #ifdef USE_UNIXSOCKET
         "UNIXSOCKET, "
+#endif
+#ifdef USE_URING
+        "URING, "
+#endif
+#ifdef USE_XDP
+        "XDP, "
 #endif
         ;
 
 // ----------------------------------------------------------------------
 
+#ifdef USE_ECHO
+static void
+ccnl_relay_echo(struct ccnl_relay_s *relay, char *echopfx, int suite)
+{
+    struct ccnl_prefix_s *pfx;
+    char *dup = ccnl_strdup(echopfx);
+
+    pfx = ccnl_URItoPrefix(dup, suite, NULL);
+    if (pfx)
+        ccnl_echo_add(relay, pfx);
+    ccnl_free(dup);
+}
+#endif
+
+#if defined(USE_THREADS) && defined(USE_EPOLL)
+// the options the other shards are configured with
+struct ccnl_relay_args_s {
+    int udpport1, udpport2, udp6port1, udp6port2;
+    int suite, max_cache_entries, cache_policy;
+    size_t max_cache_bytes;
+    int rx_batch, tx_batch;
+    char *datadir, *echopfx;
+};
+
+// the UDP ports and the content of the first shard, management and
+// status stay with it
+static void
+ccnl_relay_shard_setup(struct ccnl_relay_s *relay, void *aux)
+{
+    struct ccnl_relay_args_s *args = (struct ccnl_relay_args_s *) aux;
+
+    ccnl_relay_config(relay, NULL, NULL, args->udpport1, args->udpport2,
+                      args->udp6port1, args->udp6port2, -1,
+                      NULL, args->suite, args->max_cache_entries, NULL);
+    relay->rx_batch = args->rx_batch;
+    relay->tx_batch = args->tx_batch;
+    ccnl_cache_set_policy(relay, args->cache_policy);
+    relay->max_cache_bytes = args->max_cache_bytes;
+    if (args->datadir) {
+        ccnl_populate_cache(relay, args->datadir);
+    }
+#ifdef USE_ECHO
+    if (args->echopfx) {
+        ccnl_relay_echo(relay, args->echopfx, args->suite);
+    }
+#endif
+}
+#endif
+
 // ----------------------------------------------------------------------
 
 int
 main(int argc, char **argv)
 {
     int opt, max_cache_entries = -1, httpport = -1;
+    int cache_policy = CCNL_CACHE_LRU;
+    size_t max_cache_bytes = 0;
     int udpport1 = -1, udpport2 = -1;
     int udp6port1 = -1, udp6port2 = -1;
+    int rx_batch = CCNL_DEFAULT_IO_BATCH, tx_batch = CCNL_DEFAULT_IO_BATCH;
+#ifdef USE_URING
+    int use_uring = 0;
+#endif
+    int (*loop)(struct ccnl_relay_s*) = ccnl_io_loop;
+#if defined(USE_THREADS) && defined(USE_EPOLL)
+    int shards = 1, shard_depth = CCNL_SHARD_DEPTH, pipeline = 0;
+#endif
     char *datadir = NULL, *ethdev = NULL, *crypto_sock_path = NULL;
     char *wpandev = NULL;
     int suite = CCNL_SUITE_DEFAULT;
@@ -160,6 +251,13 @@ main(int argc, char **argv)
 #ifdef USE_ECHO
     char *echopfx = NULL;
 #endif
+#ifdef USE_STREAM
+    int tcpport = -1;
+    char *streampath = NULL;
+#endif
+#ifdef USE_SHM
+    char *shmpath = NULL;
+#endif
 
     time(&theRelay->startup_time);
     unsigned int seed = time(NULL) * getpid();
@@ -169,8 +267,29 @@ main(int argc, char **argv)
     srandom(seed);
 #endif
 
-    while ((opt = getopt(argc, argv, "hc:d:e:g:i:o:p:s:t:u:6:v:w:x:")) != -1) {
+    while ((opt = getopt(argc, argv, "hb:c:d:e:Eg:H:i:l:L:m:N:o:p:Pr:R:s:S:t:T:u:U6:v:w:x:X:")) != -1) {
         switch (opt) {
+        case 'b': {
+            unsigned long long max_cache_bytes_l;
+            char *end;
+            int shift = 0;
+            errno = 0;
+            max_cache_bytes_l = strtoull(optarg, &end, 10);
+            if (*end && strchr("kK", *end)) {
+                shift = 10;
+            } else if (*end && strchr("mM", *end)) {
+                shift = 20;
+            } else if (*end && strchr("gG", *end)) {
+                shift = 30;
+            }
+            end += shift ? 1 : 0;
+            if (errno || end == optarg || *end ||
+                (size_t) (max_cache_bytes_l << shift) >> shift != max_cache_bytes_l) {
+                goto usage;
+            }
+            max_cache_bytes = (size_t) (max_cache_bytes_l << shift);
+            break;
+        }
         case 'c': {
             long max_cache_entries_l;
             errno = 0;
@@ -187,6 +306,11 @@ main(int argc, char **argv)
         case 'e':
             ethdev = optarg;
             break;
+#ifdef USE_TPACKET
+        case 'E':
+            ccnl_eth_tpacket = 1;
+            break;
+#endif
         case 'g': {
             long inter_pkt_interval_l;
             errno = 0;
@@ -197,6 +321,24 @@ main(int argc, char **argv)
             inter_pkt_interval = (int) inter_pkt_interval_l;
             break;
         }
+#if defined(USE_THREADS) && defined(USE_EPOLL)
+        case 'H':
+        case 'S': {
+            long shards_l;
+            errno = 0;
+            shards_l = strtol(optarg, (char **) NULL, 10);
+            if (errno || shards_l < 1 ||
+                shards_l > (opt == 'S' ? CCNL_SHARD_MAX : CCNL_MAX_NAME_COMP)) {
+                goto usage;
+            }
+            if (opt == 'S') {
+                shards = (int) shards_l;
+            } else {
+                shard_depth = (int) shards_l;
+            }
+            break;
+        }
+#endif
         case 'i': {
             long inter_ccn_interval_l;
             errno = 0;
@@ -207,6 +349,39 @@ main(int argc, char **argv)
             inter_ccn_interval = (int) inter_ccn_interval_l;
             break;
         }
+#ifdef USE_STREAM
+        case 'l': {
+            long tcpport_l;
+            errno = 0;
+            tcpport_l = strtol(optarg, (char **) NULL, 10);
+            if (errno || tcpport_l < 0 || tcpport_l > UINT16_MAX) {
+                goto usage;
+            }
+            tcpport = (int) tcpport_l;
+            break;
+        }
+        case 'L':
+            streampath = optarg;
+            break;
+#endif
+#ifdef USE_SHM
+        case 'm':
+            shmpath = optarg;
+            break;
+#endif
+#ifdef USE_STREAM
+        case 'N':
+            if (!strcmp(optarg, "nodelay")) {
+                ccnl_stream_tcp_mode = CCNL_STREAM_NODELAY;
+            } else if (!strcmp(optarg, "cork")) {
+                ccnl_stream_tcp_mode = CCNL_STREAM_CORK;
+            } else if (!strcmp(optarg, "nagle")) {
+                ccnl_stream_tcp_mode = CCNL_STREAM_NAGLE;
+            } else {
+                goto usage;
+            }
+            break;
+#endif
 #ifdef USE_ECHO
         case 'o':
             echopfx = optarg;
@@ -215,6 +390,31 @@ main(int argc, char **argv)
         case 'p':
             crypto_sock_path = optarg;
             break;
+#if defined(USE_THREADS) && defined(USE_EPOLL)
+        case 'P':
+            pipeline = 1;
+            break;
+#endif
+        case 'r':
+            cache_policy = ccnl_cache_str2policy(optarg);
+            if (cache_policy < 0)
+                goto usage;
+            break;
+        case 'R':
+        case 'T': {
+            long batch_l;
+            errno = 0;
+            batch_l = strtol(optarg, (char **) NULL, 10);
+            if (errno || batch_l < 1 || batch_l > CCNL_MAX_IO_BATCH) {
+                goto usage;
+            }
+            if (opt == 'R') {
+                rx_batch = (int) batch_l;
+            } else {
+                tx_batch = (int) batch_l;
+            }
+            break;
+        }
         case 's':
             suite = ccnl_str2suite(optarg);
             if (!ccnl_isSuite(suite))
@@ -230,6 +430,11 @@ main(int argc, char **argv)
             httpport = (int) httpport_l;
             break;
         }
+#ifdef USE_URING
+        case 'U':
+            use_uring = 1;
+            break;
+#endif
         case 'u':
             if (udpport1 == -1) {
                 long udpport1_l;
@@ -291,25 +496,67 @@ main(int argc, char **argv)
         case 'x':
             uxpath = optarg;
             break;
+#ifdef USE_XDP
+        case 'X':
+            if (!strcmp(optarg, "native")) {
+                ccnl_eth_xdp = CCNL_XDP_NATIVE;
+            } else if (!strcmp(optarg, "generic")) {
+                ccnl_eth_xdp = CCNL_XDP_GENERIC;
+            } else {
+                goto usage;
+            }
+            break;
+#endif
         case 'h':
         default:
 usage:
             fprintf(stderr,
                     "usage: %s [options]\n"
+                    "  -b MAX_CONTENT_BYTES (suffix k, M or G, 0: unlimited)\n"
                     "  -c MAX_CONTENT_ENTRIES\n"
                     "  -d databasedir\n"
                     "  -e ethdev\n"
+#ifdef USE_TPACKET
+                    "  -E (TPACKET_V3 rings for ethdev, for bulk traffic)\n"
+#endif
                     "  -g MIN_INTER_PACKET_INTERVAL\n"
                     "  -h\n"
+#if defined(USE_THREADS) && defined(USE_EPOLL)
+                    "  -H DEPTH (name components which select the shard,\n"
+                    "             shorter Interests go to all shards)\n"
+#endif
                     "  -i MIN_INTER_CCNMSG_INTERVAL\n"
+#ifdef USE_STREAM
+                    "  -l tcpport (stream faces)\n"
+                    "  -L unixpath (stream faces)\n"
+#endif
+#ifdef USE_SHM
+                    "  -m unixpath (shared memory faces)\n"
+#endif
+#ifdef USE_STREAM
+                    "  -N TCP_MODE (stream faces: nodelay, cork, nagle)\n"
+#endif
 #ifdef USE_ECHO
                     "  -o echo_prefix\n"
 #endif
                     "  -p crypto_face_ux_socket\n"
+#if defined(USE_THREADS) && defined(USE_EPOLL)
+                    "  -P (receive and transmit threads per UDP interface)\n"
+#endif
+                    "  -r CACHE_POLICY (lru, lfu, arc, s3fifo)\n"
+                    "  -R RX_BATCH (packets read per system call)\n"
                     "  -s SUITE (ccnb, ccnx2015, ndn2013)\n"
+#if defined(USE_THREADS) && defined(USE_EPOLL)
+                    "  -S SHARDS (threads, each owning a part of the names,\n"
+                    "             prefixes can be registered on UDP faces only)\n"
+#endif
                     "  -t tcpport (for HTML status page)\n"
+                    "  -T TX_BATCH (packets sent per system call, 1: at once)\n"
                     "  -u udpport (can be specified twice)\n"
                     "  -6 udp6port (can be specified twice)\n"
+#ifdef USE_URING
+                    "  -U (io_uring event loop)\n"
+#endif
 
 #ifdef USE_LOGGING
                     "  -v DEBUG_LEVEL (fatal, error, warning, info, debug, verbose, trace)\n"
@@ -319,6 +566,9 @@ usage:
 #endif
 #ifdef USE_UNIXSOCKET
                     "  -x unixpath\n"
+#endif
+#ifdef USE_XDP
+                    "  -X XDP_MODE (AF_XDP for ethdev: native, generic)\n"
 #endif
                     , argv[0]);
             exit(EXIT_FAILURE);
@@ -332,6 +582,36 @@ usage:
     if (httpport < 0) {
         httpport = opt;
     }
+#if defined(USE_THREADS) && defined(USE_EPOLL)
+    if (shards > 1) {
+        if (ethdev || wpandev
+#ifdef USE_STREAM
+            || tcpport >= 0 || streampath
+#endif
+#ifdef USE_SHM
+            || shmpath
+#endif
+            ) {
+            fprintf(stderr, "%s: -S works with UDP interfaces only\n", argv[0]);
+            exit(EXIT_FAILURE);
+        }
+        ccnl_udp_reuseport = 1;
+    }
+    if (pipeline && (shards > 1
+#ifdef USE_URING
+                     || use_uring
+#endif
+                     )) {
+        fprintf(stderr, "%s: -P works with the epoll loop and one shard only\n",
+                argv[0]);
+        exit(EXIT_FAILURE);
+    }
+#endif
+#ifdef USE_URING
+    if (use_uring) {
+        loop = ccnl_uring_loop;
+    }
+#endif
 
     ccnl_core_init();
 
@@ -346,29 +626,83 @@ usage:
     ccnl_relay_config(theRelay, ethdev, wpandev, udpport1, udpport2,
                       udp6port1, udp6port2, httpport,
                       uxpath, suite, max_cache_entries, crypto_sock_path);
+    theRelay->rx_batch = rx_batch;
+    theRelay->tx_batch = tx_batch;
+    ccnl_cache_set_policy(theRelay, cache_policy);
+    theRelay->max_cache_bytes = max_cache_bytes;
+    DEBUGMSG(INFO, "  cache policy: %s, max %zu bytes\n",
+             ccnl_cache_policy2str(cache_policy), max_cache_bytes);
     if (datadir) {
         ccnl_populate_cache(theRelay, datadir);
     }
 
 #ifdef USE_ECHO
     if (echopfx) {
-        struct ccnl_prefix_s *pfx;
-        char *dup = ccnl_strdup(echopfx);
-
-        pfx = ccnl_URItoPrefix(dup, suite, NULL);
-        if (pfx)
-            ccnl_echo_add(theRelay, pfx);
-        ccnl_free(dup);
+        ccnl_relay_echo(theRelay, echopfx, suite);
     }
 #endif
+#ifdef USE_STREAM
+    if (tcpport >= 0) {
+        sockunion su;
 
-    ccnl_io_loop(theRelay);
+        memset(&su, 0, sizeof(su));
+        su.ip4.sin_family = AF_INET;
+        su.ip4.sin_addr.s_addr = INADDR_ANY;
+        su.ip4.sin_port = htons((uint16_t) tcpport);
+        ccnl_stream_listen(theRelay, &su);
+    }
+    if (streampath) {
+        sockunion su;
 
-    while (eventqueue) {
-        ccnl_rem_timer(eventqueue);
+        memset(&su, 0, sizeof(su));
+        su.ux.sun_family = AF_UNIX;
+        strncpy(su.ux.sun_path, streampath, sizeof(su.ux.sun_path) - 1);
+        ccnl_stream_listen(theRelay, &su);
     }
+#endif
+#ifdef USE_SHM
+    if (shmpath) {
+        ccnl_shm_listen(theRelay, shmpath);
+    }
+#endif
 
+#if defined(USE_THREADS) && defined(USE_EPOLL)
+    if (shards > 1) {
+        struct ccnl_relay_args_s args = {
+            udpport1, udpport2, udp6port1, udp6port2,
+            suite, max_cache_entries, cache_policy, max_cache_bytes,
+            rx_batch, tx_batch, datadir, NULL
+        };
+#ifdef USE_ECHO
+        args.echopfx = echopfx;
+#endif
+        if (ccnl_shard_run(theRelay, shards, shard_depth, loop,
+                           ccnl_relay_shard_setup, &args) < 0) {
+            exit(EXIT_FAILURE);
+        }
+    } else if (pipeline) {
+        if (ccnl_pipeline_run(theRelay) < 0) {
+            exit(EXIT_FAILURE);
+        }
+    } else
+#endif
+    loop(theRelay);
+
+    DEBUGMSG(INFO, "cache: %lu hits, %lu misses, %lu evictions, %zu bytes\n",
+             theRelay->cache.hits, theRelay->cache.misses,
+             theRelay->cache.evictions, theRelay->cs_bytes);
+#ifdef USE_SLAB_MALLOC
+    for (opt = 0; opt < CCNL_MEM_TYPES; opt++) {
+        struct ccnl_mem_stats_s ms;
+
+        ccnl_mem_stats(opt, &ms);
+        DEBUGMSG(INFO, "memory %s: %zu objects, %zu bytes\n",
+                 ccnl_mem_type2str(opt), ms.objects, ms.bytes);
+    }
+    DEBUGMSG(INFO, "memory reserved: %zu bytes\n", ccnl_mem_reserved());
+#endif
     ccnl_core_cleanup(theRelay);
+    ccnl_timer_cleanup();
 #ifdef USE_HTTP_STATUS
     theRelay->http = ccnl_http_cleanup(theRelay->http);
 #endif
@@ -281,7 +281,7 @@ static inline void ccnl_evtimer_reset_interest_timeout(struct ccnl_interest_s *i
     evtimer_del((evtimer_t *)(&ccnl_evtimer), (evtimer_event_t *)&i->evtmsg_timeout);
     i->evtmsg_timeout.msg.type = CCNL_MSG_INT_TIMEOUT;
     i->evtmsg_timeout.msg.content.ptr = i;
-    ((evtimer_event_t *)&i->evtmsg_timeout)->offset = i->lifetime * 1000; // ms
+    ((evtimer_event_t *)&i->evtmsg_timeout)->offset = i->lifetime; // ms
     evtimer_add_msg(&ccnl_evtimer, &i->evtmsg_timeout, ccnl_event_loop_pid);
 }
 
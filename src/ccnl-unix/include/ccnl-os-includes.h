@@ -38,6 +38,34 @@
 # include <fcntl.h>
 # include <sys/ioctl.h>
 # include <sys/select.h>
+#ifdef USE_EPOLL
+# include <sys/epoll.h>
+#endif
+#ifdef USE_THREADS
+# include <poll.h>
+# include <pthread.h>
+# include <sys/eventfd.h>
+#endif
+#ifdef USE_TPACKET
+# include <sys/mman.h>
+#endif
+#ifdef USE_XDP
+# include <sys/mman.h>
+# include <sys/syscall.h>
+# include <linux/bpf.h>
+# include <linux/if_link.h>   // XDP_FLAGS_*
+# include <linux/if_xdp.h>
+#endif
+#ifdef USE_SHM
+# include <sys/eventfd.h>
+# include <sys/mman.h>   // memfd_create()
+#endif
+#ifdef USE_URING
+# include <poll.h>
+# include <sys/mman.h>
+# include <sys/syscall.h>
+# include <linux/io_uring.h>
+#endif
 # include <sys/socket.h>
 # include <sys/time.h>
 # include <sys/un.h>
@@ -50,6 +78,21 @@
 #include <arpa/inet.h>
 #include <netinet/in.h>
 #include <net/if.h> // IFNAMSIZE, if_nametoindex
+#ifdef USE_STREAM
+#  include <netinet/tcp.h> // TCP_NODELAY, TCP_CORK
+#endif
+#ifdef USE_GSO
+#  include <netinet/udp.h>
+#  ifndef SOL_UDP
+#    define SOL_UDP      17
+#  endif
+#  ifndef UDP_SEGMENT
+#    define UDP_SEGMENT  103 // older C libraries lack the offload options
+#  endif
+#  ifndef UDP_GRO
+#    define UDP_GRO      104
+#  endif
+#endif
 
 #ifdef _DEFAULT_SOURCE
   int inet_aton(const char *cp, struct in_addr *inp);
@@ -0,0 +1,64 @@
+/*
+ * @f ccnl-pipeline.h
+ * @b CCN lite, relay with receive, forwarding and transmit threads
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-17 created
+ */
+
+#ifndef CCNL_PIPELINE_H
+#define CCNL_PIPELINE_H
+
+#if defined(USE_THREADS) && defined(USE_EPOLL)
+
+#include "ccnl-relay.h"
+
+/**
+ * @brief Bytes of each ring between two stages of the pipeline
+ */
+#ifndef CCNL_PIPELINE_RING_SIZE
+#define CCNL_PIPELINE_RING_SIZE         (1024 * 1024)
+#endif
+
+/**
+ * @brief Seconds between two reports of the stages' queue depths
+ */
+#ifndef CCNL_PIPELINE_REPORT_INTERVAL
+#define CCNL_PIPELINE_REPORT_INTERVAL   10
+#endif
+
+/**
+ * @brief Runs the relay as a pipeline of threads
+ *
+ * Every UDP interface of @p relay gets a receive thread, which reads the
+ * socket, parses and hashes the packets' names and passes both on through
+ * a ring, and a transmit thread, which sends what the interface's queue
+ * was flushed into. The calling thread runs ccnl_io_loop() and is the only
+ * one to touch PIT, CS and faces; other interfaces, e.g. the UNIX socket,
+ * stay with it. Queue depths of the rings are logged every
+ * CCNL_PIPELINE_REPORT_INTERVAL seconds (INFO) and when the relay halts.
+ *
+ * @param[in] relay     The configured relay
+ *
+ * @return 0 on success, -1 if the threads could not be started
+ */
+int
+ccnl_pipeline_run(struct ccnl_relay_s *relay);
+
+#endif // USE_THREADS && USE_EPOLL
+
+#endif // CCNL_PIPELINE_H
@@ -0,0 +1,111 @@
+/*
+ * @f ccnl-shard.h
+ * @b CCN lite, relay partitioned over several threads
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-17 created
+ */
+
+#ifndef CCNL_SHARD_H
+#define CCNL_SHARD_H
+
+#if defined(USE_THREADS) && defined(USE_EPOLL)
+
+#include "ccnl-relay.h"
+
+/**
+ * @brief Upper limit of the number of shards
+ */
+#define CCNL_SHARD_MAX          64
+
+/**
+ * @brief Name components which select the shard unless configured
+ *
+ * A name and all its extensions must land on the same shard, or Data
+ * longer than its Interest (prefix matches, chunks, implicit digests)
+ * would miss the PIT entry. An Interest shorter than this goes to all
+ * shards, Data with a shorter name to the first one.
+ */
+#ifndef CCNL_SHARD_DEPTH
+#define CCNL_SHARD_DEPTH        2
+#endif
+
+/**
+ * @brief Owner returned by @ref ccnl_shard_owner for an Interest all
+ * shards get
+ */
+#define CCNL_SHARD_ALL          (-1)
+
+/**
+ * @brief Bytes of each ring between two shards
+ */
+#ifndef CCNL_SHARD_RING_SIZE
+#define CCNL_SHARD_RING_SIZE    (256 * 1024)
+#endif
+
+/**
+ * @brief Configures the relay of a shard, called in the shard's thread
+ * Opens the same UDP ports as the first shard, but no other interfaces,
+ * and loads the same content (the shard keeps only the names it owns).
+ */
+typedef void (*ccnl_shard_setup_func)(struct ccnl_relay_s *relay, void *aux);
+
+/**
+ * @brief Runs the relay on @p count threads, each owning a part of the names
+ *
+ * Every shard is a relay of its own with PIT, CS and faces, its UDP sockets
+ * share the ports with SO_REUSEPORT (see ccnl_udp_reuseport). A packet
+ * whose name belongs to another shard, see @ref ccnl_shard_owner, is
+ * passed on through a ring. The first shard is @p relay,
+ * configured by the caller, it keeps the management (UNIX socket) and
+ * status interfaces and copies its FIB to the others whenever a management
+ * request changed it. As the other shards have the UDP sockets only, prefixes
+ * registered on other faces are refused. Returns when the first shard halts.
+ *
+ * @param[in] relay     The first shard, configured with ccnl_udp_reuseport set
+ * @param[in] count     Number of shards (threads), 1..CCNL_SHARD_MAX
+ * @param[in] depth     Name components which select the shard, at least 1
+ * @param[in] loop      Event loop of every shard, e.g. ccnl_io_loop()
+ * @param[in] setup     Configures the relays of the other shards
+ * @param[in] aux       Passed to @p setup
+ *
+ * @return 0 on success, -1 if the shards could not be started
+ */
+int
+ccnl_shard_run(struct ccnl_relay_s *relay, int count, int depth,
+               int (*loop)(struct ccnl_relay_s*),
+               ccnl_shard_setup_func setup, void *aux);
+
+/**
+ * @brief The shard owning the name of a packet
+ *
+ * Hashes the first @p depth components of the name. An Interest with
+ * fewer components goes to all shards as it may match Data of any, Data
+ * with fewer to the first shard, as do management requests.
+ *
+ * @param[in] count     Number of shards
+ * @param[in] depth     Name components which select the shard
+ * @param[in] pkt       The packet, e.g. parsed by ccnl_core_peek_prefix()
+ *
+ * @return the shard, 0..count-1, or CCNL_SHARD_ALL
+ */
+int
+ccnl_shard_owner(int count, int depth, struct ccnl_pkt_s *pkt);
+
+#endif // USE_THREADS && USE_EPOLL
+
+#endif // CCNL_SHARD_H
@@ -0,0 +1,238 @@
+/*
+ * @f ccnl-shm.h
+ * @b CCN lite, shared memory faces for applications on the same host
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-17 created
+ */
+
+#ifndef CCNL_SHM_H
+#define CCNL_SHM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef USE_SHM
+
+#include "ccnl-ring.h"
+#include "ccnl-relay.h"
+#include "ccnl-if.h"
+#include "ccnl-buf.h"
+#include "ccnl-sockunion.h"
+
+// An application connects to the relay's SOCK_SEQPACKET socket and sends
+// a struct ccnl_shm_setup_s. The relay answers with one as well, which
+// carries three descriptors: a memfd with the two rings, sealed against
+// resizing, and one eventfd per direction. The memfd starts with a struct
+// ccnl_shm_hdr_s, padded to CCNL_SHM_HDR_SIZE bytes, followed by the
+// buffer of the ring towards the relay and that of the ring towards the
+// application. The face lasts as long as the connection.
+
+#define CCNL_SHM_MAGIC          0x63636e6d  // "ccnm"
+#define CCNL_SHM_VERSION        1
+#define CCNL_SHM_HDR_SIZE       4096
+
+/**
+ * @brief Size of the buffer of each ring unless the application asks for
+ * another one
+ */
+#ifndef CCNL_SHM_RING_SIZE
+#define CCNL_SHM_RING_SIZE      (4 * 1024 * 1024)
+#endif
+
+/**
+ * @brief Largest ring buffer the relay maps
+ */
+#ifndef CCNL_SHM_RING_MAX
+#define CCNL_SHM_RING_MAX       (64 * 1024 * 1024)
+#endif
+
+/**
+ * @brief Largest packet on a shared memory face
+ */
+#ifndef CCNL_SHM_MAX_PACKET_SIZE
+#define CCNL_SHM_MAX_PACKET_SIZE (64 * 1024)
+#endif
+
+/**
+ * @brief Index of the descriptors passed with the relay's setup message
+ */
+enum {
+    CCNL_SHM_FD_MEM = 0,        /**< the memfd */
+    CCNL_SHM_FD_UP,             /**< eventfd the application rings */
+    CCNL_SHM_FD_DOWN,           /**< eventfd the relay rings */
+    CCNL_SHM_FD_COUNT,
+};
+
+/**
+ * @brief Message exchanged over the socket to set a face up
+ */
+struct ccnl_shm_setup_s {
+    uint32_t magic;             /**< CCNL_SHM_MAGIC */
+    uint32_t version;           /**< CCNL_SHM_VERSION */
+    uint32_t ring_size;         /**< ring buffer size, 0 for the default */
+};
+
+/**
+ * @brief Indices of one ring in the shared memory
+ *
+ * Both free running byte counts, see struct ccnl_ring_s, each end keeps
+ * its own one privately too and never trusts the other's.
+ */
+struct ccnl_shm_ctl_s {
+    uint32_t head;              /**< bytes appended, written by the producer */
+    uint8_t pad0[CCNL_CACHE_LINE - sizeof(uint32_t)];
+    uint32_t tail;              /**< bytes taken, written by the consumer */
+    uint32_t wait;              /**< set by a producer waiting for room */
+    uint8_t pad1[CCNL_CACHE_LINE - 2 * sizeof(uint32_t)];
+};
+
+/**
+ * @brief Start of the shared memory
+ */
+struct ccnl_shm_hdr_s {
+    uint32_t magic;             /**< CCNL_SHM_MAGIC */
+    uint32_t version;           /**< CCNL_SHM_VERSION */
+    uint32_t ring_size;         /**< size of each ring buffer */
+    uint8_t pad[CCNL_CACHE_LINE - 3 * sizeof(uint32_t)];
+    struct ccnl_shm_ctl_s up;   /**< application to relay */
+    struct ccnl_shm_ctl_s down; /**< relay to application */
+};
+
+/**
+ * @brief One end of a ring in shared memory, private to its process
+ *
+ * A ring of variable sized records like struct ccnl_ring_s, but the peer
+ * may be another, untrusted, process: the consumer checks the indices and
+ * record lengths it reads, and a broken ring reads as an error.
+ */
+struct ccnl_shm_ring_s {
+    struct ccnl_shm_ctl_s *ctl;
+    uint8_t *buf;
+    uint32_t size;              /**< buffer size, a power of two */
+    uint32_t pos;               /**< producer: head, consumer: tail */
+    uint32_t seen;              /**< the peer's index as last read */
+    uint32_t next;              /**< consumer: bytes peeked at */
+    uint32_t skip;              /**< producer: bytes the reservation skips */
+};
+
+/**
+ * @brief Returns the size of the shared memory for rings of @p ring_size
+ */
+size_t
+ccnl_shm_mem_size(uint32_t ring_size);
+
+/**
+ * @brief Sets up the ends of both rings in the mapped shared memory
+ *
+ * @param[in] mem   The mapping, its header filled in
+ * @param[in] app   Whether the caller is the application, it produces
+ *                  into the up ring then
+ * @param[out] tx   The end of the ring the caller produces into
+ * @param[out] rx   The end of the ring the caller consumes from
+ */
+void
+ccnl_shm_ring_attach(void *mem, int app, struct ccnl_shm_ring_s *tx,
+                     struct ccnl_shm_ring_s *rx);
+
+/**
+ * @brief Reserves space for a record of @p len bytes (producer)
+ *
+ * @return where the record is to be written, NULL if the ring is full,
+ *         @p len exceeds CCNL_SHM_MAX_PACKET_SIZE or the ring is broken
+ */
+void*
+ccnl_shm_ring_reserve(struct ccnl_shm_ring_s *r, size_t len);
+
+/**
+ * @brief Appends the record written to the last reservation (producer)
+ *
+ * @return 1 if the consumer may be waiting, its eventfd is to be rung
+ * @return 0 otherwise
+ */
+int
+ccnl_shm_ring_commit(struct ccnl_shm_ring_s *r, size_t len);
+
+/**
+ * @brief Asks the consumer to ring once it made room (producer)
+ *
+ * Called when ccnl_shm_ring_reserve() failed, which is to be tried again
+ * before waiting for the eventfd.
+ */
+void
+ccnl_shm_ring_want_room(struct ccnl_shm_ring_s *r);
+
+/**
+ * @brief Returns the oldest record not peeked at yet (consumer)
+ *
+ * The record stays valid until ccnl_shm_ring_release(), but its bytes
+ * are the peer's to change; a relay copies them before parsing.
+ *
+ * @return 1 and the record in @p data and @p len
+ * @return 0 if the ring is empty
+ * @return -1 if the ring is broken
+ */
+int
+ccnl_shm_ring_peek(struct ccnl_shm_ring_s *r, uint8_t **data, size_t *len);
+
+/**
+ * @brief Removes the records returned by ccnl_shm_ring_peek() (consumer)
+ *
+ * @return 1 if the producer waits for room, its eventfd is to be rung
+ * @return 0 otherwise
+ */
+int
+ccnl_shm_ring_release(struct ccnl_shm_ring_s *r);
+
+/**
+ * @brief Adds an interface which sets shared memory faces up for the
+ * applications connecting to @p path
+ *
+ * Each connection becomes a face of the interface with a made up path as
+ * its peer address. Data an application sends without an Interest asking
+ * for it is added to the content store (CCNL_FACE_FLAGS_PUSH). Packets to
+ * an application whose ring is full are dropped.
+ *
+ * Needs the epoll event loop (or the io_uring one), the faces are served
+ * through ccnl_io_watch().
+ *
+ * @param[in] relay     The relay
+ * @param[in] path      UNIX path to listen on, removed first
+ *
+ * @return index of the new interface, -1 on error
+ */
+int
+ccnl_shm_listen(struct ccnl_relay_s *relay, char *path);
+
+/**
+ * @brief Copies a packet into the ring of the face to @p dest
+ *
+ * @return 0 on success, -1 if there is no such face or its ring is full
+ * (the packet is dropped)
+ */
+int
+ccnl_shm_put(struct ccnl_if_s *ifc, sockunion *dest, struct ccnl_buf_s *buf);
+
+/**
+ * @brief Rings the eventfds of the faces ccnl_shm_put() woke up
+ */
+void
+ccnl_shm_kick(struct ccnl_if_s *ifc);
+
+#endif // USE_SHM
+
+#endif // CCNL_SHM_H
@@ -0,0 +1,122 @@
+/*
+ * @f ccnl-stream.h
+ * @b CCN lite, TCP and UNIX stream faces
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-17 created
+ */
+
+#ifndef CCNL_STREAM_H
+#define CCNL_STREAM_H
+
+#ifdef USE_STREAM
+
+#include "ccnl-relay.h"
+#include "ccnl-if.h"
+#include "ccnl-buf.h"
+#include "ccnl-sockunion.h"
+
+/**
+ * @brief How TCP connections of stream faces pass small packets
+ */
+enum {
+    CCNL_STREAM_NODELAY = 0,    /**< TCP_NODELAY, each flush goes out at once */
+    CCNL_STREAM_CORK,           /**< TCP_CORK, pushed after each flush */
+    CCNL_STREAM_NAGLE,          /**< the kernel's default */
+};
+
+/**
+ * @brief Largest packet a stream face accepts, longer ones close the
+ * connection
+ */
+#ifndef CCNL_STREAM_MAX_PACKET_SIZE
+#define CCNL_STREAM_MAX_PACKET_SIZE     (1024 * 1024)
+#endif
+
+/**
+ * @brief Bytes a connection may have waiting for the socket, packets
+ * beyond are dropped
+ */
+#ifndef CCNL_STREAM_MAX_OUTBUF
+#define CCNL_STREAM_MAX_OUTBUF          (4 * 1024 * 1024)
+#endif
+
+/**
+ * @brief Waiting bytes from which on a connection is not read from until
+ * its peer took them
+ */
+#ifndef CCNL_STREAM_OUTBUF_HIWAT
+#define CCNL_STREAM_OUTBUF_HIWAT        (1024 * 1024)
+#endif
+
+/**
+ * @brief Set before ccnl_stream_listen() to the CCNL_STREAM_* mode of the
+ * TCP connections accepted from then on
+ */
+extern int ccnl_stream_tcp_mode;
+
+/**
+ * @brief Adds an interface which accepts stream connections on @p addr
+ *
+ * @p addr is an AF_INET address for TCP or an AF_UNIX path, which is
+ * removed first. Each connection becomes a face of the interface with the
+ * peer's address, or a made up path for UNIX peers, which is removed with
+ * the connection. Packets are cut out of the byte stream by the lengths in
+ * their TLV headers (see ccnl_pkt_framelen()), packets sent to a face are
+ * buffered per connection and written without blocking; a connection which
+ * has CCNL_STREAM_OUTBUF_HIWAT bytes waiting is not read from, so that
+ * TCP's flow control holds its peer back.
+ *
+ * Needs the epoll event loop (or the io_uring one), the connections are
+ * served through ccnl_io_watch().
+ *
+ * @param[in] relay     The relay
+ * @param[in] addr      Address to listen on
+ *
+ * @return index of the new interface, -1 on error
+ */
+int
+ccnl_stream_listen(struct ccnl_relay_s *relay, sockunion *addr);
+
+/**
+ * @brief Appends a packet to the output buffer of the connection to @p dest
+ *
+ * @return 0 on success, -1 if there is no such connection or its buffer
+ * is full (the packet is dropped)
+ */
+int
+ccnl_stream_put(struct ccnl_if_s *ifc, sockunion *dest,
+                struct ccnl_buf_s *buf);
+
+/**
+ * @brief Writes the output buffers of the connections ccnl_stream_put()
+ * appended to, as far as their sockets take them
+ */
+void
+ccnl_stream_kick(struct ccnl_if_s *ifc);
+
+/**
+ * @brief Sends a packet to the connection to @p dest, the bytes the socket
+ * does not take at once are buffered
+ */
+void
+ccnl_stream_TX(struct ccnl_if_s *ifc, sockunion *dest,
+               struct ccnl_buf_s *buf);
+
+#endif // USE_STREAM
+
+#endif // CCNL_STREAM_H
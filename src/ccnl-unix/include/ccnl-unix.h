@@ -89,14 +89,40 @@ void
 ccnl_ageing(void *relay, void *aux);
 
 #if defined(USE_IPV4) || defined(USE_IPV6)
+/**
+ * @brief Non-zero: UDP interfaces opened from now on set SO_REUSEPORT
+ */
+extern int ccnl_udp_reuseport;
+
 void
 ccnl_relay_udp(struct ccnl_relay_s *relay, int32_t port, int af, int suite);
 #endif
 
+#ifdef USE_TPACKET
+/**
+ * @brief Non-zero: Ethernet interfaces opened from now on use TPACKET_V3
+ * rings
+ *
+ * Off by default: a ring block is handed over once full or after its
+ * retire timeout, which adds up to a millisecond to every frame of a
+ * request/response exchange. The rings pay off for bulk traffic.
+ */
+extern int ccnl_eth_tpacket;
+#endif
+
 void
 ccnl_ll_TX(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
            sockunion *dest, struct ccnl_buf_s *buf);
 
+#ifdef USE_MMSG
+/**
+ * @brief Sends the queue of an interface with as few sendmmsg() calls as
+ * possible, link layer frames go out one by one through ccnl_ll_TX()
+ */
+void
+ccnl_ll_TX_batch(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc);
+#endif
+
 void
 ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
                   int32_t udpport1, int32_t udpport2,
@@ -104,9 +130,120 @@ ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
                   char *uxpath, int suite, int max_cache_entries,
                   char *crypto_face_path);
 
+#ifdef USE_EPOLL
+/**
+ * @brief A descriptor served by the epoll based event loop
+ *
+ * Interfaces and the HTTP status server are registered by ccnl_io_loop()
+ * itself, other descriptors (e.g. stream faces) use ccnl_io_watch().
+ */
+struct ccnl_io_watch_s {
+    int fd;
+    uint32_t events;                    /**< registered EPOLL* flags */
+    void (*ready)(struct ccnl_relay_s *ccnl, struct ccnl_io_watch_s *w,
+                  uint32_t events);     /**< called with the ready events */
+    void *aux;
+    uint32_t deferred;                  /**< events to replay, see ccnl_io_defer() */
+    struct ccnl_io_watch_s *next;       /**< next deferred watch */
+    char active;                        /**< registered with the epoll instance */
+};
+
+/**
+ * @brief Registers @p fd with the event loop
+ *
+ * @return 0 on success, -1 on error
+ */
+int
+ccnl_io_watch(struct ccnl_io_watch_s *w, int fd, uint32_t events,
+              void (*ready)(struct ccnl_relay_s*, struct ccnl_io_watch_s*,
+                            uint32_t),
+              void *aux);
+
+/**
+ * @brief Changes the events a watch waits for, no-op if they are unchanged
+ */
+int
+ccnl_io_modify(struct ccnl_io_watch_s *w, uint32_t events);
+
+/**
+ * @brief Removes a watch from the event loop, the descriptor stays open
+ */
+void
+ccnl_io_unwatch(struct ccnl_io_watch_s *w);
+
+/**
+ * @brief Removes a watch from the event loop and frees @p mem, the memory
+ * the watch lives in
+ *
+ * Called from a handler, @p mem is freed once the loop has served the
+ * ready events of this round, which may still point to the watch.
+ */
+void
+ccnl_io_release(struct ccnl_io_watch_s *w, void *mem);
+
+/**
+ * @brief Calls the watch's handler again in the next round of the loop
+ *
+ * For edge triggered descriptors which stopped reading before the socket
+ * was drained, to give the other descriptors their turn.
+ */
+void
+ccnl_io_defer(struct ccnl_io_watch_s *w, uint32_t events);
+#endif // USE_EPOLL
+
+/**
+ * @brief Reads up to rx_batch packets from interface @p i with one system
+ * call and hands them to the core, or to ccnl_RX_steer_ptr first
+ *
+ * @param[in] flags     recv() flags, e.g. MSG_DONTWAIT
+ *
+ * @return the number of datagrams read, -1 on error (see errno)
+ */
+int
+ccnl_io_recv(struct ccnl_relay_s *ccnl, int i, int flags);
+
+/**
+ * @brief Hands a received packet of interface @p i to the core, or to
+ * ccnl_RX_steer_ptr first; link layer frames still carry their header
+ */
+void
+ccnl_io_dispatch(struct ccnl_relay_s *ccnl, int i, uint8_t *buf, size_t len,
+                 sockunion *src_addr);
+
+#if defined(USE_TPACKET) || defined(USE_XDP)
+/**
+ * @brief Memory mapped rings of an Ethernet interface, ccnl_if_s.ring
+ * points to them: TPACKET_V3 rings of its packet socket or an AF_XDP
+ * socket (see ccnl_open_xdpdev())
+ */
+struct ccnl_ll_ring_s {
+    /** hands up to @p max received frames to ccnl_io_dispatch(), returns
+     *  their number or -1 (EAGAIN) like ccnl_io_recv() */
+    int (*recv)(struct ccnl_relay_s *ccnl, int i, int max);
+    /** puts a frame to @p dst into the TX ring, -1 if the ring is full */
+    int (*put)(struct ccnl_if_s *ifc, uint8_t *dst,
+               uint8_t *data, size_t datalen);
+    /** sends the frames put into the TX ring */
+    void (*kick)(struct ccnl_if_s *ifc);
+};
+#endif
+
 int
 ccnl_io_loop(struct ccnl_relay_s *ccnl);
 
+#ifdef USE_URING
+/**
+ * @brief Runs the relay on io_uring instead of epoll
+ *
+ * Interfaces receive with multishot recvmsg into registered buffers and
+ * send through the ring, the HTTP status server and ccnl_io_watch()
+ * descriptors keep working through the epoll instance. Falls back to
+ * ccnl_io_loop() if the kernel lacks io_uring.
+ */
+int
+ccnl_uring_loop(struct ccnl_relay_s *ccnl);
+#endif
+
 void
 ccnl_populate_cache(struct ccnl_relay_s *ccnl, char *path);
 
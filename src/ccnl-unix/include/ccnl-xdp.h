@@ -0,0 +1,81 @@
+/*
+ * @f ccnl-xdp.h
+ * @b CCN lite, AF_XDP sockets for Ethernet interfaces
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-17 created
+ */
+
+#ifndef CCNL_XDP_H
+#define CCNL_XDP_H
+
+#ifdef USE_XDP
+
+#include "ccnl-if.h"
+
+/**
+ * @brief Where the XDP program of an AF_XDP interface runs
+ */
+enum {
+    CCNL_XDP_OFF = 0,           /**< AF_PACKET socket (ccnl_open_ethdev()) */
+    CCNL_XDP_NATIVE,            /**< in the driver, generic if it lacks XDP */
+    CCNL_XDP_GENERIC,           /**< in the network stack (SKB mode) */
+};
+
+/**
+ * @brief Frames of the UMEM (power of two), half for receiving, half
+ * for transmitting
+ */
+#ifndef CCNL_XDP_FRAMES
+#define CCNL_XDP_FRAMES         4096
+#endif
+
+/**
+ * @brief Bytes of a UMEM frame, holds an Ethernet frame of 1500 bytes
+ */
+#define CCNL_XDP_FRAME_SIZE     2048
+
+/**
+ * @brief Set before ccnl_relay_config() to open its Ethernet interface
+ * with ccnl_open_xdpdev() in this mode
+ */
+extern int ccnl_eth_xdp;
+
+/**
+ * @brief Opens an AF_XDP socket on queue 0 of @p devname for frames of
+ * CCNL_ETH_TYPE
+ *
+ * Attaches an XDP program which redirects these frames into the socket
+ * and passes all others to the network stack, the program is detached
+ * when the interface is cleaned up (or the process exits). The socket is
+ * bound in zero copy mode if the driver supports it, in copy mode
+ * otherwise. Sets the interface's link layer address and its ring (see
+ * struct ccnl_ll_ring_s), the event loops then receive and transmit
+ * through the UMEM.
+ *
+ * @param[in] devname   Name of the network device
+ * @param[in] i         Interface to set up
+ * @param[in] mode      CCNL_XDP_NATIVE or CCNL_XDP_GENERIC
+ *
+ * @return the socket, -1 on error (nothing is left attached)
+ */
+int
+ccnl_open_xdpdev(char *devname, struct ccnl_if_s *i, int mode);
+
+#endif // USE_XDP
+
+#endif // CCNL_XDP_H
@@ -0,0 +1,608 @@
+/*
+ * @f ccnl-pipeline.c
+ * @b CCN lite, relay with receive, forwarding and transmit threads
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-17 created
+ */
+
+#if defined(USE_MMSG) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // sendmmsg()
+#endif
+
+#include "ccnl-unix.h"
+#include "ccnl-pipeline.h"
+
+#include "ccnl-os-includes.h"
+
+#include "ccnl-core.h"
+#include "ccnl-dispatch.h"
+#include "ccnl-pkt-switch.h"
+
+#if defined(USE_THREADS) && defined(USE_EPOLL)
+
+// The forwarding thread owns the relay. Receive threads copy what they
+// read into their ring to it and wake it through its eventfd when the
+// ring was empty; the forwarding thread copies what it sends into the
+// ring of the interface's transmit thread. Each ring has one producer and
+// one consumer, and the packets never leave the thread which allocated
+// them (the allocator's caches are per thread).
+
+// records read from the receive rings before the descriptors get their turn
+#define CCNL_PIPELINE_RX_BUDGET         256
+// the receive buffers are thread local, see ccnl_io_recv()
+#define CCNL_PIPELINE_STACK_SIZE        (16 * 1024 * 1024)
+
+// counters are written by one thread and read by the forwarding thread
+#define CCNL_PIPELINE_COUNT(c)  __atomic_store_n(&(c), (c) + 1, __ATOMIC_RELAXED)
+#define CCNL_PIPELINE_READ(c)   __atomic_load_n(&(c), __ATOMIC_RELAXED)
+
+// what a ring record carries in front of the packet
+struct ccnl_pipeline_pkt_s {
+    int ifndx;
+    uint32_t addrlen;
+    sockunion addr;             // source or destination
+    // receive records: the name the receive thread parsed, namesize bytes
+    // of a struct ccnl_pkt_name_s at CCNL_PIPELINE_NAME(rec), 0: none
+    uint32_t namesize;
+    uint32_t nameoff;           // of the name in the packet
+};
+
+#define CCNL_PIPELINE_ALIGN(len)        (((len) + 7) & ~(size_t) 7)
+#define CCNL_PIPELINE_NAME(rec)         ((struct ccnl_pkt_name_s *) \
+    ((uint8_t *) (rec) + CCNL_PIPELINE_ALIGN(sizeof(*(rec)))))
+
+struct ccnl_pipeline_s;
+
+// one interface's receive and transmit stage
+struct ccnl_pipeline_if_s {
+    struct ccnl_pipeline_s *all;
+    int ifndx;
+    pthread_t rx_thread, tx_thread;
+    char rx_started, tx_started;
+    struct ccnl_ring_s rx;      // receive thread -> forwarding thread
+    struct ccnl_ring_s tx;      // forwarding thread -> transmit thread
+    int tx_efd;                 // eventfd the transmit thread sleeps on
+    // written by the receive thread
+    uint32_t received;          // packets passed on
+    uint32_t rx_dropped;        // packets lost to a full ring
+    uint32_t malformed;         // packets of no known format
+    // written by the forwarding thread
+    uint32_t rx_maxdepth;
+    uint32_t tx_maxdepth;
+    uint32_t tx_dropped;        // packets lost to a full ring
+    // written by the transmit thread
+    uint32_t sent;
+    uint32_t failed;            // sends which returned an error
+};
+
+struct ccnl_pipeline_s {
+    struct ccnl_relay_s *relay;
+    int count;                  // interfaces served by threads
+    struct ccnl_pipeline_if_s stage[CCNL_MAX_INTERFACES];
+    int stage_of[CCNL_MAX_INTERFACES]; // interface -> stage, -1: none
+    int efd;                    // eventfd of the forwarding thread
+    int halt_efd;               // readable once the threads are to stop
+    int halt;
+    struct ccnl_io_watch_s watch;
+    void *report_timer;
+    uint32_t forwarded;         // packets taken from the receive rings
+    uint32_t reported;          // forwarded at the last report
+    // the relay's own send functions, for the other interfaces
+    void (*ll_TX)(struct ccnl_relay_s*, struct ccnl_if_s*, sockunion*,
+                  struct ccnl_buf_s*);
+    void (*ll_TX_batch)(struct ccnl_relay_s*, struct ccnl_if_s*);
+};
+
+// the forwarding thread's pipeline, the receive thread's stage
+static struct ccnl_pipeline_s *ccnl_pipeline;
+static CCNL_THREAD_LOCAL struct ccnl_pipeline_if_s *ccnl_pipeline_rx_self;
+
+static void
+ccnl_pipeline_wake(int efd)
+{
+    uint64_t one = 1;
+
+    if (write(efd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        DEBUGMSG(WARNING, "pipeline: eventfd write: %s\n", strerror(errno));
+    }
+}
+
+static uint32_t
+ccnl_pipeline_addrlen(sockunion *su)
+{
+    switch (su->sa.sa_family) {
+#ifdef USE_IPV4
+    case AF_INET:
+        return sizeof(su->ip4);
+#endif
+#ifdef USE_IPV6
+    case AF_INET6:
+        return sizeof(su->ip6);
+#endif
+    default:
+        return 0;
+    }
+}
+
+// receive thread: parses and hashes the packet's name and passes both on
+// to the forwarding thread, called by ccnl_io_recv()
+static int
+ccnl_pipeline_steer(struct ccnl_relay_s *relay, int ifndx, uint8_t *data,
+                    size_t len, sockunion *src)
+{
+    struct ccnl_pipeline_if_s *self = ccnl_pipeline_rx_self;
+    struct ccnl_pipeline_pkt_s *rec;
+    struct ccnl_pkt_name_s *name;
+    struct ccnl_pkt_rx_s rx;
+    struct ccnl_prefix_s *pfx;
+    size_t hdrlen, namesize = 0;
+    uint32_t i;
+    (void) relay;
+
+    if (!self) {
+        // the forwarding thread's own interfaces
+        return 0;
+    }
+    pfx = ccnl_core_peek_prefix(&rx, data, len);
+    if (pfx) {
+        (void) ccnl_prefix_hash(pfx, pfx->compcnt);
+        namesize = CCNL_PIPELINE_ALIGN(offsetof(struct ccnl_pkt_name_s, comp) +
+                                       pfx->compcnt * sizeof(name->comp[0]));
+    } else {
+        // no name, e.g. a fragment, the forwarding thread finds out
+        uint8_t *cp = data;
+        size_t cplen = len, skip;
+        int32_t enc;
+        int suite = -1;
+
+        while (!ccnl_switch_dehead(&cp, &cplen, &enc))
+            suite = ccnl_enc2suite(enc);
+        if (suite == -1)
+            suite = ccnl_pkt2suite(cp, cplen, &skip);
+        if (!ccnl_isSuite(suite)) {
+            CCNL_PIPELINE_COUNT(self->malformed);
+            return 1;
+        }
+    }
+
+    hdrlen = CCNL_PIPELINE_ALIGN(sizeof(*rec)) + namesize;
+    rec = (struct ccnl_pipeline_pkt_s *) ccnl_ring_reserve(&self->rx,
+                                                           hdrlen + len);
+    if (!rec) {
+        CCNL_PIPELINE_COUNT(self->rx_dropped);
+        return 1;
+    }
+    rec->ifndx = ifndx;
+    rec->addr = *src;
+    rec->addrlen = ccnl_pipeline_addrlen(src);
+    rec->namesize = (uint32_t) namesize;
+    if (pfx) {
+        name = CCNL_PIPELINE_NAME(rec);
+        name->nameptr = NULL;
+        name->namelen = (uint32_t) pfx->namelen;
+        name->compcnt = pfx->compcnt;
+        name->haschunknum = pfx->chunknum != NULL;
+        name->chunknum = pfx->chunknum ? *pfx->chunknum : 0;
+        for (i = 0; i < pfx->compcnt; i++) {
+            name->comp[i].off = (uint32_t) (pfx->comp[i] - pfx->nameptr);
+            name->comp[i].len = (uint32_t) pfx->complen[i];
+            name->comp[i].hash = pfx->comphash[i];
+        }
+        rec->nameoff = (uint32_t) (pfx->nameptr - data);
+    }
+    memcpy((uint8_t *) rec + hdrlen, data, len);
+    if (ccnl_ring_commit(&self->rx, 0, hdrlen + len)) {
+        ccnl_pipeline_wake(self->all->efd);
+    }
+    CCNL_PIPELINE_COUNT(self->received);
+    return 1;
+}
+
+static void*
+ccnl_pipeline_rx_main(void *arg)
+{
+    struct ccnl_pipeline_if_s *self = (struct ccnl_pipeline_if_s *) arg;
+    struct ccnl_pipeline_s *all = self->all;
+    struct pollfd fds[2];
+
+    ccnl_pipeline_rx_self = self;
+    fds[0].fd = all->relay->ifs[self->ifndx].sock;
+    fds[0].events = POLLIN;
+    fds[1].fd = all->halt_efd;
+    fds[1].events = POLLIN;
+    while (!__atomic_load_n(&all->halt, __ATOMIC_ACQUIRE)) {
+        if (ccnl_io_recv(all->relay, self->ifndx, MSG_DONTWAIT) >= 0) {
+            continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            // e.g. an ICMP error of an earlier send
+            DEBUGMSG(DEBUG, "pipeline: recv on interface %d: %s\n",
+                     self->ifndx, strerror(errno));
+            continue;
+        }
+        if (poll(fds, 2, -1) < 0 && errno != EINTR) {
+            perror("poll");
+            break;
+        }
+    }
+    return NULL;
+}
+
+// forwarding thread: serves the packets the receive threads passed on
+static void
+ccnl_pipeline_ready(struct ccnl_relay_s *relay, struct ccnl_io_watch_s *w,
+                    uint32_t events)
+{
+    struct ccnl_pipeline_s *all = (struct ccnl_pipeline_s *) w->aux;
+    struct ccnl_pipeline_if_s *s;
+    struct ccnl_pipeline_pkt_s *rec;
+    struct ccnl_pkt_name_s *name;
+    uint64_t cnt;
+    uint32_t tag, depth;
+    uint8_t *data;
+    size_t len, hdrlen;
+    int k, total = 0;
+    (void) events;
+
+    // reset first, producers signal again once they find a ring empty
+    if (read(all->efd, &cnt, sizeof(cnt)) < 0 && errno != EAGAIN) {
+        DEBUGMSG(WARNING, "pipeline: eventfd read: %s\n", strerror(errno));
+    }
+    for (k = 0; k < all->count; k++) {
+        s = all->stage + k;
+        depth = ccnl_ring_depth(&s->rx);
+        if (depth > s->rx_maxdepth) {
+            s->rx_maxdepth = depth;
+        }
+        while (total < CCNL_PIPELINE_RX_BUDGET &&
+               (rec = (struct ccnl_pipeline_pkt_s *)
+                      ccnl_ring_peek(&s->rx, &tag, &len))) {
+            hdrlen = CCNL_PIPELINE_ALIGN(sizeof(*rec)) + rec->namesize;
+            data = (uint8_t *) rec + hdrlen;
+            // the parser takes the name from the record
+            name = rec->namesize ? CCNL_PIPELINE_NAME(rec) : NULL;
+            if (name) {
+                name->nameptr = data + rec->nameoff;
+            }
+            relay->rx_name = name;
+            ccnl_core_RX(relay, rec->ifndx, data, len - hdrlen,
+                         &rec->addr.sa, rec->addrlen);
+            relay->rx_name = NULL;
+            ccnl_ring_release(&s->rx);
+            all->forwarded++;
+            total++;
+        }
+    }
+    if (total >= CCNL_PIPELINE_RX_BUDGET) {
+        ccnl_io_defer(w, EPOLLIN);
+    }
+}
+
+// forwarding thread: passes a packet to the interface's transmit thread,
+// replaces ccnl_ll_TX()
+static void
+ccnl_pipeline_TX(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
+                 sockunion *dest, struct ccnl_buf_s *buf)
+{
+    struct ccnl_pipeline_s *all = ccnl_pipeline;
+    struct ccnl_pipeline_if_s *s;
+    struct ccnl_pipeline_pkt_s *rec;
+    uint32_t addrlen = ccnl_pipeline_addrlen(dest), depth;
+
+    if (!ifc->piped || !addrlen) {
+        all->ll_TX(ccnl, ifc, dest, buf);
+        return;
+    }
+    s = all->stage + all->stage_of[ifc - ccnl->ifs];
+    rec = (struct ccnl_pipeline_pkt_s *) ccnl_ring_reserve(&s->tx,
+                                                sizeof(*rec) + buf->datalen);
+    if (!rec) {
+        s->tx_dropped++;
+        return;
+    }
+    rec->ifndx = s->ifndx;
+    rec->addr = *dest;
+    rec->addrlen = addrlen;
+    memcpy(rec + 1, buf->data, buf->datalen);
+    if (ccnl_ring_commit(&s->tx, 0, sizeof(*rec) + buf->datalen)) {
+        ccnl_pipeline_wake(s->tx_efd);
+    }
+    depth = ccnl_ring_depth(&s->tx);
+    if (depth > s->tx_maxdepth) {
+        s->tx_maxdepth = depth;
+    }
+}
+
+// forwarding thread: flushes an interface's queue, replaces
+// ccnl_ll_TX_batch()
+static void
+ccnl_pipeline_TX_batch(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc)
+{
+    if (!ifc->piped) {
+        ccnl_pipeline->ll_TX_batch(ccnl, ifc);
+        return;
+    }
+    while (ifc->qlen > 0) {
+        ccnl_interface_CTS(ccnl, ifc);
+    }
+}
+
+// transmit thread: sends the records peeked at, up to the batch size
+#ifdef USE_MMSG
+static int
+ccnl_pipeline_send(struct ccnl_pipeline_if_s *self, int sock,
+                   struct ccnl_pipeline_pkt_s **recs, size_t *lens, int cnt)
+{
+    struct mmsghdr msgs[CCNL_MAX_IO_BATCH];
+    struct iovec iov[CCNL_MAX_IO_BATCH];
+    int k, n, off = 0;
+
+    memset(msgs, 0, cnt * sizeof(msgs[0]));
+    for (k = 0; k < cnt; k++) {
+        iov[k].iov_base = recs[k] + 1;
+        iov[k].iov_len = lens[k] - sizeof(*recs[k]);
+        msgs[k].msg_hdr.msg_name = &recs[k]->addr;
+        msgs[k].msg_hdr.msg_namelen = recs[k]->addrlen;
+        msgs[k].msg_hdr.msg_iov = iov + k;
+        msgs[k].msg_hdr.msg_iovlen = 1;
+    }
+    while (off < cnt) {
+        n = sendmmsg(sock, msgs + off, cnt - off, 0);
+        if (n <= 0) {
+            // the first message failed, drop it like sendto() would
+            CCNL_PIPELINE_COUNT(self->failed);
+            n = 1;
+        }
+        off += n;
+    }
+    return cnt;
+}
+#else
+static int
+ccnl_pipeline_send(struct ccnl_pipeline_if_s *self, int sock,
+                   struct ccnl_pipeline_pkt_s **recs, size_t *lens, int cnt)
+{
+    int k;
+
+    for (k = 0; k < cnt; k++) {
+        if (sendto(sock, recs[k] + 1, lens[k] - sizeof(*recs[k]), 0,
+                   &recs[k]->addr.sa, recs[k]->addrlen) < 0) {
+            CCNL_PIPELINE_COUNT(self->failed);
+        }
+    }
+    return cnt;
+}
+#endif
+
+static void*
+ccnl_pipeline_tx_main(void *arg)
+{
+    struct ccnl_pipeline_if_s *self = (struct ccnl_pipeline_if_s *) arg;
+    struct ccnl_pipeline_s *all = self->all;
+    struct ccnl_pipeline_pkt_s *recs[CCNL_MAX_IO_BATCH];
+    size_t lens[CCNL_MAX_IO_BATCH];
+    int sock = all->relay->ifs[self->ifndx].sock, cnt, k;
+    uint64_t val;
+    uint32_t tag;
+
+    for (;;) {
+        for (cnt = 0; cnt < CCNL_MAX_IO_BATCH; cnt++) {
+            recs[cnt] = (struct ccnl_pipeline_pkt_s *)
+                        ccnl_ring_peek(&self->tx, &tag, lens + cnt);
+            if (!recs[cnt]) {
+                break;
+            }
+        }
+        if (cnt > 0) {
+            ccnl_pipeline_send(self, sock, recs, lens, cnt);
+            ccnl_ring_release(&self->tx);
+            for (k = 0; k < cnt; k++) {
+                CCNL_PIPELINE_COUNT(self->sent);
+            }
+            continue;
+        }
+        // what was queued before the halt has been sent
+        if (__atomic_load_n(&all->halt, __ATOMIC_ACQUIRE)) {
+            break;
+        }
+        if (read(self->tx_efd, &val, sizeof(val)) < 0 && errno != EINTR) {
+            perror("eventfd read");
+            break;
+        }
+    }
+    return NULL;
+}
+
+static void
+ccnl_pipeline_report(struct ccnl_pipeline_s *all)
+{
+    struct ccnl_pipeline_if_s *s;
+    int k;
+
+    for (k = 0; k < all->count; k++) {
+        s = all->stage + k;
+        DEBUGMSG(INFO, "pipeline rx %d: %u packets, %u queued (max %u), "
+                 "%u dropped (ring full), %u malformed\n", s->ifndx,
+                 CCNL_PIPELINE_READ(s->received), ccnl_ring_depth(&s->rx),
+                 s->rx_maxdepth, CCNL_PIPELINE_READ(s->rx_dropped),
+                 CCNL_PIPELINE_READ(s->malformed));
+    }
+    DEBUGMSG(INFO, "pipeline fwd: %u packets\n", all->forwarded);
+    for (k = 0; k < all->count; k++) {
+        s = all->stage + k;
+        DEBUGMSG(INFO, "pipeline tx %d: %u packets, %u queued (max %u), "
+                 "%u dropped (ring full), %u failed\n", s->ifndx,
+                 CCNL_PIPELINE_READ(s->sent), ccnl_ring_depth(&s->tx),
+                 s->tx_maxdepth, s->tx_dropped,
+                 CCNL_PIPELINE_READ(s->failed));
+    }
+    all->reported = all->forwarded;
+}
+
+// logs the queue depths while packets are flowing
+static void
+ccnl_pipeline_report_timer(void *ptr, void *aux)
+{
+    struct ccnl_pipeline_s *all = (struct ccnl_pipeline_s *) aux;
+    (void) ptr;
+
+    if (all->forwarded != all->reported) {
+        ccnl_pipeline_report(all);
+    }
+    all->report_timer = ccnl_set_timer(CCNL_PIPELINE_REPORT_INTERVAL * 1000000,
+                                       ccnl_pipeline_report_timer, ptr, aux);
+}
+
+int
+ccnl_pipeline_run(struct ccnl_relay_s *relay)
+{
+    struct ccnl_pipeline_s *all;
+    struct ccnl_pipeline_if_s *s;
+    pthread_attr_t attr;
+    int i, k, rc = -1;
+
+    all = (struct ccnl_pipeline_s *) ccnl_calloc(1, sizeof(*all));
+    if (!all) {
+        return -1;
+    }
+    all->relay = relay;
+    all->efd = all->halt_efd = -1;
+    for (i = 0; i < CCNL_MAX_INTERFACES; i++) {
+        all->stage_of[i] = -1;
+        all->stage[i].tx_efd = -1;
+    }
+    for (i = 0; i < relay->ifcount; i++) {
+        if (!ccnl_pipeline_addrlen(&relay->ifs[i].addr) ||
+            relay->ifs[i].stream) {
+            // UDP interfaces only, stream faces stay with the loop
+            continue;
+        }
+        s = all->stage + all->count;
+        s->all = all;
+        s->ifndx = i;
+        s->tx_efd = eventfd(0, EFD_CLOEXEC);
+        if (s->tx_efd < 0 ||
+            ccnl_ring_init(&s->rx, CCNL_PIPELINE_RING_SIZE) ||
+            ccnl_ring_init(&s->tx, CCNL_PIPELINE_RING_SIZE)) {
+            goto Done;
+        }
+        all->stage_of[i] = all->count++;
+    }
+    if (!all->count) {
+        DEBUGMSG(ERROR, "pipeline: no UDP interface\n");
+        goto Done;
+    }
+    all->efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    all->halt_efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (all->efd < 0 || all->halt_efd < 0) {
+        perror("eventfd");
+        goto Done;
+    }
+    if (ccnl_io_watch(&all->watch, all->efd, EPOLLIN, ccnl_pipeline_ready,
+                      all)) {
+        goto Done;
+    }
+
+    ccnl_pipeline = all;
+    all->ll_TX = relay->ccnl_ll_TX_ptr;
+    all->ll_TX_batch = relay->ccnl_ll_TX_batch_ptr;
+    relay->ccnl_ll_TX_ptr = ccnl_pipeline_TX;
+    if (relay->ccnl_ll_TX_batch_ptr) {
+        relay->ccnl_ll_TX_batch_ptr = ccnl_pipeline_TX_batch;
+    }
+    relay->ccnl_RX_steer_ptr = ccnl_pipeline_steer;
+    for (k = 0; k < all->count; k++) {
+        relay->ifs[all->stage[k].ifndx].piped = 1;
+    }
+
+    // the threads share the start of the log clock
+    (void) current_time();
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, CCNL_PIPELINE_STACK_SIZE);
+    for (k = 0; k < all->count; k++) {
+        s = all->stage + k;
+        if (pthread_create(&s->tx_thread, &attr, ccnl_pipeline_tx_main, s)) {
+            perror("pthread_create");
+            break;
+        }
+        s->tx_started = 1;
+        if (pthread_create(&s->rx_thread, &attr, ccnl_pipeline_rx_main, s)) {
+            perror("pthread_create");
+            break;
+        }
+        s->rx_started = 1;
+    }
+    pthread_attr_destroy(&attr);
+    if (k == all->count) {
+        DEBUGMSG(INFO, "pipeline: %d interfaces with receive and transmit "
+                 "threads\n", all->count);
+        all->report_timer = ccnl_set_timer(CCNL_PIPELINE_REPORT_INTERVAL *
+                                           1000000, ccnl_pipeline_report_timer,
+                                           relay, all);
+        ccnl_io_loop(relay);
+        ccnl_rem_timer(all->report_timer);
+        rc = 0;
+    }
+
+    // receive threads leave their loop, transmit threads once they sent
+    // what is queued
+    __atomic_store_n(&all->halt, 1, __ATOMIC_RELEASE);
+    ccnl_pipeline_wake(all->halt_efd);
+    for (k = 0; k < all->count; k++) {
+        s = all->stage + k;
+        if (s->rx_started) {
+            pthread_join(s->rx_thread, NULL);
+        }
+    }
+    for (k = 0; k < all->count; k++) {
+        s = all->stage + k;
+        if (s->tx_started) {
+            ccnl_pipeline_wake(s->tx_efd);
+            pthread_join(s->tx_thread, NULL);
+        }
+    }
+    ccnl_pipeline_report(all);
+    ccnl_io_unwatch(&all->watch);
+    for (k = 0; k < all->count; k++) {
+        relay->ifs[all->stage[k].ifndx].piped = 0;
+    }
+    relay->ccnl_RX_steer_ptr = NULL;
+    relay->ccnl_ll_TX_ptr = all->ll_TX;
+    relay->ccnl_ll_TX_batch_ptr = all->ll_TX_batch;
+    ccnl_pipeline = NULL;
+
+Done:
+    for (k = 0; k < CCNL_MAX_INTERFACES; k++) {
+        s = all->stage + k;
+        if (s->tx_efd >= 0) {
+            close(s->tx_efd);
+        }
+        ccnl_ring_free(&s->rx);
+        ccnl_ring_free(&s->tx);
+    }
+    if (all->efd >= 0) {
+        close(all->efd);
+    }
+    if (all->halt_efd >= 0) {
+        close(all->halt_efd);
+    }
+    ccnl_free(all);
+    return rc;
+}
+
+#endif // USE_THREADS && USE_EPOLL
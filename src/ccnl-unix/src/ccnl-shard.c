@@ -0,0 +1,693 @@
+/*
+ * @f ccnl-shard.c
+ * @b CCN lite, relay partitioned over several threads
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-17 created
+ */
+
+#include "ccnl-unix.h"
+#include "ccnl-shard.h"
+
+#include "ccnl-os-includes.h"
+
+#include "ccnl-core.h"
+#include "ccnl-dispatch.h"
+
+#if defined(USE_THREADS) && defined(USE_EPOLL)
+
+// Each shard is a relay of its own, running in its own thread: PIT, CS,
+// faces, timers and the allocator's caches are never shared. A shard
+// hands a packet it receives for a name it does not own to the owner,
+// copied into the ring from the receiving to the owning shard, and wakes
+// the owner through its eventfd when that ring was empty.
+
+// what a ring record carries, see ccnl_ring_commit()
+enum {
+    CCNL_SHARD_PKT = 1,         // a received packet
+    CCNL_SHARD_MGMT,            // a management request, for the first shard
+    CCNL_SHARD_FIB_BEGIN,       // the first shard's FIB follows
+    CCNL_SHARD_FIB,             // one FIB entry
+    CCNL_SHARD_FIB_END,         // the FIB is complete, replaces the old one
+    CCNL_SHARD_HALT,            // leave the event loop
+};
+
+// records read from the rings before the descriptors get their turn
+#define CCNL_SHARD_RX_BUDGET    256
+// the receive buffers are thread local, see ccnl_io_recv()
+#define CCNL_SHARD_STACK_SIZE   (16 * 1024 * 1024)
+// usec until a FIB copy which did not fit into a ring is sent again
+#define CCNL_SHARD_FIB_RETRY    10000
+
+struct ccnl_shard_pkt_s {
+    int ifndx;
+    uint32_t addrlen;
+    sockunion src;
+    // followed by the packet
+};
+
+struct ccnl_shard_fib_s {
+    int ifndx;
+    uint32_t addrlen;
+    sockunion peer;
+    int suite;
+    uint32_t compcnt;
+    uint32_t chunknum;
+    int has_chunknum;
+    // followed by compcnt uint32_t lengths and the components
+};
+
+// a FIB entry received after CCNL_SHARD_FIB_BEGIN, kept until the copy ends
+struct ccnl_shard_staged_s {
+    struct ccnl_shard_staged_s *next;
+    size_t len;
+    struct ccnl_shard_fib_s rec;    // and the rest of the record
+};
+
+struct ccnl_shards_s;
+
+struct ccnl_shard_s {
+    struct ccnl_shards_s *all;
+    int id;
+    struct ccnl_relay_s *relay;
+    pthread_t thread;
+    int efd;                    // eventfd, counts wakeups from other shards
+    struct ccnl_io_watch_s watch;
+    char fib_pending;           // a FIB check or copy is scheduled
+    uint32_t fib_version;       // of the relay's FIB when last copied
+    uint64_t fib_todo;          // shards still waiting for the FIB copy
+    // the FIB copy being received, applied on CCNL_SHARD_FIB_END
+    char fib_staging;
+    struct ccnl_shard_staged_s *fib_staged, **fib_tail;
+    // written by the shard's thread only
+    uint32_t steered;           // packets passed to other shards
+    uint32_t received;          // packets taken from other shards
+    uint32_t dropped;           // packets lost to a full ring
+};
+
+struct ccnl_shards_s {
+    int count;
+    int depth;
+    int (*loop)(struct ccnl_relay_s*);
+    ccnl_shard_setup_func setup;
+    void *aux;
+    struct ccnl_shard_s shard[CCNL_SHARD_MAX];
+    struct ccnl_ring_s *rings;  // count * count, from * count + to
+};
+
+static CCNL_THREAD_LOCAL struct ccnl_shard_s *ccnl_shard_self;
+
+static struct ccnl_ring_s*
+ccnl_shard_ring(struct ccnl_shards_s *all, int from, int to)
+{
+    return all->rings + from * all->count + to;
+}
+
+// names of management requests, see ccnl_fwd_handleInterest()
+static int
+ccnl_shard_is_mgmt(struct ccnl_prefix_s *pfx)
+{
+    return pfx->compcnt == 4 && pfx->complen[0] == 4 &&
+           !memcmp(pfx->comp[0], "ccnx", 4);
+}
+
+// the high bits of the hash of the first depth components select the
+// shard as the low ones select the buckets of the shard's own tables;
+// extensions of a name thus have the same owner
+int
+ccnl_shard_owner(int count, int depth, struct ccnl_pkt_s *pkt)
+{
+    struct ccnl_prefix_s *pfx = pkt->pfx;
+
+    // management requests go to the shard with the UNIX socket
+    if (ccnl_shard_is_mgmt(pfx)) {
+        return 0;
+    }
+    if (pfx->compcnt < (uint32_t) depth) {
+        // Data of any shard may match an Interest too short to select one,
+        // a short name of Data has the first shard as owner
+        return (pkt->flags & CCNL_PKT_REQUEST) ? CCNL_SHARD_ALL : 0;
+    }
+    return (int) (((uint64_t) ccnl_prefix_hash(pfx, (uint32_t) depth) *
+                   (uint64_t) count) >> 32);
+}
+
+static void
+ccnl_shard_wake(struct ccnl_shard_s *to)
+{
+    uint64_t one = 1;
+
+    if (write(to->efd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        DEBUGMSG(WARNING, "shard %d: eventfd write: %s\n", to->id,
+                 strerror(errno));
+    }
+}
+
+// reserves a record in the ring to shard @to
+static void*
+ccnl_shard_reserve(struct ccnl_shard_s *self, int to, size_t len)
+{
+    return ccnl_ring_reserve(ccnl_shard_ring(self->all, self->id, to), len);
+}
+
+static void
+ccnl_shard_commit(struct ccnl_shard_s *self, int to, uint32_t tag,
+                  size_t len)
+{
+    if (ccnl_ring_commit(ccnl_shard_ring(self->all, self->id, to), tag, len)) {
+        ccnl_shard_wake(self->all->shard + to);
+    }
+}
+
+// only the UDP sockets are opened by every shard, see ccnl_shard_setup_func
+static int
+ccnl_shard_face_shared(struct ccnl_face_s *f)
+{
+    return f->ifndx >= 0 && (f->peer.sa.sa_family == AF_INET ||
+                             f->peer.sa.sa_family == AF_INET6);
+}
+
+// FIB entries via other faces would exist on the first shard only, and
+// the Interests owned by the others would never reach them
+static int
+ccnl_shard_fib_face(struct ccnl_relay_s *relay, struct ccnl_face_s *f)
+{
+    (void) relay;
+    return ccnl_shard_face_shared(f);
+}
+
+// serializes the FIB entries via UDP faces to shard @to, the interfaces
+// have the same indices there; returns -1 if the ring is too full for all
+static int
+ccnl_shard_fib_copy(struct ccnl_shard_s *self, struct ccnl_relay_s *relay,
+                    int to)
+{
+    struct ccnl_forward_s *fwd;
+    struct ccnl_shard_fib_s *rec;
+    uint8_t *cp;
+    size_t len;
+    uint32_t i;
+    int cnt = 0;
+
+    // an incomplete copy is dropped by the next CCNL_SHARD_FIB_BEGIN
+    if (!ccnl_shard_reserve(self, to, 0)) {
+        return -1;
+    }
+    ccnl_shard_commit(self, to, CCNL_SHARD_FIB_BEGIN, 0);
+    for (fwd = relay->fib; fwd; fwd = fwd->next) {
+        struct ccnl_face_s *f = fwd->face;
+
+        if (!f || !fwd->prefix || !ccnl_shard_face_shared(f)) {
+            continue;
+        }
+        len = sizeof(*rec) + fwd->prefix->compcnt * sizeof(uint32_t);
+        for (i = 0; i < fwd->prefix->compcnt; i++) {
+            len += fwd->prefix->complen[i];
+        }
+        rec = (struct ccnl_shard_fib_s *) ccnl_shard_reserve(self, to, len);
+        if (!rec) {
+            return -1;
+        }
+        rec->ifndx = f->ifndx;
+        rec->peer = f->peer;
+        rec->addrlen = f->peer.sa.sa_family == AF_INET
+                       ? sizeof(f->peer.ip4) : sizeof(f->peer.ip6);
+        rec->suite = fwd->suite;
+        rec->compcnt = fwd->prefix->compcnt;
+        rec->has_chunknum = fwd->prefix->chunknum != NULL;
+        rec->chunknum = rec->has_chunknum ? *fwd->prefix->chunknum : 0;
+        cp = (uint8_t *) (rec + 1);
+        for (i = 0; i < rec->compcnt; i++, cp += sizeof(uint32_t)) {
+            uint32_t complen = (uint32_t) fwd->prefix->complen[i];
+
+            memcpy(cp, &complen, sizeof(complen));
+        }
+        for (i = 0; i < rec->compcnt; i++) {
+            memcpy(cp, fwd->prefix->comp[i], fwd->prefix->complen[i]);
+            cp += fwd->prefix->complen[i];
+        }
+        ccnl_shard_commit(self, to, CCNL_SHARD_FIB, len);
+        cnt++;
+    }
+    if (!ccnl_shard_reserve(self, to, 0)) {
+        return -1;
+    }
+    ccnl_shard_commit(self, to, CCNL_SHARD_FIB_END, 0);
+    DEBUGMSG(DEBUG, "shard %d: copied %d FIB entries\n", to, cnt);
+    return 0;
+}
+
+// copies the FIB to the shards which have not got it yet, all of them if
+// it changed, and tries again later for those whose ring was full
+static void
+ccnl_shard_fib_sync(void *ptr, void *aux)
+{
+    struct ccnl_relay_s *relay = (struct ccnl_relay_s *) ptr;
+    struct ccnl_shard_s *self = (struct ccnl_shard_s *) aux;
+    int to;
+
+    self->fib_pending = 0;
+    if (self->fib_version != relay->fib_version) {
+        self->fib_version = relay->fib_version;
+        for (to = 1; to < self->all->count; to++) {
+            self->fib_todo |= 1ULL << to;
+        }
+    }
+    for (to = 1; to < self->all->count; to++) {
+        if ((self->fib_todo & (1ULL << to)) &&
+            !ccnl_shard_fib_copy(self, relay, to)) {
+            self->fib_todo &= ~(1ULL << to);
+        }
+    }
+    if (self->fib_todo) {
+        DEBUGMSG(WARNING, "shards: ring full, FIB copy delayed\n");
+        self->fib_pending = 1;
+        ccnl_set_timer(CCNL_SHARD_FIB_RETRY, ccnl_shard_fib_sync, relay, self);
+    }
+}
+
+// drops the FIB entries received since CCNL_SHARD_FIB_BEGIN
+static void
+ccnl_shard_fib_unstage(struct ccnl_shard_s *self)
+{
+    struct ccnl_shard_staged_s *e;
+
+    while ((e = self->fib_staged)) {
+        self->fib_staged = e->next;
+        ccnl_free(e);
+    }
+    self->fib_tail = &self->fib_staged;
+    self->fib_staging = 0;
+}
+
+// keeps a FIB entry until the copy is complete
+static void
+ccnl_shard_fib_stage(struct ccnl_shard_s *self, uint8_t *rec, size_t len)
+{
+    struct ccnl_shard_staged_s *e;
+
+    if (!self->fib_staging || len < sizeof(e->rec)) {
+        return;
+    }
+    e = (struct ccnl_shard_staged_s *)
+        ccnl_malloc(offsetof(struct ccnl_shard_staged_s, rec) + len);
+    if (!e) {
+        DEBUGMSG(WARNING, "shard %d: out of memory, FIB copy dropped\n",
+                 self->id);
+        ccnl_shard_fib_unstage(self);
+        return;
+    }
+    e->next = NULL;
+    e->len = len;
+    memcpy(&e->rec, rec, len);
+    *self->fib_tail = e;
+    self->fib_tail = &e->next;
+}
+
+// rebuilds a FIB entry copied by the first shard
+static void
+ccnl_shard_fib_add(struct ccnl_relay_s *relay, struct ccnl_shard_fib_s *rec,
+                   size_t len)
+{
+    struct ccnl_prefix_s *pfx;
+    struct ccnl_face_s *f;
+    uint8_t *lens = (uint8_t *) (rec + 1), *cp;
+    size_t byteslen = 0;
+    uint32_t i, complen;
+
+    if (rec->compcnt > CCNL_MAX_NAME_COMP ||
+        len < sizeof(*rec) + rec->compcnt * sizeof(uint32_t)) {
+        return;
+    }
+    for (i = 0; i < rec->compcnt; i++) {
+        memcpy(&complen, lens + i * sizeof(uint32_t), sizeof(complen));
+        byteslen += complen;
+    }
+    if (len != sizeof(*rec) + rec->compcnt * sizeof(uint32_t) + byteslen) {
+        return;
+    }
+    f = ccnl_get_face_or_create(relay, rec->ifndx, &rec->peer.sa,
+                                rec->addrlen);
+    if (!f) {
+        return;
+    }
+    f->flags |= CCNL_FACE_FLAGS_STATIC;
+    pfx = ccnl_prefix_new_compact((char) rec->suite, rec->compcnt, byteslen,
+                                  rec->has_chunknum ? &rec->chunknum : NULL);
+    if (!pfx) {
+        return;
+    }
+    cp = lens + rec->compcnt * sizeof(uint32_t);
+    for (i = 0, byteslen = 0; i < rec->compcnt; i++) {
+        memcpy(&complen, lens + i * sizeof(uint32_t), sizeof(complen));
+        pfx->comp[i] = pfx->bytes + byteslen;
+        pfx->complen[i] = complen;
+        memcpy(pfx->comp[i], cp + byteslen, complen);
+        byteslen += complen;
+    }
+    if (ccnl_fib_add_entry(relay, pfx, f)) {
+        ccnl_prefix_free(pfx);
+    }
+}
+
+// replaces the FIB by the complete copy
+static void
+ccnl_shard_fib_apply(struct ccnl_shard_s *self, struct ccnl_relay_s *relay)
+{
+    struct ccnl_shard_staged_s *e;
+
+    if (!self->fib_staging) {
+        return;
+    }
+    while (!ccnl_fib_rem_entry(relay, NULL, NULL))
+        ;
+    for (e = self->fib_staged; e; e = e->next) {
+        ccnl_shard_fib_add(relay, &e->rec, e->len);
+    }
+    ccnl_shard_fib_unstage(self);
+}
+
+// looks for changes of the FIB in the next round of the loop, once the
+// management request has been served
+static void
+ccnl_shard_fib_check(struct ccnl_shard_s *self, struct ccnl_relay_s *relay)
+{
+    if (!self->fib_pending) {
+        self->fib_pending = 1;
+        ccnl_set_timer(0, ccnl_shard_fib_sync, relay, self);
+    }
+}
+
+// copies a received packet into the ring to shard @to
+static void
+ccnl_shard_pass(struct ccnl_shard_s *self, int to, uint32_t tag, int ifndx,
+                uint8_t *data, size_t len, sockunion *src)
+{
+    struct ccnl_shard_pkt_s *rec;
+
+    rec = (struct ccnl_shard_pkt_s *) ccnl_shard_reserve(self, to,
+                                                         sizeof(*rec) + len);
+    if (!rec) {
+        self->dropped++;
+        return;
+    }
+    rec->ifndx = ifndx;
+    rec->src = *src;
+    rec->addrlen = src->sa.sa_family == AF_INET ? sizeof(src->ip4)
+                                                : sizeof(src->ip6);
+    memcpy(rec + 1, data, len);
+    ccnl_shard_commit(self, to, tag, sizeof(*rec) + len);
+    self->steered++;
+}
+
+// passes a packet to the shard owning its name, returns 1 if it did
+static int
+ccnl_shard_steer(struct ccnl_relay_s *relay, int ifndx, uint8_t *data,
+                 size_t len, sockunion *src)
+{
+    struct ccnl_shard_s *self = ccnl_shard_self;
+    struct ccnl_pkt_rx_s rx;
+    struct ccnl_prefix_s *pfx;
+    int owner, mgmt, to;
+
+    pfx = ccnl_core_peek_prefix(&rx, data, len);
+    if (!pfx) {
+        return 0;
+    }
+    mgmt = ccnl_shard_is_mgmt(pfx);
+    if (src->sa.sa_family != AF_INET && src->sa.sa_family != AF_INET6) {
+        // the UNIX socket of the first shard
+        if (mgmt) {
+            ccnl_shard_fib_check(self, relay);
+        }
+        return 0;
+    }
+    owner = ccnl_shard_owner(self->all->count, self->all->depth, &rx.pkt);
+    if (owner == CCNL_SHARD_ALL) {
+        // each shard answers from its own content and keeps a PIT entry
+        // for the Data its owner hands it, the upstream node drops the
+        // copies by their nonce
+        for (to = 0; to < self->all->count; to++) {
+            if (to != self->id) {
+                ccnl_shard_pass(self, to, CCNL_SHARD_PKT, ifndx, data, len,
+                                src);
+            }
+        }
+        return 0;
+    }
+    if (owner == self->id) {
+        if (mgmt) {
+            ccnl_shard_fib_check(self, relay);
+        }
+        return 0;
+    }
+    ccnl_shard_pass(self, owner, mgmt ? CCNL_SHARD_MGMT : CCNL_SHARD_PKT,
+                    ifndx, data, len, src);
+    return 1;
+}
+
+// serves the records other shards sent to this one
+static void
+ccnl_shard_ready(struct ccnl_relay_s *relay, struct ccnl_io_watch_s *w,
+                 uint32_t events)
+{
+    struct ccnl_shard_s *self = (struct ccnl_shard_s *) w->aux;
+    struct ccnl_ring_s *r;
+    uint64_t cnt;
+    uint32_t tag;
+    size_t len;
+    uint8_t *rec;
+    int from, total = 0;
+    (void) events;
+
+    // reset first, producers signal again once they find a ring empty
+    if (read(self->efd, &cnt, sizeof(cnt)) < 0 && errno != EAGAIN) {
+        DEBUGMSG(WARNING, "shard %d: eventfd read: %s\n", self->id,
+                 strerror(errno));
+    }
+    for (from = 0; from < self->all->count; from++) {
+        if (from == self->id) {
+            continue;
+        }
+        r = ccnl_shard_ring(self->all, from, self->id);
+        while (total < CCNL_SHARD_RX_BUDGET &&
+               (rec = (uint8_t *) ccnl_ring_peek(r, &tag, &len))) {
+            switch (tag) {
+            case CCNL_SHARD_MGMT:
+                ccnl_shard_fib_check(self, relay);
+                // fall through
+            case CCNL_SHARD_PKT: {
+                struct ccnl_shard_pkt_s *p = (struct ccnl_shard_pkt_s *) rec;
+
+                self->received++;
+                ccnl_core_RX(relay, p->ifndx, (uint8_t *) (p + 1),
+                             len - sizeof(*p), &p->src.sa, p->addrlen);
+                break;
+            }
+            case CCNL_SHARD_FIB_BEGIN:
+                ccnl_shard_fib_unstage(self);
+                self->fib_staging = 1;
+                break;
+            case CCNL_SHARD_FIB:
+                ccnl_shard_fib_stage(self, rec, len);
+                break;
+            case CCNL_SHARD_FIB_END:
+                ccnl_shard_fib_apply(self, relay);
+                break;
+            case CCNL_SHARD_HALT:
+                relay->halt_flag = 1;
+                break;
+            default:
+                break;
+            }
+            ccnl_ring_release(r);
+            total++;
+        }
+    }
+    if (total >= CCNL_SHARD_RX_BUDGET) {
+        ccnl_io_defer(w, EPOLLIN);
+    }
+}
+
+// turns a configured relay into shard @self
+static int
+ccnl_shard_attach(struct ccnl_shard_s *self, struct ccnl_relay_s *relay)
+{
+    struct ccnl_content_s *c, *next;
+    int dropped = 0;
+
+    ccnl_shard_self = self;
+    self->relay = relay;
+    relay->id = self->id;
+    self->fib_tail = &self->fib_staged;
+    relay->ccnl_RX_steer_ptr = ccnl_shard_steer;
+    // every shard loaded the same files, each keeps what it owns
+    for (c = relay->contents; c; c = next) {
+        next = c->next;
+        if (ccnl_shard_owner(self->all->count, self->all->depth,
+                             c->pkt) != self->id) {
+            ccnl_content_remove(relay, c);
+            dropped++;
+        }
+    }
+    if (dropped) {
+        DEBUGMSG(INFO, "shard %d: %d cached objects belong to other shards\n",
+                 self->id, dropped);
+    }
+    return ccnl_io_watch(&self->watch, self->efd, EPOLLIN,
+                         ccnl_shard_ready, self);
+}
+
+static void
+ccnl_shard_report(struct ccnl_shard_s *self)
+{
+    DEBUGMSG(INFO, "shard %d: %u packets passed on, %u taken over, "
+             "%u dropped (ring full)\n", self->id, self->steered,
+             self->received, self->dropped);
+}
+
+static void*
+ccnl_shard_main(void *arg)
+{
+    struct ccnl_shard_s *self = (struct ccnl_shard_s *) arg;
+    struct ccnl_relay_s *relay;
+
+    // allocated here: memory goes back to the thread's own caches
+    relay = (struct ccnl_relay_s *) ccnl_calloc(1, sizeof(*relay));
+    if (!relay) {
+        DEBUGMSG(ERROR, "shard %d: out of memory\n", self->id);
+        return NULL;
+    }
+    time(&relay->startup_time);
+    self->all->setup(relay, self->all->aux);
+    if (ccnl_shard_attach(self, relay) == 0) {
+        DEBUGMSG(INFO, "shard %d running\n", self->id);
+        self->all->loop(relay);
+    }
+    ccnl_shard_report(self);
+    ccnl_shard_fib_unstage(self);
+    // the faces' timers go first
+    ccnl_core_cleanup(relay);
+    ccnl_timer_cleanup();
+    ccnl_free(relay);
+    ccnl_mem_trim();
+    return NULL;
+}
+
+int
+ccnl_shard_run(struct ccnl_relay_s *relay, int count, int depth,
+               int (*loop)(struct ccnl_relay_s*),
+               ccnl_shard_setup_func setup, void *aux)
+{
+    struct ccnl_shards_s *all;
+    struct ccnl_shard_s *self;
+    pthread_attr_t attr;
+    int i, k, started = 1, rc = -1;
+
+    if (count < 1 || count > CCNL_SHARD_MAX) {
+        DEBUGMSG(ERROR, "shards: count must be 1..%d\n", CCNL_SHARD_MAX);
+        return -1;
+    }
+    all = (struct ccnl_shards_s *) ccnl_calloc(1, sizeof(*all));
+    if (!all) {
+        return -1;
+    }
+    all->count = count;
+    all->depth = depth > 0 ? depth : CCNL_SHARD_DEPTH;
+    all->loop = loop;
+    all->setup = setup;
+    all->aux = aux;
+    all->rings = (struct ccnl_ring_s *) ccnl_calloc((size_t) (count * count),
+                                                    sizeof(*all->rings));
+    if (!all->rings) {
+        goto Done;
+    }
+    for (i = 0; i < count; i++) {
+        all->shard[i].all = all;
+        all->shard[i].id = i;
+        all->shard[i].efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (all->shard[i].efd < 0) {
+            perror("eventfd");
+            goto Done;
+        }
+        for (k = 0; k < count; k++) {
+            if (k != i &&
+                ccnl_ring_init(ccnl_shard_ring(all, i, k), CCNL_SHARD_RING_SIZE)) {
+                goto Done;
+            }
+        }
+    }
+
+    self = all->shard;
+    if (ccnl_shard_attach(self, relay)) {
+        goto Done;
+    }
+    if (count > 1) {
+        relay->ccnl_fib_face_ptr = ccnl_shard_fib_face;
+    }
+    // the threads share the start of the log clock
+    (void) current_time();
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, CCNL_SHARD_STACK_SIZE);
+    for (; started < count; started++) {
+        if (pthread_create(&all->shard[started].thread, &attr,
+                           ccnl_shard_main, all->shard + started)) {
+            perror("pthread_create");
+            break;
+        }
+    }
+    pthread_attr_destroy(&attr);
+    if (started == count) {
+        DEBUGMSG(INFO, "%d shards, names hashed over %d components\n",
+                 count, all->depth);
+        loop(relay);
+        rc = 0;
+    } else {
+        relay->halt_flag = 1;
+    }
+
+    // the others stop once they read their halt record
+    for (i = 1; i < started; i++) {
+        while (!ccnl_shard_reserve(self, i, 0)) {
+            sched_yield();
+        }
+        ccnl_shard_commit(self, i, CCNL_SHARD_HALT, 0);
+    }
+    for (i = 1; i < started; i++) {
+        pthread_join(all->shard[i].thread, NULL);
+    }
+    ccnl_shard_report(self);
+    ccnl_io_unwatch(&self->watch);
+    relay->ccnl_RX_steer_ptr = NULL;
+    relay->ccnl_fib_face_ptr = NULL;
+    ccnl_shard_self = NULL;
+
+Done:
+    for (i = 0; i < count; i++) {
+        if (all->shard[i].efd > 0) {
+            close(all->shard[i].efd);
+        }
+        for (k = 0; all->rings && k < count; k++) {
+            ccnl_ring_free(ccnl_shard_ring(all, i, k));
+        }
+    }
+    ccnl_free(all->rings);
+    ccnl_free(all);
+    return rc;
+}
+
+#endif // USE_THREADS && USE_EPOLL
@@ -0,0 +1,179 @@
+/*
+ * @f ccnl-shm-ring.c
+ * @b CCN lite, rings of packets in memory shared with another process
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-17 created
+ */
+
+#include "ccnl-shm.h"
+
+#ifdef USE_SHM
+
+// Kept free of the relay, the client library in ccnl-utils links it too.
+// Records are laid out as in ccnl-ring.c: an 8 byte header, the packet
+// padded to 8 bytes, never wrapping around; a header with the length
+// CCNL_SHM_WRAP marks the unused end of the buffer. Indices are published
+// sequentially consistent, so that a producer checking for an empty ring
+// and a consumer checking for new records before it sleeps (and likewise
+// for room and the wait flag) cannot both miss each other.
+
+#define CCNL_SHM_REC_HDR        8u
+#define CCNL_SHM_ALIGN(len)     (((uint32_t) (len) + 7) & ~(uint32_t) 7)
+#define CCNL_SHM_WRAP           UINT32_MAX
+
+size_t
+ccnl_shm_mem_size(uint32_t ring_size)
+{
+    return CCNL_SHM_HDR_SIZE + 2 * (size_t) ring_size;
+}
+
+void
+ccnl_shm_ring_attach(void *mem, int app, struct ccnl_shm_ring_s *tx,
+                     struct ccnl_shm_ring_s *rx)
+{
+    struct ccnl_shm_hdr_s *hdr = (struct ccnl_shm_hdr_s *) mem;
+    uint8_t *up = (uint8_t *) mem + CCNL_SHM_HDR_SIZE;
+    uint8_t *down = up + hdr->ring_size;
+
+    tx->ctl = app ? &hdr->up : &hdr->down;
+    tx->buf = app ? up : down;
+    rx->ctl = app ? &hdr->down : &hdr->up;
+    rx->buf = app ? down : up;
+    tx->size = rx->size = hdr->ring_size;
+    tx->pos = tx->seen = __atomic_load_n(&tx->ctl->head, __ATOMIC_ACQUIRE);
+    rx->pos = rx->seen = __atomic_load_n(&rx->ctl->tail, __ATOMIC_ACQUIRE);
+    tx->next = tx->skip = rx->next = rx->skip = 0;
+}
+
+void*
+ccnl_shm_ring_reserve(struct ccnl_shm_ring_s *r, size_t len)
+{
+    uint32_t need, off, tail, skip = 0;
+
+    if (len > CCNL_SHM_MAX_PACKET_SIZE ||
+        len > r->size / 2 - CCNL_SHM_REC_HDR) {
+        return NULL;
+    }
+    need = CCNL_SHM_REC_HDR + CCNL_SHM_ALIGN(len);
+    off = r->pos & (r->size - 1);
+    if (off + need > r->size) {
+        skip = r->size - off;
+    }
+    if (r->pos - r->seen + skip + need > r->size) {
+        tail = __atomic_load_n(&r->ctl->tail, __ATOMIC_SEQ_CST);
+        // a tail ahead of the head would make room out of nothing, and
+        // kept as seen it would do so for the next reservation
+        if (r->pos - tail > r->size) {
+            return NULL;
+        }
+        r->seen = tail;
+        if (r->pos - r->seen + skip + need > r->size) {
+            return NULL;
+        }
+    }
+    r->skip = skip;
+    return r->buf + ((r->pos + skip) & (r->size - 1)) + CCNL_SHM_REC_HDR;
+}
+
+int
+ccnl_shm_ring_commit(struct ccnl_shm_ring_s *r, size_t len)
+{
+    uint32_t old = r->pos, *rec;
+
+    if (r->skip) {
+        rec = (uint32_t *) (r->buf + (r->pos & (r->size - 1)));
+        rec[0] = CCNL_SHM_WRAP;
+        r->pos += r->skip;
+        r->skip = 0;
+    }
+    rec = (uint32_t *) (r->buf + (r->pos & (r->size - 1)));
+    rec[0] = (uint32_t) len;
+    r->pos += CCNL_SHM_REC_HDR + CCNL_SHM_ALIGN(len);
+
+    __atomic_store_n(&r->ctl->head, r->pos, __ATOMIC_SEQ_CST);
+    // the consumer took everything before this record: it may wait for us
+    return __atomic_load_n(&r->ctl->tail, __ATOMIC_SEQ_CST) == old;
+}
+
+void
+ccnl_shm_ring_want_room(struct ccnl_shm_ring_s *r)
+{
+    __atomic_store_n(&r->ctl->wait, 1, __ATOMIC_SEQ_CST);
+}
+
+int
+ccnl_shm_ring_peek(struct ccnl_shm_ring_s *r, uint8_t **data, size_t *len)
+{
+    uint32_t pos = r->pos + r->next, off, avail, reclen, need;
+
+    if (pos == r->seen) {
+        r->seen = __atomic_load_n(&r->ctl->head, __ATOMIC_SEQ_CST);
+        if (r->seen - r->pos > r->size) {
+            return -1;
+        }
+    }
+    for (;;) {
+        avail = r->seen - pos;
+        if (!avail) {
+            return 0;
+        }
+        off = pos & (r->size - 1);
+        if (avail < CCNL_SHM_REC_HDR || avail > r->size) {
+            return -1;
+        }
+        // read once, the producer may scribble over it
+        reclen = __atomic_load_n((uint32_t *) (r->buf + off), __ATOMIC_RELAXED);
+        if (reclen != CCNL_SHM_WRAP) {
+            break;
+        }
+        // released with the record behind it, which always follows
+        if (r->size - off > avail) {
+            return -1;
+        }
+        r->next += r->size - off;
+        pos = r->pos + r->next;
+    }
+    if (reclen > CCNL_SHM_MAX_PACKET_SIZE) {
+        return -1;
+    }
+    need = CCNL_SHM_REC_HDR + CCNL_SHM_ALIGN(reclen);
+    if (need > avail || off + need > r->size) {
+        return -1;
+    }
+    *data = r->buf + off + CCNL_SHM_REC_HDR;
+    *len = reclen;
+    r->next += need;
+    return 1;
+}
+
+int
+ccnl_shm_ring_release(struct ccnl_shm_ring_s *r)
+{
+    if (r->next) {
+        r->pos += r->next;
+        r->next = 0;
+        __atomic_store_n(&r->ctl->tail, r->pos, __ATOMIC_SEQ_CST);
+    }
+    if (__atomic_load_n(&r->ctl->wait, __ATOMIC_SEQ_CST)) {
+        __atomic_store_n(&r->ctl->wait, 0, __ATOMIC_RELAXED);
+        return 1;
+    }
+    return 0;
+}
+
+#endif // USE_SHM
@@ -0,0 +1,503 @@
+/*
+ * @f ccnl-shm.c
+ * @b CCN lite, shared memory faces for applications on the same host
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-17 created
+ */
+
+#if defined(USE_SHM) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // accept4(), memfd_create(), F_ADD_SEALS
+#endif
+
+#include "ccnl-unix.h"
+#include "ccnl-shm.h"
+
+#include "ccnl-os-includes.h"
+
+#include "ccnl-core.h"
+
+#ifdef USE_SHM
+
+// The listening socket is an interface of the relay which the event loops
+// leave alone, like that of the stream faces. Each connection gets its
+// memory and eventfds once the application sent its setup message and is
+// a face of the interface from then on; the core sends to it through the
+// interface's queue and ccnl_ll_TX(), which copies the packet into the
+// ring towards the application. Records of the other ring are copied out
+// before the core parses them, the application could change them while
+// they are being looked at.
+
+// records taken from one ring before the others get their turn
+#define CCNL_SHM_RX_BUDGET      64
+// connections accepted in one go
+#define CCNL_SHM_ACCEPT_MAX     16
+// smallest ring buffer, it holds at least two of the largest packets
+#define CCNL_SHM_RING_MIN       (4 * CCNL_SHM_MAX_PACKET_SIZE)
+
+struct ccnl_shm_face_s;
+
+// a listening socket
+struct ccnl_shm_s {
+    struct ccnl_io_watch_s w;
+    struct ccnl_relay_s *relay;
+    int ifndx;
+    struct ccnl_htable_s index;         // faces by peer address
+    struct ccnl_shm_face_s *faces;
+    struct ccnl_shm_face_s *dirty;      // rings to ring since the kick
+    uint32_t seqno;                     // names the peers
+    uint8_t *rx;                        // the record being parsed
+};
+
+struct ccnl_shm_face_s {
+    struct ccnl_io_watch_s w;           // the connection
+    struct ccnl_io_watch_s bell;        // the eventfd the application rings
+    struct ccnl_shm_s *srv;
+    struct ccnl_shm_face_s *next, *prev;
+    struct ccnl_shm_face_s *dnext;      // on the dirty list
+    struct ccnl_hnode_s hnode;
+    sockunion peer;
+    void *mem;                          // the shared memory, NULL until set up
+    size_t memsize;
+    int down;                           // the eventfd the relay rings
+    struct ccnl_shm_ring_s tx, rx;
+    char dirty, failed;
+};
+
+static struct ccnl_shm_face_s*
+ccnl_shm_lookup(struct ccnl_shm_s *s, sockunion *peer)
+{
+    struct ccnl_hnode_s *n;
+    struct ccnl_shm_face_s *f;
+
+    for (n = ccnl_htable_lookup(&s->index, ccnl_addr_hash(peer));
+         n; n = ccnl_htable_next(n)) {
+        f = CCNL_HTABLE_ENTRY(n, struct ccnl_shm_face_s, hnode);
+        if (!ccnl_addr_cmp(&f->peer, peer)) {
+            return f;
+        }
+    }
+    return NULL;
+}
+
+static void
+ccnl_shm_ring_bell(int fd)
+{
+    uint64_t one = 1;
+
+    if (write(fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        DEBUGMSG(DEBUG, "shm eventfd: %s\n", strerror(errno));
+    }
+}
+
+// the connection's handler closes it in this round of the loop; never
+// closed right away as the core may be sending to it while it is read
+static void
+ccnl_shm_fail(struct ccnl_shm_face_s *f)
+{
+    if (!f->failed) {
+        f->failed = 1;
+        ccnl_io_defer(&f->w, EPOLLHUP);
+    }
+}
+
+static void
+ccnl_shm_close(struct ccnl_shm_face_s *f)
+{
+    struct ccnl_shm_s *s = f->srv;
+    struct ccnl_shm_face_s **pp;
+    struct ccnl_face_s *fc;
+
+    DEBUGMSG(INFO, "shm face %s closed\n", ccnl_addr2ascii(&f->peer));
+    fc = ccnl_face_lookup(s->relay, s->ifndx, &f->peer);
+    if (fc) {
+        ccnl_face_remove(s->relay, fc);
+    }
+    if (f->dirty) {
+        for (pp = &s->dirty; *pp != f; pp = &(*pp)->dnext);
+        *pp = f->dnext;
+    }
+    if (f->mem) {
+        ccnl_io_unwatch(&f->bell);
+        close(f->bell.fd);
+        close(f->down);
+        munmap(f->mem, f->memsize);
+    }
+    ccnl_io_unwatch(&f->w);
+    close(f->w.fd);
+    ccnl_htable_remove(&s->index, &f->hnode);
+    DBL_LINKED_LIST_REMOVE(s->faces, f);
+    // the loop may still hold ready events of either watch
+    ccnl_io_release(&f->w, f);
+}
+
+// hands the records of the application to the core, returns 1 if there
+// are more than @p budget, 0 once the ring is empty and -1 if it is broken
+static int
+ccnl_shm_drain(struct ccnl_shm_face_s *f, int budget)
+{
+    struct ccnl_shm_s *s = f->srv;
+    uint8_t *data;
+    size_t len;
+    int rc, n = 0;
+
+    for (;;) {
+        rc = ccnl_shm_ring_peek(&f->rx, &data, &len);
+        if (rc < 0) {
+            DEBUGMSG(WARNING, "shm face %s: broken ring, closing\n",
+                     ccnl_addr2ascii(&f->peer));
+            return -1;
+        }
+        if (!rc) {
+            if (!f->rx.next) {
+                return 0;
+            }
+            // the application may have appended while we were busy,
+            // it only rings when it saw the ring empty
+            if (ccnl_shm_ring_release(&f->rx)) {
+                ccnl_shm_ring_bell(f->down);
+            }
+            continue;
+        }
+        memcpy(s->rx, data, len);
+        ccnl_io_dispatch(s->relay, s->ifndx, s->rx, len, &f->peer);
+        if (++n >= budget) {
+            if (ccnl_shm_ring_release(&f->rx)) {
+                ccnl_shm_ring_bell(f->down);
+            }
+            return 1;
+        }
+    }
+}
+
+static void
+ccnl_shm_recv(struct ccnl_relay_s *relay, struct ccnl_io_watch_s *w,
+              uint32_t events)
+{
+    struct ccnl_shm_face_s *f = (struct ccnl_shm_face_s *) w->aux;
+    uint64_t cnt;
+    int rc;
+    (void) relay;
+    (void) events;
+
+    if (f->failed) {
+        return;
+    }
+    // the eventfd is level triggered, the ring is drained below
+    if (read(w->fd, &cnt, sizeof(cnt)) < 0 && errno != EAGAIN) {
+        ccnl_shm_fail(f);
+        return;
+    }
+    rc = ccnl_shm_drain(f, CCNL_SHM_RX_BUDGET);
+    if (rc < 0) {
+        ccnl_shm_fail(f);
+    } else if (rc > 0) {
+        ccnl_io_defer(w, EPOLLIN);
+    }
+}
+
+// maps the rings of a connection whose setup message arrived and passes
+// their descriptors back
+static int
+ccnl_shm_setup(struct ccnl_shm_face_s *f, struct ccnl_shm_setup_s *req)
+{
+    struct ccnl_shm_setup_s rsp;
+    struct ccnl_shm_hdr_s *hdr;
+    union {
+        struct cmsghdr align;
+        char buf[CMSG_SPACE(CCNL_SHM_FD_COUNT * sizeof(int))];
+    } ctrl;
+    struct msghdr msg;
+    struct iovec iov;
+    struct cmsghdr *cm;
+    int fds[CCNL_SHM_FD_COUNT] = { -1, -1, -1 };
+    uint32_t size = CCNL_SHM_RING_MIN;
+    int k;
+
+    if (req->magic != CCNL_SHM_MAGIC || req->version != CCNL_SHM_VERSION) {
+        DEBUGMSG(WARNING, "shm face %s: bad setup message\n",
+                 ccnl_addr2ascii(&f->peer));
+        return -1;
+    }
+    while (size < (req->ring_size ? req->ring_size : CCNL_SHM_RING_SIZE) &&
+           size < CCNL_SHM_RING_MAX) {
+        size <<= 1;
+    }
+    f->memsize = ccnl_shm_mem_size(size);
+
+    // sealed, the application cannot shrink the memory under our feet
+    fds[CCNL_SHM_FD_MEM] = memfd_create("ccnl-shm",
+                                        MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fds[CCNL_SHM_FD_MEM] < 0 ||
+        ftruncate(fds[CCNL_SHM_FD_MEM], (off_t) f->memsize) ||
+        fcntl(fds[CCNL_SHM_FD_MEM], F_ADD_SEALS,
+              F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL)) {
+        DEBUGMSG(WARNING, "shm memfd: %s\n", strerror(errno));
+        goto failed;
+    }
+    f->mem = mmap(NULL, f->memsize, PROT_READ | PROT_WRITE, MAP_SHARED,
+                  fds[CCNL_SHM_FD_MEM], 0);
+    if (f->mem == MAP_FAILED) {
+        DEBUGMSG(WARNING, "shm mmap: %s\n", strerror(errno));
+        f->mem = NULL;
+        goto failed;
+    }
+    hdr = (struct ccnl_shm_hdr_s *) f->mem;
+    hdr->magic = CCNL_SHM_MAGIC;
+    hdr->version = CCNL_SHM_VERSION;
+    hdr->ring_size = size;
+    ccnl_shm_ring_attach(f->mem, 0, &f->tx, &f->rx);
+
+    fds[CCNL_SHM_FD_UP] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    fds[CCNL_SHM_FD_DOWN] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fds[CCNL_SHM_FD_UP] < 0 || fds[CCNL_SHM_FD_DOWN] < 0) {
+        DEBUGMSG(WARNING, "shm eventfd: %s\n", strerror(errno));
+        goto failed;
+    }
+
+    rsp.magic = CCNL_SHM_MAGIC;
+    rsp.version = CCNL_SHM_VERSION;
+    rsp.ring_size = size;
+    iov.iov_base = &rsp;
+    iov.iov_len = sizeof(rsp);
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctrl.buf;
+    msg.msg_controllen = sizeof(ctrl.buf);
+    cm = CMSG_FIRSTHDR(&msg);
+    cm->cmsg_level = SOL_SOCKET;
+    cm->cmsg_type = SCM_RIGHTS;
+    cm->cmsg_len = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cm), fds, sizeof(fds));
+    if (sendmsg(f->w.fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT) < 0) {
+        DEBUGMSG(WARNING, "shm face %s: %s\n", ccnl_addr2ascii(&f->peer),
+                 strerror(errno));
+        goto failed;
+    }
+    if (ccnl_io_watch(&f->bell, fds[CCNL_SHM_FD_UP], EPOLLIN,
+                      ccnl_shm_recv, f) < 0) {
+        goto failed;
+    }
+    // the mapping keeps the memory
+    close(fds[CCNL_SHM_FD_MEM]);
+    f->down = fds[CCNL_SHM_FD_DOWN];
+    DEBUGMSG(INFO, "shm face %s set up, %u byte rings\n",
+             ccnl_addr2ascii(&f->peer), size);
+    return 0;
+
+failed:
+    if (f->mem) {
+        munmap(f->mem, f->memsize);
+        f->mem = NULL;
+    }
+    for (k = 0; k < CCNL_SHM_FD_COUNT; k++) {
+        if (fds[k] >= 0) {
+            close(fds[k]);
+        }
+    }
+    return -1;
+}
+
+// the connection: the setup message, then only its end
+static void
+ccnl_shm_ready(struct ccnl_relay_s *relay, struct ccnl_io_watch_s *w,
+               uint32_t events)
+{
+    struct ccnl_shm_face_s *f = (struct ccnl_shm_face_s *) w->aux;
+    struct ccnl_shm_setup_s req;
+    ssize_t rc;
+    (void) relay;
+
+    if (!f->failed && (events & (EPOLLIN | EPOLLERR | EPOLLHUP))) {
+        rc = recv(w->fd, &req, sizeof(req), MSG_DONTWAIT);
+        if (rc < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                f->failed = 1;
+            }
+        } else if (rc == 0 && f->mem) {
+            // what the application appended before it left still counts,
+            // at most a ring full of the smallest records
+            ccnl_shm_drain(f, (int) (f->rx.size / 8));
+            f->failed = 1;
+        } else if (rc == 0 || f->mem || rc != (ssize_t) sizeof(req) ||
+                   ccnl_shm_setup(f, &req)) {
+            // closed, or a message which is not a first setup
+            f->failed = 1;
+        }
+    }
+    if (f->failed) {
+        ccnl_shm_close(f);
+    }
+}
+
+static void
+ccnl_shm_accept(struct ccnl_relay_s *relay, struct ccnl_io_watch_s *w,
+                uint32_t events)
+{
+    struct ccnl_shm_s *s = (struct ccnl_shm_s *) w->aux;
+    struct ccnl_shm_face_s *f;
+    int k, fd;
+    (void) relay;
+    (void) events;
+
+    // the listening socket is level triggered, the rest comes next round
+    for (k = 0; k < CCNL_SHM_ACCEPT_MAX; k++) {
+        fd = accept4(w->fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                DEBUGMSG(WARNING, "shm accept: %s\n", strerror(errno));
+            }
+            return;
+        }
+        f = (struct ccnl_shm_face_s *) ccnl_calloc(1, sizeof(*f));
+        if (!f) {
+            close(fd);
+            continue;
+        }
+        f->srv = s;
+        f->down = -1;
+        // unnamed, a path of its own tells the faces apart
+        f->peer.ux.sun_family = AF_UNIX;
+        snprintf(f->peer.ux.sun_path, sizeof(f->peer.ux.sun_path),
+                 "%u@%.80s", ++s->seqno,
+                 s->relay->ifs[s->ifndx].addr.ux.sun_path);
+        if (ccnl_io_watch(&f->w, fd, EPOLLIN, ccnl_shm_ready, f) < 0) {
+            ccnl_free(f);
+            close(fd);
+            continue;
+        }
+        ccnl_htable_insert(&s->index, &f->hnode, ccnl_addr_hash(&f->peer));
+        DBL_LINKED_LIST_ADD(s->faces, f);
+        DEBUGMSG(INFO, "shm connection %s\n", ccnl_addr2ascii(&f->peer));
+    }
+}
+
+int
+ccnl_shm_put(struct ccnl_if_s *ifc, sockunion *dest, struct ccnl_buf_s *buf)
+{
+    struct ccnl_shm_face_s *f;
+    uint8_t *p;
+
+    f = ccnl_shm_lookup((struct ccnl_shm_s *) ifc->shm, dest);
+    if (!f || !f->mem || f->failed) {
+        DEBUGMSG(DEBUG, "no shm face %s\n", ccnl_addr2ascii(dest));
+        return -1;
+    }
+    p = (uint8_t *) ccnl_shm_ring_reserve(&f->tx, buf->datalen);
+    if (!p) {
+        DEBUGMSG(DEBUG, "shm face %s: ring full, packet dropped\n",
+                 ccnl_addr2ascii(dest));
+        return -1;
+    }
+    memcpy(p, buf->data, buf->datalen);
+    if (ccnl_shm_ring_commit(&f->tx, buf->datalen) && !f->dirty) {
+        f->dirty = 1;
+        f->dnext = f->srv->dirty;
+        f->srv->dirty = f;
+    }
+    return 0;
+}
+
+void
+ccnl_shm_kick(struct ccnl_if_s *ifc)
+{
+    struct ccnl_shm_s *s = (struct ccnl_shm_s *) ifc->shm;
+    struct ccnl_shm_face_s *f;
+
+    while ((f = s->dirty)) {
+        s->dirty = f->dnext;
+        f->dirty = 0;
+        ccnl_shm_ring_bell(f->down);
+    }
+}
+
+static void
+ccnl_shm_release(struct ccnl_if_s *i)
+{
+    struct ccnl_shm_s *s = (struct ccnl_shm_s *) i->shm;
+
+    // the faces are gone already
+    while (s->faces) {
+        ccnl_shm_close(s->faces);
+    }
+    ccnl_io_unwatch(&s->w);
+    ccnl_htable_free(&s->index);
+    ccnl_free(s->rx);
+    ccnl_free(s);
+    i->shm = NULL;
+    i->shm_release = NULL;
+}
+
+int
+ccnl_shm_listen(struct ccnl_relay_s *relay, char *path)
+{
+    struct ccnl_if_s *i;
+    struct ccnl_shm_s *s;
+    int fd;
+
+    if (relay->ifcount >= CCNL_MAX_INTERFACES) {
+        DEBUGMSG(WARNING, "too many interfaces, no shm interface\n");
+        return -1;
+    }
+    i = &relay->ifs[relay->ifcount];
+    memset(&i->addr, 0, sizeof(i->addr));
+    i->addr.ux.sun_family = AF_UNIX;
+    strncpy(i->addr.ux.sun_path, path, sizeof(i->addr.ux.sun_path) - 1);
+    unlink(i->addr.ux.sun_path);
+
+    fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        perror("shm socket");
+        return -1;
+    }
+    if (bind(fd, &i->addr.sa, sizeof(i->addr.ux)) || listen(fd, SOMAXCONN)) {
+        perror("shm bind/listen");
+        ccnl_close_socket(fd);
+        return -1;
+    }
+    s = (struct ccnl_shm_s *) ccnl_calloc(1, sizeof(*s));
+    if (s) {
+        s->rx = (uint8_t *) ccnl_malloc(CCNL_SHM_MAX_PACKET_SIZE);
+    }
+    if (!s || !s->rx ||
+        ccnl_io_watch(&s->w, fd, EPOLLIN, ccnl_shm_accept, s) < 0) {
+        if (s) {
+            ccnl_free(s->rx);
+        }
+        ccnl_free(s);
+        ccnl_close_socket(fd);
+        return -1;
+    }
+    s->relay = relay;
+    s->ifndx = relay->ifcount;
+
+    i->sock = fd;
+    i->shm = s;
+    i->shm_release = ccnl_shm_release;
+    i->fwdalli = 1;
+    i->push = 1;
+    relay->ifcount++;
+    if (relay->defaultInterfaceScheduler) {
+        i->sched = relay->defaultInterfaceScheduler(relay, ccnl_interface_CTS);
+    }
+    DEBUGMSG(INFO, "shm interface (%s) configured\n",
+             ccnl_addr2ascii(&i->addr));
+    return s->ifndx;
+}
+
+#endif // USE_SHM
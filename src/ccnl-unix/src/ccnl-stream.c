@@ -0,0 +1,537 @@
+/*
+ * @f ccnl-stream.c
+ * @b CCN lite, TCP and UNIX stream faces
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-17 created
+ */
+
+#if defined(USE_STREAM) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // accept4(), TCP_CORK
+#endif
+
+#include "ccnl-unix.h"
+#include "ccnl-stream.h"
+
+#include "ccnl-os-includes.h"
+
+#include "ccnl-core.h"
+
+#ifdef USE_STREAM
+
+// A listening socket is an interface of the relay, which the event loops
+// leave alone: its connections are served through ccnl_io_watch(). Each
+// connection is a face of the interface, the core sends to it through the
+// interface's queue and ccnl_ll_TX(), which finds the connection by the
+// face's peer address. Received bytes are collected until a whole packet
+// is there and handed to the core in place, sent packets are copied into
+// the connection's output buffer unless the socket takes them at once.
+
+// initial size of a connection's input buffer, grows for larger packets
+#define CCNL_STREAM_RXBUF_SIZE  (64 * 1024)
+// packets read from one connection before the others get their turn
+#define CCNL_STREAM_RX_BUDGET   64
+// connections accepted in one go
+#define CCNL_STREAM_ACCEPT_MAX  16
+
+int ccnl_stream_tcp_mode = CCNL_STREAM_NODELAY;
+
+struct ccnl_stream_conn_s;
+
+// a listening socket
+struct ccnl_stream_s {
+    struct ccnl_io_watch_s w;
+    struct ccnl_relay_s *relay;
+    int ifndx;
+    struct ccnl_htable_s index;         // connections by peer address
+    struct ccnl_stream_conn_s *conns;
+    struct ccnl_stream_conn_s *dirty;   // output appended since the kick
+    uint32_t seqno;                     // names the UNIX peers
+};
+
+struct ccnl_stream_conn_s {
+    struct ccnl_io_watch_s w;
+    struct ccnl_stream_s *srv;
+    struct ccnl_stream_conn_s *next, *prev;
+    struct ccnl_stream_conn_s *dnext;   // on the dirty list
+    struct ccnl_hnode_s hnode;
+    sockunion peer;
+    int tcp;
+    uint8_t *in;                        // bytes of incomplete packets
+    size_t inlen, insize;
+    uint8_t *out;                       // bytes not written yet
+    size_t outoff, outlen, outsize;
+    char dirty, paused, failed;
+};
+
+static struct ccnl_stream_conn_s*
+ccnl_stream_lookup(struct ccnl_stream_s *s, sockunion *peer)
+{
+    struct ccnl_hnode_s *n;
+    struct ccnl_stream_conn_s *c;
+
+    for (n = ccnl_htable_lookup(&s->index, ccnl_addr_hash(peer));
+         n; n = ccnl_htable_next(n)) {
+        c = CCNL_HTABLE_ENTRY(n, struct ccnl_stream_conn_s, hnode);
+        if (!ccnl_addr_cmp(&c->peer, peer)) {
+            return c;
+        }
+    }
+    return NULL;
+}
+
+// the connection's handler closes it in this round of the loop; never
+// closed right away as the core may be sending to it while it is read
+static void
+ccnl_stream_fail(struct ccnl_stream_conn_s *c)
+{
+    if (!c->failed) {
+        c->failed = 1;
+        ccnl_io_defer(&c->w, EPOLLHUP);
+    }
+}
+
+static void
+ccnl_stream_close(struct ccnl_stream_conn_s *c)
+{
+    struct ccnl_stream_s *s = c->srv;
+    struct ccnl_stream_conn_s **pp;
+    struct ccnl_face_s *f;
+
+    DEBUGMSG(INFO, "stream connection %s closed\n", ccnl_addr2ascii(&c->peer));
+    f = ccnl_face_lookup(s->relay, s->ifndx, &c->peer);
+    if (f) {
+        ccnl_face_remove(s->relay, f);
+    }
+    if (c->dirty) {
+        for (pp = &s->dirty; *pp != c; pp = &(*pp)->dnext);
+        *pp = c->dnext;
+    }
+    ccnl_io_unwatch(&c->w);
+    close(c->w.fd);
+    ccnl_htable_remove(&s->index, &c->hnode);
+    DBL_LINKED_LIST_REMOVE(s->conns, c);
+    ccnl_free(c->in);
+    ccnl_free(c->out);
+    // the loop may still hold ready events of the connection
+    ccnl_io_release(&c->w, c);
+}
+
+// writes the output buffer as far as the socket takes it, waits for
+// EPOLLOUT for the rest
+static void
+ccnl_stream_send(struct ccnl_stream_conn_s *c)
+{
+    ssize_t rc;
+    int off = 0, on = 1;
+
+    while (c->outoff < c->outlen) {
+        rc = send(c->w.fd, c->out + c->outoff, c->outlen - c->outoff,
+                  MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (rc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                ccnl_io_modify(&c->w, EPOLLIN | EPOLLOUT | EPOLLET);
+                return;
+            }
+            DEBUGMSG(DEBUG, "stream send to %s: %s\n",
+                     ccnl_addr2ascii(&c->peer), strerror(errno));
+            ccnl_stream_fail(c);
+            return;
+        }
+        c->outoff += (size_t) rc;
+    }
+    c->outoff = c->outlen = 0;
+    if (c->tcp && ccnl_stream_tcp_mode == CCNL_STREAM_CORK) {
+        // uncorking pushes the last partial segment
+        setsockopt(c->w.fd, IPPROTO_TCP, TCP_CORK, &off, sizeof(off));
+        setsockopt(c->w.fd, IPPROTO_TCP, TCP_CORK, &on, sizeof(on));
+    }
+    ccnl_io_modify(&c->w, EPOLLIN | EPOLLET);
+    if (c->paused) {
+        c->paused = 0;
+        ccnl_io_defer(&c->w, EPOLLIN);
+    }
+}
+
+// hands the complete packets to the core and reads more, up to the budget
+static void
+ccnl_stream_recv(struct ccnl_stream_conn_s *c)
+{
+    struct ccnl_stream_s *s = c->srv;
+    size_t off, len = 0, room = 0;
+    ssize_t rc = 0;
+    int cnt = 0;
+
+    for (;;) {
+        for (off = 0; !c->failed; off += len) {
+            if (c->outlen - c->outoff >= CCNL_STREAM_OUTBUF_HIWAT) {
+                // the peer does not take what it asked for, the rest waits
+                // until ccnl_stream_send() got rid of it
+                c->paused = 1;
+                break;
+            }
+            if (ccnl_pkt_framelen(c->in + off, c->inlen - off, &len) < 0 ||
+                len > CCNL_STREAM_MAX_PACKET_SIZE) {
+                DEBUGMSG(WARNING, "stream from %s: no packet (suite) or too "
+                         "long, closing\n", ccnl_addr2ascii(&c->peer));
+                ccnl_stream_fail(c);
+                return;
+            }
+            if (!len || len > c->inlen - off) {
+                break;
+            }
+            ccnl_io_dispatch(s->relay, s->ifndx, c->in + off, len, &c->peer);
+            cnt++;
+        }
+        if (off) {
+            memmove(c->in, c->in + off, c->inlen - off);
+            c->inlen -= off;
+        }
+        if (c->failed || c->paused) {
+            return;
+        }
+        if (len > c->insize) {
+            uint8_t *in = (uint8_t *) ccnl_realloc(c->in, len);
+
+            if (!in) {
+                ccnl_stream_fail(c);
+                return;
+            }
+            c->in = in;
+            c->insize = len;
+        }
+        if (cnt >= CCNL_STREAM_RX_BUDGET) {
+            ccnl_io_defer(&c->w, EPOLLIN);
+            return;
+        }
+        if (rc > 0 && (size_t) rc < room) {
+            // a short read means the socket ran dry
+            return;
+        }
+
+        room = c->insize - c->inlen;
+        rc = recv(c->w.fd, c->in + c->inlen, room, MSG_DONTWAIT);
+        if (rc < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                ccnl_stream_fail(c);
+            }
+            return;
+        }
+        if (rc == 0) {
+            ccnl_stream_fail(c);
+            return;
+        }
+#ifdef USE_STATS
+        s->relay->ifs[s->ifndx].rx_batches++;
+#endif
+        c->inlen += (size_t) rc;
+    }
+}
+
+static void
+ccnl_stream_ready(struct ccnl_relay_s *relay, struct ccnl_io_watch_s *w,
+                  uint32_t events)
+{
+    struct ccnl_stream_conn_s *c = (struct ccnl_stream_conn_s *) w->aux;
+    (void) relay;
+
+    if ((events & EPOLLOUT) && !c->failed) {
+        ccnl_stream_send(c);
+    }
+    if ((events & (EPOLLIN | EPOLLERR | EPOLLHUP)) && !c->failed &&
+        !c->paused) {
+        ccnl_stream_recv(c);
+    }
+    if (c->failed) {
+        ccnl_stream_close(c);
+    }
+}
+
+static void
+ccnl_stream_accept(struct ccnl_relay_s *relay, struct ccnl_io_watch_s *w,
+                   uint32_t events)
+{
+    struct ccnl_stream_s *s = (struct ccnl_stream_s *) w->aux;
+    struct ccnl_stream_conn_s *c;
+    sockunion peer;
+    socklen_t len;
+    int k, fd, on = 1;
+    (void) relay;
+    (void) events;
+
+    // the listening socket is level triggered, the rest comes next round
+    for (k = 0; k < CCNL_STREAM_ACCEPT_MAX; k++) {
+        len = sizeof(peer);
+        memset(&peer, 0, sizeof(peer));
+        fd = accept4(w->fd, &peer.sa, &len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                DEBUGMSG(WARNING, "stream accept: %s\n", strerror(errno));
+            }
+            return;
+        }
+        c = (struct ccnl_stream_conn_s *) ccnl_calloc(1, sizeof(*c));
+        if (c) {
+            c->in = (uint8_t *) ccnl_malloc(CCNL_STREAM_RXBUF_SIZE);
+        }
+        if (!c || !c->in) {
+            ccnl_free(c);
+            close(fd);
+            continue;
+        }
+        c->insize = CCNL_STREAM_RXBUF_SIZE;
+        c->srv = s;
+#ifdef USE_UNIXSOCKET
+        if (peer.sa.sa_family == AF_UNIX) {
+            // unnamed, a path of its own tells the faces apart
+            memset(&c->peer, 0, sizeof(c->peer));
+            c->peer.ux.sun_family = AF_UNIX;
+            snprintf(c->peer.ux.sun_path, sizeof(c->peer.ux.sun_path),
+                     "%u@%.80s", ++s->seqno,
+                     s->relay->ifs[s->ifndx].addr.ux.sun_path);
+        } else
+#endif
+        {
+            c->peer = peer;
+            c->tcp = 1;
+            if (ccnl_stream_tcp_mode == CCNL_STREAM_NODELAY) {
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+            } else if (ccnl_stream_tcp_mode == CCNL_STREAM_CORK) {
+                setsockopt(fd, IPPROTO_TCP, TCP_CORK, &on, sizeof(on));
+            }
+        }
+        if (ccnl_io_watch(&c->w, fd, EPOLLIN | EPOLLET, ccnl_stream_ready,
+                          c) < 0) {
+            ccnl_free(c->in);
+            ccnl_free(c);
+            close(fd);
+            continue;
+        }
+        ccnl_htable_insert(&s->index, &c->hnode, ccnl_addr_hash(&c->peer));
+        DBL_LINKED_LIST_ADD(s->conns, c);
+        // bytes may have arrived before the registration
+        ccnl_io_defer(&c->w, EPOLLIN);
+        DEBUGMSG(INFO, "stream connection from %s\n",
+                 ccnl_addr2ascii(&c->peer));
+    }
+}
+
+int
+ccnl_stream_put(struct ccnl_if_s *ifc, sockunion *dest,
+                struct ccnl_buf_s *buf)
+{
+    struct ccnl_stream_conn_s *c;
+    size_t size;
+    uint8_t *out;
+
+    c = ccnl_stream_lookup((struct ccnl_stream_s *) ifc->stream, dest);
+    if (!c || c->failed) {
+        DEBUGMSG(DEBUG, "no stream connection to %s\n", ccnl_addr2ascii(dest));
+        return -1;
+    }
+    if (c->outlen - c->outoff + buf->datalen > CCNL_STREAM_MAX_OUTBUF) {
+        DEBUGMSG(DEBUG, "stream to %s: output buffer full, packet dropped\n",
+                 ccnl_addr2ascii(dest));
+        return -1;
+    }
+    if (c->outlen + buf->datalen > c->outsize && c->outoff) {
+        memmove(c->out, c->out + c->outoff, c->outlen - c->outoff);
+        c->outlen -= c->outoff;
+        c->outoff = 0;
+    }
+    if (c->outlen + buf->datalen > c->outsize) {
+        for (size = c->outsize ? c->outsize : CCNL_STREAM_RXBUF_SIZE;
+             size < c->outlen + buf->datalen; size *= 2);
+        out = (uint8_t *) ccnl_realloc(c->out, size);
+        if (!out) {
+            return -1;
+        }
+        c->out = out;
+        c->outsize = size;
+    }
+    memcpy(c->out + c->outlen, buf->data, buf->datalen);
+    c->outlen += buf->datalen;
+    if (!c->dirty) {
+        c->dirty = 1;
+        c->dnext = c->srv->dirty;
+        c->srv->dirty = c;
+    }
+    return 0;
+}
+
+void
+ccnl_stream_kick(struct ccnl_if_s *ifc)
+{
+    struct ccnl_stream_s *s = (struct ccnl_stream_s *) ifc->stream;
+    struct ccnl_stream_conn_s *c;
+
+    while ((c = s->dirty)) {
+        s->dirty = c->dnext;
+        c->dirty = 0;
+        // a partly written buffer waits for EPOLLOUT
+        if (!c->failed && !(c->w.events & EPOLLOUT)) {
+            ccnl_stream_send(c);
+        }
+    }
+}
+
+void
+ccnl_stream_TX(struct ccnl_if_s *ifc, sockunion *dest,
+               struct ccnl_buf_s *buf)
+{
+    struct ccnl_stream_conn_s *c;
+    ssize_t rc = 0;
+
+    c = ccnl_stream_lookup((struct ccnl_stream_s *) ifc->stream, dest);
+    if (c && !c->failed && c->outoff == c->outlen) {
+        // nothing waiting: straight from the packet, buffer the rest only
+        rc = send(c->w.fd, buf->data, buf->datalen,
+                  MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (rc == (ssize_t) buf->datalen) {
+            if (c->tcp && ccnl_stream_tcp_mode == CCNL_STREAM_CORK) {
+                int off = 0, on = 1;
+
+                setsockopt(c->w.fd, IPPROTO_TCP, TCP_CORK, &off, sizeof(off));
+                setsockopt(c->w.fd, IPPROTO_TCP, TCP_CORK, &on, sizeof(on));
+            }
+            return;
+        }
+        if (rc < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                ccnl_stream_fail(c);
+                return;
+            }
+            rc = 0;
+        }
+        // the output buffer is empty and takes the rest
+        if (c->outsize < buf->datalen - (size_t) rc) {
+            uint8_t *out = (uint8_t *) ccnl_realloc(c->out,
+                                                    buf->datalen - (size_t) rc);
+            if (!out) {
+                ccnl_stream_fail(c);
+                return;
+            }
+            c->out = out;
+            c->outsize = buf->datalen - (size_t) rc;
+        }
+        memcpy(c->out, buf->data + rc, buf->datalen - (size_t) rc);
+        c->outoff = 0;
+        c->outlen = buf->datalen - (size_t) rc;
+        ccnl_io_modify(&c->w, EPOLLIN | EPOLLOUT | EPOLLET);
+        return;
+    }
+    if (!ccnl_stream_put(ifc, dest, buf)) {
+        ccnl_stream_kick(ifc);
+    }
+}
+
+static void
+ccnl_stream_release(struct ccnl_if_s *i)
+{
+    struct ccnl_stream_s *s = (struct ccnl_stream_s *) i->stream;
+
+    // the faces are gone already
+    while (s->conns) {
+        ccnl_stream_close(s->conns);
+    }
+    ccnl_io_unwatch(&s->w);
+    ccnl_htable_free(&s->index);
+    ccnl_free(s);
+    i->stream = NULL;
+    i->stream_release = NULL;
+}
+
+int
+ccnl_stream_listen(struct ccnl_relay_s *relay, sockunion *addr)
+{
+    struct ccnl_if_s *i;
+    struct ccnl_stream_s *s;
+    socklen_t len;
+    int fd, on = 1;
+
+    if (relay->ifcount >= CCNL_MAX_INTERFACES) {
+        DEBUGMSG(WARNING, "too many interfaces, no stream interface\n");
+        return -1;
+    }
+    i = &relay->ifs[relay->ifcount];
+    switch (addr->sa.sa_family) {
+#ifdef USE_IPV4
+    case AF_INET:
+        len = sizeof(addr->ip4);
+        break;
+#endif
+#ifdef USE_IPV6
+    case AF_INET6:
+        len = sizeof(addr->ip6);
+        break;
+#endif
+#ifdef USE_UNIXSOCKET
+    case AF_UNIX:
+        len = sizeof(addr->ux);
+        unlink(addr->ux.sun_path);
+        break;
+#endif
+    default:
+        return -1;
+    }
+
+    fd = socket(addr->sa.sa_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                0);
+    if (fd < 0) {
+        perror("stream socket");
+        return -1;
+    }
+    if (addr->sa.sa_family != AF_UNIX) {
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    }
+    if (bind(fd, &addr->sa, len) || listen(fd, SOMAXCONN)) {
+        perror("stream bind/listen");
+        close(fd);
+        return -1;
+    }
+    s = (struct ccnl_stream_s *) ccnl_calloc(1, sizeof(*s));
+    if (!s) {
+        close(fd);
+        return -1;
+    }
+    if (ccnl_io_watch(&s->w, fd, EPOLLIN, ccnl_stream_accept, s) < 0) {
+        ccnl_free(s);
+        close(fd);
+        return -1;
+    }
+    s->relay = relay;
+    s->ifndx = relay->ifcount;
+
+    memcpy(&i->addr, addr, len);
+    getsockname(fd, &i->addr.sa, &len); // the port if it was 0
+    i->sock = fd;
+    i->stream = s;
+    i->stream_release = ccnl_stream_release;
+    i->fwdalli = 1;
+    relay->ifcount++;
+    if (relay->defaultInterfaceScheduler) {
+        i->sched = relay->defaultInterfaceScheduler(relay, ccnl_interface_CTS);
+    }
+    DEBUGMSG(INFO, "stream interface (%s) configured\n",
+             ccnl_addr2ascii(&i->addr));
+    return s->ifndx;
+}
+
+#endif // USE_STREAM
@@ -20,6 +20,11 @@
  * 2017-06-16 created
  */
 
+#if (defined(USE_MMSG) || defined(USE_URING) || defined(USE_TPACKET)) && \
+    !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // recvmmsg(), sendmmsg(), syscall(), MAP_POPULATE
+#endif
+
 #include "ccnl-unix.h"
 
 #include "ccnl-os-includes.h"
@@ -35,12 +40,28 @@
 #ifdef USE_HTTP_STATUS
 #include "ccnl-http-status.h"
 #endif
+#ifdef USE_XDP
+#include "ccnl-xdp.h"
+#endif
+#ifdef USE_STREAM
+#include "ccnl-stream.h"
+#endif
+#ifdef USE_SHM
+#include "ccnl-shm.h"
+#endif
 
 /**
  * TODO: The variables are never updated within the context of
  * ccnl_unix.c
  */
-static int lasthour = -1;
+static CCNL_THREAD_LOCAL int lasthour = -1;
+
+// set before ccnl_relay_config() to let the UDP sockets of several relays
+// (shards) share their ports, the kernel spreads the peers among them
+int ccnl_udp_reuseport;
+#ifdef USE_TPACKET
+int ccnl_eth_tpacket;
+#endif
 #ifdef USE_SCHEDULER
 static int inter_ccn_interval = 0; // in usec
 static int inter_pkt_interval = 0; // in usec
@@ -83,6 +104,214 @@ ccnl_open_ethdev(char *devname, struct sockaddr_ll *sll, uint16_t ethtype)
 
     return s;
 }
+
+#ifdef USE_TPACKET
+
+// TPACKET_V3 rings of an Ethernet interface: the kernel fills whole
+// blocks of received frames and hands them over at once (or after the
+// retire timeout), transmitted frames are written into the slots of the
+// TX ring and sent with one system call for all of them
+#ifndef CCNL_TPACKET_BLOCK_SIZE
+#define CCNL_TPACKET_BLOCK_SIZE     (1 << 18)   // multiple of the page size
+#endif
+#ifndef CCNL_TPACKET_RX_BLOCKS
+#define CCNL_TPACKET_RX_BLOCKS      32
+#endif
+#define CCNL_TPACKET_TX_BLOCKS      2
+#define CCNL_TPACKET_FRAME_SIZE     2048        // TX slots, Ethernet MTU
+#define CCNL_TPACKET_RETIRE_MSEC    1           // bound on the RX latency
+
+// frame data in a TX slot, behind the header (tp_hdrlen minus the address)
+#define CCNL_TPACKET_TX_OFF         TPACKET_ALIGN(sizeof(struct tpacket3_hdr))
+
+struct ccnl_tpacket_s {
+    struct ccnl_ll_ring_s ops;          // first, ccnl_if_s.ring points here
+    uint8_t *map;
+    size_t maplen;
+    uint8_t *rx;                        // RX blocks, followed by the TX ring
+    unsigned int rx_cur;
+    struct tpacket3_hdr *rx_next;       // next frame of block rx_cur
+    uint32_t rx_left;                   // its frames not handled yet
+    uint8_t *tx;
+    unsigned int tx_frames, tx_cur;
+};
+
+static void
+ccnl_tpacket_release(struct ccnl_if_s *i)
+{
+    struct ccnl_tpacket_s *tp = (struct ccnl_tpacket_s *) i->ring;
+
+    munmap(tp->map, tp->maplen);
+    ccnl_free(tp);
+    i->ring = NULL;
+    i->ring_release = NULL;
+}
+
+// hands the frames of the blocks the kernel retired to the core, in
+// place, until max frames are done or no block is ready; a block left
+// halfway is resumed by the next call; returns the number of frames or
+// -1 (EAGAIN)
+static int
+ccnl_tpacket_recv(struct ccnl_relay_s *ccnl, int i, int max)
+{
+    struct ccnl_tpacket_s *tp = (struct ccnl_tpacket_s *) ccnl->ifs[i].ring;
+    struct tpacket_block_desc *bd;
+    struct tpacket3_hdr *ph;
+    struct sockaddr_ll *sll;
+    sockunion src_addr;
+    int cnt = 0;
+
+    while (cnt < max) {
+        bd = (struct tpacket_block_desc *) (tp->rx +
+                                (size_t) tp->rx_cur * CCNL_TPACKET_BLOCK_SIZE);
+        if (!tp->rx_next) {
+            if (!(__atomic_load_n(&bd->hdr.bh1.block_status, __ATOMIC_ACQUIRE) &
+                  TP_STATUS_USER)) {
+                break;
+            }
+            tp->rx_left = bd->hdr.bh1.num_pkts;
+            tp->rx_next = (struct tpacket3_hdr *) ((uint8_t *) bd +
+                                        bd->hdr.bh1.offset_to_first_pkt);
+        }
+        for (; tp->rx_left && cnt < max; tp->rx_left--, cnt++) {
+            ph = tp->rx_next;
+            sll = (struct sockaddr_ll *) ((uint8_t *) ph +
+                                TPACKET_ALIGN(sizeof(struct tpacket3_hdr)));
+            memset(&src_addr, 0, sizeof(src_addr));
+            memcpy(&src_addr.linklayer, sll, sizeof(*sll));
+            tp->rx_next = (struct tpacket3_hdr *) ((uint8_t *) ph +
+                                                   ph->tp_next_offset);
+            ccnl_io_dispatch(ccnl, i, (uint8_t *) ph + ph->tp_mac,
+                             ph->tp_snaplen, &src_addr);
+        }
+        if (tp->rx_left) {
+            break;
+        }
+        // the block goes back to the kernel with all its frames
+        tp->rx_next = NULL;
+        __atomic_store_n(&bd->hdr.bh1.block_status, TP_STATUS_KERNEL,
+                         __ATOMIC_RELEASE);
+        tp->rx_cur = (tp->rx_cur + 1) % CCNL_TPACKET_RX_BLOCKS;
+#ifdef USE_STATS
+        ccnl->ifs[i].rx_batches++;
+#endif
+    }
+    if (!cnt) {
+        errno = EAGAIN;
+        return -1;
+    }
+    return cnt;
+}
+
+// puts a frame into the next slot of the TX ring, the kernel sends it
+// with the next ccnl_tpacket_kick(); returns -1 if the ring is full,
+// frames larger than a slot are dropped
+static int
+ccnl_tpacket_put(struct ccnl_if_s *ifc, uint8_t *dst,
+                 uint8_t *data, size_t datalen)
+{
+    struct ccnl_tpacket_s *tp = (struct ccnl_tpacket_s *) ifc->ring;
+    struct tpacket3_hdr *ph;
+    uint16_t type = htons(CCNL_ETH_TYPE);
+    uint8_t *frame;
+
+    if (datalen + 14 > CCNL_TPACKET_FRAME_SIZE - CCNL_TPACKET_TX_OFF) {
+        DEBUGMSG(DEBUG, "tpacket: frame of %zu bytes dropped\n", datalen);
+        return 0;
+    }
+    ph = (struct tpacket3_hdr *) (tp->tx +
+                                  (size_t) tp->tx_cur * CCNL_TPACKET_FRAME_SIZE);
+    if (__atomic_load_n(&ph->tp_status, __ATOMIC_ACQUIRE) &
+        (TP_STATUS_SEND_REQUEST | TP_STATUS_SENDING)) {
+        return -1;
+    }
+    frame = (uint8_t *) ph + CCNL_TPACKET_TX_OFF;
+    memcpy(frame, dst, 6);
+    memcpy(frame + 6, ifc->addr.linklayer.sll_addr, 6);
+    memcpy(frame + 12, &type, sizeof(type));
+    memcpy(frame + 14, data, datalen);
+    ph->tp_len = (uint32_t) (datalen + 14);
+    ph->tp_snaplen = ph->tp_len;
+    ph->tp_next_offset = 0;
+    __atomic_store_n(&ph->tp_status, TP_STATUS_SEND_REQUEST, __ATOMIC_RELEASE);
+    tp->tx_cur = (tp->tx_cur + 1) % tp->tx_frames;
+    return 0;
+}
+
+// sends the frames put into the TX ring
+static void
+ccnl_tpacket_kick(struct ccnl_if_s *ifc)
+{
+    if (send(ifc->sock, NULL, 0, MSG_DONTWAIT) < 0 && errno != EAGAIN) {
+        DEBUGMSG(DEBUG, "tpacket send failed: %s\n", strerror(errno));
+    }
+#ifdef USE_STATS
+    ifc->tx_batches++;
+#endif
+}
+
+// maps RX and TX rings onto the packet socket of interface i, the
+// interface keeps the plain socket calls if that is not possible
+static void
+ccnl_tpacket_setup(struct ccnl_if_s *i)
+{
+    struct tpacket_req3 rx, tx;
+    struct ccnl_tpacket_s *tp;
+    int v = TPACKET_V3, one = 1;
+
+    memset(&rx, 0, sizeof(rx));
+    rx.tp_block_size = CCNL_TPACKET_BLOCK_SIZE;
+    rx.tp_block_nr = CCNL_TPACKET_RX_BLOCKS;
+    rx.tp_frame_size = CCNL_TPACKET_FRAME_SIZE;
+    rx.tp_frame_nr = rx.tp_block_nr * (rx.tp_block_size / rx.tp_frame_size);
+    rx.tp_retire_blk_tov = CCNL_TPACKET_RETIRE_MSEC;
+    // the TX ring must not ask for the RX only features
+    memset(&tx, 0, sizeof(tx));
+    tx.tp_block_size = CCNL_TPACKET_BLOCK_SIZE;
+    tx.tp_block_nr = CCNL_TPACKET_TX_BLOCKS;
+    tx.tp_frame_size = CCNL_TPACKET_FRAME_SIZE;
+    tx.tp_frame_nr = tx.tp_block_nr * (tx.tp_block_size / tx.tp_frame_size);
+
+    if (setsockopt(i->sock, SOL_PACKET, PACKET_VERSION, &v, sizeof(v)) < 0 ||
+        // malformed frames are skipped instead of stopping the TX ring
+        setsockopt(i->sock, SOL_PACKET, PACKET_LOSS, &one, sizeof(one)) < 0 ||
+        setsockopt(i->sock, SOL_PACKET, PACKET_RX_RING, &rx, sizeof(rx)) < 0 ||
+        setsockopt(i->sock, SOL_PACKET, PACKET_TX_RING, &tx, sizeof(tx)) < 0) {
+        DEBUGMSG(WARNING, "TPACKET_V3 rings not available (%s), "
+                 "ETH interface uses socket calls\n", strerror(errno));
+        return;
+    }
+    tp = (struct ccnl_tpacket_s *) ccnl_calloc(1, sizeof(*tp));
+    if (!tp) {
+        return;
+    }
+    tp->maplen = (size_t) (rx.tp_block_nr + tx.tp_block_nr) * CCNL_TPACKET_BLOCK_SIZE;
+    tp->map = mmap(NULL, tp->maplen, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_LOCKED | MAP_POPULATE, i->sock, 0);
+    if (tp->map == MAP_FAILED) {
+        // e.g. RLIMIT_MEMLOCK, the rings work unlocked as well
+        tp->map = mmap(NULL, tp->maplen, PROT_READ | PROT_WRITE, MAP_SHARED,
+                       i->sock, 0);
+    }
+    if (tp->map == MAP_FAILED) {
+        perror("tpacket mmap");
+        ccnl_free(tp);
+        return;
+    }
+    tp->rx = tp->map;
+    tp->tx = tp->map + (size_t) rx.tp_block_nr * CCNL_TPACKET_BLOCK_SIZE;
+    tp->tx_frames = tx.tp_frame_nr;
+    tp->ops.recv = ccnl_tpacket_recv;
+    tp->ops.put = ccnl_tpacket_put;
+    tp->ops.kick = ccnl_tpacket_kick;
+    i->ring = tp;
+    i->ring_release = ccnl_tpacket_release;
+    DEBUGMSG(INFO, "ETH interface uses TPACKET_V3 rings (%u RX blocks of %u "
+             "bytes, %u TX frames)\n", rx.tp_block_nr, rx.tp_block_size,
+             tx.tp_frame_nr);
+}
+
+#endif // USE_TPACKET
 #endif // USE_LINKLAYER
 
 
@@ -169,6 +398,13 @@ ccnl_open_udpdev(uint16_t port, struct sockaddr_in *si)
     si->sin_addr.s_addr = INADDR_ANY;
     si->sin_port = htons(port);
     si->sin_family = PF_INET;
+#ifdef SO_REUSEPORT
+    opt_value = 1;
+    if (ccnl_udp_reuseport &&
+        setsockopt(s, SOL_SOCKET, SO_REUSEPORT, &opt_value, sizeof(opt_value)) < 0) {
+        perror("udp sock reuseport");
+    }
+#endif
     if (bind(s, (struct sockaddr *)si, sizeof(*si)) < 0) {
         perror("udp sock bind");
         return -1;
@@ -203,6 +439,16 @@ ccnl_open_udp6dev(uint16_t port, struct sockaddr_in6 *sin)
     sin->sin6_addr = in6addr_any;
     sin->sin6_port = htons(port);
     sin->sin6_family = PF_INET6;
+#ifdef SO_REUSEPORT
+    if (ccnl_udp_reuseport) {
+        int opt_value = 1;
+
+        if (setsockopt(s, SOL_SOCKET, SO_REUSEPORT,
+                       &opt_value, sizeof(opt_value)) < 0) {
+            perror("udp6 sock reuseport");
+        }
+    }
+#endif
     if (bind(s, (struct sockaddr *)sin, sizeof(*sin)) < 0) {
         perror("udp sock bind");
         return -1;
@@ -241,6 +487,26 @@ ccnl_eth_sendto(int sock, uint8_t *dst, uint8_t *src,
 
     return sendto(sock, buf, hdrlen + datalen, 0, 0, 0);
 }
+
+#if defined(USE_TPACKET) || defined(USE_XDP)
+// sends a frame through the TX ring of the interface, at once
+static void
+ccnl_ll_ring_TX(struct ccnl_if_s *ifc, uint8_t *dst,
+                uint8_t *data, size_t datalen)
+{
+    struct ccnl_ll_ring_s *ring = (struct ccnl_ll_ring_s *) ifc->ring;
+
+    if (ring->put(ifc, dst, data, datalen) < 0) {
+        // the kernel did not get to the ring yet
+        ring->kick(ifc);
+        if (ring->put(ifc, dst, data, datalen) < 0) {
+            DEBUGMSG(DEBUG, "TX ring full, frame dropped\n");
+            return;
+        }
+    }
+    ring->kick(ifc);
+}
+#endif
 #endif // USE_LINKLAYER
 
 
@@ -276,18 +542,38 @@ ccnl_relay_defaultInterfaceScheduler(struct ccnl_relay_s *ccnl,
 void ccnl_ageing(void *relay, void *aux)
 {
     time_t t = time(NULL);
-    struct tm *tm = localtime(&t);
-
-    if (lasthour != tm->tm_hour) {
-        DEBUGMSG(INFO, "local time is %s", ctime(&t));
-        lasthour = tm->tm_hour;
+    struct tm tm;
+    char buf[26];
+
+    // shards and pipeline stages age in threads of their own
+    localtime_r(&t, &tm);
+    if (lasthour != tm.tm_hour) {
+        DEBUGMSG(INFO, "local time is %s", ctime_r(&t, buf));
+        lasthour = tm.tm_hour;
     }
 
-    ccnl_do_ageing(relay, aux);
+    // PIT entries, content and faces expire by timers of their own
+    (void) aux;
     ccnl_set_timer(1000000, ccnl_ageing, relay, 0);
 }
 
 #if defined(USE_IPV4) || defined(USE_IPV6)
+#ifdef USE_GSO
+// turns on UDP segmentation offload where the kernel has it, Linux 4.18
+// for sending and 5.0 for receiving
+static void
+ccnl_udp_offload(struct ccnl_if_s *i)
+{
+    int on = 1, gso_size = 0;
+
+    i->gro = setsockopt(i->sock, SOL_UDP, UDP_GRO, &on, sizeof(on)) == 0;
+    // a socket wide segment size of 0 changes nothing but probes the option
+    i->gso = setsockopt(i->sock, SOL_UDP, UDP_SEGMENT,
+                        &gso_size, sizeof(gso_size)) == 0;
+    DEBUGMSG(INFO, "  UDP offload: gso=%d gro=%d\n", i->gso, i->gro);
+}
+#endif
+
 void
 ccnl_relay_udp(struct ccnl_relay_s *relay, int32_t sport, int af, int suite)
 {
@@ -339,6 +625,9 @@ ccnl_relay_udp(struct ccnl_relay_s *relay, int32_t sport, int af, int suite)
     relay->ifcount++;
     DEBUGMSG(INFO, "UDP interface (%s) configured\n",
              ccnl_addr2ascii(&i->addr));
+#ifdef USE_GSO
+    ccnl_udp_offload(i);
+#endif
     if (relay->defaultInterfaceScheduler)
         i->sched = relay->defaultInterfaceScheduler(relay,
                                                         ccnl_interface_CTS);
@@ -351,6 +640,19 @@ ccnl_ll_TX(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
 {
     ssize_t rc = -1;
     (void) ccnl;
+#ifdef USE_STREAM
+    if (ifc->stream) {
+        ccnl_stream_TX(ifc, dest, buf);
+        return;
+    }
+#endif
+#ifdef USE_SHM
+    if (ifc->shm) {
+        ccnl_shm_put(ifc, dest, buf);
+        ccnl_shm_kick(ifc);
+        return;
+    }
+#endif
     switch(dest->sa.sa_family) {
 #ifdef USE_IPV4
     case AF_INET:
@@ -388,6 +690,13 @@ ccnl_ll_TX(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
 #endif
 #ifdef USE_LINKLAYER
     case AF_PACKET:
+#if defined(USE_TPACKET) || defined(USE_XDP)
+        if (ifc->ring) {
+            ccnl_ll_ring_TX(ifc, dest->linklayer.sll_addr,
+                            buf->data, buf->datalen);
+            break;
+        }
+#endif
         rc = ccnl_eth_sendto(ifc->sock,
                              dest->linklayer.sll_addr,
                              ifc->addr.linklayer.sll_addr,
@@ -417,6 +726,230 @@ ccnl_ll_TX(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
     (void) rc; // just to silence a compiler warning (if USE_DEBUG is not set)
 }
 
+#if defined(USE_MMSG) || defined(USE_URING)
+// length of a destination address sendmsg() can handle, 0 otherwise
+static socklen_t
+ccnl_ll_addrlen(sockunion *dest)
+{
+    switch (dest->sa.sa_family) {
+#ifdef USE_IPV4
+    case AF_INET:
+        return sizeof(struct sockaddr_in);
+#endif
+#ifdef USE_IPV6
+    case AF_INET6:
+        return sizeof(struct sockaddr_in6);
+#endif
+#ifdef USE_UNIXSOCKET
+    case AF_UNIX:
+        return sizeof(struct sockaddr_un);
+#endif
+    default:
+        return 0;
+    }
+}
+#endif
+
+#ifdef USE_MMSG
+#ifdef USE_GSO
+// payload and segments one UDP_SEGMENT send may carry
+#define CCNL_GSO_MAX_BYTES      (65535 - 40 - 8)
+#define CCNL_GSO_MAX_SEGMENTS   64
+
+// number of queued datagrams from position pos on which go to the same
+// peer with the same size (the last one may be shorter), i.e. which one
+// UDP_SEGMENT send can carry
+static int
+ccnl_ll_gso_run(struct ccnl_if_s *ifc, size_t pos)
+{
+    struct ccnl_txrequest_s *first, *r;
+    size_t total, n;
+
+    first = ifc->queue + ((ifc->qfront + pos) % CCNL_MAX_IF_QLEN);
+    if (first->dst.sa.sa_family != AF_INET &&
+        first->dst.sa.sa_family != AF_INET6) {
+        return 1;
+    }
+    total = first->buf->datalen;
+    for (n = 1; pos + n < ifc->qlen && n < CCNL_GSO_MAX_SEGMENTS; n++) {
+        r = ifc->queue + ((ifc->qfront + pos + n) % CCNL_MAX_IF_QLEN);
+        if (r->buf->datalen > first->buf->datalen ||
+            total + r->buf->datalen > CCNL_GSO_MAX_BYTES ||
+            memcmp(&r->dst, &first->dst, ccnl_ll_addrlen(&first->dst))) {
+            break;
+        }
+        total += r->buf->datalen;
+        if (r->buf->datalen < first->buf->datalen) {
+            n++; // a shorter segment ends the run
+            break;
+        }
+    }
+    return (int) n;
+}
+#endif // USE_GSO
+
+void
+ccnl_ll_TX_batch(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc)
+{
+    struct mmsghdr msgs[CCNL_MAX_IO_BATCH];
+    struct iovec iov[CCNL_MAX_IF_QLEN];
+    int segs[CCNL_MAX_IO_BATCH]; // queued datagrams per message
+#ifdef USE_GSO
+    union {
+        size_t align; // as struct cmsghdr
+        char buf[CMSG_SPACE(sizeof(uint16_t))];
+    } ctrl[CCNL_MAX_IO_BATCH];
+    struct cmsghdr *cm;
+    uint16_t gso_size;
+#endif
+    struct ccnl_txrequest_s *r;
+    int j, k, n, cnt, pos;
+
+#ifdef USE_STREAM
+    if (ifc->stream) {
+        // into the connections' output buffers, one write per connection
+        while (ifc->qlen > 0) {
+            r = ifc->queue + ifc->qfront;
+            ccnl_stream_put(ifc, &r->dst, r->buf);
+            ccnl_buf_free(r->buf);
+            r->buf = NULL;
+            ifc->qfront = (ifc->qfront + 1) % CCNL_MAX_IF_QLEN;
+            ifc->qlen--;
+#ifdef USE_STATS
+            ifc->tx_cnt++;
+#endif
+        }
+        ccnl_stream_kick(ifc);
+        return;
+    }
+#endif
+#ifdef USE_SHM
+    if (ifc->shm) {
+        // into the faces' rings, one eventfd write per face
+        while (ifc->qlen > 0) {
+            r = ifc->queue + ifc->qfront;
+            ccnl_shm_put(ifc, &r->dst, r->buf);
+            ccnl_buf_free(r->buf);
+            r->buf = NULL;
+            ifc->qfront = (ifc->qfront + 1) % CCNL_MAX_IF_QLEN;
+            ifc->qlen--;
+#ifdef USE_STATS
+            ifc->tx_cnt++;
+#endif
+        }
+        ccnl_shm_kick(ifc);
+        return;
+    }
+#endif
+    while (ifc->qlen > 0) {
+        r = ifc->queue + ifc->qfront;
+        if (!ccnl_ll_addrlen(&r->dst)) {
+#if defined(USE_TPACKET) || defined(USE_XDP)
+            if (ifc->ring && r->dst.sa.sa_family == AF_PACKET) {
+                struct ccnl_ll_ring_s *ring = (struct ccnl_ll_ring_s *) ifc->ring;
+
+                // fill the TX ring with the queued frames, one send for all
+                for (k = 0; ifc->qlen > 0 && r->dst.sa.sa_family == AF_PACKET &&
+                            ring->put(ifc, r->dst.linklayer.sll_addr,
+                                      r->buf->data, r->buf->datalen) == 0;
+                     k++) {
+                    ccnl_buf_free(r->buf);
+                    r->buf = NULL;
+                    ifc->qfront = (ifc->qfront + 1) % CCNL_MAX_IF_QLEN;
+                    ifc->qlen--;
+#ifdef USE_STATS
+                    ifc->tx_cnt++;
+#endif
+                    r = ifc->queue + ifc->qfront;
+                }
+                ring->kick(ifc);
+                if (!k) {
+                    // the ring is full, the rest waits for EPOLLOUT
+                    return;
+                }
+                continue;
+            }
+#endif
+            // link layer frames have their own send path
+            ccnl_interface_CTS(ccnl, ifc);
+            continue;
+        }
+
+        // collect the queued datagrams up to the next other transport,
+        // runs of equal sized ones to the same peer share a message
+        memset(msgs, 0, sizeof(msgs));
+        for (cnt = 0, pos = 0; pos < (int) ifc->qlen && cnt < CCNL_MAX_IO_BATCH;
+             cnt++, pos += segs[cnt - 1]) {
+            r = ifc->queue + ((ifc->qfront + pos) % CCNL_MAX_IF_QLEN);
+            msgs[cnt].msg_hdr.msg_namelen = ccnl_ll_addrlen(&r->dst);
+            if (!msgs[cnt].msg_hdr.msg_namelen) {
+                break;
+            }
+            segs[cnt] = 1;
+#ifdef USE_GSO
+            if (ifc->gso) {
+                segs[cnt] = ccnl_ll_gso_run(ifc, pos);
+            }
+#endif
+            for (j = 0; j < segs[cnt]; j++) {
+                struct ccnl_buf_s *buf;
+
+                buf = ifc->queue[(ifc->qfront + pos + j) % CCNL_MAX_IF_QLEN].buf;
+                iov[pos + j].iov_base = buf->data;
+                iov[pos + j].iov_len = buf->datalen;
+            }
+            msgs[cnt].msg_hdr.msg_name = &r->dst;
+            msgs[cnt].msg_hdr.msg_iov = iov + pos;
+            msgs[cnt].msg_hdr.msg_iovlen = segs[cnt];
+#ifdef USE_GSO
+            if (segs[cnt] > 1) {
+                gso_size = (uint16_t) iov[pos].iov_len;
+                msgs[cnt].msg_hdr.msg_control = ctrl + cnt;
+                msgs[cnt].msg_hdr.msg_controllen = CMSG_SPACE(sizeof(gso_size));
+                cm = CMSG_FIRSTHDR(&msgs[cnt].msg_hdr);
+                cm->cmsg_level = SOL_UDP;
+                cm->cmsg_type = UDP_SEGMENT;
+                cm->cmsg_len = CMSG_LEN(sizeof(gso_size));
+                memcpy(CMSG_DATA(cm), &gso_size, sizeof(gso_size));
+            }
+#endif
+        }
+
+        n = sendmmsg(ifc->sock, msgs, cnt, 0);
+        DEBUGMSG(DEBUG, "sendmmsg of %d messages returned %d\n", cnt, n);
+        if (n <= 0) {
+#ifdef USE_GSO
+            if (segs[0] > 1 &&
+                (errno == EINVAL || errno == EIO || errno == EMSGSIZE)) {
+                // e.g. segments beyond the path MTU: go on without offload
+                DEBUGMSG(WARNING, "UDP_SEGMENT send failed (%s), "
+                         "segmentation offload turned off\n", strerror(errno));
+                ifc->gso = 0;
+                continue;
+            }
+#endif
+            // the first message failed, drop it like sendto() would
+            n = 1;
+        }
+#ifdef USE_STATS
+        ifc->tx_batches++;
+#endif
+        for (k = 0; k < n; k++) {
+            for (j = 0; j < segs[k]; j++) {
+                r = ifc->queue + ifc->qfront;
+                ccnl_buf_free(r->buf);
+                r->buf = NULL;
+                ifc->qfront = (ifc->qfront + 1) % CCNL_MAX_IF_QLEN;
+                ifc->qlen--;
+#ifdef USE_STATS
+                ifc->tx_cnt++;
+#endif
+            }
+        }
+    }
+}
+#endif // USE_MMSG
+
 void
 ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
                   int32_t udpport1, int32_t udpport2,
@@ -438,10 +971,14 @@ ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
     relay->pit = NULL;
     relay->fib = NULL;
     relay->faces = NULL;
-    relay->nonces = NULL;
     relay->max_cache_entries = max_cache_entries;
     relay->max_pit_entries = CCNL_DEFAULT_MAX_PIT_ENTRIES;
     relay->ccnl_ll_TX_ptr = &ccnl_ll_TX;
+#ifdef USE_MMSG
+    relay->ccnl_ll_TX_batch_ptr = &ccnl_ll_TX_batch;
+#endif
+    relay->rx_batch = CCNL_DEFAULT_IO_BATCH;
+    relay->tx_batch = CCNL_DEFAULT_IO_BATCH;
 
 #ifdef USE_SCHEDULER
     relay->defaultFaceScheduler = ccnl_relay_defaultFaceScheduler;
@@ -451,7 +988,19 @@ ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
     // add (real) eth0 interface with index 0:
     if (ethdev) {
         i = &relay->ifs[relay->ifcount];
-        i->sock = ccnl_open_ethdev(ethdev, &i->addr.linklayer, CCNL_ETH_TYPE);
+        i->sock = -1;
+#ifdef USE_XDP
+        if (ccnl_eth_xdp) {
+            i->sock = ccnl_open_xdpdev(ethdev, i, ccnl_eth_xdp);
+            if (i->sock < 0) {
+                DEBUGMSG(WARNING, "AF_XDP not available, using AF_PACKET\n");
+            }
+        }
+#endif
+        if (i->sock < 0) {
+            i->sock = ccnl_open_ethdev(ethdev, &i->addr.linklayer,
+                                       CCNL_ETH_TYPE);
+        }
         i->mtu = 1500;
         i->reflect = 1;
         i->fwdalli = 1;
@@ -459,6 +1008,11 @@ ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
             relay->ifcount++;
             DEBUGMSG(INFO, "ETH interface (%s %s) configured\n",
                      ethdev, ccnl_addr2ascii(&i->addr));
+#ifdef USE_TPACKET
+            if (ccnl_eth_tpacket && !i->ring) {
+                ccnl_tpacket_setup(i);
+            }
+#endif
             if (relay->defaultInterfaceScheduler)
                 i->sched = relay->defaultInterfaceScheduler(relay,
                                                         ccnl_interface_CTS);
@@ -559,13 +1113,1111 @@ ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
     ccnl_set_timer(1000000, ccnl_ageing, relay, 0);
 }
 
+// receive buffers, packets are parsed in place and copied by the core
+// only if it keeps them
+#ifdef USE_GSO
+# define CCNL_IO_RXBUF_SIZE     65535 // a UDP_GRO datagram's segments
+#else
+# define CCNL_IO_RXBUF_SIZE     CCNL_MAX_PACKET_SIZE
+#endif
+static CCNL_THREAD_LOCAL uint8_t ccnl_io_rxbufs[CCNL_MAX_IO_BATCH][CCNL_IO_RXBUF_SIZE];
+
+void
+ccnl_io_dispatch(struct ccnl_relay_s *ccnl, int i, uint8_t *buf, size_t len,
+                 sockunion *src_addr)
+{
+    if (ccnl->ccnl_RX_steer_ptr &&
+        ccnl->ccnl_RX_steer_ptr(ccnl, i, buf, len, src_addr)) {
+        return;
+    }
+    if (0) {}
+#ifdef USE_IPV4
+    else if (src_addr->sa.sa_family == AF_INET) {
+        ccnl_core_RX(ccnl, i, buf, len,
+                     &src_addr->sa, sizeof(src_addr->ip4));
+    }
+#endif
+#ifdef USE_IPV6
+    else if (src_addr->sa.sa_family == AF_INET6) {
+        ccnl_core_RX(ccnl, i, buf, len,
+                     &src_addr->sa, sizeof(src_addr->ip6));
+    }
+#endif
+#ifdef USE_LINKLAYER
+    else if (src_addr->sa.sa_family == AF_PACKET) {
+        if (len > 14) {
+            ccnl_core_RX(ccnl, i, buf + 14, len - 14,
+                         &src_addr->sa, sizeof(src_addr->linklayer));
+        }
+    }
+#endif
+#ifdef USE_WPAN
+    else if (src_addr->sa.sa_family == AF_IEEE802154) {
+        if (len > 14) {
+            ccnl_core_RX(ccnl, i, buf, len,
+                         &src_addr->sa, sizeof(src_addr->linklayer));
+        }
+    }
+#endif
+#ifdef USE_UNIXSOCKET
+    else if (src_addr->sa.sa_family == AF_UNIX) {
+        ccnl_core_RX(ccnl, i, buf, len,
+                     &src_addr->sa, sizeof(src_addr->ux));
+    }
+#endif
+}
+
+// packets one ccnl_io_recv() asks for
+static int
+ccnl_io_rx_batch(struct ccnl_relay_s *ccnl)
+{
+#ifdef USE_MMSG
+    if (ccnl->rx_batch < 1) {
+        return 1;
+    }
+    return ccnl->rx_batch < CCNL_MAX_IO_BATCH ? ccnl->rx_batch
+                                              : CCNL_MAX_IO_BATCH;
+#else
+    (void) ccnl;
+    return 1;
+#endif
+}
+
+#ifdef USE_GSO
+// size of the segments a UDP_GRO datagram was coalesced from, 0 if it
+// is a single one
+static size_t
+ccnl_io_gro_size(struct msghdr *mh)
+{
+    struct cmsghdr *cm;
+    int gso_size;
+
+    for (cm = CMSG_FIRSTHDR(mh); cm; cm = CMSG_NXTHDR(mh, cm)) {
+        if (cm->cmsg_level == SOL_UDP && cm->cmsg_type == UDP_GRO) {
+            memcpy(&gso_size, CMSG_DATA(cm), sizeof(gso_size));
+            return gso_size > 0 ? (size_t) gso_size : 0;
+        }
+    }
+    return 0;
+}
+#endif
+
+#ifdef USE_MMSG
+
+// reads up to rx_batch packets from interface i with one recvmmsg() and
+// hands them to the core, returns the number of packets or -1
+int
+ccnl_io_recv(struct ccnl_relay_s *ccnl, int i, int flags)
+{
+    struct mmsghdr msgs[CCNL_MAX_IO_BATCH];
+    struct iovec iov[CCNL_MAX_IO_BATCH];
+    sockunion src_addr[CCNL_MAX_IO_BATCH];
+#ifdef USE_GSO
+    union {
+        size_t align; // as struct cmsghdr
+        char buf[CMSG_SPACE(sizeof(int))];
+    } ctrl[CCNL_MAX_IO_BATCH];
+#endif
+    size_t len, off, seg;
+    int k, n, cnt = ccnl_io_rx_batch(ccnl);
+
+#if defined(USE_TPACKET) || defined(USE_XDP)
+    if (ccnl->ifs[i].ring) {
+        return ((struct ccnl_ll_ring_s *) ccnl->ifs[i].ring)->recv(ccnl, i,
+                                                        ccnl_io_rx_batch(ccnl));
+    }
+#endif
+    memset(msgs, 0, cnt * sizeof(msgs[0]));
+    for (k = 0; k < cnt; k++) {
+        iov[k].iov_base = ccnl_io_rxbufs[k];
+        iov[k].iov_len = sizeof(ccnl_io_rxbufs[k]);
+        msgs[k].msg_hdr.msg_iov = iov + k;
+        msgs[k].msg_hdr.msg_iovlen = 1;
+        msgs[k].msg_hdr.msg_name = src_addr + k;
+        msgs[k].msg_hdr.msg_namelen = sizeof(src_addr[k]);
+#ifdef USE_GSO
+        msgs[k].msg_hdr.msg_control = ctrl + k;
+        msgs[k].msg_hdr.msg_controllen = sizeof(ctrl[k]);
+#endif
+    }
+    // without MSG_WAITFORONE a blocking socket waits for a full batch
+    n = recvmmsg(ccnl->ifs[i].sock, msgs, cnt, flags | MSG_WAITFORONE, NULL);
+    if (n <= 0) {
+        return n < 0 ? -1 : 0;
+    }
+#ifdef USE_STATS
+    ccnl->ifs[i].rx_batches++;
+#endif
+    for (k = 0; k < n; k++) {
+        len = msgs[k].msg_len;
+        seg = 0;
+#ifdef USE_GSO
+        seg = ccnl_io_gro_size(&msgs[k].msg_hdr);
+#endif
+        if (!seg) {
+            seg = len;
+        }
+        // a coalesced datagram is split back into its segments
+        for (off = 0; off < len; off += seg) {
+            ccnl_io_dispatch(ccnl, i, ccnl_io_rxbufs[k] + off,
+                             len - off < seg ? len - off : seg, src_addr + k);
+        }
+    }
+    return n;
+}
+
+#else // USE_MMSG
+
+// reads one packet from interface i and hands it to the core, returns
+// the number of packets or -1
+int
+ccnl_io_recv(struct ccnl_relay_s *ccnl, int i, int flags)
+{
+    sockunion src_addr;
+    socklen_t addrlen = sizeof(sockunion);
+    ssize_t recvlen;
+
+#if defined(USE_TPACKET) || defined(USE_XDP)
+    if (ccnl->ifs[i].ring) {
+        return ((struct ccnl_ll_ring_s *) ccnl->ifs[i].ring)->recv(ccnl, i,
+                                                        ccnl_io_rx_batch(ccnl));
+    }
+#endif
+    recvlen = recvfrom(ccnl->ifs[i].sock, ccnl_io_rxbufs[0],
+                       sizeof(ccnl_io_rxbufs[0]), flags,
+                       (struct sockaddr*) &src_addr, &addrlen);
+    if (recvlen < 0) {
+        return -1;
+    }
+#ifdef USE_STATS
+    ccnl->ifs[i].rx_batches++;
+#endif
+    if (recvlen > 0) {
+        ccnl_io_dispatch(ccnl, i, ccnl_io_rxbufs[0], (size_t) recvlen,
+                         &src_addr);
+    }
+    return 1;
+}
+
+#endif // USE_MMSG
+
+// sends what the interfaces queued during this round of the loop
+static void
+ccnl_io_flush(struct ccnl_relay_s *ccnl)
+{
+#ifndef USE_SCHEDULER
+    int i;
+
+    for (i = 0; i < ccnl->ifcount; i++) {
+        ccnl_interface_flush(ccnl, ccnl->ifs + i);
+    }
+#else
+    (void) ccnl;
+#endif
+}
+
+#ifdef USE_EPOLL
+
+// packets read from one interface before the others get their turn
+#define CCNL_IO_RX_BUDGET       64
+#define CCNL_IO_MAX_EVENTS      32
+
+static CCNL_THREAD_LOCAL int ccnl_io_epfd = -1;
+static CCNL_THREAD_LOCAL struct ccnl_io_watch_s *ccnl_io_deferred;
+// the deferred watches of this round not served yet
+static CCNL_THREAD_LOCAL struct ccnl_io_watch_s *ccnl_io_serving;
+// released while handlers run, freed once they are done, see
+// ccnl_io_release()
+static CCNL_THREAD_LOCAL struct ccnl_io_watch_s *ccnl_io_dead;
+static CCNL_THREAD_LOCAL int ccnl_io_busy;
+static CCNL_THREAD_LOCAL struct ccnl_io_watch_s ccnl_io_ifs[CCNL_MAX_INTERFACES];
+static CCNL_THREAD_LOCAL int ccnl_io_ifcount;
+#ifdef USE_HTTP_STATUS
+static CCNL_THREAD_LOCAL struct ccnl_io_watch_s ccnl_io_http;
+#endif
+
+int
+ccnl_io_watch(struct ccnl_io_watch_s *w, int fd, uint32_t events,
+              void (*ready)(struct ccnl_relay_s*, struct ccnl_io_watch_s*,
+                            uint32_t),
+              void *aux)
+{
+    struct epoll_event ev;
+
+    if (ccnl_io_epfd < 0) {
+        ccnl_io_epfd = epoll_create1(EPOLL_CLOEXEC);
+        if (ccnl_io_epfd < 0) {
+            perror("epoll_create1");
+            return -1;
+        }
+    }
+    memset(w, 0, sizeof(*w));
+    w->fd = fd;
+    w->ready = ready;
+    w->aux = aux;
+
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.ptr = w;
+    if (epoll_ctl(ccnl_io_epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        perror("epoll_ctl add");
+        return -1;
+    }
+    w->events = events;
+    w->active = 1;
+    return 0;
+}
+
+int
+ccnl_io_modify(struct ccnl_io_watch_s *w, uint32_t events)
+{
+    struct epoll_event ev;
+
+    if (!w->active || w->events == events) {
+        return 0;
+    }
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.ptr = w;
+    if (epoll_ctl(ccnl_io_epfd, EPOLL_CTL_MOD, w->fd, &ev) < 0) {
+        perror("epoll_ctl mod");
+        return -1;
+    }
+    w->events = events;
+    return 0;
+}
+
+void
+ccnl_io_unwatch(struct ccnl_io_watch_s *w)
+{
+    struct ccnl_io_watch_s **pp;
+
+    if (!w->active) {
+        return;
+    }
+    // fails if the descriptor was closed already, which removed it
+    epoll_ctl(ccnl_io_epfd, EPOLL_CTL_DEL, w->fd, NULL);
+    if (w->deferred) {
+        for (pp = &ccnl_io_deferred; *pp && *pp != w; pp = &(*pp)->next);
+        if (!*pp) {
+            for (pp = &ccnl_io_serving; *pp && *pp != w; pp = &(*pp)->next);
+        }
+        if (*pp) {
+            *pp = w->next;
+        }
+        w->deferred = 0;
+    }
+    w->active = 0;
+}
+
+void
+ccnl_io_release(struct ccnl_io_watch_s *w, void *mem)
+{
+    ccnl_io_unwatch(w);
+    if (!ccnl_io_busy) {
+        ccnl_free(mem);
+        return;
+    }
+    // ready events of this round may still point to the watch
+    w->aux = mem;
+    w->next = ccnl_io_dead;
+    ccnl_io_dead = w;
+}
+
+void
+ccnl_io_defer(struct ccnl_io_watch_s *w, uint32_t events)
+{
+    if (!w->deferred) {
+        w->next = ccnl_io_deferred;
+        ccnl_io_deferred = w;
+    }
+    w->deferred |= events;
+}
+
+static void
+ccnl_io_if_ready(struct ccnl_relay_s *ccnl, struct ccnl_io_watch_s *w,
+                 uint32_t events)
+{
+    struct ccnl_if_s *ifc = (struct ccnl_if_s *) w->aux;
+    int i = (int) (ifc - ccnl->ifs), n, total = 0;
+
+    if (events & (EPOLLIN | EPOLLERR)) {
+        // edge triggered: read until the socket is empty
+        while (total < CCNL_IO_RX_BUDGET) {
+            n = ccnl_io_recv(ccnl, i, MSG_DONTWAIT);
+            if (n < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    break;
+                }
+                // e.g. a queued ICMP error, datagrams may wait behind it
+                // and no new edge announces them
+                DEBUGMSG(WARNING, "receiving on interface %d: %s\n",
+                         i, strerror(errno));
+                total++;
+                continue;
+            }
+            total += n;
+            if (n < ccnl_io_rx_batch(ccnl)) {
+                // a short batch means the socket ran dry
+                break;
+            }
+        }
+        if (total >= CCNL_IO_RX_BUDGET) {
+            ccnl_io_defer(w, EPOLLIN);
+        }
+    }
+    if (events & EPOLLOUT) {
+        ccnl_interface_flush(ccnl, ifc);
+        // no new edge while the socket stays writable
+        if (ifc->qlen > 0) {
+            ccnl_io_defer(w, EPOLLOUT);
+        }
+    }
+}
+
+#ifdef USE_HTTP_STATUS
+static void
+ccnl_io_http_ready(struct ccnl_relay_s *ccnl, struct ccnl_io_watch_s *w,
+                   uint32_t events)
+{
+    (void) w;
+    ccnl_http_io(ccnl, ccnl->http, (events & (EPOLLIN | EPOLLERR | EPOLLHUP)) != 0,
+                 (events & EPOLLOUT) != 0);
+}
+
+// follows the status server from its listening socket to the client's
+// and back, level triggered as it serves one request at a time
+static void
+ccnl_io_http_sync(struct ccnl_relay_s *ccnl)
+{
+    int fd, rd, wr;
+    uint32_t events;
+
+    if (ccnl_http_interest(ccnl->http, &fd, &rd, &wr)) {
+        return;
+    }
+    events = (rd ? EPOLLIN : 0) | (wr ? EPOLLOUT : 0);
+    if (ccnl_io_http.active && ccnl_io_http.fd == fd) {
+        ccnl_io_modify(&ccnl_io_http, events);
+        return;
+    }
+    ccnl_io_unwatch(&ccnl_io_http);
+    ccnl_io_watch(&ccnl_io_http, fd, events, ccnl_io_http_ready, NULL);
+}
+#endif
+
+// registers new interfaces and asks for write events only while an
+// interface has packets queued
+static void
+ccnl_io_if_sync(struct ccnl_relay_s *ccnl)
+{
+    int i;
+
+    for (i = 0; i < ccnl->ifcount; i++) {
+        uint32_t events = EPOLLIN | EPOLLET;
+
+        if (ccnl->ifs[i].qlen > 0) {
+            events |= EPOLLOUT;
+        }
+        if (i >= ccnl_io_ifcount) {
+            ccnl_io_ifcount = i + 1;
+            if (ccnl->ifs[i].piped) {
+                // served by the threads of ccnl_pipeline_run()
+                continue;
+            }
+            if (ccnl->ifs[i].stream || ccnl->ifs[i].shm) {
+                // its connections have watches of their own
+                continue;
+            }
+            if (ccnl_io_watch(ccnl_io_ifs + i, ccnl->ifs[i].sock, events,
+                              ccnl_io_if_ready, ccnl->ifs + i) < 0) {
+                exit(EXIT_FAILURE);
+            }
+            // an edge may have passed before the registration
+            ccnl_io_defer(ccnl_io_ifs + i, EPOLLIN);
+        } else {
+            ccnl_io_modify(ccnl_io_ifs + i, events);
+        }
+    }
+}
+
+// waits up to timeout msec for the registered descriptors, then serves
+// the deferred watches and the ready ones
+static void
+ccnl_io_epoll_run(struct ccnl_relay_s *ccnl, int timeout)
+{
+    struct epoll_event evs[CCNL_IO_MAX_EVENTS];
+    struct ccnl_io_watch_s *w, *next;
+    int i, rc;
+
+    if (ccnl_io_deferred) {
+        timeout = 0;
+    }
+    rc = epoll_wait(ccnl_io_epfd, evs, CCNL_IO_MAX_EVENTS, timeout);
+    if (rc < 0) {
+        if (errno == EINTR) {
+            return;
+        }
+        perror("epoll_wait(): ");
+        exit(EXIT_FAILURE);
+    }
+
+    ccnl_io_busy++;
+    // handlers may defer again, hence take the list first
+    ccnl_io_serving = ccnl_io_deferred;
+    ccnl_io_deferred = NULL;
+    while ((w = ccnl_io_serving)) {
+        uint32_t events = w->deferred;
+
+        ccnl_io_serving = w->next;
+        w->deferred = 0;
+        w->ready(ccnl, w, events);
+    }
+    for (i = 0; i < rc; i++) {
+        w = (struct ccnl_io_watch_s *) evs[i].data.ptr;
+        if (w->active) {
+            w->ready(ccnl, w, evs[i].events);
+        }
+    }
+    if (--ccnl_io_busy == 0) {
+        for (w = ccnl_io_dead, ccnl_io_dead = NULL; w; w = next) {
+            next = w->next;
+            ccnl_free(w->aux);
+        }
+    }
+}
+
+int
+ccnl_io_loop(struct ccnl_relay_s *ccnl)
+{
+    if (ccnl->ifcount == 0) {
+        DEBUGMSG(ERROR, "no socket to work with, not good, quitting\n");
+        exit(EXIT_FAILURE);
+    }
+
+    DEBUGMSG(INFO, "starting main event and IO loop (epoll)\n");
+    while (!ccnl->halt_flag) {
+        int usec = ccnl_run_events();
+
+        ccnl_io_flush(ccnl);
+#ifdef USE_HTTP_STATUS
+        ccnl_io_http_sync(ccnl);
+#endif
+        ccnl_io_if_sync(ccnl);
+        ccnl_io_epoll_run(ccnl, usec >= 0 ? (usec + 999) / 1000 : -1);
+    }
+
+    return 0;
+}
+
+#ifdef USE_URING
+
+// io_uring backend: interfaces receive with multishot recvmsg into a
+// registered buffer ring, ccnl_interface_CTS() queues sendmsg requests,
+// timers bound the wait for completions and all other descriptors
+// (HTTP status, watches) are served through the epoll instance, which
+// the ring polls as one more descriptor.
+
+#define CCNL_URING_ENTRIES      256     // submission queue
+#define CCNL_URING_CQ_ENTRIES   4096
+#define CCNL_URING_RX_BUFS      128     // power of two
+#define CCNL_URING_TX_SLOTS     256
+#define CCNL_URING_TX_BACKLOG   1024    // sends waiting for a slot
+#define CCNL_URING_BGID         0
+
+// what a completion belongs to, in the upper half of its user_data
+enum {
+    CCNL_URING_RX = 1,
+    CCNL_URING_TX,
+    CCNL_URING_EPOLL,
+};
+
+struct ccnl_uring_tx_s {
+    struct msghdr msg;
+    struct iovec iov;
+    sockunion dst;
+    struct ccnl_buf_s *buf;
+    int next;                           // free list
+};
+
+struct ccnl_uring_backlog_s {
+    struct ccnl_if_s *ifc;
+    sockunion dst;
+    struct ccnl_buf_s *buf;
+};
+
+static CCNL_THREAD_LOCAL struct {
+    int fd;
+    uint8_t *rings;                     // SQ and CQ, one mapping
+    size_t rings_len;
+    unsigned *sq_head, *sq_tail, *sq_mask, *sq_array;
+    unsigned *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    unsigned sq_entries, to_submit;
+
+    struct io_uring_buf_ring *br;       // registered receive buffers
+    uint8_t *bufs;
+    size_t bufsize;
+    unsigned short br_tail;
+
+    struct msghdr rx_msg[CCNL_MAX_INTERFACES]; // name and control sizes
+    char rx_armed[CCNL_MAX_INTERFACES];
+    char epoll_armed;
+
+    struct ccnl_uring_tx_s tx[CCNL_URING_TX_SLOTS];
+    int tx_free;
+
+    // in order, sent before anything newer once slots are released
+    struct ccnl_uring_backlog_s backlog[CCNL_URING_TX_BACKLOG];
+    unsigned bl_head, bl_len;
+} ccnl_uring = { .fd = -1 };
+
+static int
+ccnl_uring_enter(unsigned to_submit, unsigned min_complete, unsigned flags,
+                 void *arg, size_t argsz)
+{
+    return (int) syscall(__NR_io_uring_enter, ccnl_uring.fd, to_submit,
+                         min_complete, flags, arg, argsz);
+}
+
+static void
+ccnl_uring_recycle(unsigned short bid)
+{
+    struct io_uring_buf *b;
+
+    b = &ccnl_uring.br->bufs[ccnl_uring.br_tail & (CCNL_URING_RX_BUFS - 1)];
+    b->addr = (uint64_t) (uintptr_t) (ccnl_uring.bufs +
+                                      (size_t) bid * ccnl_uring.bufsize);
+    b->len = (uint32_t) ccnl_uring.bufsize;
+    b->bid = bid;
+    ccnl_uring.br_tail++;
+    __atomic_store_n(&ccnl_uring.br->tail, ccnl_uring.br_tail,
+                     __ATOMIC_RELEASE);
+}
+
+// closes the ring, which cancels what is still in flight, and drops
+// the buffers the pending sends hold
+static void
+ccnl_uring_cleanup(void)
+{
+    int i;
+
+    if (ccnl_uring.fd < 0) {
+        return;
+    }
+    close(ccnl_uring.fd);
+    ccnl_uring.fd = -1;
+    for (i = 0; i < CCNL_URING_TX_SLOTS; i++) {
+        if (ccnl_uring.tx[i].buf) {
+            ccnl_buf_free(ccnl_uring.tx[i].buf);
+            ccnl_uring.tx[i].buf = NULL;
+        }
+    }
+    for (; ccnl_uring.bl_len; ccnl_uring.bl_len--) {
+        ccnl_buf_free(ccnl_uring.backlog[ccnl_uring.bl_head].buf);
+        ccnl_uring.bl_head = (ccnl_uring.bl_head + 1) % CCNL_URING_TX_BACKLOG;
+    }
+    if (ccnl_uring.bufs) {
+        munmap(ccnl_uring.bufs, CCNL_URING_RX_BUFS * ccnl_uring.bufsize);
+        ccnl_uring.bufs = NULL;
+    }
+    if (ccnl_uring.br) {
+        munmap(ccnl_uring.br, CCNL_URING_RX_BUFS * sizeof(struct io_uring_buf));
+        ccnl_uring.br = NULL;
+    }
+    if (ccnl_uring.sqes) {
+        munmap(ccnl_uring.sqes,
+               ccnl_uring.sq_entries * sizeof(struct io_uring_sqe));
+        ccnl_uring.sqes = NULL;
+    }
+    if (ccnl_uring.rings) {
+        munmap(ccnl_uring.rings, ccnl_uring.rings_len);
+        ccnl_uring.rings = NULL;
+    }
+    memset(ccnl_uring.rx_armed, 0, sizeof(ccnl_uring.rx_armed));
+    ccnl_uring.epoll_armed = 0;
+    ccnl_uring.to_submit = 0;
+}
+
+static int
+ccnl_uring_init(void)
+{
+    struct io_uring_params p;
+    struct io_uring_buf_reg reg;
+    uint8_t *sq, *cq;
+    size_t sqlen, cqlen;
+    int i;
+
+    memset(&p, 0, sizeof(p));
+    p.flags = IORING_SETUP_CQSIZE;
+    p.cq_entries = CCNL_URING_CQ_ENTRIES;
+    ccnl_uring.fd = (int) syscall(__NR_io_uring_setup, CCNL_URING_ENTRIES, &p);
+    if (ccnl_uring.fd < 0) {
+        perror("io_uring_setup");
+        return -1;
+    }
+    if (!(p.features & IORING_FEAT_SINGLE_MMAP) ||
+        !(p.features & IORING_FEAT_EXT_ARG)) {
+        DEBUGMSG(WARNING, "io_uring: kernel too old\n");
+        goto fail;
+    }
+
+    sqlen = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    cqlen = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (cqlen > sqlen) {
+        sqlen = cqlen;
+    }
+    sq = mmap(NULL, sqlen, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+              ccnl_uring.fd, IORING_OFF_SQ_RING);
+    if (sq == MAP_FAILED) {
+        perror("io_uring mmap");
+        goto fail;
+    }
+    ccnl_uring.rings = sq;
+    ccnl_uring.rings_len = sqlen;
+    cq = sq;
+    ccnl_uring.sq_head = (unsigned *) (sq + p.sq_off.head);
+    ccnl_uring.sq_tail = (unsigned *) (sq + p.sq_off.tail);
+    ccnl_uring.sq_mask = (unsigned *) (sq + p.sq_off.ring_mask);
+    ccnl_uring.sq_array = (unsigned *) (sq + p.sq_off.array);
+    ccnl_uring.cq_head = (unsigned *) (cq + p.cq_off.head);
+    ccnl_uring.cq_tail = (unsigned *) (cq + p.cq_off.tail);
+    ccnl_uring.cq_mask = (unsigned *) (cq + p.cq_off.ring_mask);
+    ccnl_uring.cqes = (struct io_uring_cqe *) (cq + p.cq_off.cqes);
+    ccnl_uring.sq_entries = p.sq_entries;
+    ccnl_uring.sqes = mmap(NULL, p.sq_entries * sizeof(struct io_uring_sqe),
+                           PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                           ccnl_uring.fd, IORING_OFF_SQES);
+    if (ccnl_uring.sqes == MAP_FAILED) {
+        ccnl_uring.sqes = NULL;
+        perror("io_uring mmap sqes");
+        goto fail;
+    }
+
+    // receive buffers: completion header, source address, control
+    // messages (UDP_GRO) and the datagram
+    ccnl_uring.bufsize = sizeof(struct io_uring_recvmsg_out) +
+                         sizeof(sockunion) + CMSG_SPACE(sizeof(int)) +
+                         CCNL_IO_RXBUF_SIZE;
+    ccnl_uring.br = mmap(NULL, CCNL_URING_RX_BUFS * sizeof(struct io_uring_buf),
+                         PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                         -1, 0);
+    ccnl_uring.bufs = mmap(NULL, CCNL_URING_RX_BUFS * ccnl_uring.bufsize,
+                           PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                           -1, 0);
+    if (ccnl_uring.br == MAP_FAILED) {
+        ccnl_uring.br = NULL;
+    }
+    if (ccnl_uring.bufs == MAP_FAILED) {
+        ccnl_uring.bufs = NULL;
+    }
+    if (!ccnl_uring.br || !ccnl_uring.bufs) {
+        perror("io_uring buffers");
+        goto fail;
+    }
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uint64_t) (uintptr_t) ccnl_uring.br;
+    reg.ring_entries = CCNL_URING_RX_BUFS;
+    reg.bgid = CCNL_URING_BGID;
+    if (syscall(__NR_io_uring_register, ccnl_uring.fd,
+                IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        perror("io_uring register buffers");
+        goto fail;
+    }
+    for (i = 0; i < CCNL_URING_RX_BUFS; i++) {
+        ccnl_uring_recycle((unsigned short) i);
+    }
+
+    for (i = 0; i < CCNL_URING_TX_SLOTS; i++) {
+        ccnl_uring.tx[i].next = i + 1 < CCNL_URING_TX_SLOTS ? i + 1 : -1;
+    }
+    ccnl_uring.tx_free = 0;
+    ccnl_uring.bl_head = ccnl_uring.bl_len = 0;
+    return 0;
+
+fail:
+    ccnl_uring_cleanup();
+    return -1;
+}
+
+// next free submission queue entry, submits the queue if it is full
+static struct io_uring_sqe*
+ccnl_uring_sqe(void)
+{
+    unsigned tail = *ccnl_uring.sq_tail, idx;
+    struct io_uring_sqe *sqe;
+
+    int rc;
+
+    if (tail - __atomic_load_n(ccnl_uring.sq_head, __ATOMIC_ACQUIRE) >=
+        ccnl_uring.sq_entries) {
+        rc = ccnl_uring_enter(ccnl_uring.to_submit, 0, 0, NULL, 0);
+        // the kernel may take fewer, the rest goes with the next enter
+        if (rc > 0) {
+            ccnl_uring.to_submit -= (unsigned) rc < ccnl_uring.to_submit
+                                    ? (unsigned) rc : ccnl_uring.to_submit;
+        }
+        if (tail - __atomic_load_n(ccnl_uring.sq_head, __ATOMIC_ACQUIRE) >=
+            ccnl_uring.sq_entries) {
+            return NULL;
+        }
+    }
+    idx = tail & *ccnl_uring.sq_mask;
+    sqe = ccnl_uring.sqes + idx;
+    memset(sqe, 0, sizeof(*sqe));
+    ccnl_uring.sq_array[idx] = idx;
+    __atomic_store_n(ccnl_uring.sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ccnl_uring.to_submit++;
+    return sqe;
+}
+
+static void
+ccnl_uring_arm_rx(struct ccnl_relay_s *ccnl, int i)
+{
+    struct io_uring_sqe *sqe = ccnl_uring_sqe();
+    struct msghdr *msg = ccnl_uring.rx_msg + i;
+
+    if (!sqe) {
+        return;
+    }
+    // only the sizes of the name and control areas matter
+    memset(msg, 0, sizeof(*msg));
+    msg->msg_namelen = sizeof(sockunion);
+#ifdef USE_GSO
+    msg->msg_controllen = CMSG_SPACE(sizeof(int));
+#endif
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->fd = ccnl->ifs[i].sock;
+    sqe->addr = (uint64_t) (uintptr_t) msg;
+    sqe->len = 1;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = CCNL_URING_BGID;
+    sqe->user_data = ((uint64_t) CCNL_URING_RX << 32) | (uint32_t) i;
+    ccnl_uring.rx_armed[i] = 1;
+}
+
+static void
+ccnl_uring_rx_done(struct ccnl_relay_s *ccnl, int i, struct io_uring_cqe *cqe)
+{
+    struct io_uring_recvmsg_out *out;
+    struct msghdr *msg = ccnl_uring.rx_msg + i;
+    struct msghdr ctl;
+    unsigned short bid;
+    uint8_t *buf, *data;
+    size_t len, off, seg = 0;
+
+    if (!(cqe->flags & IORING_CQE_F_MORE)) {
+        // e.g. out of buffers, rearmed in the next round
+        ccnl_uring.rx_armed[i] = 0;
+    }
+    if (!(cqe->flags & IORING_CQE_F_BUFFER)) {
+        return;
+    }
+    bid = (unsigned short) (cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+    buf = ccnl_uring.bufs + (size_t) bid * ccnl_uring.bufsize;
+    if (cqe->res > 0 && i < ccnl->ifcount) {
+        out = (struct io_uring_recvmsg_out *) buf;
+        data = buf + sizeof(*out) + msg->msg_namelen + msg->msg_controllen;
+        len = out->payloadlen;
+        if (!(out->flags & MSG_TRUNC)) {
+#ifdef USE_STATS
+            ccnl->ifs[i].rx_batches++;
+#endif
+#ifdef USE_GSO
+            memset(&ctl, 0, sizeof(ctl));
+            ctl.msg_control = buf + sizeof(*out) + msg->msg_namelen;
+            ctl.msg_controllen = out->controllen;
+            seg = ccnl_io_gro_size(&ctl);
+#else
+            (void) ctl;
+#endif
+            if (!seg) {
+                seg = len;
+            }
+            for (off = 0; off < len; off += seg) {
+                ccnl_io_dispatch(ccnl, i, data + off,
+                                 len - off < seg ? len - off : seg,
+                                 (sockunion *) (buf + sizeof(*out)));
+            }
+        }
+    }
+    // packets are parsed in place and copied by the core if kept
+    ccnl_uring_recycle(bid);
+}
+
+// queues a sendmsg request which holds a reference to the buffer until
+// it completes, returns -1 if no slot or submission entry is free
+static int
+ccnl_uring_send(struct ccnl_if_s *ifc, sockunion *dest, struct ccnl_buf_s *buf)
+{
+    struct ccnl_uring_tx_s *tx;
+    struct io_uring_sqe *sqe;
+    socklen_t addrlen = ccnl_ll_addrlen(dest);
+    int slot = ccnl_uring.tx_free;
+
+    if (slot < 0 || !(sqe = ccnl_uring_sqe())) {
+        return -1;
+    }
+    tx = ccnl_uring.tx + slot;
+    ccnl_uring.tx_free = tx->next;
+
+    memcpy(&tx->dst, dest, addrlen);
+    tx->buf = ccnl_buf_ref(buf);
+    tx->iov.iov_base = buf->data;
+    tx->iov.iov_len = buf->datalen;
+    memset(&tx->msg, 0, sizeof(tx->msg));
+    tx->msg.msg_name = &tx->dst;
+    tx->msg.msg_namelen = addrlen;
+    tx->msg.msg_iov = &tx->iov;
+    tx->msg.msg_iovlen = 1;
+
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = ifc->sock;
+    sqe->addr = (uint64_t) (uintptr_t) &tx->msg;
+    sqe->len = 1;
+    sqe->user_data = ((uint64_t) CCNL_URING_TX << 32) | (uint32_t) slot;
+    return 0;
+}
+
+// sends the backlog in order as far as slots allow
+static void
+ccnl_uring_pump(void)
+{
+    struct ccnl_uring_backlog_s *b;
+
+    while (ccnl_uring.bl_len) {
+        b = ccnl_uring.backlog + ccnl_uring.bl_head;
+        if (ccnl_uring_send(b->ifc, &b->dst, b->buf) < 0) {
+            return;
+        }
+        ccnl_buf_free(b->buf);
+        b->buf = NULL;
+        ccnl_uring.bl_head = (ccnl_uring.bl_head + 1) % CCNL_URING_TX_BACKLOG;
+        ccnl_uring.bl_len--;
+    }
+}
+
+// ccnl_ll_TX_ptr of the io_uring backend
+static void
+ccnl_uring_TX(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
+              sockunion *dest, struct ccnl_buf_s *buf)
+{
+    struct ccnl_uring_backlog_s *b;
+
+    if (!ccnl_ll_addrlen(dest) || ifc->stream || ifc->shm) {
+        // link layer frames, stream or shm faces
+        ccnl_ll_TX(ccnl, ifc, dest, buf);
+        return;
+    }
+    // nothing may overtake the backlog
+    if (!ccnl_uring.bl_len && !ccnl_uring_send(ifc, dest, buf)) {
+        return;
+    }
+    if (ccnl_uring.bl_len >= CCNL_URING_TX_BACKLOG) {
+        DEBUGMSG(WARNING, "io_uring: send backlog full, dropping buf=%p\n",
+                 (void *) buf);
+        return;
+    }
+    b = ccnl_uring.backlog + (ccnl_uring.bl_head + ccnl_uring.bl_len) %
+                             CCNL_URING_TX_BACKLOG;
+    b->ifc = ifc;
+    memcpy(&b->dst, dest, sizeof(sockunion));
+    b->buf = ccnl_buf_ref(buf);
+    ccnl_uring.bl_len++;
+}
+
+static void
+ccnl_uring_tx_done(int slot, struct io_uring_cqe *cqe)
+{
+    struct ccnl_uring_tx_s *tx = ccnl_uring.tx + slot;
+
+    if (cqe->res < 0) {
+        DEBUGMSG(DEBUG, "io_uring sendmsg failed: %s\n", strerror(-cqe->res));
+    }
+    ccnl_buf_free(tx->buf);
+    tx->buf = NULL;
+    tx->next = ccnl_uring.tx_free;
+    ccnl_uring.tx_free = slot;
+}
+
+// waits a little for the sends in flight so that their buffers are not
+// dropped under the kernel's feet, then tears the ring down
+static void
+ccnl_uring_finish(void)
+{
+    struct io_uring_getevents_arg arg;
+    struct __kernel_timespec ts;
+    struct io_uring_cqe *cqe;
+    unsigned head, tail;
+    int i, busy, round;
+
+    for (round = 0; round < 100; round++) {
+        for (i = busy = 0; i < CCNL_URING_TX_SLOTS; i++) {
+            busy |= ccnl_uring.tx[i].buf != NULL;
+        }
+        if (!busy) {
+            break;
+        }
+        memset(&arg, 0, sizeof(arg));
+        ts.tv_sec = 0;
+        ts.tv_nsec = 10000000L;
+        arg.ts = (uint64_t) (uintptr_t) &ts;
+        if (ccnl_uring_enter(ccnl_uring.to_submit, 1,
+                             IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+                             &arg, sizeof(arg)) >= 0) {
+            ccnl_uring.to_submit = 0;
+        }
+        head = *ccnl_uring.cq_head;
+        tail = __atomic_load_n(ccnl_uring.cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++) {
+            cqe = ccnl_uring.cqes + (head & *ccnl_uring.cq_mask);
+            if ((int) (cqe->user_data >> 32) == CCNL_URING_TX) {
+                ccnl_uring_tx_done((int) (uint32_t) cqe->user_data, cqe);
+            }
+            __atomic_store_n(ccnl_uring.cq_head, head + 1, __ATOMIC_RELEASE);
+        }
+    }
+    ccnl_uring_cleanup();
+}
+
+static void
+ccnl_uring_arm_epoll(void)
+{
+    struct io_uring_sqe *sqe = ccnl_uring_sqe();
+
+    if (!sqe) {
+        return;
+    }
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = ccnl_io_epfd;
+    sqe->poll32_events = POLLIN;
+    sqe->user_data = (uint64_t) CCNL_URING_EPOLL << 32;
+    ccnl_uring.epoll_armed = 1;
+}
+
+int
+ccnl_uring_loop(struct ccnl_relay_s *ccnl)
+{
+    struct io_uring_getevents_arg arg;
+    struct __kernel_timespec ts;
+    struct io_uring_cqe *cqe;
+    unsigned head, tail;
+    int i, rc;
+    void (*tx_ptr)(struct ccnl_relay_s *, struct ccnl_if_s *,
+                   sockunion *, struct ccnl_buf_s *);
+    void (*tx_batch_ptr)(struct ccnl_relay_s *, struct ccnl_if_s *);
+
+    if (ccnl->ifcount == 0) {
+        DEBUGMSG(ERROR, "no socket to work with, not good, quitting\n");
+        exit(EXIT_FAILURE);
+    }
+    if (ccnl_uring_init() < 0) {
+        DEBUGMSG(WARNING, "io_uring not available, using epoll\n");
+        return ccnl_io_loop(ccnl);
+    }
+    tx_ptr = ccnl->ccnl_ll_TX_ptr;
+    tx_batch_ptr = ccnl->ccnl_ll_TX_batch_ptr;
+    ccnl->ccnl_ll_TX_ptr = &ccnl_uring_TX;
+    ccnl->ccnl_ll_TX_batch_ptr = NULL;
+
+    DEBUGMSG(INFO, "starting main event and IO loop (io_uring)\n");
+    while (!ccnl->halt_flag) {
+        int usec = ccnl_run_events();
+
+        ccnl_io_flush(ccnl);
+#ifdef USE_HTTP_STATUS
+        ccnl_io_http_sync(ccnl);
+#endif
+        for (i = 0; i < ccnl->ifcount; i++) {
+            if (ccnl_uring.rx_armed[i]) {
+                continue;
+            }
+            if (ccnl->ifs[i].stream || ccnl->ifs[i].shm) {
+                // its connections have watches of their own
+                ccnl_uring.rx_armed[i] = 1;
+                continue;
+            }
+#if defined(USE_TPACKET) || defined(USE_XDP)
+            if (ccnl->ifs[i].ring) {
+                // frames are taken from the mapped ring, not with recvmsg
+                if (ccnl_io_watch(ccnl_io_ifs + i, ccnl->ifs[i].sock,
+                                  EPOLLIN | EPOLLET, ccnl_io_if_ready,
+                                  ccnl->ifs + i) < 0) {
+                    exit(EXIT_FAILURE);
+                }
+                ccnl_io_defer(ccnl_io_ifs + i, EPOLLIN);
+                ccnl_uring.rx_armed[i] = 1;
+                continue;
+            }
+#endif
+            ccnl_uring_arm_rx(ccnl, i);
+        }
+        if (ccnl_io_epfd >= 0 && !ccnl_uring.epoll_armed) {
+            ccnl_uring_arm_epoll();
+        }
+        ccnl_uring_pump();
+
+        memset(&arg, 0, sizeof(arg));
+        if (ccnl_io_deferred) {
+            usec = 0;
+        }
+        if (usec >= 0) {
+            ts.tv_sec = usec / 1000000;
+            ts.tv_nsec = (usec % 1000000) * 1000L;
+            arg.ts = (uint64_t) (uintptr_t) &ts;
+        }
+        rc = ccnl_uring_enter(ccnl_uring.to_submit, 1,
+                              IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+                              &arg, sizeof(arg));
+        if (rc < 0 && errno != ETIME && errno != EINTR) {
+            perror("io_uring_enter(): ");
+            exit(EXIT_FAILURE);
+        }
+        if (rc >= 0) {
+            ccnl_uring.to_submit -= (unsigned) rc < ccnl_uring.to_submit
+                                    ? (unsigned) rc : ccnl_uring.to_submit;
+        }
+
+        head = *ccnl_uring.cq_head;
+        tail = __atomic_load_n(ccnl_uring.cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++) {
+            cqe = ccnl_uring.cqes + (head & *ccnl_uring.cq_mask);
+            switch ((int) (cqe->user_data >> 32)) {
+            case CCNL_URING_RX:
+                ccnl_uring_rx_done(ccnl, (int) (uint32_t) cqe->user_data, cqe);
+                break;
+            case CCNL_URING_TX:
+                ccnl_uring_tx_done((int) (uint32_t) cqe->user_data, cqe);
+                ccnl_uring_pump();
+                break;
+            case CCNL_URING_EPOLL:
+                ccnl_uring.epoll_armed = 0;
+                break;
+            }
+            __atomic_store_n(ccnl_uring.cq_head, head + 1, __ATOMIC_RELEASE);
+        }
+        if (ccnl_io_epfd >= 0 && (!ccnl_uring.epoll_armed || ccnl_io_deferred)) {
+            ccnl_io_epoll_run(ccnl, 0);
+        }
+    }
+
+    ccnl_uring_finish();
+    ccnl->ccnl_ll_TX_ptr = tx_ptr;
+    ccnl->ccnl_ll_TX_batch_ptr = tx_batch_ptr;
+    return 0;
+}
+
+#endif // USE_URING
+
+#else // USE_EPOLL
+
 int
 ccnl_io_loop(struct ccnl_relay_s *ccnl)
 {
     int i, maxfd = -1, rc;
-    size_t len;
     fd_set readfs, writefs;
-    unsigned char buf[CCNL_MAX_PACKET_SIZE];
 
     if (ccnl->ifcount == 0) {
         DEBUGMSG(ERROR, "no socket to work with, not good, quitting\n");
@@ -580,8 +2232,9 @@ ccnl_io_loop(struct ccnl_relay_s *ccnl)
 
     DEBUGMSG(INFO, "starting main event and IO loop\n");
     while (!ccnl->halt_flag) {
-        int usec;
+        int usec = ccnl_run_events();
 
+        ccnl_io_flush(ccnl);
         FD_ZERO(&readfs);
         FD_ZERO(&writefs);
 
@@ -595,7 +2248,6 @@ ccnl_io_loop(struct ccnl_relay_s *ccnl)
             }
         }
 
-        usec = ccnl_run_events();
         if (usec >= 0) {
             struct timeval deadline;
             deadline.tv_sec = usec / 1000000;
@@ -615,52 +2267,11 @@ ccnl_io_loop(struct ccnl_relay_s *ccnl)
 #endif
         for (i = 0; i < ccnl->ifcount; i++) {
             if (FD_ISSET(ccnl->ifs[i].sock, &readfs)) {
-                sockunion src_addr;
-                socklen_t addrlen = sizeof(sockunion);
-                ssize_t recvlen;
-                if ((recvlen = recvfrom(ccnl->ifs[i].sock, buf, sizeof(buf), 0,
-                                (struct sockaddr*) &src_addr, &addrlen)) > 0) {
-                    len = (size_t) recvlen;
-                    if (0) {}
-#ifdef USE_IPV4
-                    else if (src_addr.sa.sa_family == AF_INET) {
-                        ccnl_core_RX(ccnl, i, buf, len,
-                                     &src_addr.sa, sizeof(src_addr.ip4));
-                    }
-#endif
-#ifdef USE_IPV6
-                    else if (src_addr.sa.sa_family == AF_INET6) {
-                        ccnl_core_RX(ccnl, i, buf, len,
-                                     &src_addr.sa, sizeof(src_addr.ip6));
-                    }
-#endif
-#ifdef USE_LINKLAYER
-                    else if (src_addr.sa.sa_family == AF_PACKET) {
-                        if (len > 14) {
-                            ccnl_core_RX(ccnl, i, buf + 14, len - 14,
-                                         &src_addr.sa, sizeof(src_addr.linklayer));
-                        }
-                    }
-#endif
-#ifdef USE_WPAN
-                    else if (src_addr.sa.sa_family == AF_IEEE802154) {
-                        if (len > 14) {
-                            ccnl_core_RX(ccnl, i, buf, len,
-                                         &src_addr.sa, sizeof(src_addr.linklayer));
-                        }
-                    }
-#endif
-#ifdef USE_UNIXSOCKET
-                    else if (src_addr.sa.sa_family == AF_UNIX) {
-                        ccnl_core_RX(ccnl, i, buf, len,
-                                     &src_addr.sa, sizeof(src_addr.ux));
-                    }
-#endif
-                }
+                ccnl_io_recv(ccnl, i, 0);
             }
 
             if (FD_ISSET(ccnl->ifs[i].sock, &writefs)) {
-              ccnl_interface_CTS(ccnl, ccnl->ifs + i);
+                ccnl_interface_flush(ccnl, ccnl->ifs + i);
             }
         }
     }
@@ -668,6 +2279,8 @@ ccnl_io_loop(struct ccnl_relay_s *ccnl)
     return 0;
 }
 
+#endif // USE_EPOLL
+
 void
 ccnl_populate_cache(struct ccnl_relay_s *ccnl, char *path)
 {
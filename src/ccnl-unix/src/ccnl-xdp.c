@@ -0,0 +1,510 @@
+/*
+ * @f ccnl-xdp.c
+ * @b CCN lite, AF_XDP sockets for Ethernet interfaces
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-17 created
+ */
+
+#if defined(USE_XDP) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // syscall(), MAP_POPULATE
+#endif
+
+#include "ccnl-unix.h"
+#include "ccnl-xdp.h"
+
+#include "ccnl-os-includes.h"
+
+#include "ccnl-core.h"
+
+#ifdef USE_XDP
+
+// The UMEM is one anonymous mapping of CCNL_XDP_FRAMES frames. The first
+// half receives: the frames sit in the fill ring until the kernel puts a
+// packet into one and passes it through the RX ring, the core parses it
+// in place and the frame goes back into the fill ring. The second half
+// transmits: free frames are kept on a stack, filled and passed through
+// the TX ring, and come back through the completion ring once sent. All
+// rings have one producer and one consumer, the relay's thread and the
+// kernel.
+
+#ifndef AF_XDP
+#define AF_XDP                  44
+#endif
+#ifndef SOL_XDP
+#define SOL_XDP                 283
+#endif
+
+#define CCNL_XDP_RING_SIZE      (CCNL_XDP_FRAMES / 2)   // per ring
+#define CCNL_XDP_QUEUE          0
+// sendto() calls to empty the TX ring, copy mode sends a batch per call
+#define CCNL_XDP_TX_TRIES       16
+
+int ccnl_eth_xdp;
+
+// producer/consumer ring shared with the kernel
+struct ccnl_xdp_ring_s {
+    uint32_t *producer;
+    uint32_t *consumer;
+    uint32_t *flags;
+    void *desc;                         // struct xdp_desc or UMEM addresses
+    uint32_t prod;                      // our end, published in batches
+    void *map;
+    size_t maplen;
+};
+
+struct ccnl_xdp_s {
+    struct ccnl_ll_ring_s ops;          // first, ccnl_if_s.ring points here
+    uint8_t *umem;
+    struct ccnl_xdp_ring_s rx, tx, fill, comp;
+    uint64_t tx_free[CCNL_XDP_RING_SIZE];
+    unsigned int tx_nfree;
+    int need_wakeup;                    // kick only when the kernel asks
+    int map_fd, prog_fd, link_fd;
+    int ifindex;
+};
+
+static int
+ccnl_xdp_bpf(int cmd, union bpf_attr *attr)
+{
+    return (int) syscall(__NR_bpf, cmd, attr, sizeof(*attr));
+}
+
+// redirects frames of CCNL_ETH_TYPE into the socket of the queue they
+// arrived on and passes the others (and those of queues without a socket)
+// to the network stack:
+//
+//      r2 = ctx->data; r3 = ctx->data_end
+//      if (r2 + 14 > r3) goto pass
+//      if (*(u16 *) (r2 + 12) != htons(CCNL_ETH_TYPE)) goto pass
+//      return bpf_redirect_map(xsks, ctx->rx_queue_index, XDP_PASS)
+//  pass:
+//      return XDP_PASS
+static int
+ccnl_xdp_load(int map_fd)
+{
+#define INSN(c, d, s, o, i) { (uint8_t) (c), (d), (s), (int16_t) (o), (int32_t) (i) }
+    struct bpf_insn prog[] = {
+        INSN(BPF_LDX | BPF_MEM | BPF_W, 2, 1, offsetof(struct xdp_md, data), 0),
+        INSN(BPF_LDX | BPF_MEM | BPF_W, 3, 1, offsetof(struct xdp_md, data_end), 0),
+        INSN(BPF_ALU64 | BPF_MOV | BPF_X, 4, 2, 0, 0),
+        INSN(BPF_ALU64 | BPF_ADD | BPF_K, 4, 0, 0, 14),
+        INSN(BPF_JMP | BPF_JGT | BPF_X, 4, 3, 8, 0),
+        INSN(BPF_LDX | BPF_MEM | BPF_H, 4, 2, 12, 0),
+        INSN(BPF_JMP | BPF_JNE | BPF_K, 4, 0, 6, htons(CCNL_ETH_TYPE)),
+        INSN(BPF_LDX | BPF_MEM | BPF_W, 2, 1,
+             offsetof(struct xdp_md, rx_queue_index), 0),
+        INSN(BPF_LD | BPF_DW | BPF_IMM, 1, BPF_PSEUDO_MAP_FD, 0, map_fd),
+        INSN(0, 0, 0, 0, 0),
+        INSN(BPF_ALU64 | BPF_MOV | BPF_K, 3, 0, 0, XDP_PASS),
+        INSN(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_redirect_map),
+        INSN(BPF_JMP | BPF_EXIT, 0, 0, 0, 0),
+        INSN(BPF_ALU64 | BPF_MOV | BPF_K, 0, 0, 0, XDP_PASS),
+        INSN(BPF_JMP | BPF_EXIT, 0, 0, 0, 0),
+    };
+#undef INSN
+    union bpf_attr attr;
+    char log[1024];
+    int fd;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.prog_type = BPF_PROG_TYPE_XDP;
+    attr.expected_attach_type = BPF_XDP;
+    attr.insns = (uint64_t) (uintptr_t) prog;
+    attr.insn_cnt = sizeof(prog) / sizeof(prog[0]);
+    attr.license = (uint64_t) (uintptr_t) "Dual BSD/GPL";
+    attr.log_buf = (uint64_t) (uintptr_t) log;
+    attr.log_size = sizeof(log);
+    attr.log_level = 1;
+    log[0] = '\0';
+    fd = ccnl_xdp_bpf(BPF_PROG_LOAD, &attr);
+    if (fd < 0) {
+        DEBUGMSG(WARNING, "xdp: could not load the program (%s)\n%s",
+                 strerror(errno), log);
+    }
+    return fd;
+}
+
+// attaches the program in *mode, or generic if the driver lacks XDP
+static int
+ccnl_xdp_attach(int prog_fd, int ifindex, int *mode)
+{
+    union bpf_attr attr;
+    int fd;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.link_create.prog_fd = (uint32_t) prog_fd;
+    attr.link_create.target_ifindex = (uint32_t) ifindex;
+    attr.link_create.attach_type = BPF_XDP;
+    if (*mode == CCNL_XDP_NATIVE) {
+        attr.link_create.flags = XDP_FLAGS_DRV_MODE;
+        fd = ccnl_xdp_bpf(BPF_LINK_CREATE, &attr);
+        if (fd >= 0) {
+            return fd;
+        }
+        DEBUGMSG(INFO, "xdp: no native XDP (%s), running generic\n",
+                 strerror(errno));
+        *mode = CCNL_XDP_GENERIC;
+    }
+    attr.link_create.flags = XDP_FLAGS_SKB_MODE;
+    fd = ccnl_xdp_bpf(BPF_LINK_CREATE, &attr);
+    if (fd < 0) {
+        DEBUGMSG(WARNING, "xdp: could not attach the program (%s)\n",
+                 strerror(errno));
+    }
+    return fd;
+}
+
+static int
+ccnl_xdp_map_ring(int sock, struct ccnl_xdp_ring_s *r,
+                  struct xdp_ring_offset *off, size_t descsize, off_t pgoff)
+{
+    r->maplen = off->desc + CCNL_XDP_RING_SIZE * descsize;
+    r->map = mmap(NULL, r->maplen, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, sock, pgoff);
+    if (r->map == MAP_FAILED) {
+        r->map = NULL;
+        perror("xdp ring mmap");
+        return -1;
+    }
+    r->producer = (uint32_t *) ((uint8_t *) r->map + off->producer);
+    r->consumer = (uint32_t *) ((uint8_t *) r->map + off->consumer);
+    r->flags = (uint32_t *) ((uint8_t *) r->map + off->flags);
+    r->desc = (uint8_t *) r->map + off->desc;
+    r->prod = *r->producer;
+    return 0;
+}
+
+static void
+ccnl_xdp_free(struct ccnl_xdp_s *x)
+{
+    struct ccnl_xdp_ring_s *rings[] = { &x->rx, &x->tx, &x->fill, &x->comp };
+    unsigned int k;
+
+    // closing the link detaches the program
+    if (x->link_fd >= 0) {
+        close(x->link_fd);
+    }
+    if (x->prog_fd >= 0) {
+        close(x->prog_fd);
+    }
+    if (x->map_fd >= 0) {
+        close(x->map_fd);
+    }
+    for (k = 0; k < sizeof(rings) / sizeof(rings[0]); k++) {
+        if (rings[k]->map) {
+            munmap(rings[k]->map, rings[k]->maplen);
+        }
+    }
+    if (x->umem) {
+        munmap(x->umem, (size_t) CCNL_XDP_FRAMES * CCNL_XDP_FRAME_SIZE);
+    }
+    ccnl_free(x);
+}
+
+static void
+ccnl_xdp_release(struct ccnl_if_s *i)
+{
+    ccnl_xdp_free((struct ccnl_xdp_s *) i->ring);
+    i->ring = NULL;
+    i->ring_release = NULL;
+}
+
+// takes the sent frames back from the completion ring
+static void
+ccnl_xdp_complete(struct ccnl_xdp_s *x)
+{
+    uint64_t *addrs = (uint64_t *) x->comp.desc;
+    uint32_t cons = *x->comp.consumer;
+    uint32_t prod = __atomic_load_n(x->comp.producer, __ATOMIC_ACQUIRE);
+
+    for (; cons != prod; cons++) {
+        x->tx_free[x->tx_nfree++] = addrs[cons & (CCNL_XDP_RING_SIZE - 1)];
+    }
+    __atomic_store_n(x->comp.consumer, cons, __ATOMIC_RELEASE);
+}
+
+static int
+ccnl_xdp_recv(struct ccnl_relay_s *ccnl, int i, int max)
+{
+    struct ccnl_xdp_s *x = (struct ccnl_xdp_s *) ccnl->ifs[i].ring;
+    struct xdp_desc *descs = (struct xdp_desc *) x->rx.desc, *d;
+    uint64_t *fill = (uint64_t *) x->fill.desc;
+    uint32_t cons = *x->rx.consumer, prod;
+    sockunion src_addr;
+    uint8_t *frame;
+    int k, n;
+
+    prod = __atomic_load_n(x->rx.producer, __ATOMIC_ACQUIRE);
+    n = (int) (prod - cons) < max ? (int) (prod - cons) : max;
+    if (n <= 0) {
+        errno = EAGAIN;
+        return -1;
+    }
+    memset(&src_addr, 0, sizeof(src_addr));
+    src_addr.linklayer.sll_family = AF_PACKET;
+    src_addr.linklayer.sll_protocol = htons(CCNL_ETH_TYPE);
+    src_addr.linklayer.sll_ifindex = x->ifindex;
+    src_addr.linklayer.sll_halen = ETH_ALEN;
+    for (k = 0; k < n; k++) {
+        d = descs + ((cons + k) & (CCNL_XDP_RING_SIZE - 1));
+        frame = x->umem + d->addr;
+        if (d->len > 14) {
+            memcpy(src_addr.linklayer.sll_addr, frame + 6, ETH_ALEN);
+            ccnl_io_dispatch(ccnl, i, frame, d->len, &src_addr);
+        }
+        // the core copied what it keeps, the frame can be filled again
+        fill[x->fill.prod++ & (CCNL_XDP_RING_SIZE - 1)] =
+            d->addr & ~((uint64_t) CCNL_XDP_FRAME_SIZE - 1);
+    }
+    __atomic_store_n(x->rx.consumer, cons + (uint32_t) n, __ATOMIC_RELEASE);
+    __atomic_store_n(x->fill.producer, x->fill.prod, __ATOMIC_RELEASE);
+    if (x->need_wakeup &&
+        (__atomic_load_n(x->fill.flags, __ATOMIC_ACQUIRE) & XDP_RING_NEED_WAKEUP)) {
+        recvfrom(ccnl->ifs[i].sock, NULL, 0, MSG_DONTWAIT, NULL, NULL);
+    }
+#ifdef USE_STATS
+    ccnl->ifs[i].rx_batches++;
+#endif
+    return n;
+}
+
+static int
+ccnl_xdp_put(struct ccnl_if_s *ifc, uint8_t *dst,
+             uint8_t *data, size_t datalen)
+{
+    struct ccnl_xdp_s *x = (struct ccnl_xdp_s *) ifc->ring;
+    struct xdp_desc *d;
+    uint16_t type = htons(CCNL_ETH_TYPE);
+    uint8_t *frame;
+    uint64_t addr;
+
+    if (datalen + 14 > CCNL_XDP_FRAME_SIZE) {
+        DEBUGMSG(DEBUG, "xdp: frame of %zu bytes dropped\n", datalen);
+        return 0;
+    }
+    if (!x->tx_nfree) {
+        ccnl_xdp_complete(x);
+        if (!x->tx_nfree) {
+            return -1;
+        }
+    }
+    // as many TX frames as ring entries: a free frame has room in the ring
+    addr = x->tx_free[--x->tx_nfree];
+    frame = x->umem + addr;
+    memcpy(frame, dst, 6);
+    memcpy(frame + 6, ifc->addr.linklayer.sll_addr, 6);
+    memcpy(frame + 12, &type, sizeof(type));
+    memcpy(frame + 14, data, datalen);
+    d = (struct xdp_desc *) x->tx.desc + (x->tx.prod++ & (CCNL_XDP_RING_SIZE - 1));
+    d->addr = addr;
+    d->len = (uint32_t) (datalen + 14);
+    d->options = 0;
+    return 0;
+}
+
+static void
+ccnl_xdp_kick(struct ccnl_if_s *ifc)
+{
+    struct ccnl_xdp_s *x = (struct ccnl_xdp_s *) ifc->ring;
+    int k;
+
+    __atomic_store_n(x->tx.producer, x->tx.prod, __ATOMIC_RELEASE);
+    for (k = 0; k < CCNL_XDP_TX_TRIES; k++) {
+        if (x->need_wakeup &&
+            !(__atomic_load_n(x->tx.flags, __ATOMIC_ACQUIRE) & XDP_RING_NEED_WAKEUP)) {
+            break;
+        }
+        if (sendto(ifc->sock, NULL, 0, MSG_DONTWAIT, NULL, 0) >= 0 ||
+            (errno != EAGAIN && errno != EBUSY)) {
+            break;
+        }
+        // copy mode took a batch, the rest is still in the ring
+        if (__atomic_load_n(x->tx.consumer, __ATOMIC_ACQUIRE) == x->tx.prod) {
+            break;
+        }
+    }
+    ccnl_xdp_complete(x);
+#ifdef USE_STATS
+    ifc->tx_batches++;
+#endif
+}
+
+// binds in zero copy mode if the program runs in the driver and the
+// driver supports it, in copy mode otherwise (generic XDP copies anyway)
+static int
+ccnl_xdp_bind(struct ccnl_xdp_s *x, int sock, int native)
+{
+    static const uint16_t flags[] = {
+        XDP_ZEROCOPY | XDP_USE_NEED_WAKEUP,
+        XDP_COPY | XDP_USE_NEED_WAKEUP,
+        XDP_COPY,                       // kernels without need_wakeup
+    };
+    struct sockaddr_xdp sxdp;
+    unsigned int k;
+
+    for (k = native ? 0 : 1; k < sizeof(flags) / sizeof(flags[0]); k++) {
+        memset(&sxdp, 0, sizeof(sxdp));
+        sxdp.sxdp_family = AF_XDP;
+        sxdp.sxdp_flags = flags[k];
+        sxdp.sxdp_ifindex = (uint32_t) x->ifindex;
+        sxdp.sxdp_queue_id = CCNL_XDP_QUEUE;
+        if (bind(sock, (struct sockaddr *) &sxdp, sizeof(sxdp)) == 0) {
+            x->need_wakeup = (flags[k] & XDP_USE_NEED_WAKEUP) != 0;
+            DEBUGMSG(INFO, "xdp: socket bound in %s mode\n",
+                     (flags[k] & XDP_ZEROCOPY) ? "zero copy" : "copy");
+            return 0;
+        }
+    }
+    perror("xdp bind");
+    return -1;
+}
+
+int
+ccnl_open_xdpdev(char *devname, struct ccnl_if_s *i, int mode)
+{
+    struct xdp_umem_reg reg;
+    struct xdp_mmap_offsets off;
+    union bpf_attr attr;
+    struct ccnl_xdp_s *x;
+    struct ifreq ifr;
+    socklen_t optlen = sizeof(off);
+    uint32_t key = CCNL_XDP_QUEUE, k;
+    int sock, fd, size = CCNL_XDP_RING_SIZE;
+
+    DEBUGMSG(TRACE, "ccnl_open_xdpdev %s\n", devname);
+
+    x = (struct ccnl_xdp_s *) ccnl_calloc(1, sizeof(*x));
+    if (!x) {
+        return -1;
+    }
+    x->map_fd = x->prog_fd = x->link_fd = -1;
+
+    // the AF_XDP socket takes no ioctls
+    memset(&ifr, 0, sizeof(ifr));
+    strncpy(ifr.ifr_name, devname, IFNAMSIZ - 1);
+    fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0 || ioctl(fd, SIOCGIFHWADDR, (void *) &ifr) < 0) {
+        perror("xdp ioctl get hw addr");
+        if (fd >= 0) {
+            close(fd);
+        }
+        ccnl_free(x);
+        return -1;
+    }
+    close(fd);
+    x->ifindex = (int) if_nametoindex(devname);
+
+    sock = socket(AF_XDP, SOCK_RAW, 0);
+    if (sock < 0) {
+        perror("xdp socket");
+        ccnl_free(x);
+        return -1;
+    }
+    x->umem = mmap(NULL, (size_t) CCNL_XDP_FRAMES * CCNL_XDP_FRAME_SIZE,
+                   PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (x->umem == MAP_FAILED) {
+        x->umem = NULL;
+        perror("xdp umem");
+        goto fail;
+    }
+    memset(&reg, 0, sizeof(reg));
+    reg.addr = (uint64_t) (uintptr_t) x->umem;
+    reg.len = (uint64_t) CCNL_XDP_FRAMES * CCNL_XDP_FRAME_SIZE;
+    reg.chunk_size = CCNL_XDP_FRAME_SIZE;
+    if (setsockopt(sock, SOL_XDP, XDP_UMEM_REG, &reg, sizeof(reg)) < 0 ||
+        setsockopt(sock, SOL_XDP, XDP_UMEM_FILL_RING, &size, sizeof(size)) < 0 ||
+        setsockopt(sock, SOL_XDP, XDP_UMEM_COMPLETION_RING, &size, sizeof(size)) < 0 ||
+        setsockopt(sock, SOL_XDP, XDP_RX_RING, &size, sizeof(size)) < 0 ||
+        setsockopt(sock, SOL_XDP, XDP_TX_RING, &size, sizeof(size)) < 0 ||
+        getsockopt(sock, SOL_XDP, XDP_MMAP_OFFSETS, &off, &optlen) < 0) {
+        perror("xdp setsockopt");
+        goto fail;
+    }
+    if (ccnl_xdp_map_ring(sock, &x->rx, &off.rx, sizeof(struct xdp_desc),
+                          XDP_PGOFF_RX_RING) < 0 ||
+        ccnl_xdp_map_ring(sock, &x->tx, &off.tx, sizeof(struct xdp_desc),
+                          XDP_PGOFF_TX_RING) < 0 ||
+        ccnl_xdp_map_ring(sock, &x->fill, &off.fr, sizeof(uint64_t),
+                          XDP_UMEM_PGOFF_FILL_RING) < 0 ||
+        ccnl_xdp_map_ring(sock, &x->comp, &off.cr, sizeof(uint64_t),
+                          XDP_UMEM_PGOFF_COMPLETION_RING) < 0) {
+        goto fail;
+    }
+    for (k = 0; k < CCNL_XDP_RING_SIZE; k++) {
+        ((uint64_t *) x->fill.desc)[x->fill.prod++ & (CCNL_XDP_RING_SIZE - 1)] =
+            (uint64_t) k * CCNL_XDP_FRAME_SIZE;
+        x->tx_free[x->tx_nfree++] =
+            (uint64_t) (CCNL_XDP_RING_SIZE + k) * CCNL_XDP_FRAME_SIZE;
+    }
+    __atomic_store_n(x->fill.producer, x->fill.prod, __ATOMIC_RELEASE);
+
+    memset(&attr, 0, sizeof(attr));
+    attr.map_type = BPF_MAP_TYPE_XSKMAP;
+    attr.key_size = sizeof(uint32_t);
+    attr.value_size = sizeof(uint32_t);
+    attr.max_entries = CCNL_XDP_QUEUE + 1;
+    x->map_fd = ccnl_xdp_bpf(BPF_MAP_CREATE, &attr);
+    if (x->map_fd < 0) {
+        perror("xdp map");
+        goto fail;
+    }
+    x->prog_fd = ccnl_xdp_load(x->map_fd);
+    if (x->prog_fd < 0) {
+        goto fail;
+    }
+    x->link_fd = ccnl_xdp_attach(x->prog_fd, x->ifindex, &mode);
+    if (x->link_fd < 0) {
+        goto fail;
+    }
+    if (ccnl_xdp_bind(x, sock, mode == CCNL_XDP_NATIVE) < 0) {
+        goto fail;
+    }
+    memset(&attr, 0, sizeof(attr));
+    attr.map_fd = (uint32_t) x->map_fd;
+    attr.key = (uint64_t) (uintptr_t) &key;
+    attr.value = (uint64_t) (uintptr_t) &sock;
+    if (ccnl_xdp_bpf(BPF_MAP_UPDATE_ELEM, &attr) < 0) {
+        perror("xdp map update");
+        goto fail;
+    }
+
+    i->sock = sock;
+    i->addr.linklayer.sll_family = AF_PACKET;
+    memcpy(i->addr.linklayer.sll_addr, &ifr.ifr_hwaddr.sa_data, ETH_ALEN);
+    i->addr.linklayer.sll_halen = ETH_ALEN;
+    i->addr.linklayer.sll_ifindex = x->ifindex;
+    i->addr.linklayer.sll_protocol = htons(CCNL_ETH_TYPE);
+    x->ops.recv = ccnl_xdp_recv;
+    x->ops.put = ccnl_xdp_put;
+    x->ops.kick = ccnl_xdp_kick;
+    i->ring = x;
+    i->ring_release = ccnl_xdp_release;
+    DEBUGMSG(INFO, "ETH interface uses AF_XDP (%s XDP, queue %d, "
+             "%d frames of %d bytes)\n",
+             mode == CCNL_XDP_NATIVE ? "native" : "generic", CCNL_XDP_QUEUE,
+             CCNL_XDP_FRAMES, CCNL_XDP_FRAME_SIZE);
+    return sock;
+
+fail:
+    ccnl_xdp_free(x);
+    close(sock);
+    return -1;
+}
+
+#endif // USE_XDP
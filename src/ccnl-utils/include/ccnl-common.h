@@ -57,12 +57,12 @@
 #include "ccnl-logging.h"
 #include "ccnl-pkt-builder.h"
 
-#ifndef USE_DEBUG_MALLOC
+#if !defined(USE_DEBUG_MALLOC) && !defined(USE_SLAB_MALLOC)
 #define ccnl_malloc(s)                  malloc(s)
 #define ccnl_calloc(n,s)                calloc(n,s)
 #define ccnl_realloc(p,s)               realloc(p,s)
 #define ccnl_free(p)                    free(p)
-#endif //USE_DEBUG_MALLOC
+#endif //USE_DEBUG_MALLOC && USE_SLAB_MALLOC
 #define free_2ptr_list(a,b)     ccnl_free(a), ccnl_free(b)
 
 struct ccnl_prefix_s* ccnl_prefix_new(char suite, uint32_t cnt);
@@ -76,6 +76,7 @@ int ccnl_pkt_prependComponent(int suite, char *src, int *offset, unsigned char *
 #include "ccnl-pkt-switch.h"
 
 #include "ccnl-socket.h"
+#include "ccnl-shm-client.h"
 
 
 // include only the utils, not the core routines:
@@ -0,0 +1,110 @@
+/**
+ * @addtogroup CCNL-utils
+ * @{
+ *
+ * @file ccnl-shm-client.h
+ * @brief Shared memory face of an application to a relay on the same host
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#ifndef CCNL_SHM_CLIENT_H
+#define CCNL_SHM_CLIENT_H
+
+#ifdef USE_SHM
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "ccnl-shm.h"
+
+/**
+ * @brief A face to the relay, see ccnl_shm_listen()
+ */
+struct ccnl_shm_client_s {
+    int sock;                   /**< the connection, the face ends with it */
+    int up;                     /**< eventfd to ring the relay */
+    int down;                   /**< eventfd the relay rings */
+    void *mem;
+    size_t memsize;
+    struct ccnl_shm_ring_s tx;  /**< towards the relay */
+    struct ccnl_shm_ring_s rx;  /**< from the relay */
+    int bell;                   /**< the relay is to be rung at the flush */
+};
+
+/**
+ * @brief Connects to the relay's shared memory socket at @p path
+ *
+ * @param[in] path       The relay's -m path
+ * @param[in] ring_size  Bytes per ring, 0 for the relay's default
+ *
+ * @return the face, NULL on error (see errno)
+ */
+struct ccnl_shm_client_s*
+ccnl_shm_client_connect(const char *path, uint32_t ring_size);
+
+/**
+ * @brief Reserves room for a packet of @p len bytes in the ring towards
+ * the relay, to be written in place and passed on with
+ * ccnl_shm_client_commit()
+ *
+ * @return where to write the packet, NULL if the ring is full or @p len
+ * exceeds CCNL_SHM_MAX_PACKET_SIZE
+ */
+void*
+ccnl_shm_client_reserve(struct ccnl_shm_client_s *c, size_t len);
+
+/**
+ * @brief Passes the packet written to the last reservation on, the relay
+ * sees it at the latest after ccnl_shm_client_flush()
+ */
+void
+ccnl_shm_client_commit(struct ccnl_shm_client_s *c, size_t len);
+
+/**
+ * @brief Wakes the relay up if it sleeps, once per batch of commits
+ */
+void
+ccnl_shm_client_flush(struct ccnl_shm_client_s *c);
+
+/**
+ * @brief Sends a packet, waiting up to @p timeout ms for room in the ring
+ *
+ * @return 0 on success, -1 on error (EAGAIN after the timeout, EMSGSIZE)
+ */
+int
+ccnl_shm_client_send(struct ccnl_shm_client_s *c, const uint8_t *data,
+                     size_t len, int timeout);
+
+/**
+ * @brief Receives a packet, waiting up to @p timeout ms (-1: forever)
+ *
+ * @return its length, truncated to @p size, or -1 on error (EAGAIN after
+ * the timeout, ECONNRESET if the relay went away)
+ */
+ssize_t
+ccnl_shm_client_recv(struct ccnl_shm_client_s *c, uint8_t *buf, size_t size,
+                     int timeout);
+
+/**
+ * @brief Closes the face and frees @p c
+ */
+void
+ccnl_shm_client_close(struct ccnl_shm_client_s *c);
+
+#endif // USE_SHM
+
+#endif // CCNL_SHM_CLIENT_H
+/** @} */
@@ -116,6 +116,8 @@ dtag2str(uint64_t dtag)
     case CCNL_DTAG_SERVEDCTN:     return "SERVEDCTN";
     case CCNL_DTAG_VERIFIED:      return "VERIFIED";
     case CCNL_DTAG_CALLBACK:      return "CALLBACK";
+    case CCNL_DTAG_CSBYTES:       return "CSBYTES";
+    case CCNL_DTAG_CSMAXBYTES:    return "CSMAXBYTES";
     case CCNL_DTAG_SUITE:         return "SUITE";
     case CCNL_DTAG_COMPLENGTH:    return "COMPLENGTH";
     }
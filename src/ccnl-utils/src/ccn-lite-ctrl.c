@@ -547,7 +547,7 @@ mkNewFaceRequest(uint8_t *out, size_t outlen, char *macsrc, char *ip4src, char *
         return -1;
     }
     if (macsrc) {
-        if (ccnl_ccnb_mkStrBlob(faceinst + len3, faceinst + sizeof(faceinst), CCNL_DTAG_MACSRC, CCN_TT_DTAG, macsrc, &len)) {
+        if (ccnl_ccnb_mkStrBlob(faceinst + len3, faceinst + sizeof(faceinst), CCNL_DTAG_MACSRC, CCN_TT_DTAG, macsrc, &len3)) {
             return -1;
         }
     }
@@ -50,6 +50,10 @@ main(int argc, char *argv[])
 {
     int cnt, len, opt, port, sock = 0, socksize, suite = CCNL_SUITE_NDNTLV;
     char *addr = NULL, *udp = NULL, *ux = NULL;
+#ifdef USE_SHM
+    char *shmpath = NULL;
+    struct ccnl_shm_client_s *shm = NULL;
+#endif
     struct sockaddr sa;
     struct ccnl_prefix_s *prefix;
     float wait = 3.0;
@@ -59,8 +63,13 @@ main(int argc, char *argv[])
     ccnl_isFragmentFunc isFragment;
 #endif
 
-    while ((opt = getopt(argc, argv, "hn:s:u:v:w:x:")) != -1) {
+    while ((opt = getopt(argc, argv, "hm:n:s:u:v:w:x:")) != -1) {
         switch (opt) {
+#ifdef USE_SHM
+        case 'm':
+            shmpath = optarg;
+            break;
+#endif
         case 'n': {
             errno = 0;
             unsigned long chunknum_ul = strtoul(optarg, (char **) NULL, 10);
@@ -96,6 +105,9 @@ main(int argc, char *argv[])
         default:
 usage:
             fprintf(stderr, "usage: %s [options] URI\n"
+#ifdef USE_SHM
+            "  -m ux_path_name  shared memory face of the relay (its -m)\n"
+#endif
             "  -n CHUNKNUM      positive integer for chunk interest\n"
             "  -s SUITE         (ccnb, ccnx2015, ndn2013)\n"
             "  -u a.b.c.d/port  UDP destination (default is suite-dependent)\n"
@@ -126,6 +138,15 @@ usage:
     isFragment = ccnl_suite2isFragmentFunc(suite);
 #endif
 
+#ifdef USE_SHM
+    if (shmpath) { // rings shared with the relay
+        shm = ccnl_shm_client_connect(shmpath, 0);
+        if (!shm) {
+            perror("shm connect");
+            exit(-1);
+        }
+    } else
+#endif
     if (ux) { // use UNIX socket
         struct sockaddr_un *su = (struct sockaddr_un*) &sa;
         su->sun_family = AF_UNIX;
@@ -176,6 +197,12 @@ usage:
         } else {
             socksize = sizeof(struct sockaddr_in);
         }
+#ifdef USE_SHM
+        if (shm) {
+            rc = ccnl_shm_client_send(shm, buf->data, buf->datalen,
+                                      (int) (wait * 1000));
+        } else
+#endif
         rc = sendto(sock, buf->data, buf->datalen, 0, (struct sockaddr*)&sa, socksize);
         if (rc < 0) {
             perror("sendto");
@@ -190,10 +217,21 @@ usage:
             size_t len2;
             DEBUGMSG(TRACE, "  waiting for packet\n");
 
-            if (block_on_read(sock, wait) <= 0) { // timeout
-                break;
+#ifdef USE_SHM
+            if (shm) {
+                len = (int) ccnl_shm_client_recv(shm, out, sizeof(out),
+                                                 (int) (wait * 1000));
+                if (len < 0) { // timeout
+                    break;
+                }
+            } else
+#endif
+            {
+                if (block_on_read(sock, wait) <= 0) { // timeout
+                    break;
+                }
+                len = recv(sock, out, sizeof(out), 0);
             }
-            len = recv(sock, out, sizeof(out), 0);
 
             DEBUGMSG(DEBUG, "received %d bytes\n", len);
 /*
@@ -275,6 +313,11 @@ usage:
     fprintf(stderr, "timeout\n");
 
 done:
+#ifdef USE_SHM
+    if (shm) {
+        ccnl_shm_client_close(shm);
+    } else
+#endif
     close(sock);
     myexit(-1);
     return 0; // avoid a compiler warning
@@ -0,0 +1,273 @@
+/*
+ * @f util/ccnl-shm-client.c
+ * @b shared memory face of an application to a relay on the same host
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-17 created
+ */
+
+#include <errno.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "ccnl-shm-client.h"
+
+#ifdef USE_SHM
+
+// waits for the relay's eventfd, returns 1 when it rang, 0 after the
+// timeout and -1 if the relay went away
+static int
+ccnl_shm_client_wait(struct ccnl_shm_client_s *c, int timeout)
+{
+    struct pollfd pfd[2];
+    uint64_t cnt;
+    int rc;
+
+    pfd[0].fd = c->down;
+    pfd[0].events = POLLIN;
+    pfd[1].fd = c->sock;
+    pfd[1].events = POLLIN;
+    do {
+        rc = poll(pfd, 2, timeout);
+    } while (rc < 0 && errno == EINTR);
+    if (rc < 0) {
+        return -1;
+    }
+    if (pfd[1].revents) {
+        // the relay sends nothing after the setup, this is its end
+        errno = ECONNRESET;
+        return -1;
+    }
+    if (!rc) {
+        errno = EAGAIN;
+        return 0;
+    }
+    if (read(c->down, &cnt, sizeof(cnt)) < 0 && errno != EAGAIN) {
+        return -1;
+    }
+    return 1;
+}
+
+struct ccnl_shm_client_s*
+ccnl_shm_client_connect(const char *path, uint32_t ring_size)
+{
+    struct ccnl_shm_client_s *c;
+    struct ccnl_shm_setup_s req, rsp;
+    struct sockaddr_un name;
+    union {
+        struct cmsghdr align;
+        char buf[CMSG_SPACE(CCNL_SHM_FD_COUNT * sizeof(int))];
+    } ctrl;
+    struct msghdr msg;
+    struct iovec iov;
+    struct cmsghdr *cm;
+    struct stat st;
+    int fds[CCNL_SHM_FD_COUNT] = { -1, -1, -1 };
+    int k, err;
+
+    c = (struct ccnl_shm_client_s *) calloc(1, sizeof(*c));
+    if (!c) {
+        return NULL;
+    }
+    c->up = c->down = -1;
+    c->sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (c->sock < 0) {
+        goto failed;
+    }
+    memset(&name, 0, sizeof(name));
+    name.sun_family = AF_UNIX;
+    strncpy(name.sun_path, path, sizeof(name.sun_path) - 1);
+    if (connect(c->sock, (struct sockaddr *) &name, sizeof(name))) {
+        goto failed;
+    }
+
+    req.magic = CCNL_SHM_MAGIC;
+    req.version = CCNL_SHM_VERSION;
+    req.ring_size = ring_size;
+    if (send(c->sock, &req, sizeof(req), MSG_NOSIGNAL) != sizeof(req)) {
+        goto failed;
+    }
+    iov.iov_base = &rsp;
+    iov.iov_len = sizeof(rsp);
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctrl.buf;
+    msg.msg_controllen = sizeof(ctrl.buf);
+    if (recvmsg(c->sock, &msg, MSG_CMSG_CLOEXEC) != sizeof(rsp)) {
+        errno = ECONNREFUSED;
+        goto failed;
+    }
+    cm = CMSG_FIRSTHDR(&msg);
+    if (!cm || cm->cmsg_level != SOL_SOCKET || cm->cmsg_type != SCM_RIGHTS ||
+        cm->cmsg_len != CMSG_LEN(sizeof(fds))) {
+        errno = EPROTO;
+        goto failed;
+    }
+    memcpy(fds, CMSG_DATA(cm), sizeof(fds));
+    if (rsp.magic != CCNL_SHM_MAGIC || rsp.version != CCNL_SHM_VERSION ||
+        !rsp.ring_size || (rsp.ring_size & (rsp.ring_size - 1)) ||
+        fstat(fds[CCNL_SHM_FD_MEM], &st) ||
+        (size_t) st.st_size < ccnl_shm_mem_size(rsp.ring_size)) {
+        errno = EPROTO;
+        goto failed;
+    }
+
+    c->memsize = ccnl_shm_mem_size(rsp.ring_size);
+    c->mem = mmap(NULL, c->memsize, PROT_READ | PROT_WRITE, MAP_SHARED,
+                  fds[CCNL_SHM_FD_MEM], 0);
+    if (c->mem == MAP_FAILED) {
+        c->mem = NULL;
+        goto failed;
+    }
+    if (((struct ccnl_shm_hdr_s *) c->mem)->ring_size != rsp.ring_size) {
+        errno = EPROTO;
+        goto failed;
+    }
+    close(fds[CCNL_SHM_FD_MEM]);
+    c->up = fds[CCNL_SHM_FD_UP];
+    c->down = fds[CCNL_SHM_FD_DOWN];
+    ccnl_shm_ring_attach(c->mem, 1, &c->tx, &c->rx);
+    return c;
+
+failed:
+    err = errno;
+    for (k = 0; k < CCNL_SHM_FD_COUNT; k++) {
+        if (fds[k] >= 0) {
+            close(fds[k]);
+        }
+    }
+    c->up = c->down = -1;
+    ccnl_shm_client_close(c);
+    errno = err;
+    return NULL;
+}
+
+void*
+ccnl_shm_client_reserve(struct ccnl_shm_client_s *c, size_t len)
+{
+    return ccnl_shm_ring_reserve(&c->tx, len);
+}
+
+void
+ccnl_shm_client_commit(struct ccnl_shm_client_s *c, size_t len)
+{
+    if (ccnl_shm_ring_commit(&c->tx, len)) {
+        c->bell = 1;
+    }
+}
+
+void
+ccnl_shm_client_flush(struct ccnl_shm_client_s *c)
+{
+    uint64_t one = 1;
+
+    if (c->bell) {
+        c->bell = 0;
+        if (write(c->up, &one, sizeof(one)) < 0) {
+            // EAGAIN: the counter is far from zero, it rings anyway
+        }
+    }
+}
+
+int
+ccnl_shm_client_send(struct ccnl_shm_client_s *c, const uint8_t *data,
+                     size_t len, int timeout)
+{
+    void *p;
+    int rc;
+
+    if (len > CCNL_SHM_MAX_PACKET_SIZE) {
+        errno = EMSGSIZE;
+        return -1;
+    }
+    while (!(p = ccnl_shm_client_reserve(c, len))) {
+        // the relay rings the same eventfd once it made room
+        ccnl_shm_client_flush(c);
+        ccnl_shm_ring_want_room(&c->tx);
+        if ((p = ccnl_shm_client_reserve(c, len))) {
+            break;
+        }
+        rc = ccnl_shm_client_wait(c, timeout);
+        if (rc <= 0) {
+            return -1;
+        }
+    }
+    memcpy(p, data, len);
+    ccnl_shm_client_commit(c, len);
+    ccnl_shm_client_flush(c);
+    return 0;
+}
+
+ssize_t
+ccnl_shm_client_recv(struct ccnl_shm_client_s *c, uint8_t *buf, size_t size,
+                     int timeout)
+{
+    uint8_t *data;
+    size_t len;
+    int rc;
+
+    for (;;) {
+        rc = ccnl_shm_ring_peek(&c->rx, &data, &len);
+        if (rc < 0) {
+            errno = EPROTO;
+            return -1;
+        }
+        if (rc) {
+            if (len > size) {
+                len = size;
+            }
+            memcpy(buf, data, len);
+            ccnl_shm_ring_release(&c->rx);
+            return (ssize_t) len;
+        }
+        rc = ccnl_shm_client_wait(c, timeout);
+        if (rc <= 0) {
+            return -1;
+        }
+    }
+}
+
+void
+ccnl_shm_client_close(struct ccnl_shm_client_s *c)
+{
+    if (!c) {
+        return;
+    }
+    if (c->mem) {
+        munmap(c->mem, c->memsize);
+    }
+    if (c->up >= 0) {
+        close(c->up);
+    }
+    if (c->down >= 0) {
+        close(c->down);
+    }
+    if (c->sock >= 0) {
+        close(c->sock);
+    }
+    free(c);
+}
+
+#endif // USE_SHM
@@ -0,0 +1,249 @@
+/**
+ * @file test_cache.c
+ * @brief Tests for the replacement policies of the content store
+ *
+ * Copyright (C) 2018 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "ccnl-core.h"
+
+static struct ccnl_relay_s relay;
+
+static void
+setup(int policy, int max_cache_entries)
+{
+    memset(&relay, 0, sizeof(relay));
+    relay.max_cache_entries = max_cache_entries;
+    assert_int_equal(0, ccnl_cache_set_policy(&relay, policy));
+}
+
+static void
+teardown(void)
+{
+    while (relay.contents) {
+        ccnl_content_remove(&relay, relay.contents);
+    }
+    ccnl_htable_free(&relay.cs_index);
+    ccnl_cache_cleanup(&relay);
+}
+
+static struct ccnl_content_s*
+add(char *uri)
+{
+    char buf[100];
+    struct ccnl_pkt_s *pkt = ccnl_calloc(1, sizeof(struct ccnl_pkt_s));
+    struct ccnl_content_s *c;
+
+    strcpy(buf, uri);
+    pkt->pfx = ccnl_URItoPrefix(buf, 0, NULL);
+    pkt->buf = ccnl_buf_new(NULL, 1);
+    c = ccnl_content_new(&pkt);
+    assert_true(c == ccnl_content_add2cache(&relay, c));
+    return c;
+}
+
+static int
+cached(char *uri)
+{
+    char buf[100];
+    struct ccnl_prefix_s *pfx;
+    int found;
+
+    strcpy(buf, uri);
+    pfx = ccnl_URItoPrefix(buf, 0, NULL);
+    found = ccnl_content_find(&relay, pfx) != NULL;
+    ccnl_prefix_free(pfx);
+    return found;
+}
+
+void test_cache_policy_names()
+{
+    int policy;
+
+    for (policy = 0; policy < CCNL_CACHE_LAST; policy++) {
+        assert_int_equal(policy,
+                         ccnl_cache_str2policy(ccnl_cache_policy2str(policy)));
+    }
+    assert_int_equal(-1, ccnl_cache_str2policy("fifo"));
+    memset(&relay, 0, sizeof(relay));
+    assert_int_equal(-1, ccnl_cache_set_policy(&relay, CCNL_CACHE_LAST));
+}
+
+void test_cache_lru()
+{
+    struct ccnl_content_s *a;
+
+    setup(CCNL_CACHE_LRU, 3);
+    a = add("/a");
+    add("/b");
+    add("/c");
+    ccnl_cache_hit(&relay, a);
+    add("/d");
+    assert_true(cached("/a"));
+    assert_false(cached("/b"));
+    assert_int_equal(3, relay.contentcnt);
+    assert_int_equal(1, relay.cache.evictions);
+    teardown();
+}
+
+void test_cache_lfu()
+{
+    struct ccnl_content_s *a, *c;
+
+    setup(CCNL_CACHE_LFU, 3);
+    a = add("/a");
+    add("/b");
+    c = add("/c");
+    ccnl_cache_hit(&relay, a);
+    ccnl_cache_hit(&relay, a);
+    ccnl_cache_hit(&relay, c);
+    add("/d");
+    assert_false(cached("/b"));
+    add("/e");
+    assert_false(cached("/d"));
+    assert_true(cached("/a") && cached("/c") && cached("/e"));
+    teardown();
+}
+
+void test_cache_arc()
+{
+    struct ccnl_content_s *c;
+
+    setup(CCNL_CACHE_ARC, 4);
+    ccnl_cache_hit(&relay, add("/a"));
+    ccnl_cache_hit(&relay, add("/b"));
+    add("/c");
+    add("/d");
+    // T1 = {d, c} exceeds its target size 0
+    add("/e");
+    assert_false(cached("/c"));
+    assert_int_equal(1, relay.cache.ghosts[0].count);
+
+    // a hit in B1 grows the target size of T1 and admits into T2
+    c = add("/c");
+    assert_int_equal(1, relay.cache.arc_p);
+    assert_int_equal(2, c->queue);
+    assert_false(cached("/d"));
+    assert_true(cached("/a") && cached("/b") && cached("/e"));
+    teardown();
+}
+
+void test_cache_s3fifo()
+{
+    struct ccnl_content_s *a, *b;
+    char uri[16];
+    int i;
+
+    setup(CCNL_CACHE_S3FIFO, 10);
+    a = add("/a");
+    add("/b");
+    for (i = 0; i < 8; i++) {
+        sprintf(uri, "/x%d", i);
+        add(uri);
+    }
+    ccnl_cache_hit(&relay, a);
+    // a was accessed in the small queue and moves on, b leaves as a ghost
+    add("/y");
+    assert_true(cached("/a"));
+    assert_int_equal(2, a->queue);
+    assert_false(cached("/b"));
+    assert_int_equal(1, relay.cache.ghosts[0].count);
+
+    // a returning name goes to the main queue right away
+    b = add("/b");
+    assert_int_equal(2, b->queue);
+    assert_false(cached("/x0"));
+    assert_int_equal(1, relay.cache.ghosts[0].count);
+    teardown();
+}
+
+void test_cache_static()
+{
+    struct ccnl_content_s *a, *b;
+    int policy;
+
+    for (policy = 0; policy < CCNL_CACHE_LAST; policy++) {
+        setup(policy, 2);
+        a = add("/a");
+        a->flags |= CCNL_CONTENT_FLAGS_STATIC;
+        b = add("/b");
+        b->flags |= CCNL_CONTENT_FLAGS_STATIC;
+        // only pinned entries left, nothing can be evicted
+        assert_int_equal(-1, ccnl_cache_evict(&relay));
+        assert_true(cached("/a") && cached("/b"));
+        teardown();
+    }
+}
+
+void test_cache_set_policy()
+{
+    setup(CCNL_CACHE_LRU, 3);
+    add("/a");
+    add("/b");
+    add("/c");
+    assert_int_equal(0, ccnl_cache_set_policy(&relay, CCNL_CACHE_S3FIFO));
+    assert_int_equal(3, relay.cache.queues[0].count);
+    assert_int_equal(0, relay.cache.queues[1].count);
+    add("/d");
+    assert_false(cached("/a"));
+    teardown();
+}
+
+void test_cache_bytes()
+{
+    struct ccnl_content_s *a;
+    size_t size;
+
+    setup(CCNL_CACHE_LRU, -1);
+    a = add("/a");
+    size = a->size;
+    assert_true(size == ccnl_content_size(a));
+    assert_true(size > sizeof(struct ccnl_content_s) + sizeof(struct ccnl_pkt_s));
+    assert_true(relay.cs_bytes == size);
+
+    // room for three entries of the same size
+    relay.max_cache_bytes = 3 * size;
+    add("/b");
+    add("/c");
+    add("/d");
+    assert_false(cached("/a"));
+    assert_int_equal(3, relay.contentcnt);
+    assert_true(relay.cs_bytes == 3 * size);
+
+    ccnl_content_remove(&relay, relay.contents);
+    assert_true(relay.cs_bytes == 2 * size);
+    teardown();
+    assert_true(relay.cs_bytes == 0);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_cache_policy_names),
+        unit_test(test_cache_lru),
+        unit_test(test_cache_lfu),
+        unit_test(test_cache_arc),
+        unit_test(test_cache_s3fifo),
+        unit_test(test_cache_static),
+        unit_test(test_cache_set_policy),
+        unit_test(test_cache_bytes),
+    };
+
+    return run_tests(tests);
+}
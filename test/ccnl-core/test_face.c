@@ -0,0 +1,236 @@
+/**
+ * @file test_face.c
+ * @brief Tests for the removal of faces
+ *
+ * Copyright (C) 2018 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "ccnl-core.h"
+
+#define TEARDOWN_FACES   10000
+#define TEARDOWN_PIT     1000000
+
+static struct ccnl_relay_s relay;
+
+static struct ccnl_face_s*
+new_face(int port)
+{
+    sockunion su;
+
+    memset(&su, 0, sizeof(su));
+    su.ip4.sin_family = AF_INET;
+    su.ip4.sin_addr.s_addr = htonl(0x7f000001);
+    su.ip4.sin_port = htons(port);
+    return ccnl_get_face_or_create(&relay, 0, &su.sa, sizeof(su.ip4));
+}
+
+static struct ccnl_prefix_s*
+new_prefix(char *uri)
+{
+    char buf[100];
+
+    strcpy(buf, uri);
+    return ccnl_URItoPrefix(buf, 6, NULL); // CCNL_SUITE_NDNTLV
+}
+
+static struct ccnl_interest_s*
+new_interest(char *uri, struct ccnl_face_s *from)
+{
+    struct ccnl_pkt_s *pkt = ccnl_calloc(1, sizeof(struct ccnl_pkt_s));
+    struct ccnl_interest_s *i;
+
+    pkt->suite = 6;
+    pkt->pfx = new_prefix(uri);
+    pkt->s.ndntlv.interestlifetime = 4000;
+    i = ccnl_interest_new(&relay, from, &pkt);
+    assert_non_null(i);
+    assert_int_equal(0, ccnl_interest_append_pending(i, from));
+    return i;
+}
+
+void test_face_remove()
+{
+    struct ccnl_face_s *a, *b, *c;
+    struct ccnl_interest_s *i1;
+
+    memset(&relay, 0, sizeof(relay));
+    relay.max_pit_entries = -1;
+    a = new_face(9001);
+    b = new_face(9002);
+    c = new_face(9003);
+    i1 = new_interest("/x/1", a);
+    assert_int_equal(0, ccnl_interest_append_pending(i1, b));
+    new_interest("/x/2", b);
+    assert_int_equal(0, ccnl_fib_add_entry(&relay, new_prefix("/x"), b));
+    assert_int_equal(0, ccnl_fib_add_entry(&relay, new_prefix("/y"), c));
+    assert_int_equal(0, ccnl_fib_add_entry(&relay, new_prefix("/z"), b));
+    // the entry moves to the list of its new face
+    assert_int_equal(0, ccnl_fib_add_entry(&relay, new_prefix("/z"), c));
+
+    // the entry pending only on b goes, the other one keeps a
+    ccnl_face_remove(&relay, b);
+    assert_int_equal(1, relay.pitcnt);
+    assert_true(relay.pit == i1);
+    assert_true(i1->pending->face == a && !i1->pending->next);
+    assert_true(i1->from == a);
+    assert_true(relay.fib && relay.fib->face == c && relay.fib->next &&
+                relay.fib->next->face == c && !relay.fib->next->next);
+
+    ccnl_face_remove(&relay, a);
+    assert_int_equal(0, relay.pitcnt);
+    assert_null(c->pit);
+    assert_null(c->pendints);
+    ccnl_face_remove(&relay, c);
+    assert_null(relay.fib);
+    assert_null(relay.faces);
+    ccnl_htable_free(&relay.face_index);
+    ccnl_htable_free(&relay.pit_index);
+    ccnl_htable_free(&relay.fib_index);
+    ccnl_timer_cleanup();
+}
+
+static struct ccnl_buf_s *sent[4];
+static uint32_t sent_refcnt[4];
+static int sentcnt;
+
+static void
+record_tx(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
+          sockunion *dest, struct ccnl_buf_s *buf)
+{
+    (void) ccnl;
+    (void) ifc;
+    (void) dest;
+    sent[sentcnt] = buf;
+    sent_refcnt[sentcnt++] = buf->refcnt;
+}
+
+void test_face_send_shared()
+{
+    struct ccnl_face_s *faces[3];
+    struct ccnl_pkt_s *pkt = ccnl_calloc(1, sizeof(struct ccnl_pkt_s));
+    int n;
+
+    memset(&relay, 0, sizeof(relay));
+    relay.ccnl_ll_TX_ptr = record_tx;
+    pkt->buf = ccnl_buf_new("data", 4);
+    for (n = 0; n < 3; n++) {
+        faces[n] = new_face(9101 + n);
+        assert_int_equal(0, ccnl_send_pkt(&relay, faces[n], pkt));
+    }
+    // every face sent the packet's own buffer, no copies were made
+    assert_int_equal(3, sentcnt);
+    for (n = 0; n < 3; n++) {
+        assert_true(sent[n] == pkt->buf);
+        assert_int_equal(2, sent_refcnt[n]);
+    }
+    assert_int_equal(1, pkt->buf->refcnt);
+
+    // a queued buffer is found by identity, equal bytes by their hash
+    faces[0]->outq = ccnl_calloc(1, sizeof(struct ccnl_outq_s));
+    faces[0]->outq->buf = ccnl_buf_ref(pkt->buf);
+    faces[0]->outqend = faces[0]->outq;
+    assert_int_equal(-1, ccnl_face_enqueue(&relay, faces[0], ccnl_buf_ref(pkt->buf)));
+    assert_int_equal(2, pkt->buf->refcnt);
+    assert_int_equal(-1, ccnl_face_enqueue(&relay, faces[0], ccnl_buf_new("data", 4)));
+    assert_true(faces[0]->outq->buf == pkt->buf && !faces[0]->outq->next);
+
+    for (n = 0; n < 3; n++) {
+        ccnl_face_remove(&relay, faces[n]);
+    }
+    assert_int_equal(1, pkt->buf->refcnt);
+    ccnl_pkt_free(pkt);
+    ccnl_htable_free(&relay.face_index);
+    ccnl_timer_cleanup();
+}
+
+/* Tears down many faces next to a large PIT. Removing a face only visits
+ * the entries which refer to it, with a walk over the whole PIT per face
+ * this would not finish in any reasonable time. */
+void test_face_teardown()
+{
+    struct ccnl_face_s **faces, *anchor;
+    struct ccnl_pkt_s *pkts;
+    struct ccnl_prefix_s *pfxs;
+    uint8_t **comps, *names;
+    size_t *complens;
+    struct ccnl_interest_s **pit;
+    struct ccnl_pkt_s *pkt;
+    int n;
+
+    memset(&relay, 0, sizeof(relay));
+    relay.max_pit_entries = -1;
+    anchor = new_face(1);
+
+    // one name component of four bytes per entry, kept in a few arrays
+    pkts = calloc(TEARDOWN_PIT, sizeof(*pkts));
+    pfxs = calloc(TEARDOWN_PIT, sizeof(*pfxs));
+    comps = calloc(TEARDOWN_PIT, sizeof(*comps));
+    complens = calloc(TEARDOWN_PIT, sizeof(*complens));
+    names = calloc(TEARDOWN_PIT, 4);
+    pit = calloc(TEARDOWN_PIT, sizeof(*pit));
+    faces = calloc(TEARDOWN_FACES, sizeof(*faces));
+    assert_true(pkts && pfxs && comps && complens && names && pit && faces);
+    for (n = 0; n < TEARDOWN_PIT; n++) {
+        memcpy(names + 4 * n, &n, 4);
+        comps[n] = names + 4 * n;
+        complens[n] = 4;
+        pfxs[n].comp = comps + n;
+        pfxs[n].complen = complens + n;
+        pfxs[n].compcnt = 1;
+        pfxs[n].suite = 6;
+        pkts[n].suite = 6;
+        pkts[n].pfx = pfxs + n;
+        pkts[n].s.ndntlv.interestlifetime = 4000;
+        pkt = pkts + n;
+        pit[n] = ccnl_interest_new(&relay, anchor, &pkt);
+        assert_non_null(pit[n]);
+    }
+    for (n = 0; n < TEARDOWN_FACES; n++) {
+        faces[n] = new_face(10000 + n);
+        assert_non_null(faces[n]);
+    }
+    for (n = 0; n < TEARDOWN_FACES; n++) {
+        assert_int_equal(0, ccnl_interest_append_pending(pit[n], faces[n]));
+        assert_int_equal(0, ccnl_interest_append_pending(pit[n], anchor));
+    }
+    assert_int_equal(TEARDOWN_PIT, relay.pitcnt);
+
+    for (n = TEARDOWN_FACES - 1; n >= 0; n--) {
+        ccnl_face_remove(&relay, faces[n]);
+    }
+    assert_true(relay.faces == anchor && !anchor->next);
+    assert_int_equal(TEARDOWN_PIT, relay.pitcnt);
+    for (n = 0; n < TEARDOWN_FACES; n++) {
+        assert_true(pit[n]->pending->face == anchor && !pit[n]->pending->next);
+    }
+    assert_true(anchor->pit != NULL);
+    // the packets and names live in the arrays above, the PIT is left to
+    // the end of the process
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_face_remove),
+        unit_test(test_face_send_shared),
+        unit_test(test_face_teardown),
+    };
+
+    return run_tests(tests);
+}
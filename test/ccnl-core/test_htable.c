@@ -0,0 +1,330 @@
+/**
+ * @file test_htable.c
+ * @brief Tests for the hash table and the content store, FIB and PIT indices
+ *
+ * Copyright (C) 2018 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "ccnl-core.h"
+
+static int suite = 0;
+
+struct item_s {
+    int value;
+    struct ccnl_hnode_s hnode;
+};
+
+static struct ccnl_content_s*
+new_content(char *uri)
+{
+    char buf[100];
+    struct ccnl_pkt_s *pkt = ccnl_calloc(1, sizeof(struct ccnl_pkt_s));
+
+    strcpy(buf, uri);
+    pkt->pfx = ccnl_URItoPrefix(buf, suite, NULL);
+    pkt->buf = ccnl_buf_new(NULL, 1);
+    pkt->suite = suite;
+    return ccnl_content_new(&pkt);
+}
+
+void test_htable_empty()
+{
+    struct ccnl_htable_s t;
+
+    memset(&t, 0, sizeof(t));
+    assert_null(ccnl_htable_lookup(&t, 42));
+    ccnl_htable_free(&t);
+}
+
+void test_htable_insert_remove()
+{
+    struct ccnl_htable_s t;
+    struct item_s a, b, c;
+    struct ccnl_hnode_s *n;
+
+    memset(&t, 0, sizeof(t));
+    a.value = 1;
+    b.value = 2;
+    c.value = 3;
+    assert_int_equal(0, ccnl_htable_insert(&t, &a.hnode, 7));
+    assert_int_equal(0, ccnl_htable_insert(&t, &b.hnode, 7 + CCNL_HTABLE_MIN_SIZE));
+    assert_int_equal(0, ccnl_htable_insert(&t, &c.hnode, 7));
+    assert_int_equal(3, t.count);
+
+    n = ccnl_htable_lookup(&t, 7 + CCNL_HTABLE_MIN_SIZE);
+    assert_non_null(n);
+    assert_int_equal(2, CCNL_HTABLE_ENTRY(n, struct item_s, hnode)->value);
+    assert_null(ccnl_htable_next(n));
+
+    n = ccnl_htable_lookup(&t, 7);
+    assert_non_null(n);
+    n = ccnl_htable_next(n);
+    assert_non_null(n);
+    assert_null(ccnl_htable_next(n));
+
+    ccnl_htable_remove(&t, &a.hnode);
+    ccnl_htable_remove(&t, &a.hnode);
+    n = ccnl_htable_lookup(&t, 7);
+    assert_int_equal(3, CCNL_HTABLE_ENTRY(n, struct item_s, hnode)->value);
+    assert_int_equal(2, t.count);
+
+    ccnl_htable_free(&t);
+    assert_null(ccnl_htable_lookup(&t, 7));
+}
+
+void test_htable_grow()
+{
+    struct ccnl_htable_s t;
+    struct item_s items[4 * CCNL_HTABLE_MIN_SIZE];
+    struct ccnl_hnode_s *n;
+    uint32_t i;
+
+    memset(&t, 0, sizeof(t));
+    for (i = 0; i < 4 * CCNL_HTABLE_MIN_SIZE; i++) {
+        items[i].value = (int) i;
+        assert_int_equal(0, ccnl_htable_insert(&t, &items[i].hnode, i * 31));
+    }
+    assert_true(t.size >= 4 * CCNL_HTABLE_MIN_SIZE);
+    for (i = 0; i < 4 * CCNL_HTABLE_MIN_SIZE; i++) {
+        n = ccnl_htable_lookup(&t, i * 31);
+        assert_non_null(n);
+        assert_int_equal((int) i, CCNL_HTABLE_ENTRY(n, struct item_s, hnode)->value);
+    }
+    ccnl_htable_free(&t);
+}
+
+void test_cs_find()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_content_s *c1, *c2;
+    struct ccnl_prefix_s *pfx;
+    char buf[100];
+
+    memset(&relay, 0, sizeof(relay));
+    c1 = new_content("/path/to/data");
+    c2 = new_content("/path/to");
+    assert_true(c1 == ccnl_content_add2cache(&relay, c1));
+    assert_true(c2 == ccnl_content_add2cache(&relay, c2));
+
+    strcpy(buf, "/path/to/data");
+    pfx = ccnl_URItoPrefix(buf, suite, NULL);
+    assert_true(c1 == ccnl_content_find(&relay, pfx));
+    ccnl_content_remove(&relay, c1);
+    assert_null(ccnl_content_find(&relay, pfx));
+    ccnl_prefix_free(pfx);
+
+    strcpy(buf, "/path/to");
+    pfx = ccnl_URItoPrefix(buf, suite + 1, NULL);
+    assert_null(ccnl_content_find(&relay, pfx));
+    pfx->suite = suite;
+    assert_true(c2 == ccnl_content_find(&relay, pfx));
+    ccnl_prefix_free(pfx);
+
+    ccnl_content_remove(&relay, c2);
+    assert_true(relay.contents == NULL);
+    assert_int_equal(0, relay.cs_index.count);
+    ccnl_htable_free(&relay.cs_index);
+}
+
+void test_fib_find()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_forward_s *f1, *f2;
+    struct ccnl_prefix_s *pfx;
+    char buf[100];
+
+    memset(&relay, 0, sizeof(relay));
+    f1 = ccnl_calloc(1, sizeof(*f1));
+    f2 = ccnl_calloc(1, sizeof(*f2));
+    strcpy(buf, "/path/to");
+    f1->prefix = ccnl_URItoPrefix(buf, suite, NULL);
+    f1->suite = suite;
+    strcpy(buf, "/path");
+    f2->prefix = ccnl_URItoPrefix(buf, suite, NULL);
+    f2->suite = suite;
+    assert_int_equal(0, ccnl_forward_add(&relay, f1));
+    assert_int_equal(0, ccnl_forward_add(&relay, f2));
+    assert_int_equal(2, relay.fib_index.count);
+
+    strcpy(buf, "/path/to");
+    pfx = ccnl_URItoPrefix(buf, suite, NULL);
+    assert_true(f1 == ccnl_forward_find(&relay, pfx));
+    pfx->compcnt = 1;
+    assert_true(f2 == ccnl_forward_find(&relay, pfx));
+    pfx->suite = suite + 1;
+    assert_null(ccnl_forward_find(&relay, pfx));
+    pfx->suite = suite;
+
+    assert_true(relay.fib->next == ccnl_forward_remove(&relay, relay.fib));
+    assert_true(f1 == relay.fib);
+    assert_null(ccnl_forward_find(&relay, pfx));
+    pfx->compcnt = 2;
+    assert_true(f1 == ccnl_forward_find(&relay, pfx));
+    ccnl_prefix_free(pfx);
+
+    assert_null(ccnl_forward_remove(&relay, f1));
+    assert_true(relay.fib == NULL);
+    assert_int_equal(0, relay.fib_index.count);
+    ccnl_htable_free(&relay.fib_index);
+}
+
+void test_face_find()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_face_s *f1, *f2;
+    sockunion su;
+
+    memset(&relay, 0, sizeof(relay));
+    memset(&su, 0, sizeof(su));
+    su.ip4.sin_family = AF_INET;
+    su.ip4.sin_addr.s_addr = htonl(0x7f000001);
+    su.ip4.sin_port = htons(9695);
+    f1 = ccnl_get_face_or_create(&relay, 0, &su.sa, sizeof(su.ip4));
+    assert_non_null(f1);
+    su.ip4.sin_port = htons(9696);
+    f2 = ccnl_get_face_or_create(&relay, 0, &su.sa, sizeof(su.ip4));
+    assert_true(f1 != f2);
+    assert_int_equal(2, relay.face_index.count);
+
+    // bytes outside of the address do not matter
+    memset(su.ip4.sin_zero, 0xff, sizeof(su.ip4.sin_zero));
+    assert_true(f2 == ccnl_get_face_or_create(&relay, 0, &su.sa, sizeof(su.ip4)));
+    su.ip4.sin_port = htons(9695);
+    assert_true(f1 == ccnl_get_face_or_create(&relay, 0, &su.sa, sizeof(su.ip4)));
+    assert_int_equal(2, relay.face_index.count);
+
+    ccnl_face_remove(&relay, f1);
+    assert_int_equal(1, relay.face_index.count);
+    f1 = ccnl_get_face_or_create(&relay, 0, &su.sa, sizeof(su.ip4));
+    assert_true(f1 != f2);
+    assert_int_equal(2, relay.face_index.count);
+
+    while (relay.faces) {
+        ccnl_face_remove(&relay, relay.faces);
+    }
+    assert_int_equal(0, relay.face_index.count);
+    ccnl_htable_free(&relay.face_index);
+}
+
+static struct ccnl_pkt_s*
+new_interest(char *uri, int sfx, uint64_t minsuffix)
+{
+    char buf[100];
+    struct ccnl_pkt_s *pkt = ccnl_calloc(1, sizeof(struct ccnl_pkt_s));
+
+    strcpy(buf, uri);
+    pkt->pfx = ccnl_URItoPrefix(buf, sfx, NULL);
+    pkt->suite = sfx;
+    pkt->s.ndntlv.minsuffix = minsuffix;
+    pkt->s.ndntlv.maxsuffix = minsuffix + 1;
+    return pkt;
+}
+
+void test_pit_find()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_interest_s *i1, *i2;
+    struct ccnl_pkt_s *pkt;
+
+    memset(&relay, 0, sizeof(relay));
+    relay.max_pit_entries = -1;
+    pkt = new_interest("/path/to/data", suite, 0);
+    i1 = ccnl_interest_new(&relay, NULL, &pkt);
+    assert_non_null(i1);
+    pkt = new_interest("/path/to", suite, 0);
+    i2 = ccnl_interest_new(&relay, NULL, &pkt);
+    assert_non_null(i2);
+    assert_int_equal(2, relay.pit_index.count);
+
+    pkt = new_interest("/path/to/data", suite, 0);
+    assert_true(i1 == ccnl_interest_find(&relay, pkt));
+    pkt->pfx->compcnt = 2;
+    assert_true(i2 == ccnl_interest_find(&relay, pkt));
+    pkt->pfx->compcnt = 1;
+    assert_null(ccnl_interest_find(&relay, pkt));
+    pkt->pfx->compcnt = 3;
+    ccnl_pkt_free(pkt);
+
+    ccnl_interest_remove(&relay, i1);
+    ccnl_interest_remove(&relay, i2);
+    assert_true(relay.pit == NULL);
+    assert_int_equal(0, relay.pit_index.count);
+    ccnl_htable_free(&relay.pit_index);
+}
+
+void test_pit_serve()
+{
+    int ndn = 6; // NDNTLV
+    struct ccnl_relay_s relay;
+    struct ccnl_face_s face;
+    struct ccnl_interest_s *i1, *i2, *i3;
+    struct ccnl_content_s *c;
+    struct ccnl_pkt_s *pkt;
+    char buf[100];
+
+    memset(&relay, 0, sizeof(relay));
+    memset(&face, 0, sizeof(face));
+    relay.max_pit_entries = -1;
+    face.ifndx = -1;
+
+    // two entries for the same name, distinguished by their selectors
+    pkt = new_interest("/path/to/data", ndn, 0);
+    i1 = ccnl_interest_new(&relay, NULL, &pkt);
+    pkt = new_interest("/path/to/data", ndn, 1);
+    i2 = ccnl_interest_new(&relay, NULL, &pkt);
+    pkt = new_interest("/path/to", ndn, 0);
+    i3 = ccnl_interest_new(&relay, NULL, &pkt);
+    assert_true(i1 && i2 && i3 && i1 != i2);
+    assert_int_equal(0, ccnl_interest_append_pending(i1, &face));
+    assert_int_equal(0, ccnl_interest_append_pending(i2, &face));
+    assert_int_equal(0, ccnl_interest_append_pending(i3, &face));
+
+    pkt = ccnl_calloc(1, sizeof(struct ccnl_pkt_s));
+    strcpy(buf, "/path/to/data");
+    pkt->pfx = ccnl_URItoPrefix(buf, ndn, NULL);
+    pkt->buf = ccnl_buf_new(NULL, 1);
+    pkt->suite = ndn;
+    c = ccnl_content_new(&pkt);
+
+    // both entries are satisfied, but the face is served only once
+    assert_int_equal(1, ccnl_content_serve_pending(&relay, c));
+    assert_true(relay.pit == i3);
+    assert_int_equal(1, relay.pitcnt);
+    assert_int_equal(1, relay.pit_index.count);
+
+    ccnl_interest_remove(&relay, i3);
+    ccnl_content_free(c);
+    ccnl_htable_free(&relay.pit_index);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_htable_empty),
+        unit_test(test_htable_insert_remove),
+        unit_test(test_htable_grow),
+        unit_test(test_cs_find),
+        unit_test(test_fib_find),
+        unit_test(test_face_find),
+        unit_test(test_pit_find),
+        unit_test(test_pit_serve),
+    };
+
+    return run_tests(tests);
+}
@@ -22,6 +22,9 @@
 #include <cmocka.h>
  
 #include "ccnl-interest.h"
+#include "ccnl-pkt.h"
+#include "ccnl-pkt-ndntlv.h"
+#include "ccnl-malloc.h"
 
 
 void test_ccnl_interest_append_pending_invalid_parameters()
@@ -54,6 +57,120 @@ void test_ccnl_interest_remove_pending_invalid_parameters()
     assert_int_equal(result, -2); 
 }
 
+#ifdef USE_SLAB_MALLOC
+static size_t
+live_objects(void)
+{
+    struct ccnl_mem_stats_s stats;
+    size_t cnt = 0;
+    int type;
+
+    for (type = 0; type < CCNL_MEM_TYPES; type++) {
+        ccnl_mem_stats(type, &stats);
+        cnt += stats.objects;
+    }
+    return cnt;
+}
+#endif
+
+void test_ccnl_interest_parse_in_place()
+{
+    // Interest for /ndn/a with nonce 01020304
+    uint8_t bytes[] = { 0x05, 0x10,
+                        0x07, 0x08, 0x08, 0x03, 'n', 'd', 'n', 0x08, 0x01, 'a',
+                        0x0a, 0x04, 0x01, 0x02, 0x03, 0x04 };
+    struct ccnl_pkt_rx_s rx;
+    struct ccnl_pkt_s *pkt;
+    uint8_t *data = bytes;
+    size_t len = sizeof(bytes), vallen;
+    uint64_t typ;
+#ifdef USE_SLAB_MALLOC
+    size_t objects = live_objects();
+#endif
+
+    assert_int_equal(ccnl_ndntlv_dehead(&data, &len, &typ, &vallen), 0);
+    assert_int_equal(typ, NDN_TLV_Interest);
+    rx.name = NULL;
+    pkt = ccnl_ndntlv_bytes2pkt_rx(&rx, typ, bytes, &data, &len);
+    assert_non_null(pkt);
+#ifdef USE_SLAB_MALLOC
+    assert_int_equal(live_objects(), objects);
+#endif
+
+    // the packet borrows the received bytes
+    assert_null(pkt->buf);
+    assert_true(pkt->flags & CCNL_PKT_BORROWED);
+    assert_int_equal(pkt->pfx->compcnt, 2);
+    assert_true(pkt->pfx->comp[0] == bytes + 6);
+    assert_true(pkt->pfx->comp[1] == bytes + 11);
+    assert_int_equal(pkt->s.ndntlv.nonce->datalen, 4);
+
+    // freeing a borrowed packet does nothing
+    ccnl_pkt_free(pkt);
+    assert_true(rx.pkt.pfx == &rx.pfx);
+
+    // keeping it makes a copy which no longer depends on the input
+    assert_int_equal(ccnl_pkt_own(&pkt), 0);
+    assert_true(pkt != &rx.pkt);
+    assert_false(pkt->flags & CCNL_PKT_BORROWED);
+    assert_int_equal(pkt->buf->datalen, sizeof(bytes));
+    memset(bytes, 0, sizeof(bytes));
+    assert_int_equal(pkt->pfx->compcnt, 2);
+    assert_int_equal(pkt->pfx->complen[0], 3);
+    assert_int_equal(0, memcmp(pkt->pfx->comp[0], "ndn", 3));
+    assert_int_equal(0, memcmp(pkt->pfx->comp[1], "a", 1));
+    assert_int_equal(pkt->s.ndntlv.nonce->data[3], 0x04);
+    ccnl_pkt_free(pkt);
+#ifdef USE_SLAB_MALLOC
+    assert_int_equal(live_objects(), objects);
+#endif
+}
+
+void test_ccnl_interest_parse_with_name()
+{
+    // Interest for /ndn/a with nonce 01020304
+    uint8_t bytes[] = { 0x05, 0x10,
+                        0x07, 0x08, 0x08, 0x03, 'n', 'd', 'n', 0x08, 0x01, 'a',
+                        0x0a, 0x04, 0x01, 0x02, 0x03, 0x04 };
+    struct ccnl_pkt_name_s name;
+    struct ccnl_pkt_rx_s rx;
+    struct ccnl_pkt_s *pkt;
+    uint8_t *data = bytes;
+    size_t len = sizeof(bytes), vallen;
+    uint64_t typ;
+
+    // the name as a receive thread passes it on, /ndn only
+    memset(&name, 0, sizeof(name));
+    name.nameptr = bytes + 2;
+    name.namelen = 10;
+    name.compcnt = 1;
+    name.comp[0].off = 4;
+    name.comp[0].len = 3;
+    name.comp[0].hash = 0x12345678;
+
+    assert_int_equal(ccnl_ndntlv_dehead(&data, &len, &typ, &vallen), 0);
+    rx.name = &name;
+    pkt = ccnl_ndntlv_bytes2pkt_rx(&rx, typ, bytes, &data, &len);
+    assert_non_null(pkt);
+
+    // the parser took the components and their hashes
+    assert_int_equal(pkt->pfx->compcnt, 1);
+    assert_true(pkt->pfx->comp[0] == bytes + 6);
+    assert_int_equal(pkt->pfx->hashcnt, 1);
+    assert_int_equal(pkt->pfx->comphash[0], 0x12345678);
+    assert_int_equal(pkt->s.ndntlv.nonce->datalen, 4);
+
+    // a name which starts elsewhere is parsed
+    data = bytes;
+    len = sizeof(bytes);
+    name.nameptr = bytes + 3;
+    assert_int_equal(ccnl_ndntlv_dehead(&data, &len, &typ, &vallen), 0);
+    pkt = ccnl_ndntlv_bytes2pkt_rx(&rx, typ, bytes, &data, &len);
+    assert_non_null(pkt);
+    assert_int_equal(pkt->pfx->compcnt, 2);
+    assert_int_equal(pkt->pfx->hashcnt, 0);
+}
+
 void test1()
 {
   int result = 0;
@@ -67,6 +184,8 @@ int main(void)
     unit_test(test_ccnl_interest_is_same_invalid_parameters),
     unit_test(test_ccnl_interest_remove_pending_invalid_parameters),
     unit_test(test_ccnl_interest_append_pending_invalid_parameters),
+    unit_test(test_ccnl_interest_parse_in_place),
+    unit_test(test_ccnl_interest_parse_with_name),
   };
  
   return run_tests(tests);
@@ -0,0 +1,131 @@
+/**
+ * @file test_malloc.c
+ * @brief Tests for the slab allocator
+ *
+ * Copyright (C) 2018 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "ccnl-core.h"
+
+#ifdef USE_SLAB_MALLOC
+
+#define MANY    100000
+
+void test_malloc_typed()
+{
+    struct ccnl_mem_stats_s before, after;
+    struct ccnl_interest_s **v;
+    int n;
+
+    ccnl_mem_stats(CCNL_MEM_INTEREST, &before);
+    v = ccnl_calloc(MANY, sizeof(*v));
+    assert_non_null(v);
+    for (n = 0; n < MANY; n++) {
+        v[n] = ccnl_obj_calloc(CCNL_MEM_INTEREST, sizeof(**v));
+        assert_non_null(v[n]);
+        assert_null(v[n]->pkt);
+        v[n]->retries = n;
+    }
+    ccnl_mem_stats(CCNL_MEM_INTEREST, &after);
+    assert_true(after.objects == before.objects + MANY);
+    assert_true(after.bytes == before.bytes + MANY * sizeof(**v));
+    for (n = 0; n < MANY; n++) {
+        assert_int_equal(n, v[n]->retries);
+        ccnl_free(v[n]);
+    }
+    ccnl_free(v);
+    ccnl_mem_stats(CCNL_MEM_INTEREST, &after);
+    assert_true(after.objects == before.objects);
+    assert_true(after.bytes == before.bytes);
+    assert_string_equal("interest", ccnl_mem_type2str(CCNL_MEM_INTEREST));
+}
+
+void test_malloc_reuse()
+{
+    void *p, *q;
+    size_t reserved;
+
+    p = ccnl_obj_malloc(CCNL_MEM_PENDINT, sizeof(struct ccnl_pendint_s));
+    reserved = ccnl_mem_reserved();
+    ccnl_free(p);
+    // the freed block is the next one handed out
+    q = ccnl_obj_malloc(CCNL_MEM_PENDINT, sizeof(struct ccnl_pendint_s));
+    assert_true(p == q);
+    assert_true(reserved == ccnl_mem_reserved());
+    ccnl_free(q);
+}
+
+void test_malloc_realloc()
+{
+    struct ccnl_mem_stats_s before, after;
+    char *p;
+    int n;
+
+    ccnl_mem_stats(CCNL_MEM_OTHER, &before);
+    p = ccnl_malloc(10);
+    memcpy(p, "0123456789", 10);
+    // grows from a slab block to a large block and back
+    for (n = 20; n < 3 * CCNL_SLAB_MAX; n *= 2) {
+        p = ccnl_realloc(p, n);
+        assert_non_null(p);
+        assert_int_equal(0, memcmp(p, "0123456789", 10));
+    }
+    p = ccnl_realloc(p, 10);
+    assert_int_equal(0, memcmp(p, "0123456789", 10));
+    ccnl_mem_stats(CCNL_MEM_OTHER, &after);
+    assert_true(after.bytes == before.bytes + 10);
+    ccnl_free(p);
+    ccnl_mem_stats(CCNL_MEM_OTHER, &after);
+    assert_true(after.objects == before.objects && after.bytes == before.bytes);
+}
+
+void test_malloc_large()
+{
+    size_t reserved = ccnl_mem_reserved();
+    uint8_t *p;
+
+    p = ccnl_calloc(1, 4 * CCNL_SLAB_SIZE);
+    assert_non_null(p);
+    assert_int_equal(0, p[4 * CCNL_SLAB_SIZE - 1]);
+    assert_true(ccnl_mem_reserved() >= reserved + 4 * CCNL_SLAB_SIZE);
+    ccnl_free(p);
+    assert_true(reserved == ccnl_mem_reserved());
+    assert_null(ccnl_calloc((size_t) -1, 2));
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_malloc_typed),
+        unit_test(test_malloc_reuse),
+        unit_test(test_malloc_realloc),
+        unit_test(test_malloc_large),
+    };
+
+    return run_tests(tests);
+}
+
+#else // USE_SLAB_MALLOC
+
+int main(void)
+{
+    return 0;
+}
+
+#endif // USE_SLAB_MALLOC
@@ -0,0 +1,103 @@
+/**
+ * @file test_nonce.c
+ * @brief Tests for the table of recently seen Interest nonces
+ *
+ * Copyright (C) 2018 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "ccnl-core.h"
+
+static struct ccnl_relay_s relay;
+
+static int
+seen(char *uri, uint32_t n)
+{
+    char buf[100];
+    struct ccnl_prefix_s *pfx;
+    union {
+        struct ccnl_buf_s buf;
+        char space[sizeof(struct ccnl_buf_s) + sizeof(uint32_t)];
+    } nonce;
+    int rc;
+
+    strcpy(buf, uri);
+    pfx = ccnl_URItoPrefix(buf, 0, NULL);
+    nonce.buf.datalen = sizeof(n);
+    memcpy(nonce.buf.data, &n, sizeof(n));
+    rc = ccnl_nonce_find_or_append(&relay, pfx, &nonce.buf);
+    ccnl_prefix_free(pfx);
+    return rc;
+}
+
+void test_nonce_dup()
+{
+    memset(&relay, 0, sizeof(relay));
+    assert_int_equal(0, seen("/a", 1));
+    assert_int_equal(-1, seen("/a", 1));
+    // the same nonce on another name is not a loop
+    assert_int_equal(0, seen("/b", 1));
+    assert_int_equal(0, seen("/a", 2));
+    assert_int_equal(3, ccnl_nonce_count(&relay));
+    ccnl_nonce_cleanup(&relay);
+}
+
+void test_nonce_expiry()
+{
+    uint32_t i;
+
+    memset(&relay, 0, sizeof(relay));
+    assert_int_equal(0, seen("/a", 1));
+    for (i = 0; i < relay.nonces.size; i++) {
+        if (relay.nonces.slots[i].expires) {
+            relay.nonces.slots[i].expires = (uint32_t) CCNL_NOW();
+        }
+    }
+    assert_int_equal(0, ccnl_nonce_count(&relay));
+    assert_int_equal(0, seen("/a", 1));
+    assert_int_equal(-1, seen("/a", 1));
+    ccnl_nonce_cleanup(&relay);
+}
+
+void test_nonce_grow()
+{
+    uint32_t i;
+
+    memset(&relay, 0, sizeof(relay));
+    for (i = 0; i < 4 * CCNL_NONCE_MIN_SIZE; i++) {
+        assert_int_equal(0, seen("/a", i));
+    }
+    assert_true(relay.nonces.size > CCNL_NONCE_MIN_SIZE);
+    // live entries survive the growth of the table
+    assert_int_equal(4 * CCNL_NONCE_MIN_SIZE, ccnl_nonce_count(&relay));
+    for (i = 0; i < 4 * CCNL_NONCE_MIN_SIZE; i++) {
+        assert_int_equal(-1, seen("/a", i));
+    }
+    ccnl_nonce_cleanup(&relay);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_nonce_dup),
+        unit_test(test_nonce_expiry),
+        unit_test(test_nonce_grow),
+    };
+
+    return run_tests(tests);
+}
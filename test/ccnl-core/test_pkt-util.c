@@ -178,6 +178,56 @@ void test_ccnl_pkt2suite_valid()
     assert_int_equal(result, CCNL_SUITE_CCNTLV);
 }
 
+void test_ccnl_pkt_framelen_invalid()
+{
+    uint8_t buffer[4] = { 0x04, 0x82, 0x00, 0x00 };
+    size_t framelen;
+
+    /** ccnb has no length in its header */
+    assert_int_equal(ccnl_pkt_framelen(buffer, sizeof(buffer), &framelen), -1);
+
+    /** a CCNx fixed header is at least 8 bytes long */
+    buffer[0] = CCNX_TLV_V1;
+    buffer[1] = CCNX_PT_Data;
+    buffer[3] = 0x04;
+    assert_int_equal(ccnl_pkt_framelen(buffer, sizeof(buffer), &framelen), -1);
+
+    /** 8 byte NDN lengths are not supported */
+    buffer[0] = NDN_TLV_Data;
+    buffer[1] = 255;
+    assert_int_equal(ccnl_pkt_framelen(buffer, sizeof(buffer), &framelen), -1);
+}
+
+void test_ccnl_pkt_framelen_valid()
+{
+    uint8_t buffer[6] = { 0x80, 0x02, NDN_TLV_Interest, 0x10, 0x00, 0x00 };
+    size_t framelen;
+
+    /** switch header, one byte length */
+    assert_int_equal(ccnl_pkt_framelen(buffer, sizeof(buffer), &framelen), 0);
+    assert_int_equal(framelen, 2 + 2 + 0x10);
+
+    /** three byte length, which is still incomplete */
+    buffer[2] = NDN_TLV_Data;
+    buffer[3] = 253;
+    buffer[4] = 0x12;
+    assert_int_equal(ccnl_pkt_framelen(buffer, 5, &framelen), 0);
+    assert_int_equal(framelen, 0);
+    buffer[5] = 0x34;
+    assert_int_equal(ccnl_pkt_framelen(buffer, 6, &framelen), 0);
+    assert_int_equal(framelen, 2 + 4 + 0x1234);
+
+    /** CCNx packet length from the fixed header */
+    buffer[0] = CCNX_TLV_V1;
+    buffer[1] = CCNX_PT_Interest;
+    buffer[2] = 0x01;
+    buffer[3] = 0x00;
+    assert_int_equal(ccnl_pkt_framelen(buffer, 4, &framelen), 0);
+    assert_int_equal(framelen, 0x100);
+    assert_int_equal(ccnl_pkt_framelen(buffer, 3, &framelen), 0);
+    assert_int_equal(framelen, 0);
+}
+
 int main(void)
 {
     const UnitTest tests[] = {
@@ -193,6 +243,8 @@ int main(void)
         unit_test(test_ccnl_cmp2int_valid),
         unit_test(test_ccnl_pkt2suite_invalid),
         unit_test(test_ccnl_pkt2suite_valid),
+        unit_test(test_ccnl_pkt_framelen_invalid),
+        unit_test(test_ccnl_pkt_framelen_valid),
     };
     
     return run_tests(tests);
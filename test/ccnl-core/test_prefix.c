@@ -127,6 +127,86 @@ void test_prefix_no_longest_match()
     assert_int_equal(0, res);
 }
 
+void test_prefix_hash()
+{
+    int prefix_hash_suite = 0;
+    char *c1 = ccnl_malloc(100);
+    strcpy(c1, "/path/to/data");
+    struct ccnl_prefix_s *p1 = ccnl_URItoPrefix(c1, prefix_hash_suite, NULL);
+
+    char *c2 = ccnl_malloc(100);
+    strcpy(c2, "/path/to/data/files");
+    struct ccnl_prefix_s *p2 = ccnl_URItoPrefix(c2, prefix_hash_suite, NULL);
+
+    assert_int_equal(ccnl_prefix_hash(p1, p1->compcnt), ccnl_prefix_hash(p2, 3));
+    assert_true(ccnl_prefix_hash(p1, p1->compcnt) != ccnl_prefix_hash(p2, p2->compcnt));
+    p2->suite = prefix_hash_suite + 1;
+    assert_true(ccnl_prefix_hash(p1, p1->compcnt) != ccnl_prefix_hash(p2, 3));
+
+    ccnl_prefix_free(p1);
+    ccnl_prefix_free(p2);
+}
+
+void test_prefix_dup_compact()
+{
+    uint32_t chunk = 7;
+    char *c = ccnl_malloc(100);
+    strcpy(c, "/path/to/data");
+    struct ccnl_prefix_s *p1 = ccnl_URItoPrefix(c, 0, &chunk);
+    struct ccnl_prefix_s *p2 = ccnl_prefix_dup(p1);
+
+    // table, copies and chunk number share the prefix's block
+    assert_true((uint8_t*) p2->comp == (uint8_t*) (p2 + 1));
+    assert_true(p2->chunknum == &p2->chunkval);
+    assert_int_equal(p2->inlinelen, 3 * (sizeof(uint8_t*) + sizeof(size_t) + sizeof(uint32_t)) + 10);
+    assert_int_equal(*p2->chunknum, 7);
+    assert_int_equal(ccnl_prefix_cmp(p1, NULL, p2, CMP_EXACT), 0);
+
+    // growing it moves the table out of the block
+    assert_int_equal(ccnl_prefix_appendCmp(p2, (uint8_t*) "x", 1), 0);
+    assert_int_equal(p2->compcnt, 4);
+    assert_string_equal(ccnl_prefix_to_path(p2), "/path/to/data/x");
+
+    ccnl_prefix_free(p1);
+    ccnl_prefix_free(p2);
+    ccnl_free(c);
+}
+
+void test_prefix_hash_cached()
+{
+    char *c1 = ccnl_malloc(100);
+    strcpy(c1, "/path/to/data");
+    struct ccnl_prefix_s *p1 = ccnl_URItoPrefix(c1, 0, NULL);
+
+    char *c2 = ccnl_malloc(100);
+    strcpy(c2, "/path/to");
+    struct ccnl_prefix_s *p2 = ccnl_URItoPrefix(c2, 0, NULL);
+
+    // the full name's hash includes the ones of its prefixes
+    uint32_t h = ccnl_prefix_hash(p1, p1->compcnt);
+    assert_int_equal(p1->hashcnt, 3);
+    assert_int_equal(ccnl_prefix_hash(p1, 2), ccnl_prefix_hash(p2, 2));
+    assert_int_equal(ccnl_prefix_hash(p1, 3), h);
+
+    // appending keeps the hashes of the old components
+    assert_int_equal(ccnl_prefix_appendCmp(p2, (uint8_t*) "data", 4), 0);
+    assert_int_equal(p2->hashcnt, 2);
+    assert_int_equal(ccnl_prefix_hash(p2, p2->compcnt), h);
+    assert_int_equal(ccnl_prefix_cmp(p1, NULL, p2, CMP_EXACT), 0);
+
+    assert_int_equal(ccnl_prefix_appendCmp(p2, (uint8_t*) "x", 1), 0);
+    assert_int_equal(ccnl_prefix_appendCmp(p1, (uint8_t*) "y", 1), 0);
+    ccnl_prefix_hash(p1, p1->compcnt);
+    ccnl_prefix_hash(p2, p2->compcnt);
+    assert_int_equal(ccnl_prefix_cmp(p1, NULL, p2, CMP_EXACT), -1);
+    assert_int_equal(ccnl_prefix_cmp(p1, NULL, p2, CMP_LONGEST), 3);
+
+    ccnl_prefix_free(p1);
+    ccnl_prefix_free(p2);
+    ccnl_free(c1);
+    ccnl_free(c2);
+}
+
 int main(void)
 {
   const UnitTest tests[] = {
@@ -137,6 +217,9 @@ int main(void)
     unit_test(test_prefix_no_exact_match),
     unit_test(test_prefix_longest_match),
     unit_test(test_prefix_no_longest_match),
+    unit_test(test_prefix_hash),
+    unit_test(test_prefix_dup_compact),
+    unit_test(test_prefix_hash_cached),
   };
  
   return run_tests(tests);
@@ -0,0 +1,184 @@
+/**
+ * @file test_ring.c
+ * @brief Tests for the single producer single consumer ring
+ *
+ * Copyright (C) 2018 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "ccnl-core.h"
+
+static void
+push(struct ccnl_ring_s *r, uint32_t tag, const char *s, int first)
+{
+    char *p = ccnl_ring_reserve(r, strlen(s));
+
+    assert_non_null(p);
+    memcpy(p, s, strlen(s));
+    assert_int_equal(first, ccnl_ring_commit(r, tag, strlen(s)));
+}
+
+static void
+pop(struct ccnl_ring_s *r, uint32_t tag, const char *s)
+{
+    uint32_t t;
+    size_t len;
+    char *p = ccnl_ring_peek(r, &t, &len);
+
+    assert_non_null(p);
+    assert_int_equal(tag, t);
+    assert_int_equal(strlen(s), len);
+    assert_true(!memcmp(p, s, len));
+    ccnl_ring_release(r);
+}
+
+void test_ring_empty()
+{
+    struct ccnl_ring_s r;
+    uint32_t tag;
+    size_t len;
+
+    assert_int_equal(0, ccnl_ring_init(&r, 100));
+    assert_int_equal(128, r.size);
+    assert_null(ccnl_ring_peek(&r, &tag, &len));
+    assert_int_equal(0, ccnl_ring_depth(&r));
+    // a record may fill at most half of the ring
+    assert_null(ccnl_ring_reserve(&r, 64));
+    ccnl_ring_free(&r);
+}
+
+void test_ring_fifo()
+{
+    struct ccnl_ring_s r;
+    uint32_t tag;
+    size_t len;
+
+    assert_int_equal(0, ccnl_ring_init(&r, 128));
+    push(&r, 1, "first", 1);
+    push(&r, 2, "second", 0);
+    push(&r, 3, "", 0);
+    assert_int_equal(3, ccnl_ring_depth(&r));
+
+    pop(&r, 1, "first");
+    pop(&r, 2, "second");
+    pop(&r, 3, "");
+    assert_null(ccnl_ring_peek(&r, &tag, &len));
+    assert_int_equal(0, ccnl_ring_depth(&r));
+
+    // the consumer took everything, the next record has to wake it
+    push(&r, 4, "again", 1);
+    ccnl_ring_free(&r);
+}
+
+void test_ring_full()
+{
+    struct ccnl_ring_s r;
+    uint32_t tag;
+    size_t len;
+    int n = 0;
+
+    // 8 byte header plus 24 bytes, four of them fill the ring
+    assert_int_equal(0, ccnl_ring_init(&r, 128));
+    while (ccnl_ring_reserve(&r, 20)) {
+        ccnl_ring_commit(&r, 0, 20);
+        n++;
+    }
+    assert_int_equal(4, n);
+    assert_int_equal(4, ccnl_ring_depth(&r));
+
+    assert_non_null(ccnl_ring_peek(&r, &tag, &len));
+    assert_int_equal(20, len);
+    ccnl_ring_release(&r);
+    // the space of the first record fits one of the same size only
+    assert_null(ccnl_ring_reserve(&r, 30));
+    assert_non_null(ccnl_ring_reserve(&r, 20));
+    ccnl_ring_free(&r);
+}
+
+void test_ring_wrap()
+{
+    struct ccnl_ring_s r;
+    char s[40];
+    int i;
+
+    assert_int_equal(0, ccnl_ring_init(&r, 128));
+    // records of different sizes wrap around the end of the buffer
+    for (i = 0; i < 100; i++) {
+        snprintf(s, sizeof(s), "record %d %.*s", i, i % 23, "xxxxxxxxxxxxxxxxxxxxxxx");
+        push(&r, (uint32_t) i, s, 1);
+        pop(&r, (uint32_t) i, s);
+    }
+    for (i = 0; i < 100; i++) {
+        snprintf(s, sizeof(s), "%d", i);
+        push(&r, (uint32_t) i, s, 1);
+        snprintf(s, sizeof(s), "%d+", i);
+        push(&r, (uint32_t) i, s, 0);
+        snprintf(s, sizeof(s), "%d", i);
+        pop(&r, (uint32_t) i, s);
+        snprintf(s, sizeof(s), "%d+", i);
+        pop(&r, (uint32_t) i, s);
+    }
+    assert_int_equal(0, ccnl_ring_depth(&r));
+    ccnl_ring_free(&r);
+}
+
+void test_ring_batch()
+{
+    struct ccnl_ring_s r;
+    uint32_t tag;
+    size_t len;
+    char s[8];
+    int i, k;
+
+    assert_int_equal(0, ccnl_ring_init(&r, 128));
+    for (i = 0; i < 50; i++) {
+        // three records at a time, the ring wraps in between
+        for (k = 0; k < 3; k++) {
+            snprintf(s, sizeof(s), "%d.%d", i, k);
+            push(&r, (uint32_t) k, s, k == 0);
+        }
+        for (k = 0; k < 3; k++) {
+            char *p = ccnl_ring_peek(&r, &tag, &len);
+
+            snprintf(s, sizeof(s), "%d.%d", i, k);
+            assert_non_null(p);
+            assert_int_equal(k, tag);
+            assert_int_equal(strlen(s), len);
+            assert_true(!memcmp(p, s, len));
+        }
+        assert_null(ccnl_ring_peek(&r, &tag, &len));
+        // peeked records stay until they are released
+        assert_int_equal(3, ccnl_ring_depth(&r));
+        ccnl_ring_release(&r);
+        assert_int_equal(0, ccnl_ring_depth(&r));
+    }
+    ccnl_ring_free(&r);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_ring_empty),
+        unit_test(test_ring_fifo),
+        unit_test(test_ring_full),
+        unit_test(test_ring_wrap),
+        unit_test(test_ring_batch),
+    };
+
+    return run_tests(tests);
+}
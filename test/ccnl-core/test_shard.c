@@ -0,0 +1,124 @@
+/**
+ * @file test_shard.c
+ * @brief Tests for the owners of names when the relay runs on several shards
+ *
+ * Copyright (C) 2018 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <string.h>
+#include <cmocka.h>
+
+#include "ccnl-shard.h"
+#include "ccnl-dispatch.h"
+#include "ccnl-pkt-ndntlv.h"
+
+#define SHARDS          4
+
+static uint8_t bytes[256];
+static struct ccnl_pkt_rx_s rx;
+
+// an ndntlv Interest (with a nonce) or Data (with content) named by the
+// components in @path, separated by '/'; valid until the next call
+static struct ccnl_pkt_s*
+parse(uint8_t typ, const char *path)
+{
+    uint8_t name[128], *cp = name;
+    const char *comp = path + 1, *end;
+    size_t len;
+
+    while (*comp) {
+        end = strchr(comp, '/');
+        len = end ? (size_t) (end - comp) : strlen(comp);
+        *cp++ = NDN_TLV_NameComponent;
+        *cp++ = (uint8_t) len;
+        memcpy(cp, comp, len);
+        cp += len;
+        comp += end ? len + 1 : len;
+    }
+    len = (size_t) (cp - name);
+    bytes[0] = typ;
+    bytes[1] = (uint8_t) (2 + len + 6);
+    bytes[2] = NDN_TLV_Name;
+    bytes[3] = (uint8_t) len;
+    memcpy(bytes + 4, name, len);
+    cp = bytes + 4 + len;
+    *cp++ = typ == NDN_TLV_Interest ? NDN_TLV_Nonce : NDN_TLV_Content;
+    *cp++ = 4;
+    memcpy(cp, "\x01\x02\x03\x04", 4);
+    cp += 4;
+
+    assert_non_null(ccnl_core_peek_prefix(&rx, bytes, (size_t) (cp - bytes)));
+    return &rx.pkt;
+}
+
+void test_shard_owner()
+{
+    int owner = ccnl_shard_owner(SHARDS, 2, parse(NDN_TLV_Data, "/a/b/c"));
+
+    assert_true(owner >= 0 && owner < SHARDS);
+    // extensions of the first depth components have the same owner
+    assert_int_equal(owner, ccnl_shard_owner(SHARDS, 2,
+                                             parse(NDN_TLV_Interest, "/a/b")));
+    assert_int_equal(owner, ccnl_shard_owner(SHARDS, 2,
+                                         parse(NDN_TLV_Data, "/a/b/c/d/e")));
+    // one shard owns everything
+    assert_int_equal(0, ccnl_shard_owner(1, 2, parse(NDN_TLV_Data, "/a/b/c")));
+}
+
+void test_shard_owner_short_interest()
+{
+    char path[32];
+    int i, owner = 0;
+
+    // Data longer than the depth, owned by another shard than the first
+    for (i = 0; i < 100 && !owner; i++) {
+        snprintf(path, sizeof(path), "/a/%d/c", i);
+        owner = ccnl_shard_owner(SHARDS, 2, parse(NDN_TLV_Data, path));
+    }
+    assert_true(owner > 0);
+    // an Interest shorter than the depth goes to all shards, the owner of
+    // the Data among them
+    assert_int_equal(CCNL_SHARD_ALL,
+                     ccnl_shard_owner(SHARDS, 2, parse(NDN_TLV_Interest, "/a")));
+    assert_int_equal(CCNL_SHARD_ALL,
+                     ccnl_shard_owner(SHARDS, 4, parse(NDN_TLV_Interest, path)));
+    // unless it is long enough for the depth
+    owner = ccnl_shard_owner(SHARDS, 1, parse(NDN_TLV_Data, path));
+    assert_int_equal(owner,
+                     ccnl_shard_owner(SHARDS, 1, parse(NDN_TLV_Interest, "/a")));
+}
+
+void test_shard_owner_short_data()
+{
+    // only an Interest of the same length matches it, on every shard
+    assert_int_equal(0, ccnl_shard_owner(SHARDS, 2, parse(NDN_TLV_Data, "/a")));
+    // management requests go to the first shard
+    assert_int_equal(0, ccnl_shard_owner(SHARDS, 2,
+                                 parse(NDN_TLV_Interest, "/ccnx/x/newface/y")));
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_shard_owner),
+        unit_test(test_shard_owner_short_interest),
+        unit_test(test_shard_owner_short_data),
+    };
+
+    return run_tests(tests);
+}
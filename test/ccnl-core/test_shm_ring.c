@@ -0,0 +1,244 @@
+/**
+ * @file test_shm_ring.c
+ * @brief Tests for the rings in memory shared with an application
+ *
+ * Copyright (C) 2018 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+
+#include "ccnl-shm.h"
+
+#define RING_SIZE       1024
+
+// the application produces into the up ring, the relay consumes from it
+static void *mem;
+static struct ccnl_shm_ring_s app_tx, app_rx, relay_tx, relay_rx;
+
+// maps a fresh pair of rings, the last one is dropped
+static void
+attach(void)
+{
+    struct ccnl_shm_hdr_s *hdr;
+
+    free(mem);
+    mem = calloc(1, ccnl_shm_mem_size(RING_SIZE));
+    assert_non_null(mem);
+    hdr = (struct ccnl_shm_hdr_s *) mem;
+    hdr->magic = CCNL_SHM_MAGIC;
+    hdr->version = CCNL_SHM_VERSION;
+    hdr->ring_size = RING_SIZE;
+    ccnl_shm_ring_attach(mem, 1, &app_tx, &app_rx);
+    ccnl_shm_ring_attach(mem, 0, &relay_tx, &relay_rx);
+}
+
+static void
+push(const char *s)
+{
+    uint8_t *p = ccnl_shm_ring_reserve(&app_tx, strlen(s));
+
+    assert_non_null(p);
+    memcpy(p, s, strlen(s));
+    ccnl_shm_ring_commit(&app_tx, strlen(s));
+}
+
+static void
+pop(const char *s)
+{
+    uint8_t *p;
+    size_t len;
+
+    assert_int_equal(1, ccnl_shm_ring_peek(&relay_rx, &p, &len));
+    assert_int_equal(strlen(s), len);
+    assert_true(!memcmp(p, s, len));
+    ccnl_shm_ring_release(&relay_rx);
+}
+
+// writes a record header at the producer's position and publishes it
+static void
+forge(uint32_t reclen, uint32_t head)
+{
+    uint32_t *rec = (uint32_t *) (app_tx.buf +
+                                  (app_tx.pos & (app_tx.size - 1)));
+
+    rec[0] = reclen;
+    app_tx.ctl->head = head;
+}
+
+void test_shm_ring_fifo()
+{
+    uint8_t *p;
+    size_t len;
+    char s[64];
+    int i;
+
+    attach();
+    assert_int_equal(0, ccnl_shm_ring_peek(&relay_rx, &p, &len));
+    // records of growing size, the ring wraps several times
+    for (i = 0; i < 200; i++) {
+        snprintf(s, sizeof(s), "%0*d", i % 60 + 1, i);
+        push(s);
+        pop(s);
+    }
+    assert_int_equal(0, ccnl_shm_ring_peek(&relay_rx, &p, &len));
+    // the other direction is untouched
+    assert_int_equal(0, ccnl_shm_ring_peek(&app_rx, &p, &len));
+    free(mem);
+    mem = NULL;
+}
+
+void test_shm_ring_bad_head()
+{
+    uint8_t *p;
+    size_t len;
+
+    attach();
+    push("abc");
+    pop("abc");
+    // a head behind the tail
+    app_tx.ctl->head = relay_rx.pos - 8;
+    assert_int_equal(-1, ccnl_shm_ring_peek(&relay_rx, &p, &len));
+
+    attach();
+    // a head more than the ring ahead of the tail
+    app_tx.ctl->head = relay_rx.pos + RING_SIZE + 8;
+    assert_int_equal(-1, ccnl_shm_ring_peek(&relay_rx, &p, &len));
+
+    attach();
+    // a head inside a record header
+    app_tx.ctl->head = 4;
+    assert_int_equal(-1, ccnl_shm_ring_peek(&relay_rx, &p, &len));
+    free(mem);
+    mem = NULL;
+}
+
+void test_shm_ring_bad_tail()
+{
+    int i;
+
+    attach();
+    for (i = 0; ccnl_shm_ring_reserve(&app_tx, 56); i++) {
+        ccnl_shm_ring_commit(&app_tx, 56);
+    }
+    assert_int_equal(RING_SIZE / 64, i);
+    // a tail ahead of the head makes no room
+    relay_rx.ctl->tail = app_tx.pos + 64;
+    assert_null(ccnl_shm_ring_reserve(&app_tx, 56));
+    // nor does one far behind it
+    relay_rx.ctl->tail = app_tx.pos - 2 * RING_SIZE;
+    assert_null(ccnl_shm_ring_reserve(&app_tx, 56));
+    free(mem);
+    mem = NULL;
+}
+
+void test_shm_ring_bad_reclen()
+{
+    uint8_t *p;
+    size_t len;
+
+    attach();
+    // larger than any packet
+    forge(CCNL_SHM_MAX_PACKET_SIZE + 1, 16);
+    assert_int_equal(-1, ccnl_shm_ring_peek(&relay_rx, &p, &len));
+
+    attach();
+    // longer than what was published
+    forge(64, 16);
+    assert_int_equal(-1, ccnl_shm_ring_peek(&relay_rx, &p, &len));
+
+    attach();
+    // reaching past the end of the buffer
+    app_tx.pos = relay_rx.pos = relay_rx.seen = RING_SIZE - 16;
+    forge(64, RING_SIZE + 512);
+    assert_int_equal(-1, ccnl_shm_ring_peek(&relay_rx, &p, &len));
+    free(mem);
+    mem = NULL;
+}
+
+void test_shm_ring_bad_wrap()
+{
+    uint8_t *p;
+    size_t len;
+
+    attach();
+    // a wrap record which does not reach the end of the buffer
+    forge(UINT32_MAX, 16);
+    assert_int_equal(-1, ccnl_shm_ring_peek(&relay_rx, &p, &len));
+
+    attach();
+    // wrap records only
+    app_tx.pos = relay_rx.pos = relay_rx.seen = RING_SIZE - 16;
+    forge(UINT32_MAX, RING_SIZE + 16);
+    *(uint32_t *) app_tx.buf = UINT32_MAX;
+    assert_int_equal(-1, ccnl_shm_ring_peek(&relay_rx, &p, &len));
+
+    attach();
+    // a proper one is skipped
+    app_tx.pos = relay_rx.pos = relay_rx.seen = RING_SIZE - 16;
+    app_tx.ctl->tail = app_tx.pos;
+    push("abcdefghijklmnop");
+    pop("abcdefghijklmnop");
+    free(mem);
+    mem = NULL;
+}
+
+void test_shm_ring_full()
+{
+    uint8_t *p;
+    size_t len;
+    int i;
+
+    attach();
+    // a record may fill at most half of the ring
+    assert_null(ccnl_shm_ring_reserve(&app_tx, RING_SIZE / 2));
+    assert_null(ccnl_shm_ring_reserve(&app_tx, CCNL_SHM_MAX_PACKET_SIZE + 1));
+    for (i = 0; i < RING_SIZE / 64; i++) {
+        push("0123456789012345678901234567890123456789012345678901234");
+    }
+    assert_null(ccnl_shm_ring_reserve(&app_tx, 1));
+    ccnl_shm_ring_want_room(&app_tx);
+
+    // taking a record makes room and asks to ring the producer
+    assert_int_equal(1, ccnl_shm_ring_peek(&relay_rx, &p, &len));
+    assert_int_equal(1, ccnl_shm_ring_release(&relay_rx));
+    assert_int_equal(0, ccnl_shm_ring_release(&relay_rx));
+    assert_non_null(ccnl_shm_ring_reserve(&app_tx, 55));
+    ccnl_shm_ring_commit(&app_tx, 55);
+    for (i = 0; i < RING_SIZE / 64; i++) {
+        assert_int_equal(1, ccnl_shm_ring_peek(&relay_rx, &p, &len));
+        assert_int_equal(55, len);
+    }
+    assert_int_equal(0, ccnl_shm_ring_peek(&relay_rx, &p, &len));
+    free(mem);
+    mem = NULL;
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_shm_ring_fifo),
+        unit_test(test_shm_ring_bad_head),
+        unit_test(test_shm_ring_bad_tail),
+        unit_test(test_shm_ring_bad_reclen),
+        unit_test(test_shm_ring_bad_wrap),
+        unit_test(test_shm_ring_full),
+    };
+
+    return run_tests(tests);
+}
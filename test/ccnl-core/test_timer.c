@@ -0,0 +1,196 @@
+/**
+ * @file test_timer.c
+ * @brief Tests for the timers of the event loop
+ *
+ * Copyright (C) 2018 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "ccnl-core.h"
+
+static int fired[16];
+static int nfired;
+
+static void
+handler(void *aux1, void *aux2)
+{
+    (void) aux2;
+    fired[nfired++] = (int) (intptr_t) aux1;
+}
+
+void test_timer_order()
+{
+    int i;
+
+    nfired = 0;
+    ccnl_time_update();
+    for (i = 9; i >= 0; i--) {
+        assert_non_null(ccnl_set_timer(i, handler, (void*) (intptr_t) i, NULL));
+    }
+    assert_int_equal(10, ccnl_timer_count());
+    // the clock is read once per run, spin until all timers are due
+    while (nfired < 10) {
+        ccnl_run_events();
+    }
+    assert_int_equal(10, nfired);
+    for (i = 0; i < 10; i++) {
+        assert_int_equal(i, fired[i]);
+    }
+    assert_int_equal(0, ccnl_timer_count());
+    assert_int_equal(-1, ccnl_run_events());
+    ccnl_timer_cleanup();
+}
+
+void test_timer_cancel()
+{
+    void *h[8];
+    int i;
+
+    nfired = 0;
+    for (i = 0; i < 8; i++) {
+        h[i] = ccnl_set_timer(1000000 + i, handler, (void*) (intptr_t) i, NULL);
+    }
+    ccnl_rem_timer(h[0]);
+    ccnl_rem_timer(h[5]);
+    ccnl_rem_timer(h[5]);
+    assert_int_equal(6, ccnl_timer_count());
+    assert_true(ccnl_run_events() > 0);
+
+    // a canceled timer is reused, the others keep their order
+    assert_true(h[5] == ccnl_set_timer(0, handler, (void*) (intptr_t) 5, NULL));
+    ccnl_run_events();
+    assert_int_equal(1, nfired);
+    assert_int_equal(5, fired[0]);
+    // the handle of a timer which fired is not queued anymore
+    ccnl_rem_timer(h[5]);
+    assert_int_equal(6, ccnl_timer_count());
+    ccnl_timer_cleanup();
+    assert_int_equal(0, ccnl_timer_count());
+}
+
+void test_timer_many()
+{
+    void *h[1000];
+    int i;
+
+    for (i = 0; i < 1000; i++) {
+        h[i] = ccnl_set_timer(1000000 + (i * 7919) % 1000, handler, NULL, NULL);
+        assert_non_null(h[i]);
+    }
+    for (i = 0; i < 1000; i += 2) {
+        ccnl_rem_timer(h[i]);
+    }
+    assert_int_equal(500, ccnl_timer_count());
+    ccnl_timer_cleanup();
+}
+
+static struct ccnl_relay_s relay;
+
+// runs the timers for msec milliseconds
+static void
+run_for(int msec)
+{
+    uint64_t end;
+
+    ccnl_time_update();
+    end = ccnl_time_usec() + msec * 1000;
+    while (ccnl_time_usec() < end) {
+        ccnl_run_events();
+    }
+}
+
+static struct ccnl_pkt_s*
+ndn_pkt(char *uri)
+{
+    char buf[100];
+    struct ccnl_pkt_s *pkt = ccnl_calloc(1, sizeof(struct ccnl_pkt_s));
+
+    strcpy(buf, uri);
+    pkt->suite = 6; // CCNL_SUITE_NDNTLV
+    pkt->pfx = ccnl_URItoPrefix(buf, pkt->suite, NULL);
+    pkt->buf = ccnl_buf_new(NULL, 1);
+    return pkt;
+}
+
+void test_timer_interest_lifetime()
+{
+    struct ccnl_pkt_s *pkt;
+    struct ccnl_interest_s *i;
+
+    memset(&relay, 0, sizeof(relay));
+    relay.max_pit_entries = -1;
+    pkt = ndn_pkt("/a");
+    pkt->s.ndntlv.interestlifetime = 20;
+    assert_non_null(ccnl_interest_new(&relay, NULL, &pkt));
+    pkt = ndn_pkt("/b");
+    pkt->s.ndntlv.interestlifetime = 4000;
+    i = ccnl_interest_new(&relay, NULL, &pkt);
+    assert_non_null(i);
+    assert_int_equal(2, ccnl_timer_count());
+
+    // only the short lived entry expires, before any retransmission
+    run_for(50);
+    assert_int_equal(1, relay.pitcnt);
+    assert_true(relay.pit == i);
+    assert_int_equal(0, i->retries);
+    assert_int_equal(1, ccnl_timer_count());
+
+    ccnl_interest_remove(&relay, i);
+    assert_int_equal(0, ccnl_timer_count());
+    ccnl_htable_free(&relay.pit_index);
+    ccnl_timer_cleanup();
+}
+
+void test_timer_content_stale()
+{
+    struct ccnl_pkt_s *pkt;
+    struct ccnl_content_s *c;
+
+    memset(&relay, 0, sizeof(relay));
+    assert_int_equal(0, ccnl_cache_set_policy(&relay, CCNL_CACHE_LRU));
+    pkt = ndn_pkt("/c");
+    pkt->s.ndntlv.freshnessperiod = 20;
+    c = ccnl_content_new(&pkt);
+    assert_true(c == ccnl_content_add2cache(&relay, c));
+    assert_false(c->flags & CCNL_CONTENT_FLAGS_STALE);
+
+    // a stale entry stays cached until CCNL_CONTENT_TIMEOUT
+    run_for(50);
+    assert_true(c->flags & CCNL_CONTENT_FLAGS_STALE);
+    assert_true(relay.contents == c);
+    assert_int_equal(1, ccnl_timer_count());
+
+    ccnl_content_remove(&relay, c);
+    assert_int_equal(0, ccnl_timer_count());
+    ccnl_htable_free(&relay.cs_index);
+    ccnl_cache_cleanup(&relay);
+    ccnl_timer_cleanup();
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_timer_order),
+        unit_test(test_timer_cancel),
+        unit_test(test_timer_many),
+        unit_test(test_timer_interest_lifetime),
+        unit_test(test_timer_content_stale),
+    };
+
+    return run_tests(tests);
+}